@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+/* Benchmark of main/at_batch.c against the simulated SARA-R412M
+ * of sim_sara_r412m.c: a write of 20 resources, one AT+ULWM2MWRITE
+ * each, is sent one command at a time, as the AT client does, and
+ * then with more and more commands in flight, e.g.:
+ *
+ * ./at_batch_bench [-s script] [-n resources] [-t turnaround_us]
+ *
+ * Without a script every command takes the 20 ms of the simulation's
+ * DEFAULT entry; scripts/sara_r412m_gprs.txt has writes at 300 ms.
+ * turnaround_us is the time the ESP32 takes, after a response has
+ * arrived, before it can send anything else (the AT client task
+ * being scheduled and parsing the line), zero by default.
+ *
+ * Round trips are the commands which found the module idle, i.e.
+ * which waited on the ESP32 rather than on the command ahead of
+ * them; times are simulated, from the first byte of the first
+ * command to the last byte of the last response.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+#include "host_os.h"
+#include "sim_sara_r412m.h"
+#include "at_client.h"
+#include "at_batch.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// The default number of resources written.
+#define DEFAULT_NUM_RESOURCES 20
+
+// How long to wait for a response, as at_client_init() is given
+// by main.c.
+#define RESPONSE_TIMEOUT_US 8000000
+
+// The object written, as the WHRE Channel Statistics object.
+#define OBJECT_ID 33055
+
+// The numbers of commands in flight tried, 1 being one at a time.
+static const int32_t gMaxInFlight[] = {1, 2, 4, 8, 16};
+
+// ----------------------------------------------------------------
+// PRIVATE VARIABLES
+// ----------------------------------------------------------------
+
+// The simulated clock.
+static int64_t gTimeUs = 0;
+
+// A response line being put together.
+static char gLine[SIM_SARA_R412M_MAX_LINE_LENGTH];
+static size_t gLineLength = 0;
+
+// The time the ESP32 takes to turn a response around.
+static int64_t gTurnaroundUs = 0;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Get a complete response line from the module, if one has
+// arrived by now, skipping empty ones.
+static bool getLine()
+{
+    char c;
+
+    while (simSaraR412mRead(&c, 1) == 1) {
+        if ((c == '\r') || (c == '\n')) {
+            if (gLineLength > 0) {
+                gLine[gLineLength] = 0;
+                gLineLength = 0;
+                return true;
+            }
+        } else if (gLineLength < sizeof(gLine) - 1) {
+            gLine[gLineLength] = c;
+            gLineLength++;
+        }
+    }
+
+    return false;
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS: STAND-INS
+// ----------------------------------------------------------------
+
+// The clock used by sim_sara_r412m.c.
+int64_t hostTimeUs(void)
+{
+    return gTimeUs;
+}
+
+void hostTimeAdvanceUs(int64_t us)
+{
+    gTimeUs += us;
+}
+
+void hostTimeAdvanceToUs(int64_t us)
+{
+    if (us > gTimeUs) {
+        gTimeUs = us;
+    }
+}
+
+// Just enough of the AT client for at_batch.c: send a command
+// straight to the simulated module.
+bool at_client_send(const char *pFormat, ...)
+{
+    char command[SIM_SARA_R412M_MAX_LINE_LENGTH];
+    va_list args;
+    int length;
+
+    va_start(args, pFormat);
+    length = vsnprintf(command, sizeof(command) - 1, pFormat, args);
+    va_end(args);
+    if ((length < 0) || (length >= (int) sizeof(command) - 1)) {
+        return false;
+    }
+    command[length] = '\r';
+    simSaraR412mWrite(command, length + 1);
+
+    return true;
+}
+
+// ...and wait for a line that matches, passing over any others.
+bool at_client_recv(const char *pFormat, ...)
+{
+    int64_t stopUs = hostTimeUs() + RESPONSE_TIMEOUT_US;
+    int64_t readyUs;
+    va_list args;
+    bool matched;
+
+    for (;;) {
+        if (getLine()) {
+            if (strchr(pFormat, '%') == NULL) {
+                matched = (strcmp(gLine, pFormat) == 0);
+            } else {
+                va_start(args, pFormat);
+                matched = (vsscanf(gLine, pFormat, args) > 0);
+                va_end(args);
+            }
+            if (matched) {
+                hostTimeAdvanceUs(gTurnaroundUs);
+                return true;
+            }
+        } else {
+            readyUs = simSaraR412mNextReadyUs();
+            if ((readyUs < 0) || (readyUs > stopUs)) {
+                hostTimeAdvanceToUs(stopUs);
+                return false;
+            }
+            hostTimeAdvanceToUs(readyUs);
+        }
+    }
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const char *pScript = NULL;
+    int32_t numResources = DEFAULT_NUM_RESOURCES;
+    char (*pCommands)[64];
+    AtBatch batch;
+    SimSaraR412mStats before;
+    SimSaraR412mStats after;
+    int64_t startUs;
+    int64_t serialUs = 0;
+    int64_t timeUs;
+    int32_t numOk;
+
+    for (int x = 1; x + 1 < argc; x += 2) {
+        if (strcmp(argv[x], "-s") == 0) {
+            pScript = argv[x + 1];
+        } else if (strcmp(argv[x], "-n") == 0) {
+            numResources = atoi(argv[x + 1]);
+        } else if (strcmp(argv[x], "-t") == 0) {
+            gTurnaroundUs = atoi(argv[x + 1]);
+        }
+    }
+    if ((numResources < 1) || (numResources > AT_BATCH_MAX_COMMANDS)) {
+        printf("between 1 and %d resources, please.\n", AT_BATCH_MAX_COMMANDS);
+        return 1;
+    }
+    if (simSaraR412mInit(pScript) != 0) {
+        return 1;
+    }
+
+    // The resources of one instance, as the values of a channel
+    pCommands = malloc(numResources * sizeof(*pCommands));
+    if (pCommands == NULL) {
+        return 1;
+    }
+    for (int32_t x = 0; x < numResources; x++) {
+        snprintf(pCommands[x], sizeof(pCommands[x]), "AT+ULWM2MWRITE=%d,0,%d,\"%d.%03d\"",
+                 OBJECT_ID, x + 1, 1000 + x * 37, (x * 191) % 1000);
+    }
+
+    // Power up and wait for the module to boot
+    simSaraR412mSetPower(true);
+    hostTimeAdvanceUs(10000000);
+
+    printf("a write of %d resource(s), %s, %lld us turnaround.\n\n", numResources,
+           (pScript != NULL) ? pScript : "20 ms per command", (long long) gTurnaroundUs);
+    printf("%-10s %9s %11s %7s %10s %7s\n", "mode", "in flight", "round trips",
+           "bursts", "time ms", "speedup");
+    for (size_t y = 0; y < sizeof(gMaxInFlight) / sizeof(gMaxInFlight[0]); y++) {
+        atBatchInit(&batch, gMaxInFlight[y]);
+        for (int32_t x = 0; x < numResources; x++) {
+            atBatchAdd(&batch, pCommands[x]);
+        }
+        simSaraR412mGetStats(&before);
+        startUs = hostTimeUs();
+        numOk = atBatchRun(&batch);
+        timeUs = hostTimeUs() - startUs;
+        simSaraR412mGetStats(&after);
+        if (gMaxInFlight[y] == 1) {
+            serialUs = timeUs;
+        }
+        if (numOk == numResources) {
+            printf("%-10s %9d %11d %7d %10.1f %7.2f\n",
+                   (gMaxInFlight[y] == 1) ? "serial" : "pipelined", gMaxInFlight[y],
+                   after.roundTrips - before.roundTrips, batch.numBursts,
+                   ((double) timeUs) / 1000, ((double) serialUs) / (timeUs + 1));
+        } else {
+            printf("%-10s %9d FAILED: %d of %d command(s) OK.\n",
+                   (gMaxInFlight[y] == 1) ? "serial" : "pipelined", gMaxInFlight[y],
+                   numOk, numResources);
+        }
+        // Let anything left over go before the next run
+        hostTimeAdvanceUs(RESPONSE_TIMEOUT_US);
+        while (getLine()) {
+        }
+    }
+
+    free(pCommands);
+    simSaraR412mDeinit();
+
+    return 0;
+}
+
+// End Of File
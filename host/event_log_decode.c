@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+/* Decode batches of the flash event log written by main/flash_log.c,
+ * as read from the Event Batch resource of the WHRE Event Log
+ * object, into CSV.  Each batch is given in hex, either on the
+ * command line or one per line on stdin, e.g.:
+ *
+ * ./event_log_decode 000000000c000000...
+ * ./event_log_decode < batches.txt > events.csv
+ *
+ * Each CSV line is the batch number, the position of the segment
+ * in the log, the time in seconds, the event and its value.  A
+ * segment at a position already seen, i.e. a batch sent again
+ * after a reset, is skipped.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "utilities.h"
+#include "flash_log.h"
+#include "log_events_app.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// The longest input line handled.
+#define MAX_LINE_LENGTH 8192
+
+// ----------------------------------------------------------------
+// PRIVATE VARIABLES
+// ----------------------------------------------------------------
+
+// The names of the events, by number, as in log_strings_app.h.
+#define EVENT_NAME(event, string) string,
+static const char *gpEventNames[] = {LOG_EVENTS_APP(EVENT_NAME)};
+
+// The position just past the last segment decoded.
+static uint32_t gEndPosition = 0;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Read a little-endian number.
+static uint32_t readUint(const uint8_t *pBuffer, int32_t length)
+{
+    uint32_t number = 0;
+
+    for (int32_t x = length - 1; x >= 0; x--) {
+        number = (number << 8) | pBuffer[x];
+    }
+
+    return number;
+}
+
+// Decode the records of a segment, printing them as CSV; returns
+// the number of records or negative on error.
+static int32_t decodeSegment(const uint8_t *pBuffer, int32_t length,
+                             uint32_t position, uint32_t timeSeconds,
+                             int32_t batchNumber)
+{
+    FlashLogRecord record;
+    const char *pName;
+    int32_t numRecords = 0;
+    int32_t x = 0;
+    int32_t n;
+
+    while (x < length) {
+        n = flashLogDecodeRecord(pBuffer + x, length - x, &timeSeconds, &record);
+        if (n <= 0) {
+            return -1;
+        }
+        pName = "";
+        if (record.event < (int32_t) (sizeof(gpEventNames) / sizeof(gpEventNames[0]))) {
+            // Drop the indent the strings have for the RAM log
+            pName = gpEventNames[record.event] + strspn(gpEventNames[record.event], " ");
+        }
+        if (*pName != 0) {
+            printf("%d,%u,%u,%s,%d\n", batchNumber, position + x,
+                   record.timeSeconds, pName, record.value);
+        } else {
+            printf("%d,%u,%u,%d,%d\n", batchNumber, position + x,
+                   record.timeSeconds, record.event, record.value);
+        }
+        x += n;
+        numRecords++;
+    }
+
+    return numRecords;
+}
+
+// Decode a batch given in hex, printing it as CSV; returns the
+// number of records or negative on error.
+static int32_t decodeHex(const char *pHex, int32_t batchNumber)
+{
+    char binary[MAX_LINE_LENGTH / 2];
+    const uint8_t *pBuffer = (const uint8_t *) binary;
+    uint32_t position;
+    uint32_t timeSeconds;
+    int32_t segmentLength;
+    int32_t length;
+    int32_t numRecords = 0;
+    int32_t result;
+
+    length = utilitiesHexStringToBytes(pHex, strcspn(pHex, " \t\r\n"),
+                                       binary, sizeof(binary));
+    while (length > 0) {
+        if (length < FLASH_LOG_SEGMENT_HEADER_SIZE) {
+            return -1;
+        }
+        position = readUint(pBuffer, 4);
+        timeSeconds = readUint(pBuffer + 4, 4);
+        segmentLength = (int32_t) readUint(pBuffer + 8, 2);
+        pBuffer += FLASH_LOG_SEGMENT_HEADER_SIZE;
+        length -= FLASH_LOG_SEGMENT_HEADER_SIZE;
+        if (segmentLength > length) {
+            return -1;
+        }
+        if ((position >= gEndPosition) || (gEndPosition == 0)) {
+            result = decodeSegment(pBuffer, segmentLength, position,
+                                   timeSeconds, batchNumber);
+            if (result < 0) {
+                return result;
+            }
+            numRecords += result;
+            gEndPosition = position + segmentLength;
+        }
+        pBuffer += segmentLength;
+        length -= segmentLength;
+    }
+
+    return numRecords;
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    char line[MAX_LINE_LENGTH];
+    const char *pHex;
+    int32_t numBatches = 0;
+    int32_t numBad = 0;
+
+    if (argc > 1) {
+        for (int32_t x = 1; x < argc; x++) {
+            if (decodeHex(argv[x], numBatches) < 0) {
+                fprintf(stderr, "batch %d is not valid.\n", numBatches);
+                numBad++;
+            }
+            numBatches++;
+        }
+    } else {
+        while (fgets(line, sizeof(line), stdin) != NULL) {
+            pHex = line + strspn(line, " \t");
+            if ((*pHex == '\r') || (*pHex == '\n') || (*pHex == 0)) {
+                continue;
+            }
+            if (decodeHex(pHex, numBatches) < 0) {
+                fprintf(stderr, "batch %d is not valid.\n", numBatches);
+                numBad++;
+            }
+            numBatches++;
+        }
+    }
+
+    return (numBad == 0) ? 0 : 1;
+}
+
+// End Of File
@@ -0,0 +1,296 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+/* Runs the WHRE wake cycle (app_main() in main.c) repeatedly on
+ * Linux against a simulated SARA-R412M, each in a child process
+ * (see hostWakeCycleRun()), and reports, for each cycle, the
+ * simulated awake time and modem-on time, e.g.:
+ *
+ * ./whre_host -n 1000 -s scripts/sara_r412m_gprs.txt -o cycles.csv
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include "esp_sleep.h"
+#include "whre_config.h"
+#include "host_os.h"
+#include "sim_sara_r412m.h"
+#include "lwm2m_arena.h"
+#include "diag.h"
+#include "trace.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// The default number of wake cycles to run.
+#define DEFAULT_NUM_CYCLES 100
+
+// The level on CONFIG_PIN_CELLULAR_ENABLE_POWER that powers the module.
+#define CELLULAR_POWER_ACTIVE_LEVEL 1
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+// Running totals for one measured quantity.
+typedef struct {
+    int64_t minUs;
+    int64_t maxUs;
+    int64_t totalUs;
+    int32_t count;
+} Summary;
+
+// What a wake cycle measures of itself, in the child process.
+typedef struct {
+    int64_t awakeUs;
+    int64_t realUs;
+    int64_t registeredUs; // -1 if it didn't register.
+    int32_t heapAllocs;
+    int32_t arenaAllocs;
+    int32_t arenaOverflows;
+    int32_t heapFragmentation;
+    DiagStats diagStats;
+} CycleResult;
+
+// ----------------------------------------------------------------
+// EXTERNAL FUNCTIONS
+// ----------------------------------------------------------------
+
+// The application entry point, in main.c.
+void app_main();
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Add a value to a summary.
+static void summaryAdd(Summary *pSummary, int64_t valueUs)
+{
+    if ((pSummary->count == 0) || (valueUs < pSummary->minUs)) {
+        pSummary->minUs = valueUs;
+    }
+    if ((pSummary->count == 0) || (valueUs > pSummary->maxUs)) {
+        pSummary->maxUs = valueUs;
+    }
+    pSummary->totalUs += valueUs;
+    pSummary->count++;
+}
+
+// Print a summary.
+static void summaryPrint(const char *pName, const Summary *pSummary)
+{
+    if (pSummary->count > 0) {
+        fprintf(stderr, "%-16s min %10.3f ms, mean %10.3f ms, max %10.3f ms\n", pName,
+                ((double) pSummary->minUs) / 1000,
+                ((double) pSummary->totalUs) / pSummary->count / 1000,
+                ((double) pSummary->maxUs) / 1000);
+    }
+}
+
+// Real monotonic time in microseconds.
+static int64_t realTimeUs()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((int64_t) now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+}
+
+// How long the last wake cycle took from boot to registering
+// with the cellular network, -1 if it didn't register.
+static int64_t bootToRegisteredUs()
+{
+    const char *pBuf;
+    int32_t len = traceGet(&pBuf);
+    TraceSpan spans[TRACE_MAX_SPANS];
+    int32_t numSpans = traceDecode(pBuf, len, NULL, spans, TRACE_MAX_SPANS);
+
+    for (int32_t x = 0; x < numSpans; x++) {
+        if (spans[x].id == TRACE_ID_BOOT_TO_REGISTERED) {
+            return spans[x].durationUs;
+        }
+    }
+
+    return -1;
+}
+
+// Run app_main() until it sleeps, in the child process of
+// hostWakeCycleRun().
+static void wakeCycle(void *pParam)
+{
+    CycleResult *pResult = (CycleResult *) pParam;
+    Lwm2mArenaStats arenaBefore;
+    Lwm2mArenaStats arenaAfter;
+    int64_t cycleStartUs = hostTimeUs();
+    int64_t realStartUs = realTimeUs();
+
+    lwm2mArenaGetStats(&arenaBefore);
+    if (setjmp(gHostDeepSleepJmp) == 0) {
+        app_main();
+        fprintf(stderr, "HOST: warning: app_main() returned without sleeping.\n");
+    }
+    pResult->realUs = realTimeUs() - realStartUs;
+    lwm2mArenaGetStats(&arenaAfter);
+    pResult->awakeUs = hostDeepSleepStartUs();
+    pResult->awakeUs = (pResult->awakeUs >= 0) ? pResult->awakeUs - cycleStartUs :
+                                                 hostTimeUs() - cycleStartUs;
+    pResult->registeredUs = bootToRegisteredUs();
+    pResult->heapAllocs = arenaAfter.heapAllocs - arenaBefore.heapAllocs;
+    pResult->arenaAllocs = arenaAfter.arenaAllocs - arenaBefore.arenaAllocs;
+    pResult->arenaOverflows = arenaAfter.arenaOverflows - arenaBefore.arenaOverflows;
+    pResult->heapFragmentation = lwm2mArenaHeapFragmentation(&arenaAfter);
+    diagGetStats(&pResult->diagStats);
+}
+
+static void usage(const char *pName)
+{
+    fprintf(stderr, "usage: %s [-n cycles] [-s script] [-o csv_file] [-v]\n", pName);
+    fprintf(stderr, "  -n  number of wake cycles to run (default %d).\n", DEFAULT_NUM_CYCLES);
+    fprintf(stderr, "  -s  SARA-R412M simulation script (see sim_sara_r412m.h).\n");
+    fprintf(stderr, "  -o  write per-cycle results to this CSV file.\n");
+    fprintf(stderr, "  -v  let the application's printf() output through.\n");
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    int32_t numCycles = DEFAULT_NUM_CYCLES;
+    const char *pScriptFile = NULL;
+    const char *pCsvFile = NULL;
+    FILE *pCsv = NULL;
+    bool verbose = false;
+    int option;
+    Summary awake = {0};
+    Summary modemOn = {0};
+    Summary real = {0};
+    Summary registered = {0};
+    Summary console = {0};
+    SimSaraR412mStats statsBefore;
+    SimSaraR412mStats statsAfter;
+    CycleResult result = {0};
+    int64_t consoleBeforeUs;
+    int64_t runStartUs;
+    int32_t numRun = 0;
+    int32_t wakeupCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+
+    while ((option = getopt(argc, argv, "n:s:o:vh")) != -1) {
+        switch (option) {
+            case 'n':
+                numCycles = atoi(optarg);
+            break;
+            case 's':
+                pScriptFile = optarg;
+            break;
+            case 'o':
+                pCsvFile = optarg;
+            break;
+            case 'v':
+                verbose = true;
+            break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (simSaraR412mInit(pScriptFile) != 0) {
+        return 1;
+    }
+    hostSetCellularPowerPin(CONFIG_PIN_CELLULAR_ENABLE_POWER, CELLULAR_POWER_ACTIVE_LEVEL);
+
+    if (pCsvFile != NULL) {
+        pCsv = fopen(pCsvFile, "w");
+        if (pCsv == NULL) {
+            fprintf(stderr, "HOST: error: unable to open \"%s\".\n", pCsvFile);
+            return 1;
+        }
+        fprintf(pCsv, "cycle,awake_us,modem_on_us,at_commands,real_us,"
+                "heap_allocs,arena_allocs,arena_overflows,heap_fragmentation_percent,"
+                "boot_to_registered_us,lwm2m_server_us,console_us\n");
+    }
+    if (!verbose) {
+        // The application talks a lot; results go to stderr
+        if (freopen("/dev/null", "w", stdout) == NULL) {
+            fprintf(stderr, "HOST: warning: unable to silence application output.\n");
+        }
+    }
+
+    runStartUs = realTimeUs();
+    for (int32_t cycle = 0; cycle < numCycles; cycle++) {
+        simSaraR412mGetStats(&statsBefore);
+        consoleBeforeUs = hostConsoleTimeUs();
+        if (hostWakeCycleRun(wakeupCause, wakeCycle, &result, sizeof(result)) != 0) {
+            fprintf(stderr, "HOST: error: wake cycle %d failed.\n", cycle);
+            break;
+        }
+        numRun++;
+        simSaraR412mGetStats(&statsAfter);
+        summaryAdd(&awake, result.awakeUs);
+        summaryAdd(&modemOn, statsAfter.onTimeUs - statsBefore.onTimeUs);
+        summaryAdd(&real, result.realUs);
+        summaryAdd(&console, hostConsoleTimeUs() - consoleBeforeUs);
+        if (result.registeredUs >= 0) {
+            summaryAdd(&registered, result.registeredUs);
+        }
+        if (pCsv != NULL) {
+            fprintf(pCsv, "%d,%lld,%lld,%d,%lld,%d,%d,%d,%d,%lld,%lld,%lld\n", cycle, (long long) result.awakeUs,
+                    (long long) (statsAfter.onTimeUs - statsBefore.onTimeUs),
+                    statsAfter.commands - statsBefore.commands,
+                    (long long) result.realUs,
+                    result.heapAllocs, result.arenaAllocs, result.arenaOverflows,
+                    result.heapFragmentation,
+                    (long long) result.registeredUs,
+                    (long long) (statsAfter.lwm2mServerTimeUs - statsBefore.lwm2mServerTimeUs),
+                    (long long) (hostConsoleTimeUs() - consoleBeforeUs));
+        }
+        wakeupCause = ESP_SLEEP_WAKEUP_TIMER;
+    }
+
+    simSaraR412mGetStats(&statsAfter);
+    fprintf(stderr, "HOST: %d wake cycle(s) in %.3f second(s) of real time.\n",
+            numRun, ((double) (realTimeUs() - runStartUs)) / 1000000);
+    summaryPrint("awake:", &awake);
+    summaryPrint("modem on:", &modemOn);
+    summaryPrint("real per cycle:", &real);
+    summaryPrint("boot to reg:", &registered);
+    summaryPrint("console:", &console);
+    fprintf(stderr, "HOST: %d AT command(s) (%d unmatched, %d round trip(s)), %lld byte(s) to and %lld byte(s) from the module.\n",
+            statsAfter.commands, statsAfter.unmatched, statsAfter.roundTrips,
+            (long long) statsAfter.bytesToModem, (long long) statsAfter.bytesFromModem);
+    fprintf(stderr, "HOST: LWM2M server: %d DTLS handshake(s), %d registration(s), %d registration update(s), %.3f second(s) in all.\n",
+            statsAfter.lwm2mHandshakes, statsAfter.lwm2mRegistrations, statsAfter.lwm2mUpdates,
+            ((double) statsAfter.lwm2mServerTimeUs) / 1000000);
+    if (numRun > 0) {
+        // The last cycle is the steady state
+        fprintf(stderr, "HOST: last cycle: %d heap allocation(s), %d LWM2M arena allocation(s), %d arena overflow(s), heap %d%% fragmented.\n",
+                result.heapAllocs, result.arenaAllocs, result.arenaOverflows,
+                result.heapFragmentation);
+        fprintf(stderr, "HOST: last cycle: %d diagnostic line(s) deferred, %d dropped.\n",
+                result.diagStats.lines, result.diagStats.dropped);
+    }
+
+    if (pCsv != NULL) {
+        fclose(pCsv);
+    }
+    simSaraR412mDeinit();
+
+    return (numRun == numCycles) ? 0 : 1;
+}
+
+// End Of File
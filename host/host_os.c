@@ -0,0 +1,1473 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+/* Host stand-ins for FreeRTOS, ESP-IDF and the GPIO/I2C/UART
+ * helpers, sufficient to run the WHRE wake cycle on Linux.
+ *
+ * Time is simulated: vTaskDelay(), blocking queue reads and the
+ * UART advance a simulated clock instead of sleeping, so that a
+ * wake cycle which takes a minute on the target takes
+ * milliseconds here.  Tasks are POSIX threads; the simulation is
+ * only approximate where several tasks block at once.
+ *
+ * Each wake cycle runs in a child process which ends at deep sleep,
+ * taking its tasks and statics with it, as a reset of the ESP32
+ * would; only the HOST_RETAINED_ATTR statics, RTC memory and the
+ * clock, flash and module outside the ESP32, come back for the
+ * next.  So do the levels of GPIOs which are held through deep
+ * sleep; the rest float, the module losing power if its power
+ * pin is one of them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <malloc.h> // For mallinfo2()
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "esp_attr.h"
+#include "esp_system.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "esp_task_wdt.h"
+#include "esp_event_loop.h"
+#include "esp_wifi.h"
+#include "esp_spi_flash.h"
+#include "esp_partition.h"
+#include "esp_heap_caps.h"
+#include "nvs_flash.h"
+#include "driver/gpio.h"
+#include "driver/rtc_io.h"
+#include "driver/uart.h"
+#include "sys/time.h"
+#include "i2c_helper.h"
+#include "uart_helper.h"
+#include "host_os.h"
+#include "sim_sara_r412m.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// The number of GPIOs on an ESP32.
+#define NUM_GPIOS 40
+
+// The I2C bus speed to charge transactions at.
+#define I2C_BUS_SPEED_HZ 100000
+
+// The fixed cost of an I2C transaction (start, address,
+// stop and driver overhead) in microseconds.
+#define I2C_TRANSACTION_OVERHEAD_US 100
+
+// The time a Wifi scan takes per channel.
+#define WIFI_SCAN_TIME_PER_CHANNEL_MS 120
+
+// The number of Wifi channels in a scan of all channels.
+#define WIFI_NUM_CHANNELS 13
+
+// The maximum number of items in a queue.
+#define MAX_QUEUE_ITEMS 64
+
+// The maximum size of a queue item.
+#define MAX_QUEUE_ITEM_SIZE 64
+
+// The number of esp_timers that can exist at once.
+#define MAX_ESP_TIMERS 4
+
+// The flash event log partition, as in partitions.csv.
+#define EVENT_LOG_PARTITION_ADDRESS 0x190000
+#define EVENT_LOG_PARTITION_SIZE    0x40000
+
+// The size of a flash sector and the time to erase one.
+#define FLASH_SECTOR_SIZE       4096
+#define FLASH_SECTOR_ERASE_US   45000
+
+// The time to program flash: a fixed cost per write, with the
+// cache disabled, plus so much per byte.
+#define FLASH_WRITE_OVERHEAD_US 20
+#define FLASH_WRITE_NS_PER_BYTE 2500
+
+// The console UART, which printf() on the ESP32 waits on once its
+// FIFO is full, at ten bits per character.
+#define CONSOLE_BAUD_RATE          115200
+#define CONSOLE_BITS_PER_CHARACTER 10
+
+// Roughly what newlib's formatter costs on the ESP32 per call and,
+// on top of that, per floating point conversion.
+#define CONSOLE_FORMAT_US       15
+#define CONSOLE_FORMAT_FLOAT_US 60
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+// An esp_timer.
+struct HostEspTimer {
+    bool inUse;
+    esp_timer_cb_t pCallback;
+    void *pArg;
+    int64_t expiryUs; // -1 if not running
+};
+
+// A queue.
+struct HostQueue {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool isUart;
+    UBaseType_t itemSize;
+    UBaseType_t length;
+    UBaseType_t count;
+    UBaseType_t readIndex;
+    char items[MAX_QUEUE_ITEMS][MAX_QUEUE_ITEM_SIZE];
+};
+
+// An event group.
+struct HostEventGroup {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    EventBits_t bits;
+};
+
+// Parameters passed to a task thread.
+typedef struct {
+    TaskFunction_t pFunction;
+    void *pParam;
+} TaskStart;
+
+// ----------------------------------------------------------------
+// EXTERNAL VARIABLES
+// ----------------------------------------------------------------
+
+// The bounds of the HOST_RETAINED_ATTR statics, from the linker.
+extern char __start_host_retained[];
+extern char __stop_host_retained[];
+
+// ----------------------------------------------------------------
+// PUBLIC VARIABLES
+// ----------------------------------------------------------------
+
+jmp_buf gHostDeepSleepJmp;
+
+// ----------------------------------------------------------------
+// PRIVATE VARIABLES
+// ----------------------------------------------------------------
+
+static pthread_mutex_t gTimeMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t gCriticalMutex;
+static pthread_once_t gCriticalOnce = PTHREAD_ONCE_INIT;
+static pthread_cond_t gUartWriteCond = PTHREAD_COND_INITIALIZER;
+
+static HOST_RETAINED_ATTR int64_t gTimeUs = 0;
+static int64_t gCycleStartUs = 0;
+static int64_t gDeepSleepStartUs = -1;
+static int64_t gDeepSleepTimeUs = 0;
+static esp_sleep_wakeup_cause_t gWakeupCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+
+// The level on each GPIO pin, which lasts through deep sleep only
+// if the pin is held, and what the GPIO is set to output, which
+// reaches a held pin once the hold is released.
+static HOST_RETAINED_ATTR int32_t gGpioLevel[NUM_GPIOS];
+static HOST_RETAINED_ATTR bool gGpioHeld[NUM_GPIOS];
+static int32_t gGpioOutput[NUM_GPIOS];
+// Set by gpio_deep_sleep_hold_en() for the coming deep sleep only.
+static bool gGpioDeepSleepHold = false;
+// Whether the RTC peripherals, needed by a hold, stay powered
+// in deep sleep.
+static bool gRtcPeriphPowered = true;
+static int32_t gCellularPowerPin = -1;
+static int32_t gCellularPowerActiveLevel = 1;
+
+static HostI2cDevice gI2cDevice = NULL;
+static int32_t gI2cTransactionCount = 0;
+
+static QueueHandle_t gUartEventQueue = NULL;
+static uint32_t gUartBaudRate = 115200;
+
+static system_event_cb_t gEventHandler = NULL;
+static void *gEventHandlerCtx = NULL;
+static int64_t gWifiScanDoneUs = -1;
+static uint8_t gWifiScanId = 0;
+static uint8_t gWifiScanChannel = 0;
+
+// The access points the host "sees": channel, RSSI.
+static const struct {
+    uint8_t channel;
+    int8_t rssi;
+} gWifiAps[] = {{1, -71}, {1, -85}, {6, -52}, {6, -64}, {6, -90},
+                {11, -58}, {11, -77}, {11, -81}, {11, -93}, {6, -69}};
+
+static struct HostEspTimer gEspTimer[MAX_ESP_TIMERS];
+
+// The thread running the wake cycle, the only one whose console
+// output is charged for: on the target, output from tasks of lower
+// priority goes out while the wake cycle is waiting on something.
+static pthread_t gConsoleThread;
+static bool gConsoleThreadSet = false;
+static HOST_RETAINED_ATTR int64_t gConsoleTimeUs = 0;
+
+// The flash event log partition, which lasts across deep sleep.
+static const esp_partition_t gEventLogPartition = {
+    ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t) 0x40,
+    EVENT_LOG_PARTITION_ADDRESS, EVENT_LOG_PARTITION_SIZE, "eventlog", false
+};
+static HOST_RETAINED_ATTR uint8_t gEventLogFlash[EVENT_LOG_PARTITION_SIZE];
+static HOST_RETAINED_ATTR bool gEventLogFlashErased = false;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS: TIME
+// ----------------------------------------------------------------
+
+// Return when the next timed event is due, -1 if none is.
+static int64_t nextTimedEventUs()
+{
+    int64_t nextUs = gWifiScanDoneUs;
+
+    hostEnterCritical();
+    for (size_t x = 0; x < sizeof(gEspTimer) / sizeof(gEspTimer[0]); x++) {
+        if (gEspTimer[x].inUse && (gEspTimer[x].expiryUs >= 0) &&
+            ((nextUs < 0) || (gEspTimer[x].expiryUs < nextUs))) {
+            nextUs = gEspTimer[x].expiryUs;
+        }
+    }
+    hostExitCritical();
+
+    return nextUs;
+}
+
+// Anything that happens at a given simulated time.
+static void runTimedEvents()
+{
+    system_event_t event;
+    uint16_t number;
+
+    if ((gWifiScanDoneUs >= 0) && (hostTimeUs() >= gWifiScanDoneUs)) {
+        gWifiScanDoneUs = -1;
+        memset(&event, 0, sizeof(event));
+        event.event_id = SYSTEM_EVENT_SCAN_DONE;
+        event.event_info.scan_done.scan_id = gWifiScanId++;
+        esp_wifi_scan_get_ap_num(&number);
+        event.event_info.scan_done.number = (uint8_t) number;
+        hostEventPost(&event);
+    }
+
+    // Timer callbacks may restart their own timer, hence the
+    // timer is stopped before its callback is called
+    hostEnterCritical();
+    for (size_t x = 0; x < sizeof(gEspTimer) / sizeof(gEspTimer[0]); x++) {
+        if (gEspTimer[x].inUse && (gEspTimer[x].expiryUs >= 0) &&
+            (hostTimeUs() >= gEspTimer[x].expiryUs)) {
+            gEspTimer[x].expiryUs = -1;
+            gEspTimer[x].pCallback(gEspTimer[x].pArg);
+        }
+    }
+    hostExitCritical();
+}
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS: CONSOLE
+// ----------------------------------------------------------------
+
+// Charge the wake cycle for formatting and writing to the console.
+static void consoleCharge(const char *pFormat, int32_t length)
+{
+    int64_t us = 0;
+    const char *pChar = pFormat;
+
+    if (!gConsoleThreadSet || !pthread_equal(pthread_self(), gConsoleThread)) {
+        return;
+    }
+    if (pFormat != NULL) {
+        us += CONSOLE_FORMAT_US;
+        while ((pChar = strchr(pChar, '%')) != NULL) {
+            pChar++;
+            pChar += strspn(pChar, "-+ #0123456789.*hlLjzt");
+            if ((*pChar != 0) && (strchr("fFeEgGaA", *pChar) != NULL)) {
+                us += CONSOLE_FORMAT_FLOAT_US;
+            }
+        }
+    }
+    if (length > 0) {
+        us += ((int64_t) length) * CONSOLE_BITS_PER_CHARACTER * 1000000 / CONSOLE_BAUD_RATE;
+    }
+    gConsoleTimeUs += us;
+    hostTimeAdvanceUs(us);
+}
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS: GPIO
+// ----------------------------------------------------------------
+
+// Put a level on a GPIO pin, powering the module on or off if it
+// is the power pin.
+static void setGpioLevel(int32_t gpio, int32_t level)
+{
+    gGpioLevel[gpio] = level;
+    if (gpio == gCellularPowerPin) {
+        simSaraR412mSetPower(level == gCellularPowerActiveLevel);
+    }
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS: HOST
+// ----------------------------------------------------------------
+
+// Return the simulated time.
+int64_t hostTimeUs(void)
+{
+    int64_t timeUs;
+
+    pthread_mutex_lock(&gTimeMutex);
+    timeUs = gTimeUs;
+    pthread_mutex_unlock(&gTimeMutex);
+
+    return timeUs;
+}
+
+// Advance the simulated clock.
+void hostTimeAdvanceUs(int64_t us)
+{
+    if (us > 0) {
+        pthread_mutex_lock(&gTimeMutex);
+        gTimeUs += us;
+        pthread_mutex_unlock(&gTimeMutex);
+        runTimedEvents();
+    }
+}
+
+// Advance the simulated clock to a given time.
+void hostTimeAdvanceToUs(int64_t us)
+{
+    hostTimeAdvanceUs(us - hostTimeUs());
+}
+
+// Start a new wake cycle.
+void hostWakeCycleStart(int32_t wakeupCause)
+{
+    gConsoleThread = pthread_self();
+    gConsoleThreadSet = true;
+    gCycleStartUs = hostTimeUs();
+    gDeepSleepStartUs = -1;
+    gWakeupCause = (esp_sleep_wakeup_cause_t) wakeupCause;
+}
+
+// Run a wake cycle in a child process.
+int32_t hostWakeCycleRun(int32_t wakeupCause, void (*pCycle)(void *),
+                         void *pResult, size_t resultSize)
+{
+    size_t retainedSize = __stop_host_retained - __start_host_retained;
+    char *pShared;
+    pid_t pid;
+    int status = 0;
+    int32_t errorCode = -1;
+
+    pShared = mmap(NULL, retainedSize + resultSize, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (pShared == MAP_FAILED) {
+        return errorCode;
+    }
+    // Anything buffered would otherwise be written by both processes
+    fflush(NULL);
+    pid = fork();
+    if (pid == 0) {
+        hostWakeCycleStart(wakeupCause);
+        pCycle(pResult);
+        memcpy(pShared, __start_host_retained, retainedSize);
+        memcpy(pShared + retainedSize, pResult, resultSize);
+        fflush(stdout);
+        // The tasks, still blocked wherever they were, end here
+        _exit(0);
+    }
+    if ((pid > 0) && (waitpid(pid, &status, 0) == pid) &&
+        WIFEXITED(status) && (WEXITSTATUS(status) == 0)) {
+        memcpy(__start_host_retained, pShared, retainedSize);
+        memcpy(pResult, pShared + retainedSize, resultSize);
+        errorCode = 0;
+    }
+    munmap(pShared, retainedSize + resultSize);
+
+    return errorCode;
+}
+
+// Return when the current wake cycle went to sleep.
+int64_t hostDeepSleepStartUs(void)
+{
+    return gDeepSleepStartUs;
+}
+
+// Return the last requested sleep time.
+int64_t hostDeepSleepTimeUs(void)
+{
+    return gDeepSleepTimeUs;
+}
+
+// Return the simulated time spent writing to the console.
+int64_t hostConsoleTimeUs(void)
+{
+    return gConsoleTimeUs;
+}
+
+// Set the pin that powers the cellular module.
+void hostSetCellularPowerPin(int32_t pin, int32_t activeLevel)
+{
+    gCellularPowerPin = pin;
+    gCellularPowerActiveLevel = activeLevel;
+}
+
+// Simulated time of day.
+int hostGettimeofday(struct timeval *pTv, void *pTz)
+{
+    int64_t timeUs = hostTimeUs();
+
+    (void) pTz;
+    if (pTv != NULL) {
+        pTv->tv_sec = timeUs / 1000000;
+        pTv->tv_usec = timeUs % 1000000;
+    }
+
+    return 0;
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS: FREERTOS
+// ----------------------------------------------------------------
+
+static void criticalInit()
+{
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&gCriticalMutex, &attr);
+}
+
+void hostEnterCritical(void)
+{
+    pthread_once(&gCriticalOnce, criticalInit);
+    pthread_mutex_lock(&gCriticalMutex);
+}
+
+void hostExitCritical(void)
+{
+    pthread_mutex_unlock(&gCriticalMutex);
+}
+
+void vTaskDelay(const TickType_t xTicksToDelay)
+{
+    hostTimeAdvanceUs(((int64_t) xTicksToDelay) * portTICK_PERIOD_MS * 1000);
+    // Let any other tasks run
+    sched_yield();
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t) (hostTimeUs() / (portTICK_PERIOD_MS * 1000));
+}
+
+static void *taskThread(void *pParam)
+{
+    TaskStart start = *((TaskStart *) pParam);
+
+    free(pParam);
+    start.pFunction(start.pParam);
+
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t pvTaskCode,
+                                   const char * const pcName,
+                                   const uint32_t usStackDepth,
+                                   void * const pvParameters,
+                                   UBaseType_t uxPriority,
+                                   TaskHandle_t * const pvCreatedTask,
+                                   const BaseType_t xCoreID)
+{
+    pthread_t thread;
+    TaskStart *pStart = malloc(sizeof(*pStart));
+
+    (void) pcName;
+    (void) usStackDepth;
+    (void) uxPriority;
+    (void) xCoreID;
+
+    if (pStart == NULL) {
+        return pdFAIL;
+    }
+    pStart->pFunction = pvTaskCode;
+    pStart->pParam = pvParameters;
+    if (pthread_create(&thread, NULL, taskThread, pStart) != 0) {
+        free(pStart);
+        return pdFAIL;
+    }
+    pthread_detach(thread);
+    if (pvCreatedTask != NULL) {
+        *pvCreatedTask = (TaskHandle_t) thread;
+    }
+
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t xTaskToDelete)
+{
+    if (xTaskToDelete == NULL) {
+        pthread_exit(NULL);
+    }
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return (TaskHandle_t) pthread_self();
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize)
+{
+    QueueHandle_t pQueue = NULL;
+
+    if ((uxQueueLength <= MAX_QUEUE_ITEMS) && (uxItemSize <= MAX_QUEUE_ITEM_SIZE)) {
+        pQueue = calloc(1, sizeof(*pQueue));
+        if (pQueue != NULL) {
+            pthread_mutex_init(&(pQueue->mutex), NULL);
+            pthread_cond_init(&(pQueue->cond), NULL);
+            pQueue->length = uxQueueLength;
+            pQueue->itemSize = uxItemSize;
+        }
+    }
+
+    return pQueue;
+}
+
+void vQueueDelete(QueueHandle_t xQueue)
+{
+    if (xQueue != NULL) {
+        pthread_mutex_destroy(&(xQueue->mutex));
+        pthread_cond_destroy(&(xQueue->cond));
+        free(xQueue);
+    }
+}
+
+BaseType_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue,
+                      TickType_t xTicksToWait)
+{
+    BaseType_t success = pdFALSE;
+
+    (void) xTicksToWait;
+    pthread_mutex_lock(&(xQueue->mutex));
+    if (xQueue->count < xQueue->length) {
+        memcpy(xQueue->items[(xQueue->readIndex + xQueue->count) % xQueue->length],
+               pvItemToQueue, xQueue->itemSize);
+        xQueue->count++;
+        pthread_cond_signal(&(xQueue->cond));
+        success = pdTRUE;
+    }
+    pthread_mutex_unlock(&(xQueue->mutex));
+
+    return success;
+}
+
+// Receive from the UART event queue: synthesise a data event
+// when the simulated module has something to say.
+static BaseType_t uartQueueReceive(QueueHandle_t xQueue, void *pvBuffer,
+                                   TickType_t xTicksToWait)
+{
+    uart_event_t event;
+    int64_t deadlineUs = hostTimeUs() + ((int64_t) xTicksToWait) * portTICK_PERIOD_MS * 1000;
+    int64_t readyUs;
+
+    pthread_mutex_lock(&(xQueue->mutex));
+    for (;;) {
+        readyUs = simSaraR412mNextReadyUs();
+        if ((readyUs >= 0) &&
+            ((xTicksToWait == portMAX_DELAY) || (readyUs <= deadlineUs))) {
+            hostTimeAdvanceToUs(readyUs);
+            break;
+        }
+        if (xTicksToWait != portMAX_DELAY) {
+            // Nothing will arrive in time
+            hostTimeAdvanceToUs(deadlineUs);
+            pthread_mutex_unlock(&(xQueue->mutex));
+            return pdFALSE;
+        }
+        // Wait for the ESP32 to send something
+        pthread_cond_wait(&gUartWriteCond, &(xQueue->mutex));
+    }
+    pthread_mutex_unlock(&(xQueue->mutex));
+
+    memset(&event, 0, sizeof(event));
+    event.type = UART_DATA;
+    event.size = simSaraR412mAvailable();
+    memcpy(pvBuffer, &event, xQueue->itemSize < sizeof(event) ? xQueue->itemSize : sizeof(event));
+
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer,
+                         TickType_t xTicksToWait)
+{
+    BaseType_t success = pdFALSE;
+    struct timespec until;
+
+    if (xQueue->isUart) {
+        return uartQueueReceive(xQueue, pvBuffer, xTicksToWait);
+    }
+
+    pthread_mutex_lock(&(xQueue->mutex));
+    if ((xQueue->count == 0) && (xTicksToWait > 0)) {
+        // Give other tasks a (real) moment to send something
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_nsec += 1000000;
+        if (until.tv_nsec >= 1000000000) {
+            until.tv_sec++;
+            until.tv_nsec -= 1000000000;
+        }
+        pthread_cond_timedwait(&(xQueue->cond), &(xQueue->mutex), &until);
+    }
+    if (xQueue->count > 0) {
+        memcpy(pvBuffer, xQueue->items[xQueue->readIndex], xQueue->itemSize);
+        xQueue->readIndex = (xQueue->readIndex + 1) % xQueue->length;
+        xQueue->count--;
+        success = pdTRUE;
+    }
+    pthread_mutex_unlock(&(xQueue->mutex));
+
+    if (!success && (xTicksToWait != portMAX_DELAY)) {
+        hostTimeAdvanceUs(((int64_t) xTicksToWait) * portTICK_PERIOD_MS * 1000);
+    }
+
+    return success;
+}
+
+BaseType_t xQueueReset(QueueHandle_t xQueue)
+{
+    pthread_mutex_lock(&(xQueue->mutex));
+    xQueue->count = 0;
+    xQueue->readIndex = 0;
+    pthread_mutex_unlock(&(xQueue->mutex));
+
+    return pdPASS;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    SemaphoreHandle_t xSemaphore = xQueueCreate(1, 1);
+    char token = 0;
+
+    if (xSemaphore != NULL) {
+        xQueueSend(xSemaphore, &token, 0);
+    }
+
+    return xSemaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return xQueueCreate(1, 1);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xBlockTime)
+{
+    char token;
+
+    return xQueueReceive(xSemaphore, &token, xBlockTime);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore)
+{
+    char token = 0;
+
+    return xQueueSend(xSemaphore, &token, 0);
+}
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    EventGroupHandle_t xEventGroup = calloc(1, sizeof(*xEventGroup));
+
+    if (xEventGroup != NULL) {
+        pthread_mutex_init(&(xEventGroup->mutex), NULL);
+        pthread_cond_init(&(xEventGroup->cond), NULL);
+    }
+
+    return xEventGroup;
+}
+
+void vEventGroupDelete(EventGroupHandle_t xEventGroup)
+{
+    if (xEventGroup != NULL) {
+        pthread_mutex_destroy(&(xEventGroup->mutex));
+        pthread_cond_destroy(&(xEventGroup->cond));
+        free(xEventGroup);
+    }
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t xEventGroup,
+                               const EventBits_t uxBitsToSet)
+{
+    EventBits_t bits;
+
+    pthread_mutex_lock(&(xEventGroup->mutex));
+    xEventGroup->bits |= uxBitsToSet;
+    bits = xEventGroup->bits;
+    pthread_cond_broadcast(&(xEventGroup->cond));
+    pthread_mutex_unlock(&(xEventGroup->mutex));
+
+    return bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t xEventGroup,
+                                 const EventBits_t uxBitsToClear)
+{
+    EventBits_t bits;
+
+    pthread_mutex_lock(&(xEventGroup->mutex));
+    bits = xEventGroup->bits;
+    xEventGroup->bits &= ~uxBitsToClear;
+    pthread_mutex_unlock(&(xEventGroup->mutex));
+
+    return bits;
+}
+
+// Determine if the bits being waited for are there.
+static bool eventBitsSatisfied(EventBits_t bits, EventBits_t uxBitsToWaitFor,
+                               BaseType_t xWaitForAllBits)
+{
+    if (xWaitForAllBits) {
+        return (bits & uxBitsToWaitFor) == uxBitsToWaitFor;
+    }
+
+    return (bits & uxBitsToWaitFor) != 0;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t xEventGroup,
+                                const EventBits_t uxBitsToWaitFor,
+                                const BaseType_t xClearOnExit,
+                                const BaseType_t xWaitForAllBits,
+                                TickType_t xTicksToWait)
+{
+    int64_t deadlineUs = hostTimeUs() + ((int64_t) xTicksToWait) * portTICK_PERIOD_MS * 1000;
+    int64_t readyUs;
+    int64_t eventUs;
+    EventBits_t bits;
+    struct timespec until;
+
+    pthread_mutex_lock(&(xEventGroup->mutex));
+    while (!eventBitsSatisfied(xEventGroup->bits, uxBitsToWaitFor, xWaitForAllBits)) {
+        readyUs = simSaraR412mNextReadyUs();
+        eventUs = nextTimedEventUs();
+        if ((eventUs >= 0) && ((readyUs < 0) || (eventUs < readyUs))) {
+            readyUs = eventUs;
+        }
+        if ((readyUs < 0) ||
+            ((xTicksToWait != portMAX_DELAY) && (readyUs > deadlineUs))) {
+            // Nothing is coming in time
+            if (xTicksToWait != portMAX_DELAY) {
+                // Timed events may set bits in this group
+                pthread_mutex_unlock(&(xEventGroup->mutex));
+                hostTimeAdvanceToUs(deadlineUs);
+                pthread_mutex_lock(&(xEventGroup->mutex));
+                break;
+            }
+        }
+        // Give the AT client task a (real) moment to deal with
+        // what the modem is sending, which moves the clock on
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_nsec += 1000000;
+        if (until.tv_nsec >= 1000000000) {
+            until.tv_sec++;
+            until.tv_nsec -= 1000000000;
+        }
+        if ((pthread_cond_timedwait(&(xEventGroup->cond), &(xEventGroup->mutex), &until) != 0) &&
+            (readyUs >= 0) && (readyUs > hostTimeUs())) {
+            // Nothing else has got to it; don't stall
+            pthread_mutex_unlock(&(xEventGroup->mutex));
+            hostTimeAdvanceToUs(readyUs);
+            pthread_mutex_lock(&(xEventGroup->mutex));
+        }
+    }
+    bits = xEventGroup->bits;
+    if (xClearOnExit && eventBitsSatisfied(bits, uxBitsToWaitFor, xWaitForAllBits)) {
+        xEventGroup->bits &= ~uxBitsToWaitFor;
+    }
+    pthread_mutex_unlock(&(xEventGroup->mutex));
+
+    return bits;
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS: ESP-IDF SYSTEM
+// ----------------------------------------------------------------
+
+void esp_chip_info(esp_chip_info_t *out_info)
+{
+    memset(out_info, 0, sizeof(*out_info));
+    out_info->model = CHIP_ESP32;
+    out_info->cores = 2;
+    out_info->features = CHIP_FEATURE_WIFI_BGN | CHIP_FEATURE_BT | CHIP_FEATURE_BLE;
+}
+
+void esp_restart(void)
+{
+    esp_deep_sleep_start();
+}
+
+size_t spi_flash_get_chip_size(void)
+{
+    return 2 * 1024 * 1024;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype,
+                                                const char *label)
+{
+    if ((type != gEventLogPartition.type) ||
+        ((subtype != gEventLogPartition.subtype) && (subtype != ESP_PARTITION_SUBTYPE_ANY)) ||
+        ((label != NULL) && (strcmp(label, gEventLogPartition.label) != 0))) {
+        return NULL;
+    }
+    if (!gEventLogFlashErased) {
+        // Fresh from the factory
+        memset(gEventLogFlash, 0xff, sizeof(gEventLogFlash));
+        gEventLogFlashErased = true;
+    }
+
+    return &gEventLogPartition;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition,
+                             size_t src_offset, void *dst, size_t size)
+{
+    if ((partition != &gEventLogPartition) || (src_offset + size > partition->size)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(dst, gEventLogFlash + src_offset, size);
+
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *partition,
+                              size_t dst_offset, const void *src, size_t size)
+{
+    if ((partition != &gEventLogPartition) || (dst_offset + size > partition->size)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // Programming flash can only clear bits
+    for (size_t x = 0; x < size; x++) {
+        gEventLogFlash[dst_offset + x] &= ((const uint8_t *) src)[x];
+    }
+    hostTimeAdvanceUs(FLASH_WRITE_OVERHEAD_US + (size * FLASH_WRITE_NS_PER_BYTE) / 1000);
+
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition,
+                                    size_t start_addr, size_t size)
+{
+    if ((partition != &gEventLogPartition) || (start_addr + size > partition->size) ||
+        (start_addr % FLASH_SECTOR_SIZE != 0) || (size % FLASH_SECTOR_SIZE != 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(gEventLogFlash + start_addr, 0xff, size);
+    hostTimeAdvanceUs((size / FLASH_SECTOR_SIZE) * FLASH_SECTOR_ERASE_US);
+
+    return ESP_OK;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    (void) caps;
+    return mallinfo2().fordblks;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    struct mallinfo2 info = mallinfo2();
+
+    (void) caps;
+    return (info.keepcost < info.fordblks) ? info.keepcost : info.fordblks;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return hostTimeUs() - gCycleStartUs;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args,
+                           esp_timer_handle_t *out_handle)
+{
+    esp_err_t err = ESP_ERR_NO_MEM;
+
+    hostEnterCritical();
+    for (size_t x = 0; (x < sizeof(gEspTimer) / sizeof(gEspTimer[0])) &&
+                       (err != ESP_OK); x++) {
+        if (!gEspTimer[x].inUse) {
+            gEspTimer[x].inUse = true;
+            gEspTimer[x].pCallback = create_args->callback;
+            gEspTimer[x].pArg = create_args->arg;
+            gEspTimer[x].expiryUs = -1;
+            *out_handle = &gEspTimer[x];
+            err = ESP_OK;
+        }
+    }
+    hostExitCritical();
+
+    return err;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    esp_err_t err = ESP_ERR_INVALID_STATE;
+
+    hostEnterCritical();
+    if (timer->expiryUs < 0) {
+        timer->expiryUs = hostTimeUs() + (int64_t) timeout_us;
+        err = ESP_OK;
+    }
+    hostExitCritical();
+
+    return err;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    esp_err_t err = ESP_ERR_INVALID_STATE;
+
+    hostEnterCritical();
+    if (timer->expiryUs >= 0) {
+        timer->expiryUs = -1;
+        err = ESP_OK;
+    }
+    hostExitCritical();
+
+    return err;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    hostEnterCritical();
+    timer->inUse = false;
+    timer->expiryUs = -1;
+    hostExitCritical();
+
+    return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_reset(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_init(void)
+{
+    return ESP_OK;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void)
+{
+    return gWakeupCause;
+}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us)
+{
+    gDeepSleepTimeUs = (int64_t) time_in_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_ext1_wakeup(uint64_t mask, esp_sleep_ext1_wakeup_mode_t mode)
+{
+    (void) mask;
+    (void) mode;
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_pd_config(esp_sleep_pd_domain_t domain, esp_sleep_pd_option_t option)
+{
+    if (domain == ESP_PD_DOMAIN_RTC_PERIPH) {
+        gRtcPeriphPowered = (option != ESP_PD_OPTION_OFF);
+    }
+    return ESP_OK;
+}
+
+void esp_deep_sleep_start(void)
+{
+    gDeepSleepStartUs = hostTimeUs();
+    // Pins not held float; the module stays in whatever state
+    // that leaves it in
+    for (int32_t x = 0; x < NUM_GPIOS; x++) {
+        if (!gGpioHeld[x] || !gGpioDeepSleepHold || !gRtcPeriphPowered) {
+            gGpioHeld[x] = false;
+            setGpioLevel(x, (x == gCellularPowerPin) ? !gCellularPowerActiveLevel : 0);
+        }
+    }
+    hostTimeAdvanceUs(gDeepSleepTimeUs);
+    longjmp(gHostDeepSleepJmp, 1);
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS: EVENTS AND WIFI
+// ----------------------------------------------------------------
+
+esp_err_t esp_event_loop_init(system_event_cb_t cb, void *ctx)
+{
+    gEventHandler = cb;
+    gEventHandlerCtx = ctx;
+    return ESP_OK;
+}
+
+esp_err_t hostEventPost(system_event_t *event)
+{
+    esp_err_t espError = ESP_OK;
+
+    if (gEventHandler != NULL) {
+        espError = gEventHandler(gEventHandlerCtx, event);
+    }
+
+    return espError;
+}
+
+void tcpip_adapter_init(void)
+{
+}
+
+esp_err_t esp_wifi_init(const wifi_init_config_t *config)
+{
+    (void) config;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_deinit(void)
+{
+    gWifiScanDoneUs = -1;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_mode(wifi_mode_t mode)
+{
+    (void) mode;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_start(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_stop(void)
+{
+    gWifiScanDoneUs = -1;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_scan_start(const wifi_scan_config_t *config, bool block)
+{
+    int64_t timeUs = ((int64_t) WIFI_SCAN_TIME_PER_CHANNEL_MS) * 1000;
+
+    gWifiScanChannel = (config != NULL) ? config->channel : 0;
+    if (gWifiScanChannel == 0) {
+        timeUs *= WIFI_NUM_CHANNELS;
+    }
+    if (block) {
+        hostTimeAdvanceUs(timeUs);
+    } else {
+        gWifiScanDoneUs = hostTimeUs() + timeUs;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_scan_stop(void)
+{
+    gWifiScanDoneUs = -1;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_scan_get_ap_num(uint16_t *number)
+{
+    uint16_t count = 0;
+
+    for (size_t x = 0; x < sizeof(gWifiAps) / sizeof(gWifiAps[0]); x++) {
+        if ((gWifiScanChannel == 0) || (gWifiAps[x].channel == gWifiScanChannel)) {
+            count++;
+        }
+    }
+    *number = count;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_scan_get_ap_records(uint16_t *number, wifi_ap_record_t *ap_records)
+{
+    uint16_t count = 0;
+
+    for (size_t x = 0; (x < sizeof(gWifiAps) / sizeof(gWifiAps[0])) && (count < *number); x++) {
+        if ((gWifiScanChannel == 0) || (gWifiAps[x].channel == gWifiScanChannel)) {
+            memset(&(ap_records[count]), 0, sizeof(ap_records[count]));
+            ap_records[count].bssid[0] = 0x02; // Locally administered
+            ap_records[count].bssid[5] = (uint8_t) x;
+            snprintf((char *) ap_records[count].ssid, sizeof(ap_records[count].ssid),
+                     "host-ap-%d", (int) x);
+            ap_records[count].primary = gWifiAps[x].channel;
+            ap_records[count].rssi = gWifiAps[x].rssi;
+            ap_records[count].authmode = WIFI_AUTH_WPA2_PSK;
+            ap_records[count].pairwise_cipher = WIFI_CIPHER_TYPE_CCMP;
+            ap_records[count].group_cipher = WIFI_CIPHER_TYPE_CCMP;
+            count++;
+        }
+    }
+    *number = count;
+    return ESP_OK;
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS: GPIO
+// ----------------------------------------------------------------
+
+esp_err_t gpio_config(const gpio_config_t *pGPIOConfig)
+{
+    (void) pGPIOConfig;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    if ((gpio_num < 0) || (gpio_num >= NUM_GPIOS)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    gGpioOutput[gpio_num] = (level != 0);
+    if (!gGpioHeld[gpio_num]) {
+        setGpioLevel(gpio_num, gGpioOutput[gpio_num]);
+    }
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num)
+{
+    if ((gpio_num < 0) || (gpio_num >= NUM_GPIOS)) {
+        return 0;
+    }
+    return gGpioLevel[gpio_num];
+}
+
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode)
+{
+    (void) gpio_num;
+    (void) mode;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_pull_mode(gpio_num_t gpio_num, gpio_pull_mode_t pull)
+{
+    (void) gpio_num;
+    (void) pull;
+    return ESP_OK;
+}
+
+esp_err_t gpio_pullup_dis(gpio_num_t gpio_num)
+{
+    (void) gpio_num;
+    return ESP_OK;
+}
+
+esp_err_t gpio_pulldown_dis(gpio_num_t gpio_num)
+{
+    (void) gpio_num;
+    return ESP_OK;
+}
+
+esp_err_t gpio_hold_en(gpio_num_t gpio_num)
+{
+    if ((gpio_num < 0) || (gpio_num >= NUM_GPIOS)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    gGpioHeld[gpio_num] = true;
+    return ESP_OK;
+}
+
+esp_err_t gpio_hold_dis(gpio_num_t gpio_num)
+{
+    if ((gpio_num < 0) || (gpio_num >= NUM_GPIOS)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (gGpioHeld[gpio_num]) {
+        gGpioHeld[gpio_num] = false;
+        setGpioLevel(gpio_num, gGpioOutput[gpio_num]);
+    }
+    return ESP_OK;
+}
+
+void gpio_deep_sleep_hold_en(void)
+{
+    gGpioDeepSleepHold = true;
+}
+
+void gpio_deep_sleep_hold_dis(void)
+{
+    gGpioDeepSleepHold = false;
+}
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags)
+{
+    (void) intr_alloc_flags;
+    return ESP_OK;
+}
+
+esp_err_t rtc_gpio_init(gpio_num_t gpio_num)
+{
+    (void) gpio_num;
+    return ESP_OK;
+}
+
+esp_err_t rtc_gpio_set_direction(gpio_num_t gpio_num, rtc_gpio_mode_t mode)
+{
+    (void) gpio_num;
+    (void) mode;
+    return ESP_OK;
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS: I2C HELPER
+// ----------------------------------------------------------------
+
+int32_t i2cInit(int32_t i2cPort, int32_t pinSda, int32_t pinScl)
+{
+    (void) i2cPort;
+    (void) pinSda;
+    (void) pinScl;
+    return 0;
+}
+
+void i2cDeinit(int32_t i2cPort)
+{
+    (void) i2cPort;
+}
+
+int32_t i2cSendReceive(int32_t i2cPort, char i2cAddress,
+                       const char *pSend, uint32_t bytesToSend,
+                       char *pReceive, uint32_t bytesToReceive)
+{
+    int32_t bytesReceived = 0;
+    uint32_t bits;
+
+    (void) i2cPort;
+    gI2cTransactionCount++;
+
+    // One address byte for each direction used, 9 bits per byte
+    bits = (bytesToSend + bytesToReceive + ((pSend != NULL) ? 1 : 0) +
+            ((pReceive != NULL) ? 1 : 0)) * 9;
+    hostTimeAdvanceUs(I2C_TRANSACTION_OVERHEAD_US +
+                      (((int64_t) bits) * 1000000) / I2C_BUS_SPEED_HZ);
+
+    if (pReceive != NULL) {
+        if (gI2cDevice != NULL) {
+            bytesReceived = gI2cDevice(i2cAddress, pSend, bytesToSend,
+                                       pReceive, bytesToReceive);
+        } else {
+            memset(pReceive, 0, bytesToReceive);
+            bytesReceived = (int32_t) bytesToReceive;
+        }
+    }
+
+    return bytesReceived;
+}
+
+void hostI2cSetDevice(HostI2cDevice device)
+{
+    gI2cDevice = device;
+}
+
+int32_t hostI2cTransactionCount(void)
+{
+    return gI2cTransactionCount;
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS: UART
+// ----------------------------------------------------------------
+
+int32_t uartInit(int32_t uart, int32_t pinTxd, int32_t pinRxd,
+                 int32_t baudRate, bool flowControl,
+                 QueueHandle_t *pUartEventQueue)
+{
+    (void) uart;
+    (void) pinTxd;
+    (void) pinRxd;
+    (void) flowControl;
+
+    if (gUartEventQueue == NULL) {
+        gUartEventQueue = xQueueCreate(20, sizeof(uart_event_t));
+        if (gUartEventQueue == NULL) {
+            return -1;
+        }
+        gUartEventQueue->isUart = true;
+    }
+    gUartBaudRate = baudRate;
+    simSaraR412mSetHostBaudRate(baudRate);
+    if (pUartEventQueue != NULL) {
+        *pUartEventQueue = gUartEventQueue;
+    }
+
+    return 0;
+}
+
+void uartDeinit(int32_t uart)
+{
+    (void) uart;
+}
+
+int uart_write_bytes(uart_port_t uart_num, const char *src, size_t size)
+{
+    (void) uart_num;
+    simSaraR412mWrite(src, size);
+    if (gUartEventQueue != NULL) {
+        pthread_mutex_lock(&(gUartEventQueue->mutex));
+        pthread_cond_broadcast(&gUartWriteCond);
+        pthread_mutex_unlock(&(gUartEventQueue->mutex));
+    }
+
+    return (int) size;
+}
+
+int uart_read_bytes(uart_port_t uart_num, uint8_t *buf, uint32_t length,
+                    TickType_t ticks_to_wait)
+{
+    int64_t readyUs;
+    int64_t deadlineUs = hostTimeUs() + ((int64_t) ticks_to_wait) * portTICK_PERIOD_MS * 1000;
+
+    (void) uart_num;
+    if (simSaraR412mAvailable() == 0) {
+        readyUs = simSaraR412mNextReadyUs();
+        if ((readyUs >= 0) && (readyUs <= deadlineUs)) {
+            hostTimeAdvanceToUs(readyUs);
+        } else {
+            hostTimeAdvanceToUs(deadlineUs);
+        }
+    }
+
+    return (int) simSaraR412mRead((char *) buf, length);
+}
+
+esp_err_t uart_get_buffered_data_len(uart_port_t uart_num, size_t *size)
+{
+    (void) uart_num;
+    *size = simSaraR412mAvailable();
+    return ESP_OK;
+}
+
+esp_err_t uart_flush(uart_port_t uart_num)
+{
+    char discard[64];
+
+    (void) uart_num;
+    while (simSaraR412mRead(discard, sizeof(discard)) > 0) {}
+    return ESP_OK;
+}
+
+esp_err_t uart_flush_input(uart_port_t uart_num)
+{
+    return uart_flush(uart_num);
+}
+
+esp_err_t uart_wait_tx_done(uart_port_t uart_num, TickType_t ticks_to_wait)
+{
+    (void) uart_num;
+    (void) ticks_to_wait;
+    return ESP_OK;
+}
+
+esp_err_t uart_set_baudrate(uart_port_t uart_num, uint32_t baudrate)
+{
+    (void) uart_num;
+    gUartBaudRate = baudrate;
+    simSaraR412mSetHostBaudRate((int32_t) baudrate);
+    return ESP_OK;
+}
+
+esp_err_t uart_get_baudrate(uart_port_t uart_num, uint32_t *baudrate)
+{
+    (void) uart_num;
+    *baudrate = gUartBaudRate;
+    return ESP_OK;
+}
+
+esp_err_t uart_set_hw_flow_ctrl(uart_port_t uart_num, uart_hw_flowcontrol_t flow_ctrl,
+                                uint8_t rx_thresh)
+{
+    (void) uart_num;
+    (void) flow_ctrl;
+    (void) rx_thresh;
+    return ESP_OK;
+}
+
+esp_err_t uart_set_pin(uart_port_t uart_num, int tx_io_num, int rx_io_num,
+                       int rts_io_num, int cts_io_num)
+{
+    (void) uart_num;
+    (void) tx_io_num;
+    (void) rx_io_num;
+    (void) rts_io_num;
+    (void) cts_io_num;
+    return ESP_OK;
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS: CONSOLE WRAPPERS
+// ----------------------------------------------------------------
+
+// The application's console output, wrapped at link time (see
+// CONSOLE_LDFLAGS in the Makefile) so that it takes simulated time.
+int __real_vprintf(const char *format, va_list ap);
+int __real_puts(const char *s);
+int __real_putchar(int c);
+
+int __wrap_vprintf(const char *format, va_list ap)
+{
+    int length = __real_vprintf(format, ap);
+
+    consoleCharge(format, length);
+
+    return length;
+}
+
+int __wrap_printf(const char *format, ...)
+{
+    va_list ap;
+    int length;
+
+    va_start(ap, format);
+    length = __wrap_vprintf(format, ap);
+    va_end(ap);
+
+    return length;
+}
+
+int __wrap_puts(const char *s)
+{
+    int result = __real_puts(s);
+
+    consoleCharge("", strlen(s) + 1);
+
+    return result;
+}
+
+int __wrap_putchar(int c)
+{
+    int result = __real_putchar(c);
+
+    consoleCharge(NULL, 1);
+
+    return result;
+}
+
+// End Of File
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _HOST_OS_H_
+#define _HOST_OS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <setjmp.h>
+
+// ----------------------------------------------------------------
+// VARIABLES
+// ----------------------------------------------------------------
+
+/** Where esp_deep_sleep_start() jumps back to; set by the
+ * function given to hostWakeCycleRun() before it calls app_main().
+ */
+extern jmp_buf gHostDeepSleepJmp;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Return the simulated time since the start of the run in
+ * microseconds.  Unlike esp_timer_get_time() this is not reset
+ * at each wake.
+ */
+int64_t hostTimeUs(void);
+
+/** Advance the simulated clock by the given number of microseconds.
+ *
+ * @param us the number of microseconds to advance by.
+ */
+void hostTimeAdvanceUs(int64_t us);
+
+/** Advance the simulated clock to the given time, if that is in
+ * the future.
+ *
+ * @param us the time to advance to, as returned by hostTimeUs().
+ */
+void hostTimeAdvanceToUs(int64_t us);
+
+/** Start a new wake cycle: esp_timer_get_time() restarts from zero
+ * and esp_sleep_get_wakeup_cause() returns the given cause.  This
+ * is called by hostWakeCycleRun().
+ *
+ * @param wakeupCause the esp_sleep_wakeup_cause_t to report.
+ */
+void hostWakeCycleStart(int32_t wakeupCause);
+
+/** Run a wake cycle in a child process, which starts with the
+ * statics as they were before the first cycle, apart from those
+ * marked HOST_RETAINED_ATTR (see esp_attr.h), and ends, along with
+ * any tasks, when pCycle() returns; only the HOST_RETAINED_ATTR
+ * statics and the result come back.
+ *
+ * @param wakeupCause the esp_sleep_wakeup_cause_t to report.
+ * @param pCycle      the wake cycle, which should setjmp() on
+ *                    gHostDeepSleepJmp and call app_main().
+ * @param pResult     passed to pCycle(), for it to fill in.
+ * @param resultSize  the size of what is at pResult.
+ * @return            zero on success, else negative error code,
+ *                    e.g. if the child process crashed.
+ */
+int32_t hostWakeCycleRun(int32_t wakeupCause, void (*pCycle)(void *),
+                         void *pResult, size_t resultSize);
+
+/** Return the simulated time at which the current wake cycle
+ * called esp_deep_sleep_start(), or -1 if it has not.
+ */
+int64_t hostDeepSleepStartUs(void);
+
+/** Return the timer wake-up period requested for the last deep
+ * sleep, in microseconds.
+ */
+int64_t hostDeepSleepTimeUs(void);
+
+/** Return the simulated time the wake cycles have spent
+ * formatting and writing to the console, so far.
+ */
+int64_t hostConsoleTimeUs(void);
+
+/** Tell the host GPIO stand-in which pin switches the power to
+ * the cellular module so that the simulated SARA-R412M follows it.
+ *
+ * @param pin          the pin.
+ * @param activeLevel  the level at which power is applied.
+ */
+void hostSetCellularPowerPin(int32_t pin, int32_t activeLevel);
+
+#endif // _HOST_OS_H_
+
+// End Of File
@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+
+#ifndef _HOST_ESP_ATTR_H_
+#define _HOST_ESP_ATTR_H_
+
+// Each wake cycle on the host runs in a child process, see
+// hostWakeCycleRun(), and only the statics in this section are
+// carried over to the next: RTC memory, kept powered through deep
+// sleep, and, in host/, whatever is outside the ESP32.
+#define HOST_RETAINED_ATTR __attribute__((section("host_retained")))
+
+#define RTC_DATA_ATTR HOST_RETAINED_ATTR
+#define RTC_SLOW_ATTR HOST_RETAINED_ATTR
+#define RTC_FAST_ATTR HOST_RETAINED_ATTR
+#define RTC_NOINIT_ATTR HOST_RETAINED_ATTR
+#define IRAM_ATTR
+#define DRAM_ATTR
+
+#endif // _HOST_ESP_ATTR_H_
+
+// End Of File
@@ -0,0 +1,27 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+
+#ifndef _HOST_ESP_EVENT_LOOP_H_
+#define _HOST_ESP_EVENT_LOOP_H_
+
+#include "esp_event.h"
+
+esp_err_t esp_event_loop_init(system_event_cb_t cb, void *ctx);
+
+/** Included here, as in ESP-IDF 3.1, since callers of
+ * esp_event_loop_init() also call tcpip_adapter_init().
+ */
+void tcpip_adapter_init(void);
+
+#endif // _HOST_ESP_EVENT_LOOP_H_
+
+// End Of File
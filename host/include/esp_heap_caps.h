@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+
+#ifndef _HOST_ESP_HEAP_CAPS_H_
+#define _HOST_ESP_HEAP_CAPS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+
+/** Return the free bytes in the host C library heap.
+ */
+size_t heap_caps_get_free_size(uint32_t caps);
+
+/** Return an approximation of the largest free block in the
+ * host C library heap: glibc only reports the size of the
+ * free chunk at the top of the heap, which is used instead.
+ */
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+
+#endif // _HOST_ESP_HEAP_CAPS_H_
+
+// End Of File
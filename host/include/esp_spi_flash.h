@@ -0,0 +1,22 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+
+#ifndef _HOST_ESP_SPI_FLASH_H_
+#define _HOST_ESP_SPI_FLASH_H_
+
+#include <stddef.h>
+
+size_t spi_flash_get_chip_size(void);
+
+#endif // _HOST_ESP_SPI_FLASH_H_
+
+// End Of File
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+
+#ifndef _HOST_ESP_SYSTEM_H_
+#define _HOST_ESP_SYSTEM_H_
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_sleep.h"
+
+#define CHIP_FEATURE_EMB_FLASH      (1 << 0)
+#define CHIP_FEATURE_WIFI_BGN       (1 << 1)
+#define CHIP_FEATURE_BLE            (1 << 4)
+#define CHIP_FEATURE_BT             (1 << 5)
+
+typedef enum {
+    CHIP_ESP32 = 1
+} esp_chip_model_t;
+
+typedef struct {
+    esp_chip_model_t model;
+    uint32_t features;
+    uint8_t cores;
+    uint8_t revision;
+} esp_chip_info_t;
+
+void esp_chip_info(esp_chip_info_t *out_info);
+void esp_restart(void);
+
+#endif // _HOST_ESP_SYSTEM_H_
+
+// End Of File
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+
+#ifndef _HOST_ESP_TIMER_H_
+#define _HOST_ESP_TIMER_H_
+
+#include <stdint.h>
+#include "esp_err.h"
+
+/** Timer callback.
+ */
+typedef void (*esp_timer_cb_t)(void *arg);
+
+/** How the callback is dispatched; on the host it is always
+ * called from whichever task advances the simulated clock.
+ */
+typedef enum {
+    ESP_TIMER_TASK
+} esp_timer_dispatch_t;
+
+/** Timer creation arguments.
+ */
+typedef struct {
+    esp_timer_cb_t callback;
+    void *arg;
+    esp_timer_dispatch_t dispatch_method;
+    const char *name;
+} esp_timer_create_args_t;
+
+/** Timer handle.
+ */
+typedef struct HostEspTimer *esp_timer_handle_t;
+
+/** Return the simulated time in microseconds since the
+ * start of the current wake cycle.
+ */
+int64_t esp_timer_get_time(void);
+
+/** Create a timer; the host supports a handful at once.
+ */
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args,
+                           esp_timer_handle_t *out_handle);
+
+/** Start a one-shot timer, expiring in simulated time.
+ */
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us);
+
+/** Stop a timer.
+ */
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+
+/** Delete a timer.
+ */
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+
+#endif // _HOST_ESP_TIMER_H_
+
+// End Of File
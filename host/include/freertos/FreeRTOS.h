@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _HOST_FREERTOS_H_
+#define _HOST_FREERTOS_H_
+
+/* Host stand-in for the subset of FreeRTOS used by the WHRE
+ * application.  Time is simulated (see host_os.c): blocking
+ * calls advance the simulated clock rather than sleeping.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+#define configTICK_RATE_HZ      100
+#define portTICK_PERIOD_MS      (1000 / configTICK_RATE_HZ)
+#define portTICK_RATE_MS        portTICK_PERIOD_MS
+#define portMAX_DELAY           ((TickType_t) 0xFFFFFFFFUL)
+#define pdMS_TO_TICKS(x)        ((TickType_t) ((x) / portTICK_PERIOD_MS))
+
+#define pdFALSE                 ((BaseType_t) 0)
+#define pdTRUE                  ((BaseType_t) 1)
+#define pdPASS                  pdTRUE
+#define pdFAIL                  pdFALSE
+
+#define tskNO_AFFINITY          0x7FFFFFFF
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(x)   do {(void) (x); hostEnterCritical();} while (0)
+#define portEXIT_CRITICAL(x)    do {(void) (x); hostExitCritical();} while (0)
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t TickType_t;
+
+typedef struct {
+    int unused;
+} portMUX_TYPE;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Enter the single global critical section of the host build.
+ */
+void hostEnterCritical(void);
+
+/** Leave the single global critical section of the host build.
+ */
+void hostExitCritical(void);
+
+#endif // _HOST_FREERTOS_H_
+
+// End Of File
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _HOST_EVENT_GROUPS_H_
+#define _HOST_EVENT_GROUPS_H_
+
+#include "freertos/FreeRTOS.h"
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+typedef struct HostEventGroup *EventGroupHandle_t;
+typedef TickType_t EventBits_t;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Create an event group.
+ */
+EventGroupHandle_t xEventGroupCreate(void);
+
+/** Delete an event group.
+ */
+void vEventGroupDelete(EventGroupHandle_t xEventGroup);
+
+/** Set bits in an event group, waking any waiters.
+ */
+EventBits_t xEventGroupSetBits(EventGroupHandle_t xEventGroup,
+                               const EventBits_t uxBitsToSet);
+
+/** Clear bits in an event group, returning the bits as they
+ * were before.
+ */
+EventBits_t xEventGroupClearBits(EventGroupHandle_t xEventGroup,
+                                 const EventBits_t uxBitsToClear);
+
+/** Wait for bits in an event group.  While the simulated modem
+ * has something to send before the timeout the wait gives the
+ * AT client task the chance to deal with it; otherwise the
+ * simulated clock is advanced by the timeout.
+ */
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t xEventGroup,
+                                const EventBits_t uxBitsToWaitFor,
+                                const BaseType_t xClearOnExit,
+                                const BaseType_t xWaitForAllBits,
+                                TickType_t xTicksToWait);
+
+#define xEventGroupGetBits(x) xEventGroupClearBits(x, 0)
+#define xEventGroupSetBitsFromISR(x, b, p) xEventGroupSetBits(x, b)
+
+#endif // _HOST_EVENT_GROUPS_H_
+
+// End Of File
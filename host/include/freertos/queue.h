@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _HOST_QUEUE_H_
+#define _HOST_QUEUE_H_
+
+#include "freertos/FreeRTOS.h"
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+typedef struct HostQueue *QueueHandle_t;
+typedef QueueHandle_t SemaphoreHandle_t;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Create a queue of fixed-size items.
+ */
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize);
+
+/** Delete a queue.
+ */
+void vQueueDelete(QueueHandle_t xQueue);
+
+/** Send an item to the back of a queue.
+ */
+BaseType_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue,
+                      TickType_t xTicksToWait);
+
+/** Receive an item from a queue.  If the queue is the UART
+ * event queue handed out by uartInit() then a UART_DATA event is
+ * synthesised when the simulated modem has bytes ready, advancing
+ * the simulated clock to the moment they arrive.
+ */
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer,
+                         TickType_t xTicksToWait);
+
+/** Reset a queue to empty.
+ */
+BaseType_t xQueueReset(QueueHandle_t xQueue);
+
+#define xQueueSendToBack xQueueSend
+#define xQueueSendFromISR(q, p, w) xQueueSend(q, p, 0)
+
+#endif // _HOST_QUEUE_H_
+
+// End Of File
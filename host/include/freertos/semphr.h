@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _HOST_SEMPHR_H_
+#define _HOST_SEMPHR_H_
+
+#include "freertos/queue.h"
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Create a mutex; on the host this is a single-item queue.
+ */
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+
+/** Create a binary semaphore, empty; on the host this is a
+ * single-item queue.
+ */
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+
+/** Take a mutex.
+ */
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xBlockTime);
+
+/** Give a mutex.
+ */
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore);
+
+#define vSemaphoreDelete(x) vQueueDelete(x)
+
+#endif // _HOST_SEMPHR_H_
+
+// End Of File
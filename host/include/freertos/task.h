@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _HOST_TASK_H_
+#define _HOST_TASK_H_
+
+#include "freertos/FreeRTOS.h"
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Advance the simulated clock by the given number of ticks.
+ */
+void vTaskDelay(const TickType_t xTicksToDelay);
+
+/** Return the simulated tick count.
+ */
+TickType_t xTaskGetTickCount(void);
+
+/** Create a task; on the host this is a POSIX thread.
+ */
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t pvTaskCode,
+                                   const char * const pcName,
+                                   const uint32_t usStackDepth,
+                                   void * const pvParameters,
+                                   UBaseType_t uxPriority,
+                                   TaskHandle_t * const pvCreatedTask,
+                                   const BaseType_t xCoreID);
+
+#define xTaskCreate(code, name, stack, param, prio, pHandle) \
+    xTaskCreatePinnedToCore(code, name, stack, param, prio, pHandle, tskNO_AFFINITY)
+
+/** Delete a task; only deleting the calling task (NULL) is supported.
+ */
+void vTaskDelete(TaskHandle_t xTaskToDelete);
+
+/** Return a handle for the calling task.
+ */
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+#endif // _HOST_TASK_H_
+
+// End Of File
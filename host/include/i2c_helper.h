@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+
+#ifndef _HOST_I2C_HELPER_H_
+#define _HOST_I2C_HELPER_H_
+
+/* Host stand-in for the i2c_helper component: transactions are
+ * counted and charged to the simulated clock at the configured bus
+ * speed, reads are answered by the device model in host_os.c.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Initialise I2C.
+ *
+ * @param i2cPort the I2C port to use.
+ * @param pinSda  the SDA pin.
+ * @param pinScl  the SCL pin.
+ * @return        zero on success else negative error code.
+ */
+int32_t i2cInit(int32_t i2cPort, int32_t pinSda, int32_t pinScl);
+
+/** Shut down I2C.
+ *
+ * @param i2cPort the I2C port.
+ */
+void i2cDeinit(int32_t i2cPort);
+
+/** Send and/or receive over the I2C interface, with a repeated
+ * start between the two if both are requested.
+ *
+ * @param i2cPort        the I2C port.
+ * @param i2cAddress     the 7-bit address of the device.
+ * @param pSend          a pointer to the bytes to send, may be NULL.
+ * @param bytesToSend    the number of bytes to send.
+ * @param pReceive       a pointer to storage for the received bytes,
+ *                       may be NULL.
+ * @param bytesToReceive the number of bytes to receive.
+ * @return               if pReceive is not NULL the number of bytes
+ *                       received or negative error code, else zero
+ *                       on success or negative error code.
+ */
+int32_t i2cSendReceive(int32_t i2cPort, char i2cAddress,
+                       const char *pSend, uint32_t bytesToSend,
+                       char *pReceive, uint32_t bytesToReceive);
+
+/** Host only: the device model used to answer reads; called with
+ * the bytes written in the same transaction so that register-
+ * addressed devices can be modelled.  Returns the number of bytes
+ * written to pReceive.
+ */
+typedef int32_t (*HostI2cDevice)(char i2cAddress,
+                                 const char *pSend, uint32_t bytesToSend,
+                                 char *pReceive, uint32_t bytesToReceive);
+
+/** Host only: install a device model (NULL for the default, which
+ * ACKs everything and reads back zeroes).
+ */
+void hostI2cSetDevice(HostI2cDevice device);
+
+/** Host only: the number of I2C transactions since start of day.
+ */
+int32_t hostI2cTransactionCount(void);
+
+#endif // _HOST_I2C_HELPER_H_
+
+// End Of File
@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+
+#ifndef _HOST_SYS_TIME_H_
+#define _HOST_SYS_TIME_H_
+
+// main.c includes "sys/time.h" with quotes, so this is found
+// ahead of the system header and lets gettimeofday() return
+// simulated time.
+#include_next <sys/time.h>
+
+/** Simulated time of day, in seconds since the host build started.
+ */
+int hostGettimeofday(struct timeval *pTv, void *pTz);
+
+#define gettimeofday(pTv, pTz) hostGettimeofday(pTv, pTz)
+
+#endif // _HOST_SYS_TIME_H_
+
+// End Of File
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+
+#ifndef _HOST_UART_HELPER_H_
+#define _HOST_UART_HELPER_H_
+
+/* Host stand-in for the uart_helper component: every port is
+ * connected to the simulated SARA-R412M in sim_sara_r412m.c.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Initialise a UART.
+ *
+ * @param uart           the UART port.
+ * @param pinTxd         the transmit pin.
+ * @param pinRxd         the receive pin.
+ * @param baudRate       the baud rate.
+ * @param flowControl    true to use hardware flow control.
+ * @param pUartEventQueue place to put the handle of the UART event
+ *                       queue.
+ * @return               zero on success else negative error code.
+ */
+int32_t uartInit(int32_t uart, int32_t pinTxd, int32_t pinRxd,
+                 int32_t baudRate, bool flowControl,
+                 QueueHandle_t *pUartEventQueue);
+
+/** Shut down a UART.
+ *
+ * @param uart the UART port.
+ */
+void uartDeinit(int32_t uart);
+
+#endif // _HOST_UART_HELPER_H_
+
+// End Of File
@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+/* Micro-benchmark of looking up resource instances in an
+ * Lwm2mObjectInstance by walking its pResources list against
+ * looking them up in an Lwm2mResourceTable, for objects shaped
+ * like the I2C Generic Command object but with increasingly long
+ * multi-instance resources, e.g.:
+ *
+ * ./lwm2m_table_bench [max_instances]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lwm2m.h"
+#include "lwm2m_resource_table.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// The default largest number of instances of each
+// multi-instance resource.
+#define DEFAULT_MAX_INSTANCES 1024
+
+// The number of random lookups timed at each size.
+#define NUM_LOOKUPS 200000
+
+// The number of range iterations timed at each size.
+#define NUM_RANGES 2000
+
+// The multi-instance resources, as Write Sequence and
+// Read Response were in version 1.0 of the I2C Generic
+// Command object.
+#define RESOURCE_ID_WRITE 5
+#define RESOURCE_ID_READ 9
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Real monotonic time in nanoseconds.
+static int64_t timeNs()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((int64_t) now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+// Add a resource instance to the front of an object's list,
+// which is how the list ends up reversed with respect to the
+// order SARA-R4 sends it in.
+static void addResource(Lwm2mObjectInstance *pObject, int32_t omaId,
+                        int32_t instanceId, float number)
+{
+    Lwm2mResourceInstance *pResource = calloc(1, sizeof(*pResource));
+
+    pResource->omaId = omaId;
+    pResource->instanceId = instanceId;
+    pResource->value.number = number;
+    pResource->pNext = pObject->pResources;
+    pObject->pResources = pResource;
+}
+
+// Build an I2C Generic Command-like object with numInstances
+// instances of each multi-instance resource.
+static void buildObject(Lwm2mObjectInstance *pObject, int32_t numInstances)
+{
+    memset(pObject, 0, sizeof(*pObject));
+    pObject->omaId = 33050;
+    pObject->instanceId = 1;
+    for (int32_t x = 1; x <= 9; x++) {
+        if ((x == RESOURCE_ID_WRITE) || (x == RESOURCE_ID_READ)) {
+            for (int32_t y = 0; y < numInstances; y++) {
+                addResource(pObject, x, y, (float) (y & 0xFF));
+            }
+        } else {
+            addResource(pObject, x, -1, (float) x);
+        }
+    }
+}
+
+static void freeObject(Lwm2mObjectInstance *pObject)
+{
+    Lwm2mResourceInstance *pNext;
+
+    for (Lwm2mResourceInstance *pResource = pObject->pResources;
+         pResource != NULL; pResource = pNext) {
+        pNext = pResource->pNext;
+        free(pResource);
+    }
+    pObject->pResources = NULL;
+}
+
+// Find a resource instance the way main.c does it.
+static Lwm2mResourceInstance *pListFind(const Lwm2mObjectInstance *pObject,
+                                        int32_t omaId, int32_t instanceId)
+{
+    Lwm2mResourceInstance *pResource = pObject->pResources;
+
+    while ((pResource != NULL) &&
+           ((pResource->omaId != omaId) || (pResource->instanceId != instanceId))) {
+        pResource = pResource->pNext;
+    }
+
+    return pResource;
+}
+
+// Sum all instances of a resource by walking the list.
+static float listSum(const Lwm2mObjectInstance *pObject, int32_t omaId)
+{
+    float sum = 0;
+
+    for (Lwm2mResourceInstance *pResource = pObject->pResources;
+         pResource != NULL; pResource = pResource->pNext) {
+        if (pResource->omaId == omaId) {
+            sum += pResource->value.number;
+        }
+    }
+
+    return sum;
+}
+
+// Sum all instances of a resource from the table.
+static float tableSum(const Lwm2mResourceTable *pTable, int32_t omaId)
+{
+    Lwm2mResourceTableEntry *pEntry;
+    int32_t count = lwm2mResourceTableRange(pTable, omaId, &pEntry);
+    float sum = 0;
+
+    for (int32_t x = 0; x < count; x++) {
+        sum += pEntry[x].value.number;
+    }
+
+    return sum;
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    int32_t maxInstances = DEFAULT_MAX_INSTANCES;
+    Lwm2mObjectInstance object;
+    Lwm2mResourceTable table;
+    Lwm2mResourceTableEntry *pEntries;
+    int32_t numEntries;
+    int32_t *pKeys;
+    int64_t startNs;
+    int64_t listLookupNs;
+    int64_t tableLookupNs;
+    int64_t listRangeNs;
+    int64_t tableRangeNs;
+    int64_t buildNs;
+    volatile float sink = 0;
+    int32_t misses = 0;
+
+    if (argc > 1) {
+        maxInstances = atoi(argv[1]);
+    }
+
+    printf("%10s %8s %14s %14s %14s %14s %14s\n", "instances", "entries",
+           "list find ns", "table find ns", "list range us", "table range us",
+           "table fill us");
+    for (int32_t numInstances = 4; numInstances <= maxInstances; numInstances *= 4) {
+        buildObject(&object, numInstances);
+        numEntries = 7 + (2 * numInstances);
+        pEntries = malloc(numEntries * sizeof(*pEntries));
+        lwm2mResourceTableInit(&table, object.omaId, object.instanceId,
+                               pEntries, numEntries);
+
+        // The same pseudo-random keys for both
+        pKeys = malloc(NUM_LOOKUPS * sizeof(*pKeys));
+        srand(1);
+        for (int32_t x = 0; x < NUM_LOOKUPS; x++) {
+            pKeys[x] = rand() % numInstances;
+        }
+
+        startNs = timeNs();
+        if (lwm2mResourceTableFromObject(&table, &object) != numEntries) {
+            fprintf(stderr, "table fill failed.\n");
+            return 1;
+        }
+        buildNs = timeNs() - startNs;
+
+        startNs = timeNs();
+        for (int32_t x = 0; x < NUM_LOOKUPS; x++) {
+            Lwm2mResourceInstance *pResource = pListFind(&object, RESOURCE_ID_READ, pKeys[x]);
+            if (pResource != NULL) {
+                sink += pResource->value.number;
+            } else {
+                misses++;
+            }
+        }
+        listLookupNs = timeNs() - startNs;
+
+        startNs = timeNs();
+        for (int32_t x = 0; x < NUM_LOOKUPS; x++) {
+            Lwm2mResourceTableEntry *pEntry = pLwm2mResourceTableFind(&table, RESOURCE_ID_READ, pKeys[x]);
+            if (pEntry != NULL) {
+                sink += pEntry->value.number;
+            } else {
+                misses++;
+            }
+        }
+        tableLookupNs = timeNs() - startNs;
+
+        startNs = timeNs();
+        for (int32_t x = 0; x < NUM_RANGES; x++) {
+            sink += listSum(&object, RESOURCE_ID_READ);
+        }
+        listRangeNs = timeNs() - startNs;
+
+        startNs = timeNs();
+        for (int32_t x = 0; x < NUM_RANGES; x++) {
+            sink += tableSum(&table, RESOURCE_ID_READ);
+        }
+        tableRangeNs = timeNs() - startNs;
+
+        printf("%10d %8d %14.1f %14.1f %14.3f %14.3f %14.3f\n", numInstances, numEntries,
+               ((double) listLookupNs) / NUM_LOOKUPS,
+               ((double) tableLookupNs) / NUM_LOOKUPS,
+               ((double) listRangeNs) / NUM_RANGES / 1000,
+               ((double) tableRangeNs) / NUM_RANGES / 1000,
+               ((double) buildNs) / 1000);
+
+        free(pKeys);
+        free(pEntries);
+        freeObject(&object);
+    }
+
+    if (misses > 0) {
+        fprintf(stderr, "%d lookup(s) failed.\n", misses);
+        return 1;
+    }
+
+    return 0;
+}
+
+// End Of File
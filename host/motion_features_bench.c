@@ -0,0 +1,332 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+/* Benchmark of the motion features kernel in main/motion_features.c
+ * on accelerometer traces, e.g.:
+ *
+ * ./motion_features_bench [trace.csv ...]
+ *
+ * A trace file has one sample per line: X, Y and Z in mg, comma
+ * separated, at LIS2DW_FIFO_ODR_HZ (e.g. as logged from the LIS2DW
+ * FIFO).  Without trace files an hour of samples is synthesised for
+ * a device at rest, carried by someone walking, in a vehicle and
+ * being knocked about: the noise and quantisation are those of the
+ * LIS2DW at ±2 g in high performance mode.
+ *
+ * Each trace is cut into windows of MOTION_FEATURES_WINDOW_SIZE
+ * samples and the features of each window computed, as on the
+ * device.  The time per sample, the best of NUM_TIMING_RUNS runs,
+ * is reported in nanoseconds and, on x86, in cycles of the time
+ * stamp counter, which counts at the nominal clock rate of the
+ * processor.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#if defined(__x86_64__) || defined(__i386__)
+# include <x86intrin.h>
+#endif
+#include "motion_features.h"
+#include "lis2dw_fifo.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// The number of samples in a synthesised trace: an hour.
+#define NUM_SYNTH_SAMPLES (60 * 60 * LIS2DW_FIFO_ODR_HZ)
+
+// The most samples in a trace file.
+#define MAX_SAMPLES 10000000
+
+// The number of times a trace is run through the kernel for timing,
+// the fastest being reported.
+#define NUM_TIMING_RUNS 20
+
+// The longest trace file line handled.
+#define MAX_LINE_LENGTH 256
+
+// The output of the LIS2DW for 1 g at ±2 g full scale, left-justified.
+#define COUNTS_PER_G 16384
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+// A trace.
+typedef struct {
+    const char *pName;
+    int32_t numSamples;
+    MotionFeaturesSample *pSamples;
+} Trace;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Real monotonic time in nanoseconds.
+static int64_t timeNs()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((int64_t) now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+// The time stamp counter, zero where there isn't one.
+static uint64_t cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// A normally distributed random number.
+static double gaussian()
+{
+    double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+    return sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+// Allocate storage for a trace.
+static bool traceAlloc(Trace *pTrace, const char *pName, int32_t numSamples)
+{
+    pTrace->pName = pName;
+    pTrace->numSamples = numSamples;
+    pTrace->pSamples = malloc(numSamples * sizeof(pTrace->pSamples[0]));
+
+    return (pTrace->pSamples != NULL);
+}
+
+// Free a trace.
+static void traceFree(Trace *pTrace)
+{
+    free(pTrace->pSamples);
+    pTrace->pSamples = NULL;
+}
+
+// Set a sample from mg, as the LIS2DW would output it: 14 bits,
+// left-justified, saturating at ±2 g.
+static void setSample(MotionFeaturesSample *pSample, const double *pMg)
+{
+    double counts;
+
+    for (int32_t a = 0; a < MOTION_FEATURES_NUM_AXES; a++) {
+        counts = pMg[a] * COUNTS_PER_G / 1000;
+        if (counts > 32767) {
+            counts = 32767;
+        } else if (counts < -32768) {
+            counts = -32768;
+        }
+        // The bottom two bits are always zero
+        (*pSample)[a] = (int16_t) (((int32_t) counts) & ~3);
+    }
+}
+
+// The kinds of synthesised trace.
+typedef enum {
+    SYNTH_REST,
+    SYNTH_WALKING,
+    SYNTH_VEHICLE,
+    SYNTH_KNOCKS,
+    NUM_SYNTHS
+} Synth;
+
+// Synthesise a trace: gravity on a slowly changing orientation
+// plus the motion plus 1.5 mg RMS of noise per axis.
+static bool synthTrace(Trace *pTrace, Synth synth)
+{
+    const char *pNames[NUM_SYNTHS] = {"rest", "walking", "vehicle", "knocks"};
+    double mg[MOTION_FEATURES_NUM_AXES];
+    double t;
+    double knock = 0;
+
+    if (!traceAlloc(pTrace, pNames[synth], NUM_SYNTH_SAMPLES)) {
+        return false;
+    }
+    srand(3 + synth);
+    for (int32_t x = 0; x < pTrace->numSamples; x++) {
+        t = (double) x / LIS2DW_FIFO_ODR_HZ;
+        mg[0] = 100 * sin(2 * M_PI * t / 600);
+        mg[1] = -50;
+        mg[2] = sqrt(1000000 - mg[0] * mg[0] - mg[1] * mg[1]);
+        switch (synth) {
+            case SYNTH_WALKING:
+                // Steps at a little under 2 Hz, mostly vertical
+                mg[1] += 300 * sin(2 * M_PI * 1.8 * t) + 80 * sin(2 * M_PI * 3.6 * t);
+                mg[0] += 60 * sin(2 * M_PI * 0.9 * t);
+            break;
+            case SYNTH_VEHICLE:
+                // Engine at 15 Hz on top of road noise
+                mg[2] += 40 * sin(2 * M_PI * 15 * t) + gaussian() * 30;
+                mg[0] += gaussian() * 20;
+            break;
+            case SYNTH_KNOCKS:
+                // A decaying 25 Hz ring every few seconds
+                if ((rand() % (5 * LIS2DW_FIFO_ODR_HZ)) == 0) {
+                    knock = 1500;
+                }
+                mg[0] += knock * sin(2 * M_PI * 25 * t);
+                knock *= 0.9;
+            break;
+            default:
+            break;
+        }
+        for (int32_t a = 0; a < MOTION_FEATURES_NUM_AXES; a++) {
+            mg[a] += gaussian() * 1.5;
+        }
+        setSample(&(pTrace->pSamples[x]), mg);
+    }
+
+    return true;
+}
+
+// Load a trace from a CSV file.
+static bool loadTrace(Trace *pTrace, const char *pFileName)
+{
+    FILE *pFile;
+    char line[MAX_LINE_LENGTH];
+    char *pField;
+    char *pSave;
+    double mg[MOTION_FEATURES_NUM_AXES];
+    int32_t numSamples = 0;
+
+    pFile = fopen(pFileName, "r");
+    if (pFile == NULL) {
+        fprintf(stderr, "unable to open \"%s\".\n", pFileName);
+        return false;
+    }
+    if (!traceAlloc(pTrace, pFileName, MAX_SAMPLES)) {
+        fclose(pFile);
+        return false;
+    }
+    while ((numSamples < MAX_SAMPLES) && (fgets(line, sizeof(line), pFile) != NULL)) {
+        pField = strtok_r(line, ",\r\n", &pSave);
+        for (int32_t a = 0; a < MOTION_FEATURES_NUM_AXES; a++) {
+            mg[a] = (pField != NULL) ? strtod(pField, NULL) : 0;
+            pField = strtok_r(NULL, ",\r\n", &pSave);
+        }
+        setSample(&(pTrace->pSamples[numSamples]), mg);
+        numSamples++;
+    }
+    fclose(pFile);
+    pTrace->numSamples = numSamples;
+    if (numSamples < MOTION_FEATURES_WINDOW_SIZE) {
+        fprintf(stderr, "\"%s\" has fewer than %d samples.\n", pFileName,
+                MOTION_FEATURES_WINDOW_SIZE);
+        traceFree(pTrace);
+        return false;
+    }
+
+    return true;
+}
+
+// Benchmark one trace.
+static void bench(const Trace *pTrace)
+{
+    int32_t numWindows = pTrace->numSamples / MOTION_FEATURES_WINDOW_SIZE;
+    int32_t numSamples = numWindows * MOTION_FEATURES_WINDOW_SIZE;
+    int32_t axisCount[MOTION_FEATURES_NUM_AXES] = {0};
+    int32_t dominantAxis = 0;
+    MotionFeatures features;
+    int64_t rmsTotal = 0;
+    int32_t peakMax = 0;
+    int64_t crossingsTotal = 0;
+    int64_t startNs;
+    int64_t ns;
+    int64_t bestNs = 0;
+    uint64_t startCycles;
+    uint64_t numCycles;
+    uint64_t bestCycles = 0;
+
+    // Once for the results
+    for (int32_t x = 0; x < numWindows; x++) {
+        motionFeaturesCompute(pTrace->pSamples + x * MOTION_FEATURES_WINDOW_SIZE,
+                              &features);
+        rmsTotal += features.rmsMg;
+        if (features.peakMg > peakMax) {
+            peakMax = features.peakMg;
+        }
+        crossingsTotal += features.zeroCrossings;
+        axisCount[features.dominantAxis]++;
+    }
+    for (int32_t a = 0; a < MOTION_FEATURES_NUM_AXES; a++) {
+        if (axisCount[a] > axisCount[dominantAxis]) {
+            dominantAxis = a;
+        }
+    }
+
+    // Then for the timing, the fastest of a number of runs so as
+    // to leave out whatever else the machine was doing
+    for (int32_t y = 0; y < NUM_TIMING_RUNS; y++) {
+        startNs = timeNs();
+        startCycles = cycles();
+        for (int32_t x = 0; x < numWindows; x++) {
+            motionFeaturesCompute(pTrace->pSamples + x * MOTION_FEATURES_WINDOW_SIZE,
+                                  &features);
+            // Stop the compiler throwing the work away
+            __asm__ __volatile__("" : : "g" (&features) : "memory");
+        }
+        numCycles = cycles() - startCycles;
+        ns = timeNs() - startNs;
+        if ((y == 0) || (ns < bestNs)) {
+            bestNs = ns;
+            bestCycles = numCycles;
+        }
+    }
+
+    printf("%-14s %8d %8lld %8d %8.1f %5c %8.2f %8.2f\n", pTrace->pName,
+           numWindows, (long long) (rmsTotal / numWindows), peakMax,
+           (double) crossingsTotal / numWindows, "XYZ"[dominantAxis],
+           (double) bestNs / numSamples, (double) bestCycles / numSamples);
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    Trace trace;
+
+    printf("windows of %d sample(s) at %d Hz; RMS is the mean over the windows, peak the largest,\n"
+           "crossings the mean per window, axis the one most often dominant.\n\n",
+           MOTION_FEATURES_WINDOW_SIZE, LIS2DW_FIFO_ODR_HZ);
+    printf("%-14s %8s %8s %8s %8s %5s %8s %8s\n", "trace", "windows",
+           "RMS mg", "peak mg", "crossing", "axis", "ns/smp", "cyc/smp");
+    if (argc > 1) {
+        for (int x = 1; x < argc; x++) {
+            if (loadTrace(&trace, argv[x])) {
+                bench(&trace);
+                traceFree(&trace);
+            }
+        }
+    } else {
+        for (int32_t x = 0; x < NUM_SYNTHS; x++) {
+            if (synthTrace(&trace, (Synth) x)) {
+                bench(&trace);
+            }
+            traceFree(&trace);
+        }
+    }
+
+    return 0;
+}
+
+// End Of File
@@ -0,0 +1,495 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_attr.h"
+#include "host_os.h"
+#include "sim_sara_r412m.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// The maximum number of responses/URCs in flight at once.
+#define MAX_PENDING_OUTPUTS 32
+
+// Defaults if the script doesn't say otherwise.
+#define DEFAULT_BOOT_TIME_MS   4000
+#define DEFAULT_LATENCY_MS     20
+#define DEFAULT_BAUD_RATE      115200
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+// The stand-in LWM2M server.
+typedef struct {
+    bool present;
+    int32_t handshakeMs;
+    int32_t registerMs;
+    int32_t updateMs;
+    int32_t lifetimeSeconds;
+    bool sessionUp;           // Lost at power-off.
+    int64_t registeredUntilUs; // Zero if not registered.
+} Lwm2mServer;
+
+// A script entry.
+typedef struct {
+    bool isUrc;
+    char prefix[SIM_SARA_R412M_MAX_LINE_LENGTH];
+    int32_t latencyMs;
+    char response[SIM_SARA_R412M_MAX_LINE_LENGTH];
+} ScriptEntry;
+
+// Bytes on their way to the ESP32.
+typedef struct {
+    int64_t readyUs;
+    size_t length;
+    size_t offset;
+    int32_t baudRate; // The rate the module sent them at.
+    char data[SIM_SARA_R412M_MAX_LINE_LENGTH * 2];
+} PendingOutput;
+
+// ----------------------------------------------------------------
+// PRIVATE VARIABLES
+// ----------------------------------------------------------------
+
+static ScriptEntry gScript[SIM_SARA_R412M_MAX_SCRIPT_ENTRIES];
+static int32_t gNumScriptEntries = 0;
+static ScriptEntry gDefaultEntry;
+static int32_t gBootTimeMs = DEFAULT_BOOT_TIME_MS;
+static int32_t gInitialBaudRate = DEFAULT_BAUD_RATE;
+static int32_t gMaxBaudRate = 0; // Zero for no limit
+
+// The module, and the server, outlast the wake cycles of the ESP32.
+static HOST_RETAINED_ATTR bool gPowered = false;
+static HOST_RETAINED_ATTR int64_t gPowerOnUs = 0;
+static HOST_RETAINED_ATTR int32_t gModemBaudRate = DEFAULT_BAUD_RATE;
+static int32_t gHostBaudRate = DEFAULT_BAUD_RATE;
+
+static HOST_RETAINED_ATTR char gCommand[SIM_SARA_R412M_MAX_LINE_LENGTH];
+static HOST_RETAINED_ATTR size_t gCommandLength = 0;
+
+static HOST_RETAINED_ATTR PendingOutput gPending[MAX_PENDING_OUTPUTS];
+static HOST_RETAINED_ATTR int32_t gNumPending = 0;
+
+// When the module will have sent the response to the last command.
+static HOST_RETAINED_ATTR int64_t gBusyUntilUs = 0;
+
+static HOST_RETAINED_ATTR Lwm2mServer gServer;
+
+static HOST_RETAINED_ATTR SimSaraR412mStats gStats;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// The time for a number of bytes to cross the UART at a given rate.
+static int64_t uartTimeUs(size_t bytes, int32_t baudRate)
+{
+    // 10 bits per byte with start and stop bits
+    return (((int64_t) bytes) * 10 * 1000000) / baudRate;
+}
+
+// Determine whether bytes sent by the module at a given rate get
+// across the UART: the ESP32 must be at the same rate and that rate
+// must work.
+static bool linkWorks(int32_t modemBaudRate)
+{
+    return (gHostBaudRate == modemBaudRate) &&
+           ((gMaxBaudRate == 0) || (modemBaudRate <= gMaxBaudRate));
+}
+
+// Queue bytes for the ESP32, keeping the queue ordered by ready time;
+// returns the time the last of them will have arrived.
+static int64_t queueOutput(const char *pText, int64_t readyUs)
+{
+    PendingOutput *pOutput;
+    int32_t x;
+    size_t length = 0;
+
+    if (gNumPending >= MAX_PENDING_OUTPUTS) {
+        printf("SIM: warning: too many responses pending, dropping \"%s\".\n", pText);
+        return readyUs;
+    }
+
+    // Find the insertion point and make room
+    for (x = gNumPending; (x > 0) && (gPending[x - 1].readyUs > readyUs); x--) {
+        gPending[x] = gPending[x - 1];
+    }
+    pOutput = &(gPending[x]);
+    gNumPending++;
+
+    // Turn '|' into line breaks, framing the whole thing
+    // as SARA-R4 does with "\r\n" at either end of each line
+    pOutput->data[length++] = '\r';
+    pOutput->data[length++] = '\n';
+    for (; (*pText != 0) && (length < sizeof(pOutput->data) - 4); pText++) {
+        if (*pText == '|') {
+            pOutput->data[length++] = '\r';
+            pOutput->data[length++] = '\n';
+            pOutput->data[length++] = '\r';
+            pOutput->data[length++] = '\n';
+        } else {
+            pOutput->data[length++] = *pText;
+        }
+    }
+    pOutput->data[length++] = '\r';
+    pOutput->data[length++] = '\n';
+    pOutput->length = length;
+    pOutput->offset = 0;
+    pOutput->baudRate = gModemBaudRate;
+    pOutput->readyUs = readyUs + uartTimeUs(length, gModemBaudRate);
+
+    return pOutput->readyUs;
+}
+
+// Return the best (longest prefix) response entry matching a command.
+static const ScriptEntry *pFindResponse(const char *pCommand)
+{
+    const ScriptEntry *pBest = NULL;
+    size_t bestLength = 0;
+    size_t length;
+
+    for (int32_t x = 0; x < gNumScriptEntries; x++) {
+        if (!gScript[x].isUrc) {
+            length = strlen(gScript[x].prefix);
+            if ((length > bestLength) &&
+                (strncmp(pCommand, gScript[x].prefix, length) == 0)) {
+                pBest = &(gScript[x]);
+                bestLength = length;
+            }
+        }
+    }
+
+    return pBest;
+}
+
+// Have the stand-in LWM2M server register or update the
+// registration, handshaking first if there is no DTLS session, and
+// queue the URC that says so; nothing is sent if the module is
+// registered already and an update is not asked for.
+static void serverContact(int64_t nowUs, bool update)
+{
+    int64_t durationMs = 0;
+    bool registered = (gServer.registeredUntilUs > nowUs);
+    const char *pUrc = "+UULWM2MSTAT: 1";
+
+    if (registered && !update) {
+        return;
+    }
+    if (!gServer.sessionUp) {
+        durationMs += gServer.handshakeMs;
+        gServer.sessionUp = true;
+        gStats.lwm2mHandshakes++;
+    }
+    if (registered) {
+        durationMs += gServer.updateMs;
+        gStats.lwm2mUpdates++;
+        pUrc = "+UULWM2MSTAT: 3";
+    } else {
+        durationMs += gServer.registerMs;
+        gStats.lwm2mRegistrations++;
+    }
+    gServer.registeredUntilUs = nowUs + (durationMs * 1000) +
+                                ((int64_t) gServer.lifetimeSeconds) * 1000000;
+    gStats.lwm2mServerTimeUs += durationMs * 1000;
+    queueOutput(pUrc, nowUs + (durationMs * 1000));
+    gStats.urcs++;
+}
+
+// Handle a complete command from the ESP32.
+static void handleCommand(const char *pCommand)
+{
+    const ScriptEntry *pEntry;
+    int64_t nowUs = hostTimeUs();
+    int64_t startUs = nowUs;
+    int32_t newBaudRate = 0;
+
+    gStats.commands++;
+    // One command at a time: wait for the one ahead to be answered
+    if (gBusyUntilUs > nowUs) {
+        startUs = gBusyUntilUs;
+    } else {
+        gStats.roundTrips++;
+    }
+    pEntry = pFindResponse(pCommand);
+    if (pEntry == NULL) {
+        pEntry = &gDefaultEntry;
+        gStats.unmatched++;
+    }
+    if (strcmp(pEntry->response, "-") != 0) {
+        gBusyUntilUs = queueOutput(pEntry->response,
+                                   startUs + ((int64_t) pEntry->latencyMs) * 1000);
+    }
+
+    // Schedule any URCs that this command triggers
+    for (int32_t x = 0; x < gNumScriptEntries; x++) {
+        if (gScript[x].isUrc &&
+            (strncmp(pCommand, gScript[x].prefix, strlen(gScript[x].prefix)) == 0)) {
+            queueOutput(gScript[x].response, nowUs + ((int64_t) gScript[x].latencyMs) * 1000);
+            gStats.urcs++;
+        }
+    }
+
+    if (gServer.present) {
+        if (strcmp(pCommand, "AT+ULWM2MSTAT=1") == 0) {
+            serverContact(nowUs, false);
+        } else if (strncmp(pCommand, "AT+ULWM2MREG=", 13) == 0) {
+            serverContact(nowUs, true);
+        }
+    }
+
+    // A change of baud rate takes effect after the OK
+    if ((sscanf(pCommand, "AT+IPR=%d", (int *) &newBaudRate) == 1) && (newBaudRate > 0)) {
+        gModemBaudRate = newBaudRate;
+    }
+}
+
+// Parse one line of a script file.
+static void parseScriptLine(char *pLine)
+{
+    char *pToken;
+    char *pRest;
+    ScriptEntry *pEntry;
+    bool isUrc = false;
+
+    pLine[strcspn(pLine, "\r\n")] = 0;
+    pToken = strtok_r(pLine, " \t", &pRest);
+    if ((pToken == NULL) || (*pToken == '#')) {
+        return;
+    }
+
+    if (strcmp(pToken, "BOOT") == 0) {
+        gBootTimeMs = atoi(pRest);
+        return;
+    }
+    if (strcmp(pToken, "BAUD") == 0) {
+        gInitialBaudRate = atoi(pRest);
+        return;
+    }
+    if (strcmp(pToken, "MAXBAUD") == 0) {
+        gMaxBaudRate = atoi(pRest);
+        return;
+    }
+    if (strcmp(pToken, "SERVER") == 0) {
+        if (sscanf(pRest, "%d %d %d %d", (int *) &gServer.handshakeMs,
+                   (int *) &gServer.registerMs, (int *) &gServer.updateMs,
+                   (int *) &gServer.lifetimeSeconds) == 4) {
+            gServer.present = true;
+        } else {
+            printf("SIM: warning: SERVER needs four numbers, ignoring it.\n");
+        }
+        return;
+    }
+    if (strcmp(pToken, "URC") == 0) {
+        isUrc = true;
+        pToken = strtok_r(NULL, " \t", &pRest);
+        if (pToken == NULL) {
+            return;
+        }
+    }
+
+    if (strcmp(pToken, "DEFAULT") == 0) {
+        pEntry = &gDefaultEntry;
+    } else if (gNumScriptEntries < SIM_SARA_R412M_MAX_SCRIPT_ENTRIES) {
+        pEntry = &(gScript[gNumScriptEntries]);
+        gNumScriptEntries++;
+    } else {
+        printf("SIM: warning: script too long, ignoring \"%s\".\n", pToken);
+        return;
+    }
+    memset(pEntry, 0, sizeof(*pEntry));
+    pEntry->isUrc = isUrc;
+    strncpy(pEntry->prefix, pToken, sizeof(pEntry->prefix) - 1);
+    pToken = strtok_r(NULL, " \t", &pRest);
+    if (pToken != NULL) {
+        pEntry->latencyMs = atoi(pToken);
+        while ((*pRest == ' ') || (*pRest == '\t')) {
+            pRest++;
+        }
+        strncpy(pEntry->response, pRest, sizeof(pEntry->response) - 1);
+    }
+    if (pEntry->response[0] == 0) {
+        strcpy(pEntry->response, "OK");
+    }
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Initialise the simulation.
+int32_t simSaraR412mInit(const char *pScriptFile)
+{
+    FILE *pFile;
+    char line[SIM_SARA_R412M_MAX_LINE_LENGTH * 2];
+
+    memset(&gStats, 0, sizeof(gStats));
+    memset(&gServer, 0, sizeof(gServer));
+    memset(&gDefaultEntry, 0, sizeof(gDefaultEntry));
+    gDefaultEntry.latencyMs = DEFAULT_LATENCY_MS;
+    strcpy(gDefaultEntry.response, "OK");
+    gNumScriptEntries = 0;
+    gNumPending = 0;
+    gBusyUntilUs = 0;
+    gCommandLength = 0;
+    gPowered = false;
+    gMaxBaudRate = 0;
+
+    if (pScriptFile != NULL) {
+        pFile = fopen(pScriptFile, "r");
+        if (pFile == NULL) {
+            printf("SIM: error: unable to open script file \"%s\".\n", pScriptFile);
+            return -1;
+        }
+        while (fgets(line, sizeof(line), pFile) != NULL) {
+            parseScriptLine(line);
+        }
+        fclose(pFile);
+    }
+    gModemBaudRate = gInitialBaudRate;
+
+    return 0;
+}
+
+// Shut down the simulation.
+void simSaraR412mDeinit(void)
+{
+    simSaraR412mSetPower(false);
+}
+
+// Switch the power on or off.
+void simSaraR412mSetPower(bool on)
+{
+    if (on && !gPowered) {
+        gPowerOnUs = hostTimeUs();
+        gStats.powerOns++;
+        // The module always boots at its default rate
+        gModemBaudRate = gInitialBaudRate;
+    } else if (!on && gPowered) {
+        gStats.onTimeUs += hostTimeUs() - gPowerOnUs;
+        gNumPending = 0;
+        gBusyUntilUs = 0;
+        gCommandLength = 0;
+        // The DTLS session goes with the power and the module
+        // registers afresh when it boots
+        gServer.sessionUp = false;
+        gServer.registeredUntilUs = 0;
+    }
+    gPowered = on;
+}
+
+// Determine whether the module is powered.
+bool simSaraR412mIsPowered(void)
+{
+    return gPowered;
+}
+
+// Set the baud rate of the ESP32 side.
+void simSaraR412mSetHostBaudRate(int32_t baudRate)
+{
+    gHostBaudRate = baudRate;
+}
+
+// Pass bytes from the ESP32 to the module.
+void simSaraR412mWrite(const char *pBuf, size_t len)
+{
+    // Time passes while the bytes are sent
+    hostTimeAdvanceUs(uartTimeUs(len, gHostBaudRate));
+
+    if (!gPowered ||
+        (hostTimeUs() < gPowerOnUs + ((int64_t) gBootTimeMs) * 1000) ||
+        !linkWorks(gModemBaudRate)) {
+        // Nobody listening, or nothing that makes sense
+        return;
+    }
+
+    gStats.bytesToModem += len;
+    for (size_t x = 0; x < len; x++) {
+        if ((pBuf[x] == '\r') || (pBuf[x] == '\n')) {
+            if (gCommandLength > 0) {
+                gCommand[gCommandLength] = 0;
+                handleCommand(gCommand);
+                gCommandLength = 0;
+            }
+        } else if (gCommandLength < sizeof(gCommand) - 1) {
+            gCommand[gCommandLength] = pBuf[x];
+            gCommandLength++;
+        }
+    }
+}
+
+// Read the bytes that have arrived by now.
+size_t simSaraR412mRead(char *pBuf, size_t len)
+{
+    size_t copied = 0;
+    size_t thisLength;
+    int64_t nowUs = hostTimeUs();
+
+    while ((copied < len) && (gNumPending > 0) && (gPending[0].readyUs <= nowUs)) {
+        thisLength = gPending[0].length - gPending[0].offset;
+        if (thisLength > len - copied) {
+            thisLength = len - copied;
+        }
+        if (linkWorks(gPending[0].baudRate)) {
+            memcpy(pBuf + copied, gPending[0].data + gPending[0].offset, thisLength);
+            copied += thisLength;
+            gStats.bytesFromModem += thisLength;
+        }
+        gPending[0].offset += thisLength;
+        if ((gPending[0].offset >= gPending[0].length) ||
+            !linkWorks(gPending[0].baudRate)) {
+            gNumPending--;
+            memmove(&(gPending[0]), &(gPending[1]), gNumPending * sizeof(gPending[0]));
+        }
+    }
+
+    return copied;
+}
+
+// Return the number of bytes available to read now.
+size_t simSaraR412mAvailable(void)
+{
+    size_t available = 0;
+    int64_t nowUs = hostTimeUs();
+
+    for (int32_t x = 0; (x < gNumPending) && (gPending[x].readyUs <= nowUs); x++) {
+        available += gPending[x].length - gPending[x].offset;
+    }
+
+    return available;
+}
+
+// Return the time at which the next byte will be ready.
+int64_t simSaraR412mNextReadyUs(void)
+{
+    int64_t readyUs = -1;
+
+    if (gNumPending > 0) {
+        readyUs = gPending[0].readyUs;
+    }
+
+    return readyUs;
+}
+
+// Get the statistics.
+void simSaraR412mGetStats(SimSaraR412mStats *pStats)
+{
+    *pStats = gStats;
+    if (gPowered) {
+        pStats->onTimeUs += hostTimeUs() - gPowerOnUs;
+    }
+}
+
+// End Of File
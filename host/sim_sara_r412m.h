@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _SIM_SARA_R412M_H_
+#define _SIM_SARA_R412M_H_
+
+/* A scriptable simulation of a SARA-R412M at the far end of the
+ * cellular UART.  A script file maps AT command prefixes to a
+ * latency and a response, for instance:
+ *
+ * # Comment
+ * BOOT      4000                     <- ms from power-on to AT ready
+ * BAUD      115200                   <- initial UART rate
+ * MAXBAUD   460800                   <- fastest rate that works
+ * DEFAULT   20     OK                <- anything not matched below
+ * AT+CEREG? 50     +CEREG: 0,1|OK    <- '|' separates response lines
+ * AT+UMNOPROF? 30  +UMNOPROF: 100|OK
+ * URC AT+COPS 3000 +CEREG: 1         <- sent 3000 ms after a match
+ * SERVER    1500 800 300 86400       <- the LWM2M server, see below
+ *
+ * The longest matching prefix wins; latencies are added to the time
+ * the command takes to cross the UART at the current baud rate.
+ * Commands are dealt with one at a time, in the order they arrive:
+ * a command sent before the response to the one ahead of it has
+ * gone (see at_batch.h) waits for it, its latency starting when
+ * that response has been sent.  URCs don't hold anything up.
+ *
+ * AT+IPR=<rate> moves the module to the new rate once its OK has
+ * gone; it accepts any rate but, with MAXBAUD, nothing gets through
+ * at a rate above the limit, in either direction, as with a poor
+ * line.  The module always boots at the BAUD rate.
+ *
+ * SERVER stands in for the LWM2M server at the far end of the
+ * network: the ms for a DTLS handshake, for a registration and for a
+ * registration update, then the registration lifetime in seconds.
+ * The DTLS session and the registration last until the module is
+ * powered off, the registration no longer than its lifetime.  When
+ * AT+ULWM2MSTAT=1 is received the module handshakes, if it has no
+ * session, and registers, if it is not registered, sending
+ * "+UULWM2MSTAT: 1" when done; AT+ULWM2MREG=<id> sends a
+ * registration update, "+UULWM2MSTAT: 3", or registers afresh if
+ * the registration has lapsed.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The maximum number of entries in a script.
+ */
+#define SIM_SARA_R412M_MAX_SCRIPT_ENTRIES 128
+
+/** The maximum length of a command or response.
+ */
+#define SIM_SARA_R412M_MAX_LINE_LENGTH 256
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** Statistics kept by the simulation.
+ */
+typedef struct {
+    int32_t commands;        //!< AT commands received.
+    int32_t unmatched;       //!< Commands answered by DEFAULT.
+    int32_t roundTrips;      //!< Commands that found the module
+                             //!< idle, i.e. that had to wait
+                             //!< for the ESP32 to send them
+                             //!< rather than being queued
+                             //!< behind the one ahead.
+    int32_t urcs;            //!< URCs sent.
+    int64_t bytesToModem;    //!< Bytes received from the ESP32.
+    int64_t bytesFromModem;  //!< Bytes sent to the ESP32.
+    int64_t onTimeUs;        //!< Total time powered.
+    int32_t powerOns;        //!< Number of power-on events.
+    int32_t lwm2mHandshakes;    //!< DTLS handshakes with the
+                                //!< SERVER.
+    int32_t lwm2mRegistrations; //!< Full registrations.
+    int32_t lwm2mUpdates;       //!< Registration updates.
+    int64_t lwm2mServerTimeUs;  //!< Time spent on all of those.
+} SimSaraR412mStats;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Initialise the simulation, loading a script.
+ *
+ * @param pScriptFile the script file; if NULL a built-in
+ *                    script of plain "OK"s is used.
+ * @return            zero on success else negative error code.
+ */
+int32_t simSaraR412mInit(const char *pScriptFile);
+
+/** Shut down the simulation.
+ */
+void simSaraR412mDeinit(void);
+
+/** Switch the power to the simulated module on or off.
+ *
+ * @param on true to power on.
+ */
+void simSaraR412mSetPower(bool on);
+
+/** Determine whether the simulated module is powered.
+ *
+ * @return true if powered.
+ */
+bool simSaraR412mIsPowered(void);
+
+/** Set the baud rate of the ESP32 side of the UART.  If this
+ * does not match that of the simulated module, bytes in both
+ * directions are lost.
+ *
+ * @param baudRate the baud rate.
+ */
+void simSaraR412mSetHostBaudRate(int32_t baudRate);
+
+/** Pass bytes written by the ESP32 to the simulated module.
+ *
+ * @param pBuf the bytes.
+ * @param len  the number of bytes.
+ */
+void simSaraR412mWrite(const char *pBuf, size_t len);
+
+/** Read bytes from the simulated module that have arrived by
+ * the current simulated time.
+ *
+ * @param pBuf storage for the bytes.
+ * @param len  the size of pBuf.
+ * @return     the number of bytes copied.
+ */
+size_t simSaraR412mRead(char *pBuf, size_t len);
+
+/** Return the number of bytes available to read now.
+ *
+ * @return the number of bytes.
+ */
+size_t simSaraR412mAvailable(void);
+
+/** Return the simulated time at which the next byte from the
+ * module will be available.
+ *
+ * @return the time in microseconds (see hostTimeUs()) or -1
+ *         if nothing is pending.
+ */
+int64_t simSaraR412mNextReadyUs(void);
+
+/** Get the statistics gathered so far.
+ *
+ * @param pStats place to put the statistics.
+ */
+void simSaraR412mGetStats(SimSaraR412mStats *pStats);
+
+#endif // _SIM_SARA_R412M_H_
+
+// End Of File
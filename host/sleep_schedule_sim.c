@@ -0,0 +1,357 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+/* Replays a week of wake-ups through the sleep scheduler in
+ * main/sleep_scheduler.c, making the same calls as app_main(), and
+ * reports the number of wakes and the modem-on time for a range of
+ * coalescing tolerances, alongside the fixed 60 second sleep with
+ * a report every tenth wake that the scheduler replaced, e.g.:
+ *
+ * ./sleep_schedule_sim -w 70 -r 600 -l 3600 -m 10 -e 0.5
+ *
+ * Without options a few typical sets of WHRE Operating Parameters
+ * are replayed.  Accelerometer wakes arrive at random, at the
+ * given rate per hour; the time each kind of wake takes is a
+ * model, see the constants below, not a measurement: use
+ * host/whre_host for that.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include "sleep_scheduler.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// The length of a replay.
+#define REPLAY_SECONDS (7 * 24 * 60 * 60)
+
+// How long a wake takes, awake, when it only takes a sample.
+#define SAMPLE_WAKE_SECONDS 1
+
+// How long the modem is on for a report.
+#define MODEM_SESSION_SECONDS 30
+
+// How much longer the modem is on when a location fix is wanted.
+#define LOCATION_FIX_SECONDS 20
+
+// How long a wake takes, awake, on top of the modem-on time.
+#define MODEM_WAKE_OVERHEAD_SECONDS 2
+
+// How long a wake which has nothing to do takes, awake.
+#define IDLE_WAKE_SECONDS 0.2
+
+// What the fixed schedule did: sleep for a minute, report every
+// tenth wake and on every accelerometer wake.
+#define FIXED_SLEEP_SECONDS 60
+#define FIXED_REPORT_INTERVAL 10
+
+// The coalescing tolerances tried.
+static const int32_t gTolerances[] = {0, 5, 15, 30, 60};
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+// A set of WHRE Operating Parameters plus the location fix interval
+// and the rate of accelerometer wakes.
+typedef struct {
+    const char *pName;
+    int32_t wakeUpIntervalSeconds;
+    int32_t reportingIntervalSeconds;
+    int32_t locationIntervalSeconds;
+    int32_t minSleepSeconds;
+    int32_t minModemUpSeconds;
+    double eventsPerHour;
+} Scenario;
+
+// What happened over a replay.
+typedef struct {
+    int32_t wakes;
+    int32_t modemWakes;
+    int32_t sampleWakes;
+    int32_t idleWakes;      // Woke with nothing to do.
+    int32_t deferredEvents; // Accelerometer wakes put off.
+    int32_t longestSampleGapSeconds;
+    double modemOnSeconds;
+    double awakeSeconds;
+} Result;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// The time of the next accelerometer wake after a given time.
+static double nextEvent(double timeSeconds, double eventsPerHour)
+{
+    double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+    if (eventsPerHour <= 0) {
+        return REPLAY_SECONDS * 2.0;
+    }
+
+    return timeSeconds - log(u) * 3600 / eventsPerHour;
+}
+
+// Add the time of a sample to the result.
+static void sampleTaken(Result *pResult, double timeSeconds, double *pLastSample)
+{
+    int32_t gap = (int32_t) (timeSeconds - *pLastSample);
+
+    if (gap > pResult->longestSampleGapSeconds) {
+        pResult->longestSampleGapSeconds = gap;
+    }
+    *pLastSample = timeSeconds;
+}
+
+// The time the modem is on for a wake.
+static double modemOnSeconds(const Scenario *pScenario, bool location)
+{
+    double seconds = MODEM_SESSION_SECONDS + (location ? LOCATION_FIX_SECONDS : 0);
+
+    if (seconds < pScenario->minModemUpSeconds) {
+        seconds = pScenario->minModemUpSeconds;
+    }
+
+    return seconds;
+}
+
+// Replay a week with the scheduler, calling it as app_main() does.
+static void replayScheduler(const Scenario *pScenario, int32_t toleranceSeconds,
+                            Result *pResult)
+{
+    SleepScheduler scheduler;
+    double now = 0;
+    double event;
+    double timer = 0;
+    double lastSample = 0;
+    double awake;
+    uint32_t due;
+    bool external;
+    bool modem;
+
+    memset(pResult, 0, sizeof(*pResult));
+    srand(1);
+    event = nextEvent(0, pScenario->eventsPerHour);
+
+    // A cold start
+    sleepSchedulerInit(&scheduler, 0, false);
+    sleepSchedulerSetLimits(&scheduler, pScenario->minSleepSeconds, toleranceSeconds);
+    sleepSchedulerSetInterval(&scheduler, SLEEP_SCHEDULER_ACTIVITY_SAMPLE,
+                              pScenario->wakeUpIntervalSeconds, 0);
+    sleepSchedulerSetInterval(&scheduler, SLEEP_SCHEDULER_ACTIVITY_REPORT,
+                              pScenario->reportingIntervalSeconds, 0);
+    sleepSchedulerSetInterval(&scheduler, SLEEP_SCHEDULER_ACTIVITY_LOCATION,
+                              pScenario->locationIntervalSeconds, 0);
+
+    while (now < REPLAY_SECONDS) {
+        pResult->wakes++;
+        external = false;
+        if (event <= timer) {
+            now = event;
+            event = nextEvent(now, pScenario->eventsPerHour);
+            external = true;
+            if (sleepSchedulerIsTooSoon(&scheduler, (uint32_t) now)) {
+                sleepSchedulerSetDeadline(&scheduler, SLEEP_SCHEDULER_ACTIVITY_I2C_TRIGGER,
+                                          sleepSchedulerMinSleepEnd(&scheduler));
+                pResult->deferredEvents++;
+                external = false;
+            }
+        } else {
+            now = timer;
+        }
+
+        due = sleepSchedulerDue(&scheduler, (uint32_t) now);
+        if (external) {
+            due |= SLEEP_SCHEDULER_BIT(SLEEP_SCHEDULER_ACTIVITY_I2C_TRIGGER);
+        }
+        if (due != 0) {
+            sleepSchedulerWake(&scheduler, (uint32_t) now);
+        }
+        modem = (due & SLEEP_SCHEDULER_MODEM_ACTIVITIES) != 0;
+        if (modem) {
+            // A report runs the I2C commands too
+            pResult->modemWakes++;
+            awake = modemOnSeconds(pScenario,
+                                   (due & SLEEP_SCHEDULER_BIT(SLEEP_SCHEDULER_ACTIVITY_LOCATION)) ||
+                                   external);
+            pResult->modemOnSeconds += awake;
+            awake += MODEM_WAKE_OVERHEAD_SECONDS;
+            sampleTaken(pResult, now, &lastSample);
+        } else if (due & SLEEP_SCHEDULER_BIT(SLEEP_SCHEDULER_ACTIVITY_SAMPLE)) {
+            pResult->sampleWakes++;
+            awake = SAMPLE_WAKE_SECONDS;
+            sampleTaken(pResult, now, &lastSample);
+        } else {
+            pResult->idleWakes++;
+            awake = IDLE_WAKE_SECONDS;
+        }
+        pResult->awakeSeconds += awake;
+        now += awake;
+        sleepSchedulerDone(&scheduler, due, (uint32_t) now);
+        timer = now + sleepSchedulerSleepSeconds(&scheduler, (uint32_t) now);
+    }
+}
+
+// Replay a week with the fixed schedule the scheduler replaced.
+static void replayFixed(const Scenario *pScenario, Result *pResult)
+{
+    double now = 0;
+    double event;
+    double timer = 0;
+    double lastSample = 0;
+    double awake;
+    bool report;
+
+    memset(pResult, 0, sizeof(*pResult));
+    srand(1);
+    event = nextEvent(0, pScenario->eventsPerHour);
+
+    while (now < REPLAY_SECONDS) {
+        report = ((pResult->wakes % FIXED_REPORT_INTERVAL) == 0);
+        if (event <= timer) {
+            now = event;
+            event = nextEvent(now, pScenario->eventsPerHour);
+            report = true;
+        } else {
+            now = timer;
+        }
+        pResult->wakes++;
+        if (report) {
+            // A location fix on every report
+            pResult->modemWakes++;
+            awake = modemOnSeconds(pScenario, true);
+            pResult->modemOnSeconds += awake;
+            awake += MODEM_WAKE_OVERHEAD_SECONDS;
+        } else {
+            pResult->sampleWakes++;
+            awake = SAMPLE_WAKE_SECONDS;
+        }
+        sampleTaken(pResult, now, &lastSample);
+        pResult->awakeSeconds += awake;
+        now += awake;
+        timer = now + FIXED_SLEEP_SECONDS;
+    }
+}
+
+// Print a line of results.
+static void printResult(const char *pName, const Result *pResult)
+{
+    printf("%-10s %7d %7d %7d %7d %7d %9d %9.2f %9.2f\n", pName,
+           pResult->wakes, pResult->modemWakes, pResult->sampleWakes,
+           pResult->idleWakes, pResult->deferredEvents,
+           pResult->longestSampleGapSeconds,
+           pResult->modemOnSeconds / 3600, pResult->awakeSeconds / 3600);
+}
+
+// Replay a scenario with each tolerance.
+static void replay(const Scenario *pScenario)
+{
+    Result result;
+    char name[32];
+
+    printf("%s: wake-up interval %d s, reporting interval %d s, location interval %d s,\n"
+           "minimum sleep %d s, minimum modem up time %d s, %.2f accelerometer wake(s) per hour.\n\n",
+           pScenario->pName, pScenario->wakeUpIntervalSeconds,
+           pScenario->reportingIntervalSeconds, pScenario->locationIntervalSeconds,
+           pScenario->minSleepSeconds, pScenario->minModemUpSeconds,
+           pScenario->eventsPerHour);
+    printf("%-10s %7s %7s %7s %7s %7s %9s %9s %9s\n", "schedule", "wakes", "modem",
+           "sample", "idle", "put off", "max gap s", "modem h", "awake h");
+    replayFixed(pScenario, &result);
+    printResult("fixed", &result);
+    for (size_t x = 0; x < sizeof(gTolerances) / sizeof(gTolerances[0]); x++) {
+        snprintf(name, sizeof(name), "tol %d s", (int) gTolerances[x]);
+        replayScheduler(pScenario, gTolerances[x], &result);
+        printResult(name, &result);
+    }
+    printf("\n");
+}
+
+// Print the usage.
+static void printUsage(const char *pProgramName)
+{
+    fprintf(stderr, "usage: %s [-w s] [-r s] [-l s] [-m s] [-u s] [-e n]\n", pProgramName);
+    fprintf(stderr, "  -w  Host Wake up Interval, seconds.\n");
+    fprintf(stderr, "  -r  Reporting Interval, seconds.\n");
+    fprintf(stderr, "  -l  location fix interval, seconds.\n");
+    fprintf(stderr, "  -m  Host Minimum Sleep Interval, seconds.\n");
+    fprintf(stderr, "  -u  Minimum Modem up Time, seconds.\n");
+    fprintf(stderr, "  -e  accelerometer wakes per hour.\n");
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    Scenario scenarios[] = {
+        // The defaults in main.c
+        {"defaults", 60, 600, 3600, 10, 0, 0.5},
+        // Sampling and reporting intervals which don't line up
+        {"misaligned", 70, 600, 3500, 10, 0, 0.5},
+        // Someone carrying the device about
+        {"busy", 60, 600, 3600, 30, 0, 20}
+    };
+    Scenario scenario = scenarios[0];
+    bool custom = false;
+    int c;
+
+    while ((c = getopt(argc, argv, "w:r:l:m:u:e:h")) != -1) {
+        custom = true;
+        switch (c) {
+            case 'w':
+                scenario.wakeUpIntervalSeconds = atoi(optarg);
+            break;
+            case 'r':
+                scenario.reportingIntervalSeconds = atoi(optarg);
+            break;
+            case 'l':
+                scenario.locationIntervalSeconds = atoi(optarg);
+            break;
+            case 'm':
+                scenario.minSleepSeconds = atoi(optarg);
+            break;
+            case 'u':
+                scenario.minModemUpSeconds = atoi(optarg);
+            break;
+            case 'e':
+                scenario.eventsPerHour = atof(optarg);
+            break;
+            default:
+                printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    printf("A week of wakes: \"fixed\" is a %d second sleep with a report every %d wake(s)"
+           " and on every\naccelerometer wake, \"tol\" the scheduler with the given coalescing"
+           " tolerance.  \"idle\" wakes had\nnothing to do, \"put off\" accelerometer wakes came"
+           " within the minimum sleep, \"max gap\" is the\nlongest time between samples.\n\n",
+           FIXED_SLEEP_SECONDS, FIXED_REPORT_INTERVAL);
+    if (custom) {
+        scenario.pName = "custom";
+        replay(&scenario);
+    } else {
+        for (size_t x = 0; x < sizeof(scenarios) / sizeof(scenarios[0]); x++) {
+            replay(&(scenarios[x]));
+        }
+    }
+
+    return 0;
+}
+
+// End Of File
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+/* Convert the TRACE lines written by traceDump() in a console
+ * log (from IDF Monitor or whre_host -v) into Chrome trace JSON,
+ * which can be loaded into chrome://tracing or
+ * https://ui.perfetto.dev, e.g.:
+ *
+ * ./trace_to_chrome < console.log > trace.json
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "utilities.h"
+#include "trace.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// The longest console line handled.
+#define MAX_LINE_LENGTH 4096
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    FILE *pFile = stdin;
+    char line[MAX_LINE_LENGTH];
+    char binary[MAX_LINE_LENGTH / 2];
+    TraceSpan spans[TRACE_MAX_SPANS];
+    const char *pHex;
+    int32_t length;
+    int32_t numSpans;
+    int32_t numWakes = 0;
+    uint32_t wakeTimeSeconds;
+    bool first = true;
+
+    if (argc > 1) {
+        pFile = fopen(argv[1], "r");
+        if (pFile == NULL) {
+            fprintf(stderr, "unable to open \"%s\".\n", argv[1]);
+            return 1;
+        }
+    }
+
+    printf("{\"traceEvents\":[\n");
+    while (fgets(line, sizeof(line), pFile) != NULL) {
+        pHex = strstr(line, TRACE_CONSOLE_PREFIX);
+        if (pHex == NULL) {
+            continue;
+        }
+        pHex += strlen(TRACE_CONSOLE_PREFIX);
+        length = utilitiesHexStringToBytes(pHex, strcspn(pHex, "\r\n"),
+                                           binary, sizeof(binary));
+        numSpans = traceDecode(binary, length, &wakeTimeSeconds, spans, ARRAY_SIZE(spans));
+        if (numSpans < 0) {
+            fprintf(stderr, "skipping invalid trace line.\n");
+            continue;
+        }
+        numWakes++;
+        for (int32_t x = 0; x < numSpans; x++) {
+            // Complete ("X") events; the thread ID keeps each
+            // wake on its own row
+            printf("%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                   "\"ts\":%llu,\"dur\":%u,\"args\":{\"depth\":%u}}",
+                   first ? "" : ",\n", pTraceName(spans[x].id), numWakes,
+                   ((unsigned long long) wakeTimeSeconds) * 1000000 + spans[x].startUs,
+                   (spans[x].durationUs == 0xFFFFFFFF) ? 0 : spans[x].durationUs,
+                   spans[x].depth);
+            first = false;
+        }
+    }
+    printf("\n],\"displayTimeUnit\":\"ms\"}\n");
+    fprintf(stderr, "%d wake cycle(s) converted.\n", numWakes);
+
+    if (pFile != stdin) {
+        fclose(pFile);
+    }
+
+    return 0;
+}
+
+// End Of File
@@ -0,0 +1,434 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+/* Compression and throughput benchmark of main/ts_codec.c on
+ * sensor traces, e.g.:
+ *
+ * ./ts_codec_bench [-b batch_size] [trace.csv ...]
+ *
+ * A trace file has one reading per line: the time in seconds then
+ * a value per channel, comma separated; values containing a '.'
+ * make it a float trace.  Without trace files a week of readings
+ * at the default 60 second wake interval is synthesised for an
+ * SHTC1 (temperature and humidity, as raw ticks and as floats)
+ * and a LIS2DW (X/Y/Z in mg): the quantisation, noise and drift
+ * are those of the real parts, the timing has the odd second of
+ * jitter and the odd missed wake.
+ *
+ * Each trace is encoded in batches of at most batch_size bytes,
+ * as it would be sent, and decoded again to check it.  Sizes are
+ * compared with plain binary, a 4-byte time and 4 bytes per value;
+ * throughput is in millions of readings per second.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "ts_codec.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// The default batch size in bytes, as SAMPLE_BATCH_MAX_SIZE.
+#define DEFAULT_BATCH_SIZE 256
+
+// The number of readings in a synthesised trace: a week at 60 s.
+#define NUM_SYNTH_READINGS (7 * 24 * 60)
+
+// The wake interval of a synthesised trace.
+#define SYNTH_INTERVAL_SECONDS 60
+
+// The most readings in a trace file.
+#define MAX_READINGS 1000000
+
+// The number of times a trace is encoded and decoded for timing.
+#define NUM_TIMING_RUNS 20
+
+// The longest trace file line handled.
+#define MAX_LINE_LENGTH 1024
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+// A trace.
+typedef struct {
+    const char *pName;
+    int32_t numReadings;
+    int32_t numChannels;
+    bool isFloat;
+    uint32_t *pTimes;
+    TsCodecValue *pValues; // numChannels per reading
+} Trace;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Real monotonic time in nanoseconds.
+static int64_t timeNs()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((int64_t) now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+// A normally distributed random number.
+static double gaussian()
+{
+    double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+    return sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+// Allocate storage for a trace.
+static bool traceAlloc(Trace *pTrace, const char *pName, int32_t numReadings,
+                       int32_t numChannels, bool isFloat)
+{
+    pTrace->pName = pName;
+    pTrace->numReadings = numReadings;
+    pTrace->numChannels = numChannels;
+    pTrace->isFloat = isFloat;
+    pTrace->pTimes = malloc(numReadings * sizeof(pTrace->pTimes[0]));
+    pTrace->pValues = malloc(numReadings * numChannels * sizeof(pTrace->pValues[0]));
+
+    return (pTrace->pTimes != NULL) && (pTrace->pValues != NULL);
+}
+
+// Free a trace.
+static void traceFree(Trace *pTrace)
+{
+    free(pTrace->pTimes);
+    free(pTrace->pValues);
+}
+
+// Synthesise wake times: mostly on the interval, sometimes a
+// second out, occasionally a wake missed.
+static void synthTimes(Trace *pTrace)
+{
+    uint32_t timeSeconds = 1700000000;
+
+    for (int32_t x = 0; x < pTrace->numReadings; x++) {
+        timeSeconds += SYNTH_INTERVAL_SECONDS;
+        if ((rand() % 10) == 0) {
+            timeSeconds += (rand() % 3) - 1;
+        }
+        if ((rand() % 100) == 0) {
+            timeSeconds += SYNTH_INTERVAL_SECONDS;
+        }
+        pTrace->pTimes[x] = timeSeconds;
+    }
+}
+
+// Synthesise SHTC1 temperature and humidity: a daily cycle plus
+// drift plus noise, quantised to the 16-bit ticks of the part.
+// If isFloat the values are converted to degrees C and %RH as
+// the datasheet formulae would.
+static bool synthShtc1(Trace *pTrace, bool isFloat)
+{
+    double driftC = 0;
+    double temperatureC;
+    double humidityPercent;
+    int32_t ticksT;
+    int32_t ticksRh;
+
+    if (!traceAlloc(pTrace, isFloat ? "SHTC1 float" : "SHTC1 ticks",
+                    NUM_SYNTH_READINGS, 2, isFloat)) {
+        return false;
+    }
+    srand(1);
+    synthTimes(pTrace);
+    for (int32_t x = 0; x < pTrace->numReadings; x++) {
+        driftC += gaussian() * 0.02;
+        temperatureC = 21 + driftC + 3 * sin(2 * M_PI * pTrace->pTimes[x] / 86400) +
+                       gaussian() * 0.05;
+        humidityPercent = 45 - 2 * driftC - 8 * sin(2 * M_PI * pTrace->pTimes[x] / 86400) +
+                          gaussian() * 0.2;
+        ticksT = (int32_t) ((temperatureC + 45) * 65536 / 175);
+        ticksRh = (int32_t) (humidityPercent * 65536 / 100);
+        if (isFloat) {
+            pTrace->pValues[x * 2].number = -45 + 175 * (float) ticksT / 65536;
+            pTrace->pValues[x * 2 + 1].number = 100 * (float) ticksRh / 65536;
+        } else {
+            pTrace->pValues[x * 2].integer = ticksT;
+            pTrace->pValues[x * 2 + 1].integer = ticksRh;
+        }
+    }
+
+    return true;
+}
+
+// Synthesise LIS2DW X/Y/Z in mg: lying still with a little
+// noise, occasionally knocked into a new orientation.
+static bool synthLis2dw(Trace *pTrace)
+{
+    double axes[3] = {12, -30, 998};
+    double angle;
+
+    if (!traceAlloc(pTrace, "LIS2DW mg", NUM_SYNTH_READINGS, 3, false)) {
+        return false;
+    }
+    srand(2);
+    synthTimes(pTrace);
+    for (int32_t x = 0; x < pTrace->numReadings; x++) {
+        if ((rand() % 500) == 0) {
+            angle = (rand() % 628) / 100.0;
+            axes[0] = 1000 * sin(angle) * 0.3;
+            axes[1] = 1000 * cos(angle) * 0.3;
+            axes[2] = sqrt(1000000 - axes[0] * axes[0] - axes[1] * axes[1]);
+        }
+        for (int32_t y = 0; y < 3; y++) {
+            // 14-bit output at +/-2 g is 0.244 mg per LSB
+            pTrace->pValues[x * 3 + y].integer = (int32_t) (axes[y] + gaussian() * 4);
+        }
+    }
+
+    return true;
+}
+
+// Load a trace from a CSV file.
+static bool loadTrace(Trace *pTrace, const char *pFileName)
+{
+    FILE *pFile;
+    char line[MAX_LINE_LENGTH];
+    char *pField;
+    char *pSave;
+    int32_t numChannels;
+    int32_t numReadings = 0;
+
+    pFile = fopen(pFileName, "r");
+    if (pFile == NULL) {
+        fprintf(stderr, "unable to open \"%s\".\n", pFileName);
+        return false;
+    }
+    // The first line sets the number of channels and the type
+    if (fgets(line, sizeof(line), pFile) == NULL) {
+        fclose(pFile);
+        return false;
+    }
+    numChannels = 0;
+    for (char *p = strchr(line, ','); p != NULL; p = strchr(p + 1, ',')) {
+        numChannels++;
+    }
+    if ((numChannels < 1) || (numChannels > TS_CODEC_MAX_CHANNELS) ||
+        !traceAlloc(pTrace, pFileName, MAX_READINGS, numChannels,
+                    strchr(strchr(line, ','), '.') != NULL)) {
+        fprintf(stderr, "\"%s\" is not a trace.\n", pFileName);
+        fclose(pFile);
+        return false;
+    }
+    do {
+        pField = strtok_r(line, ",\r\n", &pSave);
+        if (pField == NULL) {
+            continue;
+        }
+        pTrace->pTimes[numReadings] = (uint32_t) strtoul(pField, NULL, 10);
+        for (int32_t x = 0; x < numChannels; x++) {
+            pField = strtok_r(NULL, ",\r\n", &pSave);
+            if (pTrace->isFloat) {
+                pTrace->pValues[numReadings * numChannels + x].number = (pField != NULL) ? strtof(pField, NULL) : 0;
+            } else {
+                pTrace->pValues[numReadings * numChannels + x].integer = (pField != NULL) ? strtol(pField, NULL, 10) : 0;
+            }
+        }
+        numReadings++;
+    } while ((numReadings < MAX_READINGS) && (fgets(line, sizeof(line), pFile) != NULL));
+    fclose(pFile);
+    pTrace->numReadings = numReadings;
+
+    return true;
+}
+
+// Encode a trace in batches of batchSize bytes into pOut, each
+// batch preceded by its length as a uint16_t; returns the bytes
+// of pOut used, not counting the lengths, or negative on error.
+static int32_t encodeTrace(const Trace *pTrace, uint32_t flags, int32_t batchSize,
+                           uint8_t *pOut, int32_t *pOutLength, int32_t *pNumBatches)
+{
+    TsCodec codec;
+    uint16_t length;
+    int32_t encodedBytes = 0;
+    int32_t used = 0;
+    int32_t x = 0;
+
+    *pNumBatches = 0;
+    while (x < pTrace->numReadings) {
+        if (tsCodecEncodeStart(&codec, pOut + used + sizeof(length), batchSize,
+                               pTrace->numChannels, flags) != 0) {
+            return -1;
+        }
+        while ((x < pTrace->numReadings) &&
+               (tsCodecEncode(&codec, pTrace->pTimes[x],
+                              pTrace->pValues + x * pTrace->numChannels) == 0)) {
+            x++;
+        }
+        length = (uint16_t) tsCodecEncodedLength(&codec);
+        if (length == 0) {
+            // Batch too small for even one reading
+            return -1;
+        }
+        memcpy(pOut + used, &length, sizeof(length));
+        used += sizeof(length) + length;
+        encodedBytes += length;
+        (*pNumBatches)++;
+    }
+    *pOutLength = used;
+
+    return encodedBytes;
+}
+
+// Decode what encodeTrace() produced, checking it against the
+// trace; returns false if it doesn't match.
+static bool decodeTrace(const Trace *pTrace, const uint8_t *pIn, int32_t inLength)
+{
+    TsCodec codec;
+    TsCodecValue values[TS_CODEC_MAX_CHANNELS];
+    uint32_t timeSeconds;
+    uint16_t length;
+    int32_t used = 0;
+    int32_t x = 0;
+    int32_t result;
+
+    while (used < inLength) {
+        memcpy(&length, pIn + used, sizeof(length));
+        used += sizeof(length);
+        if (tsCodecDecodeStart(&codec, pIn + used, length) != 0) {
+            return false;
+        }
+        while ((result = tsCodecDecode(&codec, &timeSeconds, values)) > 0) {
+            if ((x >= pTrace->numReadings) || (timeSeconds != pTrace->pTimes[x]) ||
+                (memcmp(values, pTrace->pValues + x * pTrace->numChannels,
+                        pTrace->numChannels * sizeof(values[0])) != 0)) {
+                return false;
+            }
+            x++;
+        }
+        if (result < 0) {
+            return false;
+        }
+        used += length;
+    }
+
+    return (x == pTrace->numReadings);
+}
+
+// Benchmark one trace with one set of flags.
+static void bench(const Trace *pTrace, uint32_t flags, int32_t batchSize)
+{
+    int32_t rawBytes = pTrace->numReadings * (4 + pTrace->numChannels * 4);
+    int32_t outSize = rawBytes * 2 + 1024;
+    uint8_t *pOut = malloc(outSize);
+    int32_t outLength = 0;
+    int32_t encodedBytes = 0;
+    int32_t numBatches = 0;
+    int64_t startNs;
+    int64_t encodeNs;
+    int64_t decodeNs;
+    bool ok;
+
+    if (pOut == NULL) {
+        return;
+    }
+
+    startNs = timeNs();
+    for (int32_t x = 0; x < NUM_TIMING_RUNS; x++) {
+        encodedBytes = encodeTrace(pTrace, flags, batchSize, pOut, &outLength, &numBatches);
+    }
+    encodeNs = (timeNs() - startNs) / NUM_TIMING_RUNS;
+    ok = (encodedBytes > 0);
+    startNs = timeNs();
+    for (int32_t x = 0; ok && (x < NUM_TIMING_RUNS); x++) {
+        ok = decodeTrace(pTrace, pOut, outLength);
+    }
+    decodeNs = (timeNs() - startNs) / NUM_TIMING_RUNS;
+
+    if (ok) {
+        printf("%-14s %-9s %8d %8d %8d %7.2f %6.2f %9.1f %9.1f\n", pTrace->pName,
+               (flags & TS_CODEC_FLAG_XOR) ? "float-xor" :
+               (flags & TS_CODEC_FLAG_FLOAT) ? "float" : "int",
+               pTrace->numReadings, numBatches, encodedBytes,
+               (double) encodedBytes / pTrace->numReadings,
+               (double) rawBytes / encodedBytes,
+               (double) pTrace->numReadings * 1000 / (encodeNs + 1),
+               (double) pTrace->numReadings * 1000 / (decodeNs + 1));
+    } else {
+        printf("%-14s %-9s FAILED: %s\n", pTrace->pName,
+               (flags & TS_CODEC_FLAG_XOR) ? "float-xor" :
+               (flags & TS_CODEC_FLAG_FLOAT) ? "float" : "int",
+               (encodedBytes > 0) ? "decoded readings don't match" : "unable to encode");
+    }
+
+    free(pOut);
+}
+
+// Benchmark a trace with every set of flags that suits it.
+static void benchTrace(const Trace *pTrace, int32_t batchSize)
+{
+    if (pTrace->isFloat) {
+        bench(pTrace, TS_CODEC_FLAG_FLOAT, batchSize);
+        bench(pTrace, TS_CODEC_FLAG_FLOAT | TS_CODEC_FLAG_XOR, batchSize);
+    } else {
+        bench(pTrace, 0, batchSize);
+    }
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    int32_t batchSize = DEFAULT_BATCH_SIZE;
+    int32_t numFiles = 0;
+    Trace trace;
+    int x = 1;
+
+    if ((argc > 2) && (strcmp(argv[1], "-b") == 0)) {
+        batchSize = atoi(argv[2]);
+        x = 3;
+    }
+
+    printf("batches of at most %d byte(s); raw is a 4-byte time and 4 bytes per value.\n\n",
+           batchSize);
+    printf("%-14s %-9s %8s %8s %8s %7s %6s %9s %9s\n", "trace", "encoding",
+           "readings", "batches", "bytes", "B/rdg", "ratio", "enc M/s", "dec M/s");
+    for (; x < argc; x++) {
+        if (loadTrace(&trace, argv[x])) {
+            benchTrace(&trace, batchSize);
+            traceFree(&trace);
+        }
+        numFiles++;
+    }
+    if (numFiles == 0) {
+        if (synthShtc1(&trace, false)) {
+            benchTrace(&trace, batchSize);
+        }
+        traceFree(&trace);
+        if (synthShtc1(&trace, true)) {
+            benchTrace(&trace, batchSize);
+        }
+        traceFree(&trace);
+        if (synthLis2dw(&trace)) {
+            benchTrace(&trace, batchSize);
+        }
+        traceFree(&trace);
+    }
+
+    return 0;
+}
+
+// End Of File
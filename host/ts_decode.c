@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+/* Decode batches of readings encoded by main/ts_codec.c, as read
+ * from the Sample Batch resource of the I2C Generic Command object,
+ * into CSV.  Each batch is given in hex, either on the command
+ * line or one per line on stdin, e.g.:
+ *
+ * ./ts_decode 1002e0b5f3650a0b00000000
+ * ./ts_decode < batches.txt > readings.csv
+ *
+ * Each CSV line is the batch number, the time in seconds and then
+ * a value per channel.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "utilities.h"
+#include "ts_codec.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// The longest input line handled.
+#define MAX_LINE_LENGTH 8192
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Decode a batch given in hex, printing it as CSV; returns the
+// number of readings or negative on error.
+static int32_t decodeHex(const char *pHex, int32_t batchNumber)
+{
+    char binary[MAX_LINE_LENGTH / 2];
+    TsCodec codec;
+    TsCodecValue values[TS_CODEC_MAX_CHANNELS];
+    uint32_t timeSeconds;
+    int32_t length;
+    int32_t numReadings = 0;
+    int32_t result;
+
+    length = utilitiesHexStringToBytes(pHex, strcspn(pHex, " \t\r\n"),
+                                       binary, sizeof(binary));
+    result = tsCodecDecodeStart(&codec, (const uint8_t *) binary, length);
+    while (result >= 0) {
+        result = tsCodecDecode(&codec, &timeSeconds, values);
+        if (result > 0) {
+            printf("%d,%u", batchNumber, timeSeconds);
+            for (int32_t x = 0; x < tsCodecNumChannels(&codec); x++) {
+                if (tsCodecFlags(&codec) & TS_CODEC_FLAG_FLOAT) {
+                    printf(",%.9g", values[x].number);
+                } else {
+                    printf(",%d", values[x].integer);
+                }
+            }
+            printf("\n");
+            numReadings++;
+        } else if (result == 0) {
+            result = numReadings;
+            break;
+        }
+    }
+
+    return result;
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    char line[MAX_LINE_LENGTH];
+    const char *pHex;
+    int32_t numBatches = 0;
+    int32_t numBad = 0;
+
+    if (argc > 1) {
+        for (int32_t x = 1; x < argc; x++) {
+            if (decodeHex(argv[x], numBatches) < 0) {
+                fprintf(stderr, "batch %d is not valid.\n", numBatches);
+                numBad++;
+            }
+            numBatches++;
+        }
+    } else {
+        while (fgets(line, sizeof(line), stdin) != NULL) {
+            pHex = line + strspn(line, " \t");
+            if ((*pHex == '\r') || (*pHex == '\n') || (*pHex == 0)) {
+                continue;
+            }
+            if (decodeHex(pHex, numBatches) < 0) {
+                fprintf(stderr, "batch %d is not valid.\n", numBatches);
+                numBad++;
+            }
+            numBatches++;
+        }
+    }
+
+    return (numBad == 0) ? 0 : 1;
+}
+
+// End Of File
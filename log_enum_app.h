@@ -1,6 +1,8 @@
 /** You must provide a log_enum_app.h file containing your
- * application's log events.  This is a sample of the format.
- * It must be kept in line with the strings in log_strings_app.h.
+ * application's log events.  It is generated from the list in
+ * log_events_app.h, as are the strings in log_strings_app.h.
  */
-    EVENT_SYSTEM_VERSION
-
+#include "log_events_app.h"
+#define LOG_EVENT_APP_ENUM(event, string) event,
+    LOG_EVENTS_APP(LOG_EVENT_APP_ENUM)
+#undef LOG_EVENT_APP_ENUM
\ No newline at end of file
@@ -0,0 +1,22 @@
+/** The application's log events, X(event, string) for each: the
+ * enum in log_enum_app.h and the strings in log_strings_app.h are
+ * both generated from this one list, so they can't get out of
+ * step.  The position of an event in the list is also its number
+ * in the flash event log (main/flash_log.h), which is decoded long
+ * after it was written, so add new events at the end and never
+ * remove one.  This file may be included anywhere, even inside the
+ * log component's enum, so it must contain only the list.
+ */
+#ifndef _LOG_EVENTS_APP_H_
+#define _LOG_EVENTS_APP_H_
+
+#define LOG_EVENTS_APP(X) \
+    X(EVENT_SYSTEM_VERSION,        "  SYSTEM_VERSION") \
+    X(EVENT_WAKE_CAUSE,            "  WAKE_CAUSE") \
+    X(EVENT_REGISTERED_MS,         "  REGISTERED_MS") \
+    X(EVENT_REGISTRATION_FAILED,   "  REGISTRATION_FAILED") \
+    X(EVENT_LWM2M_UPDATE_FAILED,   "  LWM2M_UPDATE_FAILED") \
+    X(EVENT_REPORT_SUPPRESSED,     "  REPORT_SUPPRESSED") \
+    X(EVENT_SLEEP_SECONDS,         "  SLEEP_SECONDS")
+
+#endif // _LOG_EVENTS_APP_H_
@@ -1,5 +1,9 @@
 /** You must provide a log_strings_app.h file containing the strings
- * that match your application's log events.  This is a sample of the format.
- * It must be kept in line with the strings in log_enum_app.h.
+ * that match your application's log events.  They are generated
+ * from the list in log_events_app.h, as is the enum in
+ * log_enum_app.h.
  */
-    "  SYSTEM_VERSION"
\ No newline at end of file
+#include "log_events_app.h"
+#define LOG_EVENT_APP_STRING(event, string) string,
+    LOG_EVENTS_APP(LOG_EVENT_APP_STRING)
+#undef LOG_EVENT_APP_STRING
\ No newline at end of file
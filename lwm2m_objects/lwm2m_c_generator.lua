@@ -0,0 +1,587 @@
+-- --------------------------------------------------------------------
+--                   LwM2M Object C Header Generator
+--
+-- The C counterpart of lwm2m_object_generator.lua: from the same
+-- XML definition it writes lwm2m_object_<name>.h, giving the OMA
+-- ID and resource IDs of the object, a structure holding its
+-- resources, a static const table describing them to
+-- main/lwm2m_object_desc.c and one bulk create, write and read
+-- function for the object.  See README.md.
+--
+-- usage: lua lwm2m_c_generator.lua <in_file> [<out_dir>]
+--                                  [<n> | <resource ID>=<n> ...]
+--
+-- where <n> is the most instances of a multiple-instance resource
+-- the structure holds: a bare <n> for all of them, <resource ID>=<n>
+-- for one; the default is 8.
+-- --------------------------------------------------------------------
+local script_version = "1.1"
+
+-- The most instances of a multiple-instance resource, unless told
+local default_max_instances = 8
+
+-- Resource types in the XML and how they are held in C
+local types = {
+   Integer = {ctype = "int32_t", lwm2m = "LWM2M_RESOURCE_TYPE_INTEGER"},
+   Time    = {ctype = "int32_t", lwm2m = "LWM2M_RESOURCE_TYPE_INTEGER"},
+   Float   = {ctype = "float", lwm2m = "LWM2M_RESOURCE_TYPE_FLOAT"},
+   Boolean = {ctype = "bool", lwm2m = "LWM2M_RESOURCE_TYPE_BOOLEAN"},
+   String  = {ctype = "Lwm2mObjectDescString", lwm2m = "LWM2M_RESOURCE_TYPE_STRING"},
+   Opaque  = {ctype = "Lwm2mObjectDescOpaque", lwm2m = "LWM2M_RESOURCE_TYPE_OPAQUE"}
+}
+
+-- The largest resource ID, as LWM2M_OBJECT_DESC_MAX_RESOURCE_ID
+local max_resource_id = 31
+
+-- ----------------------------------------------------
+-- parseargs: parses XML tag arguments, as
+-- lwm2m_object_generator.lua
+-- @param s: the argument string to parse
+-- @return arguments in table form
+-- ----------------------------------------------------
+local function parseargs(s)
+  local arg = {}
+  string.gsub(s, "([%-%w]+)=([\"'])(.-)%2", function (w, _, a)
+    arg[w] = a
+  end)
+  return arg
+end
+
+-- ----------------------------------------------------
+-- parse: parses an XML document, as lwm2m_object_generator.lua
+-- but with CDATA sections taken as text
+-- @param s: the XML document to parse
+-- @return the XML document in table form
+-- ----------------------------------------------------
+local function parse(s)
+  local stack = {}
+  local top = {Name=nil,Value=nil,Attributes={},ChildNodes={}}
+  table.insert(stack, top)
+  local ni,c,label,xarg, empty
+  local i, j = 1, 1
+  s = string.gsub(s, "<!%[CDATA%[(.-)%]%]>", function (text)
+    return (string.gsub(string.gsub(string.gsub(text, "&", "&amp;"), "<", "&lt;"), ">", "&gt;"))
+  end)
+  while true do
+    ni,j,c,label,xarg, empty = string.find(s, "<(%/?)([%w:]+)(.-)(%/?)>", i)
+    if not ni then break end
+    local text = string.sub(s, i, ni-1)
+    if not string.find(text, "^%s*$") then
+      top.Value=(top.Value or "").. text
+    end
+    if empty == "/" then  -- empty element tag
+      table.insert(top.ChildNodes, {Name=label, Value=nil,Attributes=parseargs(xarg), ChildNodes={}})
+    elseif c == "" then   -- start tag
+      top = {Name=label, Value=nil,Attributes=parseargs(xarg), ChildNodes={}}
+      table.insert(stack, top)   -- new level
+    else  -- end tag
+      local toclose = table.remove(stack)  -- remove top
+      top = stack[#stack]
+      if #stack < 1 then
+        error("nothing to close with "..label)
+      end
+      if toclose.Name ~= label then
+        error("trying to close "..toclose.Name.." with "..label)
+      end
+      table.insert(top.ChildNodes, toclose)
+    end
+    i = j+1
+  end
+  if #stack > 1 then
+    error("unclosed "..stack[#stack].Name)
+  end
+
+  return stack[1].ChildNodes[1];
+end
+
+-- --------------------------------------------------------------------
+-- find_tag: finds a tag at the given level
+-- @param xml: the XML document
+-- @param tag: the tag to find
+-- @return the node containing the requested tag or nil
+-- --------------------------------------------------------------------
+local function find_tag(xml,tag)
+
+ for i,node in ipairs(xml.ChildNodes) do
+   if(node.Name == tag) then
+      return node
+   end
+ end
+end
+
+-- --------------------------------------------------------------------
+-- tag_value: the text of a tag
+-- @param xml: the XML node containing the tag
+-- @param tag: the tag
+-- @return the text, without XML escapes or surrounding white space,
+--         or "" if there is none
+-- --------------------------------------------------------------------
+local function tag_value(xml, tag)
+
+   local node = find_tag(xml, tag)
+   local s = ""
+
+   if node ~= nil and node.Value ~= nil then
+      s = string.gsub(node.Value, "&lt;", "<")
+      s = string.gsub(s, "&gt;", ">")
+      s = string.gsub(s, "&amp;", "&")
+      s = string.gsub(s, "^%s+", "")
+      s = string.gsub(s, "%s+$", "")
+   end
+
+   return s
+end
+
+-- --------------------------------------------------------------------
+-- words: splits a name into words
+-- @param name: the name, e.g. "Device I2C Address"
+-- @return a table of the words
+-- --------------------------------------------------------------------
+local function words(name)
+
+   local t = {}
+
+   for w in string.gmatch(name, "%w+") do
+      table.insert(t, w)
+   end
+
+   return t
+end
+
+-- --------------------------------------------------------------------
+-- macro_name: a name as a C macro, e.g. DEVICE_I2C_ADDRESS
+-- --------------------------------------------------------------------
+local function macro_name(name)
+   return string.upper(table.concat(words(name), "_"))
+end
+
+-- --------------------------------------------------------------------
+-- pascal_name: a name as a C type, e.g. DeviceI2cAddress
+-- --------------------------------------------------------------------
+local function pascal_name(name)
+
+   local s = ""
+
+   for i, w in ipairs(words(name)) do
+      s = s .. string.upper(string.sub(w, 1, 1)) .. string.lower(string.sub(w, 2))
+   end
+
+   return s
+end
+
+-- --------------------------------------------------------------------
+-- camel_name: a name as a C variable, e.g. deviceI2cAddress
+-- --------------------------------------------------------------------
+local function camel_name(name)
+
+   local s = pascal_name(name)
+   local first = words(name)[1]
+
+   return string.lower(first) .. string.sub(s, string.len(first) + 1)
+end
+
+-- --------------------------------------------------------------------
+-- wrap: wraps text into lines of a comment
+-- @param text: the text
+-- @param prefix: the start of each line, e.g. " * "
+-- @param width: the longest a line may be
+-- @return the lines, each ending with a newline
+-- --------------------------------------------------------------------
+local function wrap(text, prefix, width)
+
+   local s = ""
+   local line = ""
+
+   for w in string.gmatch(text, "%S+") do
+      if line ~= "" and string.len(prefix) + string.len(line) + 1 + string.len(w) > width then
+         s = s .. prefix .. line .. "\n"
+         line = w
+      elseif line == "" then
+         line = w
+      else
+         line = line .. " " .. w
+      end
+   end
+   if line ~= "" then
+      s = s .. prefix .. line .. "\n"
+   end
+
+   return s
+end
+
+-- --------------------------------------------------------------------
+-- pad: pads a string with spaces
+-- --------------------------------------------------------------------
+local function pad(s, n)
+   return s .. string.rep(" ", n - string.len(s))
+end
+
+-- --------------------------------------------------------------------
+-- read_resources: reads the resources of an object
+-- @param object_node: the Object node of the XML document
+-- @param max_instances: table of the most instances of each
+--        multiple-instance resource, by ID, with the default at [0]
+-- @return a table of the resources, in order of ID
+-- --------------------------------------------------------------------
+local function read_resources(object_node, max_instances)
+
+   local resources = {}
+
+   for i, node in ipairs(find_tag(object_node, "Resources").ChildNodes) do
+      if node.Name == "Item" then
+         local r = {}
+         r.id = tonumber(node.Attributes.ID)
+         r.name = tag_value(node, "Name")
+         r.operations = tag_value(node, "Operations")
+         r.multiple = (tag_value(node, "MultipleInstances") == "Multiple")
+         r.mandatory = (tag_value(node, "Mandatory") == "Mandatory")
+         r.type = tag_value(node, "Type")
+         r.units = tag_value(node, "Units")
+         if r.id == nil or r.id > max_resource_id then
+            error("resource \"" .. r.name .. "\" has an ID which is not from 0 to " .. max_resource_id)
+         end
+         if types[r.type] == nil then
+            error("resource \"" .. r.name .. "\" is of type \"" .. r.type .. "\", which is not supported")
+         end
+         if r.multiple then
+            r.max_instances = max_instances[r.id] or max_instances[0]
+         end
+         table.insert(resources, r)
+      end
+   end
+   table.sort(resources, function (a, b) return a.id < b.id end)
+
+   return resources
+end
+
+-- --------------------------------------------------------------------
+-- operations: the C operation bits of a resource
+-- --------------------------------------------------------------------
+local function operations(r)
+
+   local t = {}
+
+   for op in string.gmatch(r.operations, "[RWE]") do
+      table.insert(t, "LWM2M_OBJECT_DESC_OPERATION_" .. op)
+   end
+   if #t == 0 then
+      return "0"
+   end
+
+   return table.concat(t, " | ")
+end
+
+-- --------------------------------------------------------------------
+--                         Main
+-- --------------------------------------------------------------------
+
+if arg[1] == nil then
+   print ("usage: lua " .. arg[0] .. " <in_file> [<out_dir>] [<n> | <resource ID>=<n> ...]")
+   return
+end
+
+local in_file = arg[1]
+local out_dir = "."
+local max_instances = {[0] = default_max_instances}
+local command = "lwm2m_c_generator.lua " .. string.gsub(in_file, "^.*[/\\]", "")
+
+for i = 2, #arg do
+   local id, n = string.match(arg[i], "^(%d+)=(%d+)$")
+   if id ~= nil then
+      max_instances[tonumber(id)] = tonumber(n)
+      command = command .. " " .. arg[i]
+   elseif string.match(arg[i], "^%d+$") then
+      max_instances[0] = tonumber(arg[i])
+      command = command .. " " .. arg[i]
+   elseif i == 2 then
+      out_dir = arg[i]
+   else
+      error("don't understand \"" .. arg[i] .. "\"")
+   end
+end
+
+local file = io.open(in_file, "r")
+if file == nil then
+   error("unable to open " .. in_file)
+end
+local xml = parse(file:read("*a"))
+file:close()
+
+local object_node = find_tag(xml, "Object")
+local name = tag_value(object_node, "Name")
+local description = tag_value(object_node, "Description1")
+local object_id = tag_value(object_node, "ObjectID")
+local object_version = tag_value(object_node, "ObjectVersion")
+local resources = read_resources(object_node, max_instances)
+
+local file_name = string.format("lwm2m_object_%s.h", string.lower(table.concat(words(name), "_")))
+local guard = string.format("_LWM2M_OBJECT_%s_H_", macro_name(name))
+local prefix = "LWM2M_" .. macro_name(name)
+local type_name = "Lwm2m" .. pascal_name(name)
+local table_name = "g" .. type_name .. "Resources"
+local desc_name = "g" .. type_name
+local function_name = "lwm2m" .. pascal_name(name)
+
+print("Generating " .. file_name .. " for object " .. object_id .. ", \"" .. name .. "\"")
+
+file = io.open(out_dir .. "/" .. file_name, "w+")
+if file == nil then
+   error("unable to write " .. out_dir .. "/" .. file_name)
+end
+
+-- --------------------------------------------------------------------
+--                         Preamble
+-- --------------------------------------------------------------------
+
+file:write("/*\n")
+file:write(" * Copyright (C) u-blox Melbourn Ltd\n")
+file:write(" * u-blox Melbourn Ltd, Melbourn, UK\n")
+file:write(" *\n")
+file:write(" * All rights reserved.\n")
+file:write(" *\n")
+file:write(" * This source file is the sole property of u-blox Melbourn Ltd.\n")
+file:write(" * Reproduction or utilisation of this source in whole or part is\n")
+file:write(" * forbidden without the written consent of u-blox Melbourn Ltd.\n")
+file:write(" */\n")
+file:write("\n")
+file:write("#ifndef ", guard, "\n")
+file:write("#define ", guard, "\n")
+file:write("\n")
+file:write("/* GENERATED by lwm2m_objects/lwm2m_c_generator.lua ", script_version, " with:\n")
+file:write(" *\n")
+file:write(" * ", command, "\n")
+file:write(" *\n")
+file:write(" * DO NOT EDIT: change the XML and generate this again.\n")
+file:write(" *\n")
+file:write(" * The ", name, " object (", object_id, ")")
+if description ~= "" then
+   file:write(":\n")
+   file:write(" *\n")
+   file:write(wrap(description, " * ", 68))
+else
+   file:write(".\n")
+end
+file:write(" *\n")
+file:write(" * See lwm2m_object_desc.h for how the resources are held.\n")
+file:write(" */\n")
+file:write("\n")
+file:write("#include <stdint.h>\n")
+file:write("#include <stdbool.h>\n")
+file:write("#include <stddef.h>\n")
+file:write("#include \"lwm2m.h\"\n")
+file:write("#include \"lwm2m_object_desc.h\"\n")
+file:write("\n")
+
+-- --------------------------------------------------------------------
+--                         Constants
+-- --------------------------------------------------------------------
+
+file:write("// ----------------------------------------------------------------\n")
+file:write("// COMPILE-TIME CONSTANTS\n")
+file:write("// ----------------------------------------------------------------\n")
+file:write("\n")
+file:write("/** The OMA ID of the ", name, " object.\n")
+file:write(" */\n")
+file:write("#define LWM2M_OBJECT_OMA_ID_", macro_name(name), " ", object_id, "\n")
+file:write("\n")
+if object_version ~= "" then
+   file:write("/** The version of the ", name, " object this was generated\n")
+   file:write(" * from; the Lua loaded into SARA-R412M must be the same version.\n")
+   file:write(" */\n")
+   file:write("#define LWM2M_OBJECT_VERSION_", macro_name(name), " \"", object_version, "\"\n")
+   file:write("\n")
+end
+
+local width = 0
+for i, r in ipairs(resources) do
+   local s = prefix .. "_RESOURCE_" .. macro_name(r.name)
+   if string.len(s) > width then width = string.len(s) end
+end
+
+file:write("/** The resources of the ", name, " object.\n")
+file:write(" */\n")
+for i, r in ipairs(resources) do
+   file:write("#define ", pad(prefix .. "_RESOURCE_" .. macro_name(r.name), width), " ", r.id, "\n")
+end
+file:write("\n")
+
+file:write("/** The LWM2M_OBJECT_DESC_RESOURCE() bits of all of the resources\n")
+file:write(" * of the ", name, " object.\n")
+file:write(" */\n")
+local line = "#define " .. prefix .. "_RESOURCES_ALL ("
+local indent = string.rep(" ", string.len(line))
+for i, r in ipairs(resources) do
+   local bit = "LWM2M_OBJECT_DESC_RESOURCE(" .. r.id .. ")"
+   if i > 1 then
+      if string.len(line) + string.len(bit) + 5 > 72 then
+         file:write(line, " | \\\n")
+         line = indent .. bit
+      else
+         line = line .. " | " .. bit
+      end
+   else
+      line = line .. bit
+   end
+end
+file:write(line)
+file:write(")\n")
+file:write("\n")
+
+for i, r in ipairs(resources) do
+   if r.multiple then
+      local max_name = prefix .. "_" .. macro_name(r.name) .. "_MAX_INSTANCES"
+      file:write("/** The most instances of the ", r.name, " resource held.\n")
+      file:write(" */\n")
+      file:write("#ifndef ", max_name, "\n")
+      file:write("# define ", max_name, " ", r.max_instances, "\n")
+      file:write("#endif\n")
+      file:write("\n")
+   end
+end
+
+-- --------------------------------------------------------------------
+--                         Types
+-- --------------------------------------------------------------------
+
+file:write("// ----------------------------------------------------------------\n")
+file:write("// TYPES\n")
+file:write("// ----------------------------------------------------------------\n")
+file:write("\n")
+file:write("/** The resources of an instance of the ", name, " object.\n")
+file:write(" */\n")
+file:write("typedef struct {\n")
+
+local members = {}
+for i, r in ipairs(resources) do
+   local comment = r.name .. " (" .. r.id .. ")"
+   if r.units ~= "" then
+      comment = comment .. ", " .. r.units
+   end
+   if r.multiple then
+      table.insert(members, {decl = types[r.type].ctype .. " " .. camel_name(r.name) ..
+                                    "[" .. prefix .. "_" .. macro_name(r.name) .. "_MAX_INSTANCES];",
+                             comment = comment .. "."})
+      table.insert(members, {decl = "int32_t num" .. pascal_name(r.name) .. ";",
+                             comment = "The number of instances of " .. r.name .. "."})
+   else
+      table.insert(members, {decl = types[r.type].ctype .. " " .. camel_name(r.name) .. ";",
+                             comment = comment .. "."})
+   end
+end
+width = 0
+-- Line the comments up, other than those of arrays
+for i, m in ipairs(members) do
+   if string.len(m.decl) > width and not string.find(m.decl, "%[") then
+      width = string.len(m.decl)
+   end
+end
+for i, m in ipairs(members) do
+   file:write("    ", pad(m.decl, width), " //!< ", m.comment, "\n")
+end
+file:write("} ", type_name, ";\n")
+file:write("\n")
+
+-- --------------------------------------------------------------------
+--                         Tables
+-- --------------------------------------------------------------------
+
+file:write("// ----------------------------------------------------------------\n")
+file:write("// TABLES\n")
+file:write("// ----------------------------------------------------------------\n")
+file:write("\n")
+file:write("/** The resources of the ", name, " object, in order of ID.\n")
+file:write(" */\n")
+file:write("static const Lwm2mObjectDescResource ", table_name, "[] = {\n")
+for i, r in ipairs(resources) do
+   local max, count = "0", "0"
+   if r.multiple then
+      max = prefix .. "_" .. macro_name(r.name) .. "_MAX_INSTANCES"
+      count = "offsetof(" .. type_name .. ", num" .. pascal_name(r.name) .. ")"
+   end
+   file:write("    {", prefix, "_RESOURCE_", macro_name(r.name), ", ", types[r.type].lwm2m, ",\n")
+   if r.multiple then
+      file:write("     ", operations(r), ", ", tostring(r.mandatory), ",\n")
+      file:write("     ", max, ",\n")
+      file:write("     offsetof(", type_name, ", ", camel_name(r.name), "),\n")
+      file:write("     ", count, "}")
+   else
+      file:write("     ", operations(r), ", ", tostring(r.mandatory), ", ", max, ",\n")
+      file:write("     offsetof(", type_name, ", ", camel_name(r.name), "), ", count, "}")
+   end
+   if i < #resources then
+      file:write(",")
+   end
+   file:write("\n")
+end
+file:write("};\n")
+file:write("\n")
+file:write("/** The ", name, " object.\n")
+file:write(" */\n")
+file:write("static const Lwm2mObjectDesc ", desc_name, " = {\n")
+file:write("    LWM2M_OBJECT_OMA_ID_", macro_name(name), ", \"", name, "\",\n")
+file:write("    ", table_name, ",\n")
+file:write("    sizeof(", table_name, ") / sizeof(", table_name, "[0])\n")
+file:write("};\n")
+file:write("\n")
+
+-- --------------------------------------------------------------------
+--                         Functions
+-- --------------------------------------------------------------------
+
+file:write("// ----------------------------------------------------------------\n")
+file:write("// FUNCTIONS\n")
+file:write("// ----------------------------------------------------------------\n")
+file:write("\n")
+
+file:write("/** Create an instance of the ", name, " object, see\n")
+file:write(" * lwm2mObjectDescCreate().\n")
+file:write(" */\n")
+file:write("static inline int32_t ", function_name, "Create(int32_t objectInstanceId,\n")
+file:write(string.rep(" ", string.len("static inline int32_t " .. function_name .. "Create(")),
+           "int32_t shortServerId,\n")
+file:write(string.rep(" ", string.len("static inline int32_t " .. function_name .. "Create(")),
+           "const ", type_name, " *pValues,\n")
+file:write(string.rep(" ", string.len("static inline int32_t " .. function_name .. "Create(")),
+           "uint32_t resources)\n")
+file:write("{\n")
+file:write("    return lwm2mObjectDescCreate(&", desc_name, ", objectInstanceId,\n")
+file:write("                                 shortServerId, pValues, resources);\n")
+file:write("}\n")
+file:write("\n")
+
+file:write("/** Write resources of an instance of the ", name, " object,\n")
+file:write(" * see lwm2mObjectDescSet().\n")
+file:write(" */\n")
+file:write("static inline int32_t ", function_name, "Set(int32_t objectInstanceId,\n")
+file:write(string.rep(" ", string.len("static inline int32_t " .. function_name .. "Set(")),
+           "const ", type_name, " *pValues,\n")
+file:write(string.rep(" ", string.len("static inline int32_t " .. function_name .. "Set(")),
+           "uint32_t resources)\n")
+file:write("{\n")
+file:write("    return lwm2mObjectDescSet(&", desc_name, ", objectInstanceId,\n")
+file:write("                              pValues, resources);\n")
+file:write("}\n")
+file:write("\n")
+
+file:write("/** Read an instance of the ", name, " object, see\n")
+file:write(" * lwm2mObjectDescGet().\n")
+file:write(" */\n")
+file:write("static inline int32_t ", function_name, "Get(int32_t objectInstanceId,\n")
+file:write(string.rep(" ", string.len("static inline int32_t " .. function_name .. "Get(")),
+           type_name, " *pValues,\n")
+file:write(string.rep(" ", string.len("static inline int32_t " .. function_name .. "Get(")),
+           "uint32_t *pPresent)\n")
+file:write("{\n")
+file:write("    return lwm2mObjectDescGet(&", desc_name, ", objectInstanceId,\n")
+file:write("                              pValues, pPresent);\n")
+file:write("}\n")
+file:write("\n")
+
+file:write("#endif // ", guard, "\n")
+file:write("\n")
+file:write("// End Of File\n")
+
+-- close the file
+file:close()
+
+print("Done")
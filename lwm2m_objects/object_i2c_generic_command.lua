@@ -24,6 +24,7 @@ local RES_O_DELAY = 7
 local RES_M_RESPONSE_SIZE = 8
 local RES_M_READ_RESPONSE = 9
 local RES_O_READ_TIMESTAMP = 10
+local RES_O_SAMPLE_BATCH = 11
 
 -- ----------------------------------------------------
 -- Globals
@@ -40,7 +41,7 @@ local object_table = {
    Name = "I2C Generic Command",
    ObjectId = "33050",
    LwM2MVersion = "1.0",
-   ObjectVersion = "1.0",
+   ObjectVersion = "2.0",
    MultipleInstances = "Multiple",
    Mandatory = "Optional",
 
@@ -88,10 +89,10 @@ local resource_tbl = {
    [RES_M_WRITE_SEQUENCE] = {
       Name = "Write Sequence",
       Operations = "RW",
-      MultipleInstances = "Multiple",
+      MultipleInstances = "Single",
       Mandatory = "Mandatory",
-      Type = "Integer",
-      Value = {},
+      Type = "Opaque",
+      Value = "",
    },
 
    [RES_M_WRITE_SUCCESS] = {
@@ -124,10 +125,10 @@ local resource_tbl = {
    [RES_M_READ_RESPONSE] = {
       Name = "Read Response",
       Operations = "R",
-      MultipleInstances = "Multiple",
+      MultipleInstances = "Single",
       Mandatory = "Mandatory",
-      Type = "Integer",
-      Value = {},
+      Type = "Opaque",
+      Value = "",
    },
 
    [RES_O_READ_TIMESTAMP] = {
@@ -138,6 +139,15 @@ local resource_tbl = {
       Type = "Time",
       Value = 0,
    },
+
+   [RES_O_SAMPLE_BATCH] = {
+      Name = "Sample Batch",
+      Operations = "R",
+      MultipleInstances = "Single",
+      Mandatory = "Optional",
+      Type = "Opaque",
+      Value = "",
+   },
 }
 
 -- ----------------------------------------------------
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "at_client.h"
+#include "at_batch.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// To make the format for a response line from its length.
+#define STRINGIFY_LITERAL(x) #x
+#define STRINGIFY(x) STRINGIFY_LITERAL(x)
+
+// Any response line, up to AT_BATCH_MAX_LINE_LENGTH characters.
+#define AT_BATCH_LINE_FORMAT "%" STRINGIFY(AT_BATCH_MAX_LINE_LENGTH) "[^\r\n]"
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Wait for the final result code of the oldest command in flight,
+// passing over anything else, e.g. the echo of a command.
+static int32_t receiveResult()
+{
+    char line[AT_BATCH_MAX_LINE_LENGTH + 1];
+
+    for (;;) {
+        line[0] = 0;
+        if (!at_client_recv(AT_BATCH_LINE_FORMAT, line)) {
+            return AT_BATCH_RESULT_NO_REPLY;
+        }
+        if (strcmp(line, "OK") == 0) {
+            return 0;
+        }
+        if ((strncmp(line, "ERROR", 5) == 0) ||
+            (strncmp(line, "+CME ERROR", 10) == 0) ||
+            (strncmp(line, "+CMS ERROR", 10) == 0)) {
+            return AT_BATCH_RESULT_ERROR;
+        }
+    }
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Start a batch.
+void atBatchInit(AtBatch *pBatch, int32_t maxInFlight)
+{
+    memset(pBatch, 0, sizeof(*pBatch));
+    if (maxInFlight <= 0) {
+        maxInFlight = AT_BATCH_DEFAULT_MAX_IN_FLIGHT;
+    }
+    pBatch->maxInFlight = maxInFlight;
+}
+
+// Add a command to a batch.
+int32_t atBatchAdd(AtBatch *pBatch, const char *pCommand)
+{
+    int32_t index = pBatch->numCommands;
+
+    if (index >= AT_BATCH_MAX_COMMANDS) {
+        return -1;
+    }
+    pBatch->pCommands[index] = pCommand;
+    pBatch->results[index] = AT_BATCH_RESULT_NOT_RUN;
+    pBatch->numCommands++;
+
+    return index;
+}
+
+// Send the commands and collect their results.
+int32_t atBatchRun(AtBatch *pBatch)
+{
+    int32_t numSent = 0;
+    int32_t numDone = 0;
+    int32_t numOk = 0;
+    int32_t bytesInFlight = 0;
+    int32_t length;
+    bool lost = false;
+
+    while ((numDone < pBatch->numCommands) && !lost) {
+        // Send as far ahead as is allowed; there must always be
+        // at least one in flight, however long it is
+        if (numSent == numDone) {
+            pBatch->numBursts++;
+        }
+        while ((numSent < pBatch->numCommands) &&
+               (numSent - numDone < pBatch->maxInFlight)) {
+            length = strlen(pBatch->pCommands[numSent]) + 1;
+            if ((numSent > numDone) &&
+                (bytesInFlight + length > AT_BATCH_MAX_BYTES_IN_FLIGHT)) {
+                break;
+            }
+            if (!at_client_send("%s", pBatch->pCommands[numSent])) {
+                break;
+            }
+            bytesInFlight += length;
+            numSent++;
+        }
+        if (numSent == numDone) {
+            // Couldn't even send one
+            lost = true;
+            break;
+        }
+
+        // Then match the oldest one in flight with its result
+        pBatch->results[numDone] = receiveResult();
+        if (pBatch->results[numDone] == 0) {
+            numOk++;
+        } else if (pBatch->results[numDone] == AT_BATCH_RESULT_NO_REPLY) {
+            lost = true;
+        }
+        bytesInFlight -= strlen(pBatch->pCommands[numDone]) + 1;
+        numDone++;
+    }
+
+    if (lost) {
+        // Any result that turns up now can't be told apart from
+        // that of another command
+        for (int32_t x = numDone; x < numSent; x++) {
+            pBatch->results[x] = AT_BATCH_RESULT_NO_REPLY;
+        }
+        for (int32_t x = numSent; x < pBatch->numCommands; x++) {
+            pBatch->results[x] = AT_BATCH_RESULT_NOT_SENT;
+        }
+    }
+
+    return numOk;
+}
+
+// Get the result of a command.
+int32_t atBatchResult(const AtBatch *pBatch, int32_t index)
+{
+    if ((index < 0) || (index >= pBatch->numCommands)) {
+        return AT_BATCH_RESULT_NOT_RUN;
+    }
+
+    return pBatch->results[index];
+}
+
+// End Of File
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _AT_BATCH_H_
+#define _AT_BATCH_H_
+
+/* A batch of AT commands sent to SARA-R412M through the AT client
+ * without waiting for the response to each before sending the next.
+ * Commands are queued with atBatchAdd() and atBatchRun() then
+ * streams them to the module, keeping up to maxInFlight of them
+ * ahead of their responses, and matches the final result codes to
+ * the commands in order.  The module still carries out the
+ * commands one at a time but the UART and the turnaround in the AT
+ * client are no longer in between; with maxInFlight of 1 the batch
+ * goes exactly as the commands would one by one.
+ *
+ * Only commands which get nothing but a final result code back,
+ * e.g. writes, may be batched.  The commands sent ahead wait in the
+ * input buffer of the module, which is why there is a limit on how
+ * many and how many bytes; hardware flow control should be on.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The most commands in a batch.
+ */
+#ifndef AT_BATCH_MAX_COMMANDS
+# define AT_BATCH_MAX_COMMANDS 24
+#endif
+
+/** The default for the most commands sent ahead of their responses.
+ */
+#ifndef AT_BATCH_DEFAULT_MAX_IN_FLIGHT
+# define AT_BATCH_DEFAULT_MAX_IN_FLIGHT 4
+#endif
+
+/** The most bytes of commands sent ahead of their responses,
+ * keeping well within the AT input buffer of SARA-R412M; a single
+ * command longer than this is still sent, on its own.
+ */
+#ifndef AT_BATCH_MAX_BYTES_IN_FLIGHT
+# define AT_BATCH_MAX_BYTES_IN_FLIGHT 512
+#endif
+
+/** The longest response line that is looked at.
+ */
+#define AT_BATCH_MAX_LINE_LENGTH 64
+
+/** The results of a command in a batch, besides zero for "OK".
+ */
+#define AT_BATCH_RESULT_NOT_RUN  -1 //!< Not yet sent.
+#define AT_BATCH_RESULT_ERROR    -2 //!< "ERROR" or "+CME ERROR".
+#define AT_BATCH_RESULT_NO_REPLY -3 //!< Sent but no final result
+                                    //!< code, e.g. a timeout.
+#define AT_BATCH_RESULT_NOT_SENT -4 //!< Given up on after an
+                                    //!< earlier command had no reply.
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** A batch of AT commands.
+ */
+typedef struct {
+    const char *pCommands[AT_BATCH_MAX_COMMANDS]; //!< Owned by the caller.
+    int32_t results[AT_BATCH_MAX_COMMANDS];       //!< AT_BATCH_RESULT_X.
+    int32_t numCommands;
+    int32_t maxInFlight;
+    int32_t numBursts; //!< Times atBatchRun() sent commands
+                       //!< with nothing left to wait for.
+} AtBatch;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Start a batch.
+ *
+ * @param pBatch      the batch.
+ * @param maxInFlight the most commands to send ahead of their
+ *                    responses, 1 for one at a time, zero or less
+ *                    for AT_BATCH_DEFAULT_MAX_IN_FLIGHT.
+ */
+void atBatchInit(AtBatch *pBatch, int32_t maxInFlight);
+
+/** Add a command to a batch.  Nothing is sent until atBatchRun()
+ * is called.
+ *
+ * @param pBatch   the batch.
+ * @param pCommand the command, without a line ending; it must
+ *                 stay where it is until atBatchRun() returns.
+ * @return         the index of the command in the batch, else
+ *                 negative error code if the batch is full.
+ */
+int32_t atBatchAdd(AtBatch *pBatch, const char *pCommand);
+
+/** Send the commands of a batch and collect their results; the
+ * AT client must be running.  A command which gets an error back
+ * doesn't stop the others but one which gets nothing back does,
+ * since what comes after it can no longer be matched up.
+ *
+ * @param pBatch the batch.
+ * @return       the number of commands which got "OK" back.
+ */
+int32_t atBatchRun(AtBatch *pBatch);
+
+/** Get the result of a command in a batch.
+ *
+ * @param pBatch the batch.
+ * @param index  the index returned by atBatchAdd().
+ * @return       zero if the command got "OK" back, else a
+ *               negative AT_BATCH_RESULT_X.
+ */
+int32_t atBatchResult(const AtBatch *pBatch, int32_t index);
+
+#endif // _AT_BATCH_H_
+
+// End Of File
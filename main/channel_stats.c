@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "esp_attr.h" // For RTC_DATA_ATTR
+#include "utilities.h"
+#include "channel_stats.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// Marks the start of a valid block.
+#define CHANNEL_STATS_MAGIC 0x53544154 // "STAT"
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+// What is kept for a channel: the running mean and the sum of the
+// squares of the differences from it (M2 in Welford's terms).  The
+// ESP32 FPU is single precision; a float keeps the mean of 8-bit
+// readings good to well under a count for any number of samples
+// a period might hold.
+typedef struct {
+    int32_t channelId;
+    int32_t count;
+    int32_t minimum;
+    int32_t maximum;
+    int32_t last;
+    float mean;
+    float m2;
+} ChannelStatsState;
+
+// The block kept in RTC memory.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t firmwareVersion;
+    uint32_t periodStartSeconds;
+    uint32_t untracked;
+    int32_t numChannels;
+    ChannelStatsState channels[CHANNEL_STATS_MAX_CHANNELS];
+    uint32_t crc; // Must be last
+} ChannelStatsBlock;
+
+// ----------------------------------------------------------------
+// PRIVATE VARIABLES
+// ----------------------------------------------------------------
+
+// The block itself, in RTC slow memory.
+static RTC_DATA_ATTR ChannelStatsBlock gChannelStats;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// The CRC of everything except the CRC.
+static uint32_t calculateCrc()
+{
+    return utilitiesCrc32(0, &gChannelStats, offsetof(ChannelStatsBlock, crc));
+}
+
+// Update the CRC after a change.
+static void commit()
+{
+    gChannelStats.crc = calculateCrc();
+}
+
+// Find a channel, adding it if there is room; NULL if there isn't.
+static ChannelStatsState *pFindChannel(int32_t channelId)
+{
+    ChannelStatsState *pChannel;
+
+    for (int32_t x = 0; x < gChannelStats.numChannels; x++) {
+        if (gChannelStats.channels[x].channelId == channelId) {
+            return &(gChannelStats.channels[x]);
+        }
+    }
+    if (gChannelStats.numChannels >= CHANNEL_STATS_MAX_CHANNELS) {
+        return NULL;
+    }
+    pChannel = &(gChannelStats.channels[gChannelStats.numChannels]);
+    memset(pChannel, 0, sizeof(*pChannel));
+    pChannel->channelId = channelId;
+    gChannelStats.numChannels++;
+
+    return pChannel;
+}
+
+// Add a value to a channel.
+static void addValue(ChannelStatsState *pChannel, int32_t value)
+{
+    float delta;
+
+    if ((pChannel->count == 0) || (value < pChannel->minimum)) {
+        pChannel->minimum = value;
+    }
+    if ((pChannel->count == 0) || (value > pChannel->maximum)) {
+        pChannel->maximum = value;
+    }
+    pChannel->last = value;
+    pChannel->count++;
+    // Welford: the difference from the old mean times the
+    // difference from the new one
+    delta = value - pChannel->mean;
+    pChannel->mean += delta / pChannel->count;
+    pChannel->m2 += delta * (value - pChannel->mean);
+}
+
+// Start a new period, without updating the CRC.
+static void reset(uint32_t timeSeconds)
+{
+    gChannelStats.periodStartSeconds = timeSeconds;
+    gChannelStats.untracked = 0;
+    gChannelStats.numChannels = 0;
+    memset(gChannelStats.channels, 0, sizeof(gChannelStats.channels));
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Check the block at wake-up.
+int32_t channelStatsInit(uint32_t firmwareVersion, bool keep,
+                         uint32_t timeSeconds)
+{
+    bool valid = keep &&
+                 (gChannelStats.magic == CHANNEL_STATS_MAGIC) &&
+                 (gChannelStats.version == CHANNEL_STATS_VERSION) &&
+                 (gChannelStats.firmwareVersion == firmwareVersion) &&
+                 (gChannelStats.numChannels >= 0) &&
+                 (gChannelStats.numChannels <= CHANNEL_STATS_MAX_CHANNELS) &&
+                 (gChannelStats.crc == calculateCrc());
+
+    if (!valid) {
+        memset(&gChannelStats, 0, sizeof(gChannelStats));
+        gChannelStats.magic = CHANNEL_STATS_MAGIC;
+        gChannelStats.version = CHANNEL_STATS_VERSION;
+        gChannelStats.firmwareVersion = firmwareVersion;
+        reset(timeSeconds);
+        commit();
+    }
+
+    return gChannelStats.numChannels;
+}
+
+// Add the values of a sample.
+int32_t channelStatsAdd(int32_t objectInstanceId, const int32_t *pValues,
+                        int32_t numValues)
+{
+    ChannelStatsState *pChannel;
+    int32_t numAdded = 0;
+
+    for (int32_t x = 0; x < numValues; x++) {
+        pChannel = pFindChannel(CHANNEL_STATS_ID(objectInstanceId, x));
+        if (pChannel != NULL) {
+            addValue(pChannel, pValues[x]);
+            numAdded++;
+        } else {
+            gChannelStats.untracked++;
+        }
+    }
+    if (numValues > 0) {
+        commit();
+    }
+
+    return numAdded;
+}
+
+// Return the number of channels.
+int32_t channelStatsCount()
+{
+    return gChannelStats.numChannels;
+}
+
+// Get the statistics of a channel.
+int32_t channelStatsGet(int32_t index, ChannelStats *pStats)
+{
+    const ChannelStatsState *pChannel;
+
+    if ((index < 0) || (index >= gChannelStats.numChannels)) {
+        return -1;
+    }
+    pChannel = &(gChannelStats.channels[index]);
+    pStats->channelId = pChannel->channelId;
+    pStats->count = pChannel->count;
+    pStats->minimum = pChannel->minimum;
+    pStats->maximum = pChannel->maximum;
+    pStats->last = pChannel->last;
+    pStats->mean = pChannel->mean;
+    pStats->variance = 0;
+    if (pChannel->count > 1) {
+        pStats->variance = pChannel->m2 / (pChannel->count - 1);
+    }
+
+    return 0;
+}
+
+// Return the start of the period.
+uint32_t channelStatsPeriodStart()
+{
+    return gChannelStats.periodStartSeconds;
+}
+
+// Return the number of values ignored.
+uint32_t channelStatsUntracked()
+{
+    return gChannelStats.untracked;
+}
+
+// Start a new period.
+void channelStatsReset(uint32_t timeSeconds)
+{
+    reset(timeSeconds);
+    commit();
+}
+
+// End Of File
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _CHANNEL_STATS_H_
+#define _CHANNEL_STATS_H_
+
+/* Running statistics of each sensor channel over a reporting
+ * period: count, minimum, maximum, mean, variance and the last
+ * value, so that the LWM2M server can read one summary per report
+ * however many samples were taken.  A channel is one of the values
+ * of a sample as sent in a batch (see ts_codec.h), e.g. a byte
+ * read back by an I2C Generic Command instance or one of the motion
+ * features.
+ *
+ * The mean and variance are kept with Welford's algorithm, which
+ * needs a fixed amount of memory per channel and, unlike keeping
+ * the sum and the sum of squares, doesn't lose the variance to
+ * rounding when it is small compared with the mean.
+ *
+ * Like sample_store.c the statistics are in a CRC-protected block
+ * of RTC slow memory, so that they build up across the wakes of a
+ * reporting period; anything that doesn't check out is thrown away
+ * by channelStatsInit().
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The version of the channel statistics block; increment this
+ * when the layout of the block changes.
+ */
+#define CHANNEL_STATS_VERSION 1
+
+/** The number of channels statistics are kept for; values of any
+ * further channels are counted by channelStatsUntracked() but
+ * otherwise ignored.
+ */
+#ifndef CHANNEL_STATS_MAX_CHANNELS
+# define CHANNEL_STATS_MAX_CHANNELS 16
+#endif
+
+/** Make the ID of a channel.
+ *
+ * @param objectInstanceId the I2C Generic Command instance the
+ *                         channel comes from, or
+ *                         SAMPLE_STORE_INSTANCE_ID_MOTION.
+ * @param index            the index of the channel in a sample.
+ */
+#define CHANNEL_STATS_ID(objectInstanceId, index) ((((int32_t) (objectInstanceId)) << 8) | \
+                                                   ((int32_t) (index)))
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** The statistics of a channel.
+ */
+typedef struct {
+    int32_t channelId; //!< As made by CHANNEL_STATS_ID().
+    int32_t count;     //!< The number of values added.
+    int32_t minimum;
+    int32_t maximum;
+    int32_t last;      //!< The value most recently added.
+    float mean;
+    float variance;    //!< The sample variance, zero for fewer
+                       //!< than two values.
+} ChannelStats;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Check the channel statistics at wake-up, starting a new period
+ * if the block is not valid.  Call this once, after rtcStateInit().
+ *
+ * @param firmwareVersion as passed to rtcStateInit().
+ * @param keep            false to start a new period regardless,
+ *                        e.g. because this is not a warm wake.
+ * @param timeSeconds     the time now, the start of a new period.
+ * @return                the number of channels kept.
+ */
+int32_t channelStatsInit(uint32_t firmwareVersion, bool keep,
+                         uint32_t timeSeconds);
+
+/** Add the values of a sample to the statistics of its channels,
+ * starting to keep statistics for any channels not seen before in
+ * this period.
+ *
+ * @param objectInstanceId the I2C Generic Command instance the
+ *                         values came from, or
+ *                         SAMPLE_STORE_INSTANCE_ID_MOTION.
+ * @param pValues          the values, one per channel.
+ * @param numValues        the number of values.
+ * @return                 the number of values added.
+ */
+int32_t channelStatsAdd(int32_t objectInstanceId, const int32_t *pValues,
+                        int32_t numValues);
+
+/** Return the number of channels statistics are being kept for.
+ *
+ * @return the number of channels.
+ */
+int32_t channelStatsCount();
+
+/** Get the statistics of a channel.
+ *
+ * @param index  0 for the first channel seen in this period.
+ * @param pStats place to put the statistics.
+ * @return       zero on success, else negative error code.
+ */
+int32_t channelStatsGet(int32_t index, ChannelStats *pStats);
+
+/** Return the time at which the period started.
+ *
+ * @return the time, as passed to channelStatsInit() or
+ *         channelStatsReset().
+ */
+uint32_t channelStatsPeriodStart();
+
+/** Return the number of values ignored in this period because
+ * there were already CHANNEL_STATS_MAX_CHANNELS channels.
+ *
+ * @return the number of values ignored.
+ */
+uint32_t channelStatsUntracked();
+
+/** Forget all the statistics and start a new period, e.g. once
+ * they have been sent.
+ *
+ * @param timeSeconds the time now.
+ */
+void channelStatsReset(uint32_t timeSeconds);
+
+#endif // _CHANNEL_STATS_H_
+
+// End Of File
@@ -3,3 +3,7 @@
 #
 # (Uses default behaviour of compiling all source files in directory, adding 'include' to include path.)
 
+
+# malloc() and friends are wrapped so that the LWM2M component's
+# allocations can be served from the arena in lwm2m_arena.c
+COMPONENT_ADD_LDFLAGS := -l$(COMPONENT_NAME) -Wl,--wrap=malloc -Wl,--wrap=calloc -Wl,--wrap=realloc -Wl,--wrap=free
@@ -0,0 +1,429 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "diag.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// The characters that may come between a '%' and the length
+// modifier or conversion.
+#define DIAG_FLAG_CHARACTERS "-+ #0123456789."
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+// The type of the argument of a conversion.
+typedef enum {
+    DIAG_ARG_NONE,      // "%%", or the end of the format string.
+    DIAG_ARG_INT,
+    DIAG_ARG_LONG,
+    DIAG_ARG_LONG_LONG,
+    DIAG_ARG_SIZE,
+    DIAG_ARG_DOUBLE,
+    DIAG_ARG_POINTER,   // "%s" or "%p".
+    DIAG_ARG_UNSUPPORTED
+} DiagArg;
+
+// A line in the ring.
+typedef struct {
+    uint32_t sequence;  // Its index plus one once it is filled in.
+    const char *pFormat;
+    int32_t argBytes;
+    uint8_t args[DIAG_MAX_ARG_BYTES];
+} DiagLine;
+
+// ----------------------------------------------------------------
+// PRIVATE VARIABLES
+// ----------------------------------------------------------------
+
+// The ring.  Any task may put a line in but only one takes them
+// out, the task or, once it has stopped, diagStop().
+static DiagLine gRing[DIAG_RING_SIZE];
+
+// The index of the next line to be put in.
+static uint32_t gHead = 0;
+
+// The index of the next line to be taken out.
+static uint32_t gTail = 0;
+
+// The counts.
+static DiagStats gStats = {0};
+
+// Given when there's a line to take out or the task should stop.
+static SemaphoreHandle_t gWakeTask = NULL;
+
+// Given by the task when it has stopped.
+static SemaphoreHandle_t gTaskStopped = NULL;
+
+// Set to stop the task.
+static volatile bool gStopTask = false;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Find the next conversion in a format string, returning where it
+// ends, just after the conversion character, or NULL if there
+// isn't one.
+static const char *pNextConversion(const char *pFormat, DiagArg *pArg)
+{
+    const char *pChar = strchr(pFormat, '%');
+    DiagArg arg = DIAG_ARG_INT;
+    int32_t longs = 0;
+
+    *pArg = DIAG_ARG_NONE;
+    if (pChar == NULL) {
+        return NULL;
+    }
+    pChar++;
+    if (*pChar == '%') {
+        return pChar + 1;
+    }
+    pChar += strspn(pChar, DIAG_FLAG_CHARACTERS);
+    for (; (*pChar != 0) && (strchr("hljztL", *pChar) != NULL); pChar++) {
+        if (*pChar == 'l') {
+            longs++;
+        } else if ((*pChar == 'z') || (*pChar == 't')) {
+            arg = DIAG_ARG_SIZE;
+        } else if ((*pChar == 'j') || (*pChar == 'L')) {
+            arg = DIAG_ARG_UNSUPPORTED;
+        }
+    }
+    if (*pChar == 0) {
+        *pArg = DIAG_ARG_UNSUPPORTED;
+        return NULL;
+    }
+    if (arg == DIAG_ARG_INT) {
+        if (longs == 1) {
+            arg = DIAG_ARG_LONG;
+        } else if (longs > 1) {
+            arg = DIAG_ARG_LONG_LONG;
+        }
+    }
+    switch (*pChar) {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+        case 'c':
+        break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            arg = (arg == DIAG_ARG_UNSUPPORTED) ? arg : DIAG_ARG_DOUBLE;
+        break;
+        case 's':
+        case 'p':
+            arg = (arg == DIAG_ARG_UNSUPPORTED) ? arg : DIAG_ARG_POINTER;
+        break;
+        default:
+            // '*' widths and "%n" among others
+            arg = DIAG_ARG_UNSUPPORTED;
+        break;
+    }
+    *pArg = arg;
+
+    return pChar + 1;
+}
+
+// The size an argument is kept in.
+static int32_t argSize(DiagArg arg)
+{
+    switch (arg) {
+        case DIAG_ARG_INT:
+            return sizeof(int);
+        case DIAG_ARG_LONG:
+            return sizeof(long);
+        case DIAG_ARG_LONG_LONG:
+            return sizeof(long long);
+        case DIAG_ARG_SIZE:
+            return sizeof(size_t);
+        case DIAG_ARG_DOUBLE:
+            return sizeof(double);
+        case DIAG_ARG_POINTER:
+            return sizeof(void *);
+        default:
+        break;
+    }
+
+    return 0;
+}
+
+// Format the lines in the ring and write them out.
+static void drain()
+{
+    char buffer[DIAG_MAX_LINE_LENGTH];
+    DiagLine *pLine;
+
+    for (;;) {
+        pLine = &(gRing[gTail & (DIAG_RING_SIZE - 1)]);
+        if (__atomic_load_n(&(pLine->sequence), __ATOMIC_ACQUIRE) != gTail + 1) {
+            // Empty, or a line still being filled in
+            break;
+        }
+        diagFormat(buffer, sizeof(buffer), pLine->pFormat,
+                   pLine->args, pLine->argBytes);
+        __atomic_store_n(&gTail, gTail + 1, __ATOMIC_RELEASE);
+        printf("%s", buffer);
+        gStats.written++;
+    }
+}
+
+// The task which formats the lines.
+static void diagTask(void *pParam)
+{
+    (void) pParam;
+
+    while (!gStopTask) {
+        xSemaphoreTake(gWakeTask, portMAX_DELAY);
+        drain();
+    }
+    xSemaphoreGive(gTaskStopped);
+    vTaskDelete(NULL);
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Start the task.
+int32_t diagInit()
+{
+    int32_t errorCode = -1;
+
+    memset(&gStats, 0, sizeof(gStats));
+    gStopTask = false;
+    if (gWakeTask == NULL) {
+        gWakeTask = xSemaphoreCreateBinary();
+    }
+    if (gTaskStopped == NULL) {
+        gTaskStopped = xSemaphoreCreateBinary();
+    }
+    if ((gWakeTask != NULL) && (gTaskStopped != NULL) &&
+        (xTaskCreate(diagTask, "diag", DIAG_TASK_STACK_SIZE, NULL,
+                     DIAG_TASK_PRIORITY, NULL) == pdPASS)) {
+        errorCode = 0;
+    } else {
+        // Still usable, it's just that nothing comes out until
+        // diagStop()
+        printf("DIAG: error: unable to start task.\n");
+    }
+
+    return errorCode;
+}
+
+// Put a line into the ring.
+void diagPrintf(const char *pFormat, ...)
+{
+    va_list args;
+    DiagLine *pLine;
+    const char *pNext = pFormat;
+    DiagArg arg;
+    int32_t size;
+    uint32_t head;
+    int x = 0;
+    long l;
+    long long ll;
+    size_t z;
+    double d;
+    void *p;
+
+    // Claim a line, if there's room
+    head = __atomic_load_n(&gHead, __ATOMIC_RELAXED);
+    do {
+        if (head - __atomic_load_n(&gTail, __ATOMIC_ACQUIRE) >= DIAG_RING_SIZE) {
+            __atomic_fetch_add(&(gStats.dropped), 1, __ATOMIC_RELAXED);
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&gHead, &head, head + 1, true,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+    pLine = &(gRing[head & (DIAG_RING_SIZE - 1)]);
+    pLine->pFormat = pFormat;
+    pLine->argBytes = 0;
+
+    // Copy the arguments, as the format string says they are
+    va_start(args, pFormat);
+    while ((pNext = pNextConversion(pNext, &arg)) != NULL) {
+        size = argSize(arg);
+        if ((arg == DIAG_ARG_UNSUPPORTED) ||
+            (pLine->argBytes + size > DIAG_MAX_ARG_BYTES)) {
+            break;
+        }
+        switch (arg) {
+            case DIAG_ARG_INT:
+                x = va_arg(args, int);
+                memcpy(pLine->args + pLine->argBytes, &x, size);
+            break;
+            case DIAG_ARG_LONG:
+                l = va_arg(args, long);
+                memcpy(pLine->args + pLine->argBytes, &l, size);
+            break;
+            case DIAG_ARG_LONG_LONG:
+                ll = va_arg(args, long long);
+                memcpy(pLine->args + pLine->argBytes, &ll, size);
+            break;
+            case DIAG_ARG_SIZE:
+                z = va_arg(args, size_t);
+                memcpy(pLine->args + pLine->argBytes, &z, size);
+            break;
+            case DIAG_ARG_DOUBLE:
+                d = va_arg(args, double);
+                memcpy(pLine->args + pLine->argBytes, &d, size);
+            break;
+            case DIAG_ARG_POINTER:
+                p = va_arg(args, void *);
+                memcpy(pLine->args + pLine->argBytes, &p, size);
+            break;
+            default:
+            break;
+        }
+        pLine->argBytes += size;
+    }
+    va_end(args);
+
+    __atomic_store_n(&(pLine->sequence), head + 1, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&(gStats.lines), 1, __ATOMIC_RELAXED);
+    if (gWakeTask != NULL) {
+        xSemaphoreGive(gWakeTask);
+    }
+}
+
+// Stop the task and write out what's left.
+void diagStop()
+{
+    if ((gWakeTask != NULL) && (gTaskStopped != NULL) && !gStopTask) {
+        gStopTask = true;
+        xSemaphoreGive(gWakeTask);
+        while (xSemaphoreTake(gTaskStopped, portMAX_DELAY) != pdTRUE) {}
+    }
+    drain();
+    if (gStats.dropped > 0) {
+        printf("DIAG: %d line(s) dropped, the ring was full.\n", gStats.dropped);
+    }
+}
+
+// Get the counts.
+void diagGetStats(DiagStats *pStats)
+{
+    *pStats = gStats;
+}
+
+// Format a line.
+int32_t diagFormat(char *pBuffer, int32_t size, const char *pFormat,
+                   const uint8_t *pArgs, int32_t argBytes)
+{
+    char piece[DIAG_MAX_LINE_LENGTH];
+    const char *pStart = pFormat;
+    const char *pEnd;
+    DiagArg arg;
+    int32_t length = 0;
+    int32_t pieceLength;
+    int32_t offset = 0;
+    int32_t n = 0;
+    int x;
+    long l;
+    long long ll;
+    size_t z;
+    double d;
+    void *p;
+
+    pBuffer[0] = 0;
+    // Format a piece of the format string at a time, each with one
+    // conversion, so that each argument can be given its own type
+    while ((length < size - 1) && (*pStart != 0)) {
+        pEnd = pNextConversion(pStart, &arg);
+        if ((arg != DIAG_ARG_NONE) &&
+            ((arg == DIAG_ARG_UNSUPPORTED) || (offset + argSize(arg) > argBytes))) {
+            // Whatever it is, it didn't make it into the ring
+            pEnd = NULL;
+        }
+        if (pEnd == NULL) {
+            // The rest is plain text, or can't be formatted, in
+            // which case it is written as it is
+            pieceLength = strlen(pStart);
+            if (pieceLength > size - 1 - length) {
+                pieceLength = size - 1 - length;
+            }
+            memcpy(pBuffer + length, pStart, pieceLength);
+            length += pieceLength;
+            pBuffer[length] = 0;
+            break;
+        }
+        pieceLength = pEnd - pStart;
+        if (pieceLength > (int32_t) sizeof(piece) - 1) {
+            pieceLength = sizeof(piece) - 1;
+        }
+        memcpy(piece, pStart, pieceLength);
+        piece[pieceLength] = 0;
+        switch (arg) {
+            case DIAG_ARG_NONE:
+                n = snprintf(pBuffer + length, size - length, piece, 0);
+            break;
+            case DIAG_ARG_INT:
+                memcpy(&x, pArgs + offset, sizeof(x));
+                n = snprintf(pBuffer + length, size - length, piece, x);
+            break;
+            case DIAG_ARG_LONG:
+                memcpy(&l, pArgs + offset, sizeof(l));
+                n = snprintf(pBuffer + length, size - length, piece, l);
+            break;
+            case DIAG_ARG_LONG_LONG:
+                memcpy(&ll, pArgs + offset, sizeof(ll));
+                n = snprintf(pBuffer + length, size - length, piece, ll);
+            break;
+            case DIAG_ARG_SIZE:
+                memcpy(&z, pArgs + offset, sizeof(z));
+                n = snprintf(pBuffer + length, size - length, piece, z);
+            break;
+            case DIAG_ARG_DOUBLE:
+                memcpy(&d, pArgs + offset, sizeof(d));
+                n = snprintf(pBuffer + length, size - length, piece, d);
+            break;
+            case DIAG_ARG_POINTER:
+                memcpy(&p, pArgs + offset, sizeof(p));
+                n = snprintf(pBuffer + length, size - length, piece, p);
+            break;
+            default:
+            break;
+        }
+        offset += argSize(arg);
+        if (n > 0) {
+            length += n;
+        }
+        if (length > size - 1) {
+            length = size - 1;
+        }
+        pStart = pEnd;
+    }
+
+    return length;
+}
+
+// End Of File
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _DIAG_H_
+#define _DIAG_H_
+
+/* Levelled, deferred diagnostic output, in place of printf().
+ *
+ * Each call is given a level by the macro used, DIAG_ERROR() down
+ * to DIAG_DEBUG(); calls below DIAG_LEVEL are compiled out
+ * altogether, arguments included, so an argument must never have a
+ * side effect.
+ *
+ * A call that stays does not format anything: the pointer to the
+ * format string and the raw arguments are copied into a lock-free
+ * ring, which takes a few microseconds, and a task of low priority
+ * formats them and writes them to the console when the CPU has
+ * nothing better to do, e.g. while waiting on the modem.  diagStop()
+ * writes out whatever is left before sleep.  If the ring is full a
+ * line is dropped and counted rather than the caller waiting.
+ *
+ * Since formatting happens later, a "%s" argument must point at
+ * something that lasts, e.g. a string literal; "*" widths and "%n"
+ * are not supported.  Lines also come out later than, and so may
+ * be interleaved with, anything written with printf(), e.g. by the
+ * components, which is why traceDump() is called after diagStop().
+ *
+ * Define DIAG_IMMEDIATE to have the macros call printf() directly,
+ * as before, e.g. to compare the awake time in the host build.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The levels.
+ */
+#define DIAG_LEVEL_NONE  0
+#define DIAG_LEVEL_ERROR 1
+#define DIAG_LEVEL_WARN  2
+#define DIAG_LEVEL_INFO  3
+#define DIAG_LEVEL_DEBUG 4
+
+/** The lowest level compiled in.
+ */
+#ifndef DIAG_LEVEL
+# define DIAG_LEVEL DIAG_LEVEL_INFO
+#endif
+
+/** The number of lines the ring holds; must be a power of two.
+ */
+#ifndef DIAG_RING_SIZE
+# define DIAG_RING_SIZE 64
+#endif
+
+/** The most bytes of arguments a line can have; any more are
+ * dropped from the line.
+ */
+#ifndef DIAG_MAX_ARG_BYTES
+# define DIAG_MAX_ARG_BYTES 40
+#endif
+
+/** The longest line written, including the terminator.
+ */
+#ifndef DIAG_MAX_LINE_LENGTH
+# define DIAG_MAX_LINE_LENGTH 192
+#endif
+
+/** The stack size of the task which formats the lines.
+ */
+#ifndef DIAG_TASK_STACK_SIZE
+# define DIAG_TASK_STACK_SIZE 3072
+#endif
+
+/** The priority of the task which formats the lines, just above
+ * idle.
+ */
+#ifndef DIAG_TASK_PRIORITY
+# define DIAG_TASK_PRIORITY 1
+#endif
+
+/** Where the DIAG_X() macros send a line.
+ */
+#ifdef DIAG_IMMEDIATE
+# define DIAG_OUT(...) printf(__VA_ARGS__)
+#else
+# define DIAG_OUT(...) diagPrintf(__VA_ARGS__)
+#endif
+
+/** Write a line at a level, as printf().
+ */
+#if DIAG_LEVEL >= DIAG_LEVEL_ERROR
+# define DIAG_ERROR(...) DIAG_OUT(__VA_ARGS__)
+#else
+# define DIAG_ERROR(...)
+#endif
+
+#if DIAG_LEVEL >= DIAG_LEVEL_WARN
+# define DIAG_WARN(...) DIAG_OUT(__VA_ARGS__)
+#else
+# define DIAG_WARN(...)
+#endif
+
+#if DIAG_LEVEL >= DIAG_LEVEL_INFO
+# define DIAG_INFO(...) DIAG_OUT(__VA_ARGS__)
+#else
+# define DIAG_INFO(...)
+#endif
+
+#if DIAG_LEVEL >= DIAG_LEVEL_DEBUG
+# define DIAG_DEBUG(...) DIAG_OUT(__VA_ARGS__)
+#else
+# define DIAG_DEBUG(...)
+#endif
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** Counts, for the wake so far.
+ */
+typedef struct {
+    int32_t lines;   //!< Lines put into the ring.
+    int32_t dropped; //!< Lines dropped because the ring was full.
+    int32_t written; //!< Lines formatted and written.
+} DiagStats;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Start the task which formats the lines.  Lines put into the ring
+ * before this is called are kept until it is.
+ *
+ * @return zero on success, else negative error code.
+ */
+int32_t diagInit();
+
+/** Put a line into the ring, as printf(); use the DIAG_X() macros
+ * rather than calling this directly.
+ *
+ * @param pFormat the format string, which must last.
+ */
+void diagPrintf(const char *pFormat, ...) __attribute__((format(printf, 1, 2)));
+
+/** Stop the task and write out whatever is left in the ring, plus
+ * the number of lines dropped, if any; call this after the last
+ * line of the wake, just before sleep.
+ */
+void diagStop();
+
+/** Get the counts for the wake so far.
+ *
+ * @param pStats the place to put them.
+ */
+void diagGetStats(DiagStats *pStats);
+
+/** Format a line from a format string and the arguments as copied
+ * into the ring.
+ *
+ * @param pBuffer  the place to put the line.
+ * @param size     the size of pBuffer.
+ * @param pFormat  the format string.
+ * @param pArgs    the arguments, as copied by diagPrintf().
+ * @param argBytes the number of bytes at pArgs.
+ * @return         the length of the line.
+ */
+int32_t diagFormat(char *pBuffer, int32_t size, const char *pFormat,
+                   const uint8_t *pArgs, int32_t argBytes);
+
+#endif // _DIAG_H_
+
+// End Of File
@@ -0,0 +1,657 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#ifndef FLASH_LOG_DECODE_ONLY
+# include "esp_attr.h" // For RTC_DATA_ATTR
+# include "esp_partition.h"
+# include "sys/time.h"
+# include "diag.h"
+#endif
+#include "utilities.h"
+#include "flash_log.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// The most bytes a varint of a uint32_t takes.
+#define FLASH_LOG_VARINT_MAX_SIZE 5
+
+#ifndef FLASH_LOG_DECODE_ONLY
+
+// Marks the start of a valid block in RTC memory.
+#define FLASH_LOG_MAGIC 0x45564c47 // "EVLG"
+
+// Marks the start of a sector in use.
+#define FLASH_LOG_SECTOR_MAGIC 0x4c4f4721 // "LOG!"
+
+// The size of a flash sector, the unit of erase.
+#define FLASH_LOG_SECTOR_SIZE 4096
+
+// The size of the header at the start of each sector.
+#define FLASH_LOG_SECTOR_HEADER_SIZE ((uint32_t) sizeof(FlashLogSectorHeader))
+
+// The size of the buffer flash is read and written through.
+#define FLASH_LOG_CHUNK_SIZE 256
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+// The header at the start of each sector.
+typedef struct {
+    uint32_t magic;
+    uint32_t sequence;        // Counts up from zero for the life of the log.
+    uint32_t baseTimeSeconds; // What the first delta is from.
+} FlashLogSectorHeader;
+
+// Where the records of a sector stop, from scanSector().
+typedef struct {
+    uint32_t offset;
+    uint32_t timeSeconds; // Of the last record.
+    int32_t count;
+    bool clean;           // False if the records stop at a bad one.
+} FlashLogScan;
+
+// The block kept in RTC memory.  A position in the log is the
+// sequence number of a sector times the sector size plus the
+// offset into that sector.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t firmwareVersion;
+    bool started;               // A sector has been written.
+    uint32_t headSequence;      // The sector being written.
+    uint32_t headOffset;        // Where the next record goes in it.
+    uint32_t headTimeSeconds;   // The time of the last record in it.
+    uint32_t cursorPosition;    // The first record not yet sent.
+    uint32_t cursorTimeSeconds; // What its delta is from.
+    int32_t lost;
+    uint32_t crc; // Must be last
+} FlashLog;
+
+// ----------------------------------------------------------------
+// PRIVATE VARIABLES
+// ----------------------------------------------------------------
+
+// The block itself, in RTC slow memory.
+static RTC_DATA_ATTR FlashLog gFlashLog;
+
+// The partition, NULL if there isn't one.
+static const esp_partition_t *gpPartition = NULL;
+
+// The number of sectors in the partition.
+static uint32_t gNumSectors = 0;
+
+// Records waiting for flashLogFlush().
+static FlashLogRecord gStaged[FLASH_LOG_MAX_STAGED_RECORDS];
+static int32_t gNumStaged = 0;
+static int32_t gStagedLost = 0;
+
+// Flash is read and written through this.
+static uint8_t gChunk[FLASH_LOG_CHUNK_SIZE];
+
+// Where the batch from flashLogGetBatch() ends.
+static bool gBatchPending = false;
+static uint32_t gBatchEndPosition;
+static uint32_t gBatchEndTimeSeconds;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// The CRC of everything except the CRC.
+static uint32_t calculateCrc()
+{
+    return utilitiesCrc32(0, &gFlashLog, offsetof(FlashLog, crc));
+}
+
+// Update the CRC after a change.
+static void commit()
+{
+    gFlashLog.crc = calculateCrc();
+}
+
+#endif // FLASH_LOG_DECODE_ONLY
+
+// Zig-zag encode a signed number, so that small negative numbers
+// make short varints too.
+static uint32_t zigZagEncode(int32_t number)
+{
+    return (((uint32_t) number) << 1) ^ (uint32_t) (number >> 31);
+}
+
+// Undo zigZagEncode().
+static int32_t zigZagDecode(uint32_t number)
+{
+    return (int32_t) ((number >> 1) ^ (~(number & 1) + 1));
+}
+
+// Write a varint, seven bits at a time, least significant first,
+// returning its length.
+static int32_t writeVarint(uint8_t *pBuffer, uint32_t number)
+{
+    int32_t length = 0;
+
+    while (number >= 0x80) {
+        pBuffer[length++] = (uint8_t) (number | 0x80);
+        number >>= 7;
+    }
+    pBuffer[length++] = (uint8_t) number;
+
+    return length;
+}
+
+// Read a varint, returning its length or negative if it is cut
+// short or too long.
+static int32_t readVarint(const uint8_t *pBuffer, int32_t length,
+                          uint32_t *pNumber)
+{
+    uint32_t number = 0;
+
+    for (int32_t x = 0; (x < length) && (x < FLASH_LOG_VARINT_MAX_SIZE); x++) {
+        number |= ((uint32_t) (pBuffer[x] & 0x7f)) << (x * 7);
+        if ((pBuffer[x] & 0x80) == 0) {
+            *pNumber = number;
+            return x + 1;
+        }
+    }
+
+    return -1;
+}
+
+#ifndef FLASH_LOG_DECODE_ONLY
+
+// The address in the partition of the sector with a sequence
+// number.
+static uint32_t sectorAddress(uint32_t sequence)
+{
+    return (sequence % gNumSectors) * FLASH_LOG_SECTOR_SIZE;
+}
+
+// Read the header of the sector with a sequence number, returning
+// true if the sector does hold that sequence number.
+static bool readHeader(uint32_t sequence, FlashLogSectorHeader *pHeader)
+{
+    return (esp_partition_read(gpPartition, sectorAddress(sequence),
+                               pHeader, sizeof(*pHeader)) == ESP_OK) &&
+           (pHeader->magic == FLASH_LOG_SECTOR_MAGIC) &&
+           (pHeader->sequence == sequence);
+}
+
+// Walk the records of a sector from an offset, with the time the
+// first delta is from, to the first bad or erased one or to
+// stopOffset.
+static void scanSector(uint32_t sequence, uint32_t offset,
+                       uint32_t timeSeconds, uint32_t stopOffset,
+                       FlashLogScan *pScan)
+{
+    FlashLogRecord record;
+    int32_t length;
+    int32_t x;
+    int32_t n = 0;
+
+    pScan->count = 0;
+    pScan->clean = true;
+    while (offset < stopOffset) {
+        length = stopOffset - offset;
+        if (length > (int32_t) sizeof(gChunk)) {
+            length = sizeof(gChunk);
+        }
+        if (esp_partition_read(gpPartition, sectorAddress(sequence) + offset,
+                               gChunk, length) != ESP_OK) {
+            pScan->clean = false;
+            break;
+        }
+        for (x = 0; x < length; x += n) {
+            n = flashLogDecodeRecord(gChunk + x, length - x, &timeSeconds, &record);
+            if (n <= 0) {
+                break;
+            }
+            pScan->count++;
+        }
+        offset += x;
+        if (x < length) {
+            if (n == 0) {
+                // Erased flash: the end
+                break;
+            }
+            if ((x == 0) || (offset + (length - x) >= stopOffset)) {
+                // Not just cut short by the chunk
+                pScan->clean = false;
+                break;
+            }
+        }
+    }
+    pScan->offset = offset;
+    pScan->timeSeconds = timeSeconds;
+}
+
+// Find the newest and oldest sectors and where the records in
+// the newest stop.
+static void recover()
+{
+    FlashLogSectorHeader header;
+    FlashLogScan scan;
+    uint32_t oldest = 0;
+    uint32_t oldestTimeSeconds = 0;
+
+    for (uint32_t x = 0; x < gNumSectors; x++) {
+        if ((esp_partition_read(gpPartition, x * FLASH_LOG_SECTOR_SIZE,
+                                &header, sizeof(header)) == ESP_OK) &&
+            (header.magic == FLASH_LOG_SECTOR_MAGIC) &&
+            (header.sequence % gNumSectors == x)) {
+            if (!gFlashLog.started || (header.sequence > gFlashLog.headSequence)) {
+                gFlashLog.headSequence = header.sequence;
+                gFlashLog.headTimeSeconds = header.baseTimeSeconds;
+            }
+            if (!gFlashLog.started || (header.sequence < oldest)) {
+                oldest = header.sequence;
+                oldestTimeSeconds = header.baseTimeSeconds;
+            }
+            gFlashLog.started = true;
+        }
+    }
+
+    if (gFlashLog.started) {
+        scanSector(gFlashLog.headSequence, FLASH_LOG_SECTOR_HEADER_SIZE,
+                   gFlashLog.headTimeSeconds, FLASH_LOG_SECTOR_SIZE, &scan);
+        gFlashLog.headOffset = scan.offset;
+        gFlashLog.headTimeSeconds = scan.timeSeconds;
+        if (!scan.clean) {
+            // Can't write over a half-written record: carry on
+            // in the next sector
+            gFlashLog.headOffset = FLASH_LOG_SECTOR_SIZE;
+        }
+        // Send everything that survives, the server can tell
+        // which it has had before from the positions
+        gFlashLog.cursorPosition = oldest * FLASH_LOG_SECTOR_SIZE +
+                                   FLASH_LOG_SECTOR_HEADER_SIZE;
+        gFlashLog.cursorTimeSeconds = oldestTimeSeconds;
+        DIAG_INFO("FLASH_LOG: sectors %u to %u in use, %d record(s) in the newest.\n",
+                  oldest, gFlashLog.headSequence, scan.count);
+    } else {
+        DIAG_INFO("FLASH_LOG: log is empty.\n");
+    }
+}
+
+// Start the next sector, erasing whatever it held; anything there
+// that hasn't been sent is lost.
+static int32_t startSector(uint32_t timeSeconds)
+{
+    FlashLogSectorHeader header;
+    FlashLogScan scan;
+    uint32_t sequence = 0;
+    uint32_t cursorSequence;
+    uint32_t cursorOffset;
+    uint32_t cursorTimeSeconds;
+
+    if (gFlashLog.started) {
+        sequence = gFlashLog.headSequence + 1;
+        cursorSequence = gFlashLog.cursorPosition / FLASH_LOG_SECTOR_SIZE;
+        if ((sequence >= gNumSectors) && (cursorSequence <= sequence - gNumSectors)) {
+            // The ring has come round to records which haven't been
+            // sent: count them and move the cursor on to the next
+            // sector, which is now the oldest
+            if ((cursorSequence == sequence - gNumSectors) &&
+                readHeader(cursorSequence, &header)) {
+                cursorOffset = gFlashLog.cursorPosition % FLASH_LOG_SECTOR_SIZE;
+                cursorTimeSeconds = gFlashLog.cursorTimeSeconds;
+                if (cursorOffset < FLASH_LOG_SECTOR_HEADER_SIZE) {
+                    cursorOffset = FLASH_LOG_SECTOR_HEADER_SIZE;
+                    cursorTimeSeconds = header.baseTimeSeconds;
+                }
+                scanSector(cursorSequence, cursorOffset, cursorTimeSeconds,
+                           FLASH_LOG_SECTOR_SIZE, &scan);
+                gFlashLog.lost += scan.count;
+            }
+            cursorSequence = sequence - gNumSectors + 1;
+            gFlashLog.cursorPosition = cursorSequence * FLASH_LOG_SECTOR_SIZE;
+            if (readHeader(cursorSequence, &header)) {
+                gFlashLog.cursorTimeSeconds = header.baseTimeSeconds;
+            }
+        }
+    }
+
+    if (esp_partition_erase_range(gpPartition, sectorAddress(sequence),
+                                  FLASH_LOG_SECTOR_SIZE) != ESP_OK) {
+        DIAG_ERROR("FLASH_LOG: error: unable to erase sector %u.\n", sequence);
+        return -1;
+    }
+    header.magic = FLASH_LOG_SECTOR_MAGIC;
+    header.sequence = sequence;
+    header.baseTimeSeconds = timeSeconds;
+    if (esp_partition_write(gpPartition, sectorAddress(sequence),
+                            &header, sizeof(header)) != ESP_OK) {
+        DIAG_ERROR("FLASH_LOG: error: unable to write header of sector %u.\n", sequence);
+        return -1;
+    }
+    if (!gFlashLog.started) {
+        gFlashLog.cursorPosition = sequence * FLASH_LOG_SECTOR_SIZE +
+                                   FLASH_LOG_SECTOR_HEADER_SIZE;
+        gFlashLog.cursorTimeSeconds = timeSeconds;
+        gFlashLog.started = true;
+    }
+    gFlashLog.headSequence = sequence;
+    gFlashLog.headOffset = FLASH_LOG_SECTOR_HEADER_SIZE;
+    gFlashLog.headTimeSeconds = timeSeconds;
+
+    return 0;
+}
+
+// Write what has been gathered in gChunk to the head sector.
+static int32_t writeChunk(uint32_t offset, int32_t length)
+{
+    if ((length > 0) &&
+        (esp_partition_write(gpPartition, sectorAddress(gFlashLog.headSequence) + offset,
+                             gChunk, length) != ESP_OK)) {
+        DIAG_ERROR("FLASH_LOG: error: unable to write %d byte(s) to sector %u.\n",
+                   length, gFlashLog.headSequence);
+        return -1;
+    }
+
+    return 0;
+}
+
+// Write a little-endian number.
+static void writeUint(uint8_t *pBuffer, uint32_t number, int32_t length)
+{
+    for (int32_t x = 0; x < length; x++) {
+        pBuffer[x] = (uint8_t) (number >> (x * 8));
+    }
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Find the partition and where the log is up to.
+int32_t flashLogInit(uint32_t firmwareVersion, bool keep)
+{
+    bool valid = keep &&
+                 (gFlashLog.magic == FLASH_LOG_MAGIC) &&
+                 (gFlashLog.version == FLASH_LOG_VERSION) &&
+                 (gFlashLog.firmwareVersion == firmwareVersion) &&
+                 (gFlashLog.crc == calculateCrc());
+
+    gpPartition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                           (esp_partition_subtype_t) FLASH_LOG_PARTITION_SUBTYPE,
+                                           FLASH_LOG_PARTITION_LABEL);
+    if (gpPartition == NULL) {
+        DIAG_ERROR("FLASH_LOG: error: there is no \"%s\" partition.\n",
+                   FLASH_LOG_PARTITION_LABEL);
+        return -1;
+    }
+    gNumSectors = gpPartition->size / FLASH_LOG_SECTOR_SIZE;
+    if (gNumSectors < 2) {
+        DIAG_ERROR("FLASH_LOG: error: partition \"%s\" is too small.\n",
+                   FLASH_LOG_PARTITION_LABEL);
+        gpPartition = NULL;
+        return -1;
+    }
+
+    if (!valid) {
+        memset(&gFlashLog, 0, sizeof(gFlashLog));
+        gFlashLog.magic = FLASH_LOG_MAGIC;
+        gFlashLog.version = FLASH_LOG_VERSION;
+        gFlashLog.firmwareVersion = firmwareVersion;
+        recover();
+        commit();
+    }
+
+    return 0;
+}
+
+// Stage a record.
+void flashLogAppend(int32_t event, int32_t value)
+{
+    struct timeval now;
+
+    if (gNumStaged < FLASH_LOG_MAX_STAGED_RECORDS) {
+        gettimeofday(&now, NULL);
+        gStaged[gNumStaged].event = event;
+        gStaged[gNumStaged].timeSeconds = (uint32_t) now.tv_sec;
+        gStaged[gNumStaged].value = value;
+        gNumStaged++;
+    } else {
+        gStagedLost++;
+    }
+}
+
+// Write the staged records to flash.
+int32_t flashLogFlush()
+{
+    uint8_t record[FLASH_LOG_RECORD_MAX_SIZE];
+    const FlashLogRecord *pRecord;
+    uint32_t chunkOffset = gFlashLog.headOffset;
+    int32_t chunkLength = 0;
+    int32_t chunkRecords = 0;
+    int32_t errorCode = 0;
+    int32_t written = 0;
+    int32_t length;
+
+    if (gpPartition == NULL) {
+        return -1;
+    }
+    if ((gNumStaged == 0) && (gStagedLost == 0)) {
+        return 0;
+    }
+
+    for (int32_t x = 0; (x < gNumStaged) && (errorCode == 0); x++) {
+        pRecord = &(gStaged[x]);
+        length = flashLogEncodeRecord(record, pRecord->event,
+                                      pRecord->timeSeconds - gFlashLog.headTimeSeconds,
+                                      pRecord->value);
+        if (!gFlashLog.started ||
+            (gFlashLog.headOffset + length > FLASH_LOG_SECTOR_SIZE)) {
+            // Records aren't split across sectors
+            errorCode = writeChunk(chunkOffset, chunkLength);
+            if (errorCode == 0) {
+                written += chunkRecords;
+                errorCode = startSector(pRecord->timeSeconds);
+            }
+            chunkLength = 0;
+            chunkRecords = 0;
+            chunkOffset = gFlashLog.headOffset;
+            length = flashLogEncodeRecord(record, pRecord->event, 0, pRecord->value);
+        }
+        if ((errorCode == 0) && (chunkLength + length > (int32_t) sizeof(gChunk))) {
+            errorCode = writeChunk(chunkOffset, chunkLength);
+            if (errorCode == 0) {
+                written += chunkRecords;
+            }
+            chunkOffset = gFlashLog.headOffset;
+            chunkLength = 0;
+            chunkRecords = 0;
+        }
+        if (errorCode == 0) {
+            memcpy(gChunk + chunkLength, record, length);
+            chunkLength += length;
+            chunkRecords++;
+            gFlashLog.headOffset += length;
+            gFlashLog.headTimeSeconds = pRecord->timeSeconds;
+        }
+    }
+    if (errorCode == 0) {
+        errorCode = writeChunk(chunkOffset, chunkLength);
+        if (errorCode == 0) {
+            written += chunkRecords;
+        }
+    }
+    if (errorCode != 0) {
+        // Whatever didn't make it is lost and, since a failed
+        // write leaves the sector in an unknown state, the next
+        // record goes in a new one
+        gFlashLog.lost += gNumStaged - written;
+        gFlashLog.headOffset = FLASH_LOG_SECTOR_SIZE;
+        written = errorCode;
+    }
+    gFlashLog.lost += gStagedLost;
+    gStagedLost = 0;
+    gNumStaged = 0;
+    commit();
+
+    return written;
+}
+
+// Read a batch of what hasn't been sent.
+int32_t flashLogGetBatch(uint8_t *pBuffer, int32_t size)
+{
+    FlashLogSectorHeader header;
+    FlashLogRecord record;
+    uint32_t position = gFlashLog.cursorPosition;
+    uint32_t timeSeconds = gFlashLog.cursorTimeSeconds;
+    uint32_t sequence;
+    uint32_t offset;
+    uint32_t stopOffset;
+    int32_t length = 0;
+    int32_t wanted;
+    int32_t x;
+    int32_t n = 0;
+    bool finished;
+
+    gBatchPending = false;
+    if ((gpPartition == NULL) || !gFlashLog.started) {
+        return 0;
+    }
+    if (size < FLASH_LOG_SEGMENT_HEADER_SIZE + FLASH_LOG_RECORD_MAX_SIZE) {
+        return -1;
+    }
+
+    while (size - length >= FLASH_LOG_SEGMENT_HEADER_SIZE + FLASH_LOG_RECORD_MAX_SIZE) {
+        sequence = position / FLASH_LOG_SECTOR_SIZE;
+        offset = position % FLASH_LOG_SECTOR_SIZE;
+        if ((sequence > gFlashLog.headSequence) || !readHeader(sequence, &header)) {
+            break;
+        }
+        if (offset < FLASH_LOG_SECTOR_HEADER_SIZE) {
+            offset = FLASH_LOG_SECTOR_HEADER_SIZE;
+            timeSeconds = header.baseTimeSeconds;
+        }
+        stopOffset = (sequence == gFlashLog.headSequence) ? gFlashLog.headOffset :
+                                                            FLASH_LOG_SECTOR_SIZE;
+        wanted = 0;
+        if (stopOffset > offset) {
+            wanted = stopOffset - offset;
+        }
+        if (wanted > size - length - FLASH_LOG_SEGMENT_HEADER_SIZE) {
+            wanted = size - length - FLASH_LOG_SEGMENT_HEADER_SIZE;
+        }
+        if ((wanted > 0) &&
+            (esp_partition_read(gpPartition, sectorAddress(sequence) + offset,
+                                pBuffer + length + FLASH_LOG_SEGMENT_HEADER_SIZE,
+                                wanted) != ESP_OK)) {
+            break;
+        }
+        // Only whole records go
+        writeUint(pBuffer + length, sequence * FLASH_LOG_SECTOR_SIZE + offset, 4);
+        writeUint(pBuffer + length + 4, timeSeconds, 4);
+        for (x = 0; x < wanted; x += n) {
+            n = flashLogDecodeRecord(pBuffer + length + FLASH_LOG_SEGMENT_HEADER_SIZE + x,
+                                     wanted - x, &timeSeconds, &record);
+            if (n <= 0) {
+                break;
+            }
+        }
+        if (x > 0) {
+            writeUint(pBuffer + length + 8, x, 2);
+            length += FLASH_LOG_SEGMENT_HEADER_SIZE + x;
+        }
+        position = sequence * FLASH_LOG_SECTOR_SIZE + offset + x;
+        if (sequence == gFlashLog.headSequence) {
+            break;
+        }
+        // A sector before the head is done with once its records
+        // stop or if what stops them can't be decoded
+        finished = (offset + wanted >= stopOffset) ||
+                   ((x < wanted) && ((n == 0) || (x == 0)));
+        if (!finished) {
+            // Out of room
+            break;
+        }
+        position = (sequence + 1) * FLASH_LOG_SECTOR_SIZE;
+    }
+
+    gBatchEndPosition = position;
+    gBatchEndTimeSeconds = timeSeconds;
+    gBatchPending = true;
+
+    return length;
+}
+
+// Move the cursor on past the last batch.
+void flashLogBatchSent()
+{
+    if (gBatchPending) {
+        gFlashLog.cursorPosition = gBatchEndPosition;
+        gFlashLog.cursorTimeSeconds = gBatchEndTimeSeconds;
+        gFlashLog.lost = 0;
+        commit();
+        gBatchPending = false;
+    }
+}
+
+// Get the number of records lost.
+int32_t flashLogLost()
+{
+    return gFlashLog.lost + gStagedLost;
+}
+
+#endif // FLASH_LOG_DECODE_ONLY
+
+// Encode a record.
+int32_t flashLogEncodeRecord(uint8_t *pBuffer, int32_t event,
+                             int32_t deltaSeconds, int32_t value)
+{
+    int32_t length = 0;
+
+    pBuffer[length++] = (uint8_t) event;
+    length += writeVarint(pBuffer + length, zigZagEncode(deltaSeconds));
+    length += writeVarint(pBuffer + length, zigZagEncode(value));
+
+    return length;
+}
+
+// Decode a record.
+int32_t flashLogDecodeRecord(const uint8_t *pBuffer, int32_t length,
+                             uint32_t *pTimeSeconds, FlashLogRecord *pRecord)
+{
+    uint32_t delta;
+    uint32_t value;
+    int32_t x = 1;
+    int32_t n;
+
+    if ((length <= 0) || (pBuffer[0] == FLASH_LOG_EVENT_NONE)) {
+        return 0;
+    }
+    n = readVarint(pBuffer + x, length - x, &delta);
+    if (n < 0) {
+        return -1;
+    }
+    x += n;
+    n = readVarint(pBuffer + x, length - x, &value);
+    if (n < 0) {
+        return -1;
+    }
+    x += n;
+    *pTimeSeconds += (uint32_t) zigZagDecode(delta);
+    pRecord->event = pBuffer[0];
+    pRecord->timeSeconds = *pTimeSeconds;
+    pRecord->value = zigZagDecode(value);
+
+    return x;
+}
+
+// End Of File
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _FLASH_LOG_H_
+#define _FLASH_LOG_H_
+
+/* A log of events which survives deep sleep and reset: a ring of
+ * flash sectors in a partition of its own (see partitions.csv),
+ * written log-structured, one sector after the next, the oldest
+ * sector being erased when the ring comes round to it.
+ *
+ * Appending a record only puts it in a RAM staging buffer, which
+ * takes microseconds; the flash is written by flashLogFlush(), once
+ * at the end of a wake and before an upload, so that a wake cycle
+ * never waits on a flash write or erase part-way through.
+ *
+ * Records are compact binary: the event as a byte, then the
+ * seconds since the previous record in the sector and the value,
+ * both as zig-zag varints, so that a typical record is three or
+ * four bytes.  Each sector starts with a header giving its
+ * sequence number and the time the first delta is from; a record
+ * is never split across sectors.
+ *
+ * Where the log has been read up to by the LWM2M server, and where
+ * it is being written, are kept in a CRC-protected block of RTC
+ * slow memory, like sample_store.c; if that doesn't check out the
+ * sector headers are scanned to find the newest and oldest sectors
+ * and everything from the oldest is sent again.
+ *
+ * A batch for the server is one or more segments, each:
+ *
+ * position (4 bytes)  the position in the log of the first record,
+ *                     so that the server can spot a batch it has
+ *                     had before,
+ * time (4 bytes)      the time the first delta is from,
+ * length (2 bytes)    the number of bytes of records that follow,
+ * records             as in flash,
+ *
+ * ...all numbers little-endian.  host/event_log_decode turns a
+ * batch back into events.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The version of the block in RTC memory and of the format in
+ * flash; increment this when either changes.
+ */
+#define FLASH_LOG_VERSION 1
+
+/** The label of the partition, as in partitions.csv.
+ */
+#define FLASH_LOG_PARTITION_LABEL "eventlog"
+
+/** The subtype of the partition, a data subtype of our own, as in
+ * partitions.csv.
+ */
+#define FLASH_LOG_PARTITION_SUBTYPE 0x40
+
+/** The number of records that can be staged in RAM between
+ * flushes; any more are counted as lost.
+ */
+#ifndef FLASH_LOG_MAX_STAGED_RECORDS
+# define FLASH_LOG_MAX_STAGED_RECORDS 64
+#endif
+
+/** The largest an encoded record can be.
+ */
+#define FLASH_LOG_RECORD_MAX_SIZE 11
+
+/** The size of the header of a segment of a batch.
+ */
+#define FLASH_LOG_SEGMENT_HEADER_SIZE 10
+
+/** The event byte which marks the end of the records in a sector:
+ * erased flash.
+ */
+#define FLASH_LOG_EVENT_NONE 0xff
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** A record, decoded.
+ */
+typedef struct {
+    int32_t event;        //!< The event, as in log_events_app.h.
+    uint32_t timeSeconds; //!< When, from gettimeofday().
+    int32_t value;        //!< The value logged with the event.
+} FlashLogRecord;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Find the partition and where the log is up to.  Call this
+ * once, after rtcStateInit(); until it has been called, and if the
+ * partition can't be found, records are only staged.
+ *
+ * @param firmwareVersion as passed to rtcStateInit().
+ * @param keep            false to scan the flash regardless,
+ *                        e.g. because this is not a warm wake.
+ * @return                zero on success, else negative error
+ *                        code.
+ */
+int32_t flashLogInit(uint32_t firmwareVersion, bool keep);
+
+/** Append a record to the log; it is staged in RAM until the next
+ * flashLogFlush().
+ *
+ * @param event the event, 0 to 254.
+ * @param value the value.
+ */
+void flashLogAppend(int32_t event, int32_t value);
+
+/** Write the staged records to flash, erasing the oldest sector if
+ * the ring has come round to it.
+ *
+ * @return the number of records written, else negative error code.
+ */
+int32_t flashLogFlush();
+
+/** Read as much of the log as has not been sent and will fit into
+ * a batch; nothing is moved on until flashLogBatchSent() is called.
+ *
+ * @param pBuffer the place to put the batch.
+ * @param size    the size of pBuffer, at least
+ *                FLASH_LOG_SEGMENT_HEADER_SIZE +
+ *                FLASH_LOG_RECORD_MAX_SIZE.
+ * @return        the length of the batch, zero if there is nothing
+ *                to send, else negative error code.
+ */
+int32_t flashLogGetBatch(uint8_t *pBuffer, int32_t size);
+
+/** Record that the batch from the last flashLogGetBatch() has
+ * reached the server, zeroing the count of lost records.
+ */
+void flashLogBatchSent();
+
+/** Get the number of records lost, because the staging buffer was
+ * full or because the ring came round to them before they were
+ * sent, since the last batch was sent.
+ *
+ * @return the number of records lost.
+ */
+int32_t flashLogLost();
+
+/** Encode a record.
+ *
+ * @param pBuffer      the place to put it, at least
+ *                     FLASH_LOG_RECORD_MAX_SIZE bytes.
+ * @param event        the event.
+ * @param deltaSeconds the seconds since the previous record.
+ * @param value        the value.
+ * @return             the length of the record.
+ */
+int32_t flashLogEncodeRecord(uint8_t *pBuffer, int32_t event,
+                             int32_t deltaSeconds, int32_t value);
+
+/** Decode a record.
+ *
+ * @param pBuffer       the record.
+ * @param length        the bytes available at pBuffer.
+ * @param pTimeSeconds  the time of the previous record on entry,
+ *                      of this one on return.
+ * @param pRecord       the place to put the record.
+ * @return              the length of the record, zero at the end
+ *                      of the records, negative if the record is
+ *                      cut short or not valid.
+ */
+int32_t flashLogDecodeRecord(const uint8_t *pBuffer, int32_t length,
+                             uint32_t *pTimeSeconds, FlashLogRecord *pRecord);
+
+#endif // _FLASH_LOG_H_
+
+// End Of File
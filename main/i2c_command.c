@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "lwm2m_object_desc.h"
+#include "i2c_command.h"
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Read an instance of the object into a snapshot.
+int32_t i2cCommandSnapshotGet(int32_t objectInstanceId,
+                              I2cCommandSnapshot *pSnapshot)
+{
+    int32_t errorCode;
+    Lwm2mI2cGenericCommand values;
+
+    memset(pSnapshot, 0, sizeof(*pSnapshot));
+    pSnapshot->objectInstanceId = objectInstanceId;
+
+    // Read the whole object once; the sequences go straight
+    // into the snapshot while the strings and the Sample Batch
+    // are not kept, so they are given nowhere to go
+    memset(&values, 0, sizeof(values));
+    values.writeSequence.pBytes = pSnapshot->writeSequence.sequence;
+    values.writeSequence.size = I2C_SEQUENCE_WRITE_MAX_LENGTH;
+    values.readResponse.pBytes = pSnapshot->readResponse.sequence;
+    values.readResponse.size = I2C_SEQUENCE_READ_MAX_LENGTH;
+    errorCode = lwm2mI2cGenericCommandGet(objectInstanceId, &values, NULL);
+    if (errorCode == 0) {
+        pSnapshot->deviceI2cAddress = values.deviceI2cAddress;
+        pSnapshot->triggerCondition = values.triggerCondition;
+        pSnapshot->writeSequence.length = values.writeSequence.length;
+        pSnapshot->writeSuccess = values.writeSuccess;
+        pSnapshot->delay = values.delay;
+        pSnapshot->responseSize = values.responseSize;
+        pSnapshot->readResponse.length = values.readResponse.length;
+    }
+
+    return errorCode;
+}
+
+// Set the Write Success resource.
+void i2cCommandSnapshotSetWriteSuccess(I2cCommandSnapshot *pSnapshot,
+                                       bool writeSuccess)
+{
+    if (pSnapshot->writeSuccess != writeSuccess) {
+        pSnapshot->writeSuccess = writeSuccess;
+        pSnapshot->dirty |= I2C_COMMAND_DIRTY(LWM2M_I2C_GENERIC_COMMAND_RESOURCE_WRITE_SUCCESS);
+    }
+}
+
+// Set the Read Response resource.
+void i2cCommandSnapshotSetReadResponse(I2cCommandSnapshot *pSnapshot,
+                                       const I2cSequence *pI2cSequence)
+{
+    int32_t length = pI2cSequence->length;
+
+    if (length > I2C_SEQUENCE_READ_MAX_LENGTH) {
+        length = I2C_SEQUENCE_READ_MAX_LENGTH;
+    }
+    if ((pSnapshot->readResponse.length != length) ||
+        (memcmp(pSnapshot->readResponse.sequence, pI2cSequence->sequence, length) != 0)) {
+        pSnapshot->readResponse.length = length;
+        memcpy(pSnapshot->readResponse.sequence, pI2cSequence->sequence, length);
+        pSnapshot->dirty |= I2C_COMMAND_DIRTY(LWM2M_I2C_GENERIC_COMMAND_RESOURCE_READ_RESPONSE);
+    }
+}
+
+// Write the changed resources back.
+int32_t i2cCommandSnapshotFlush(I2cCommandSnapshot *pSnapshot)
+{
+    int32_t errorCode;
+    Lwm2mI2cGenericCommand values;
+
+    if (pSnapshot->dirty == 0) {
+        return 0;
+    }
+
+    // Only the resources that can be changed in a snapshot
+    memset(&values, 0, sizeof(values));
+    values.writeSuccess = pSnapshot->writeSuccess;
+    values.readResponse.pBytes = pSnapshot->readResponse.sequence;
+    values.readResponse.length = pSnapshot->readResponse.length;
+
+    // The dirty bits are the resource mask
+    errorCode = lwm2mI2cGenericCommandSet(pSnapshot->objectInstanceId, &values,
+                                          pSnapshot->dirty);
+    if (errorCode == 0) {
+        pSnapshot->dirty = 0;
+    }
+
+    return errorCode;
+}
+
+// Write a batch of samples to the Sample Batch resource.
+int32_t i2cCommandSetSampleBatch(int32_t objectInstanceId,
+                                 const uint8_t *pBatch, int32_t length)
+{
+    Lwm2mI2cGenericCommand values;
+
+    if ((length < 0) || (length > I2C_COMMAND_SAMPLE_BATCH_MAX_SIZE)) {
+        return -1;
+    }
+
+    memset(&values, 0, sizeof(values));
+    values.sampleBatch.pBytes = (uint8_t *) pBatch;
+    values.sampleBatch.length = length;
+    return lwm2mI2cGenericCommandSet(objectInstanceId, &values,
+                                     LWM2M_OBJECT_DESC_RESOURCE(LWM2M_I2C_GENERIC_COMMAND_RESOURCE_SAMPLE_BATCH));
+}
+
+// End Of File
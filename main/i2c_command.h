@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _I2C_COMMAND_H_
+#define _I2C_COMMAND_H_
+
+/* A snapshot of an instance of the I2C Generic Command object
+ * (see lwm2m_objects/i2c_generic_command.xml).  The whole instance
+ * is read from SARA-R4 with a single LWM2M object read into a flat
+ * structure which is then used in place of per-resource reads.
+ * Changes are tracked per resource so that writing the snapshot
+ * back only sends the resources which have actually changed.
+ *
+ * The OMA ID and resource IDs come from
+ * lwm2m_object_i2c_generic_command.h, generated from the XML.
+ * This is version 2.0 of the object, where the Write Sequence and
+ * Read Response resources are each a single Opaque resource
+ * holding the bytes, rather than an Integer resource instance per
+ * byte as in version 1.0.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lwm2m_object_desc.h"
+#include "lwm2m_object_i2c_generic_command.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The maximum number of bytes in an I2C sequence.  The object
+ * puts no limit on these; what limits them is that a snapshot
+ * holds both sequences and is kept on the stack and, by
+ * sample_store.c, in RTC memory for each instance.  A sequence is
+ * sent as hex so the AT command carrying it is over twice this
+ * long.
+ */
+#ifndef I2C_SEQUENCE_WRITE_MAX_LENGTH
+# define I2C_SEQUENCE_WRITE_MAX_LENGTH 64
+#endif
+#ifndef I2C_SEQUENCE_READ_MAX_LENGTH
+# define I2C_SEQUENCE_READ_MAX_LENGTH 64
+#endif
+#define I2C_SEQUENCE_MAX_LENGTH ((I2C_SEQUENCE_WRITE_MAX_LENGTH > I2C_SEQUENCE_READ_MAX_LENGTH) ? \
+                                 I2C_SEQUENCE_WRITE_MAX_LENGTH : I2C_SEQUENCE_READ_MAX_LENGTH)
+
+/** The most bytes in a Sample Batch; it is sent as hex so the
+ * AT command carrying it is over twice this long.
+ */
+#define I2C_COMMAND_SAMPLE_BATCH_MAX_SIZE 256
+
+/** The bit in I2cCommandSnapshot.dirty for a resource.
+ */
+#define I2C_COMMAND_DIRTY(resourceId) LWM2M_OBJECT_DESC_RESOURCE(resourceId)
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** Structure to hold an I2C read or write sequence.
+ */
+typedef struct {
+    int32_t length;
+    uint8_t sequence[I2C_SEQUENCE_MAX_LENGTH];
+} I2cSequence;
+
+/** A snapshot of an instance of the I2C Generic Command object;
+ * the string resources (Device Name and Command Name) are not
+ * kept.
+ */
+typedef struct {
+    int32_t objectInstanceId;
+    int32_t deviceI2cAddress;
+    int32_t triggerCondition;
+    I2cSequence writeSequence;
+    bool writeSuccess;
+    int32_t delay;
+    int32_t responseSize;
+    I2cSequence readResponse;
+    uint32_t dirty; //!< I2C_COMMAND_DIRTY() bits of changed resources.
+} I2cCommandSnapshot;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Read an instance of the I2C Generic Command object from
+ * SARA-R4 into a snapshot with a single LWM2M object read.
+ *
+ * @param objectInstanceId the instance of the object.
+ * @param pSnapshot        the snapshot to fill in.
+ * @return                 zero on success, else negative error
+ *                         code (e.g. if the instance doesn't
+ *                         exist); nothing is printed on error.
+ */
+int32_t i2cCommandSnapshotGet(int32_t objectInstanceId,
+                              I2cCommandSnapshot *pSnapshot);
+
+/** Set the Write Success resource in a snapshot.  Nothing is
+ * written to SARA-R4 until i2cCommandSnapshotFlush() is called.
+ *
+ * @param pSnapshot    the snapshot.
+ * @param writeSuccess the value of the Write Success resource.
+ */
+void i2cCommandSnapshotSetWriteSuccess(I2cCommandSnapshot *pSnapshot,
+                                       bool writeSuccess);
+
+/** Set the Read Response resource in a snapshot; Response Size
+ * is left as the server set it, the number of bytes to read next
+ * time, however many came back this time.  Nothing is written to
+ * SARA-R4 until i2cCommandSnapshotFlush() is called.
+ *
+ * @param pSnapshot    the snapshot.
+ * @param pI2cSequence the bytes read.
+ */
+void i2cCommandSnapshotSetReadResponse(I2cCommandSnapshot *pSnapshot,
+                                       const I2cSequence *pI2cSequence);
+
+/** Write the resources which have changed in a snapshot to
+ * SARA-R4 with a single LWM2M object write; if nothing has
+ * changed nothing is written.
+ *
+ * @param pSnapshot the snapshot.
+ * @return          zero on success, else negative error code.
+ */
+int32_t i2cCommandSnapshotFlush(I2cCommandSnapshot *pSnapshot);
+
+/** Write a batch of samples, encoded with ts_codec.c, to the
+ * Sample Batch resource of an instance of the object.  This goes
+ * straight to SARA-R4, it is not part of any snapshot.
+ *
+ * @param objectInstanceId the instance of the object.
+ * @param pBatch           the encoded batch.
+ * @param length           the number of bytes at pBatch, at most
+ *                         I2C_COMMAND_SAMPLE_BATCH_MAX_SIZE.
+ * @return                 zero on success, else negative error
+ *                         code.
+ */
+int32_t i2cCommandSetSampleBatch(int32_t objectInstanceId,
+                                 const uint8_t *pBatch, int32_t length);
+
+#endif // _I2C_COMMAND_H_
+
+// End Of File
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h" // For vTaskDelay()
+#include "i2c_helper.h"
+#include "i2c_command.h"
+#include "diag.h"
+#include "i2c_interpreter.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// The most operations there can be: a write, a delay and
+// a read per instance.
+#define I2C_INTERPRETER_MAX_OPS (I2C_INTERPRETER_MAX_INSTANCES * 3)
+
+// The highest 7-bit I2C address.
+#define I2C_ADDRESS_MAX 0x7F
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+// The kinds of bus operation.
+typedef enum {
+    I2C_OP_WRITE,
+    I2C_OP_DELAY,
+    I2C_OP_READ
+} I2cOpType;
+
+// A bus operation and the snapshot it came from.
+typedef struct {
+    I2cOpType type;
+    I2cCommandSnapshot *pSnapshot;
+} I2cOp;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Wait for the Delay of an instance, to the nearest tick above.
+static void delay(int32_t delayUs)
+{
+    int32_t tickUs = portTICK_PERIOD_MS * 1000;
+
+    if (delayUs > I2C_INTERPRETER_MAX_DELAY_US) {
+        delayUs = I2C_INTERPRETER_MAX_DELAY_US;
+    }
+    if (delayUs > 0) {
+        vTaskDelay((delayUs + tickUs - 1) / tickUs);
+    }
+}
+
+// Flatten the snapshots into a list of operations, returning
+// the number of operations.
+static int32_t flatten(I2cCommandSnapshot *pSnapshots, int32_t numSnapshots,
+                       I2cOp *pOps)
+{
+    int32_t numOps = 0;
+    I2cCommandSnapshot *pSnapshot;
+
+    for (int32_t x = 0; x < numSnapshots; x++) {
+        pSnapshot = pSnapshots + x;
+        if ((pSnapshot->deviceI2cAddress < 0) ||
+            (pSnapshot->deviceI2cAddress > I2C_ADDRESS_MAX)) {
+            DIAG_WARN("I2C_INTERPRETER: warn: I2C Generic Command instance %d has bad address %d, ignored.\n",
+                      pSnapshot->objectInstanceId, pSnapshot->deviceI2cAddress);
+            continue;
+        }
+        if (pSnapshot->writeSequence.length > 0) {
+            pOps[numOps].type = I2C_OP_WRITE;
+            pOps[numOps].pSnapshot = pSnapshot;
+            numOps++;
+        }
+        if (pSnapshot->delay > 0) {
+            pOps[numOps].type = I2C_OP_DELAY;
+            pOps[numOps].pSnapshot = pSnapshot;
+            numOps++;
+        }
+        if (pSnapshot->responseSize > 0) {
+            pOps[numOps].type = I2C_OP_READ;
+            pOps[numOps].pSnapshot = pSnapshot;
+            numOps++;
+        }
+    }
+
+    return numOps;
+}
+
+// Do a read into the Read Response of a snapshot, with a
+// write in the same transaction if pWrite is not NULL.
+static int32_t sendReceive(int32_t i2cPort, const I2cCommandSnapshot *pWrite,
+                           I2cCommandSnapshot *pRead)
+{
+    int32_t bytesReadOrError;
+    int32_t length = pRead->responseSize;
+    I2cSequence readSequence;
+
+    if (length > I2C_SEQUENCE_READ_MAX_LENGTH) {
+        length = I2C_SEQUENCE_READ_MAX_LENGTH;
+    }
+    bytesReadOrError = i2cSendReceive(i2cPort, (char) pRead->deviceI2cAddress,
+                                      (pWrite != NULL) ? (const char *) pWrite->writeSequence.sequence : NULL,
+                                      (pWrite != NULL) ? pWrite->writeSequence.length : 0,
+                                      (char *) readSequence.sequence, length);
+    if (bytesReadOrError >= 0) {
+        readSequence.length = bytesReadOrError;
+        i2cCommandSnapshotSetReadResponse(pRead, &readSequence);
+    } else {
+        DIAG_ERROR("I2C_INTERPRETER: error: I2C read of %d byte(s) from 0x%02x failed (%d).\n",
+                   length, pRead->deviceI2cAddress, bytesReadOrError);
+    }
+
+    return bytesReadOrError;
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Carry out the commands.
+int32_t i2cInterpreterRun(int32_t i2cPort, I2cCommandSnapshot *pSnapshots,
+                          int32_t numSnapshots)
+{
+    I2cOp ops[I2C_INTERPRETER_MAX_OPS];
+    int32_t numOps;
+    int32_t numTransactions = 0;
+    int32_t errorCode;
+    I2cOp *pOp;
+    I2cOp *pNext;
+
+    if ((numSnapshots < 0) || (numSnapshots > I2C_INTERPRETER_MAX_INSTANCES)) {
+        return -1;
+    }
+
+    numOps = flatten(pSnapshots, numSnapshots, ops);
+    for (int32_t x = 0; x < numOps; x++) {
+        pOp = &(ops[x]);
+        pNext = (x + 1 < numOps) ? &(ops[x + 1]) : NULL;
+        switch (pOp->type) {
+            case I2C_OP_WRITE:
+                if ((pNext != NULL) && (pNext->type == I2C_OP_READ) &&
+                    (pNext->pSnapshot->deviceI2cAddress == pOp->pSnapshot->deviceI2cAddress)) {
+                    // Write then read with a repeated start
+                    errorCode = sendReceive(i2cPort, pOp->pSnapshot, pNext->pSnapshot);
+                    x++;
+                } else {
+                    errorCode = i2cSendReceive(i2cPort, (char) pOp->pSnapshot->deviceI2cAddress,
+                                               (const char *) pOp->pSnapshot->writeSequence.sequence,
+                                               pOp->pSnapshot->writeSequence.length,
+                                               NULL, 0);
+                }
+                // Either way, zero or more bytes read is success
+                if (errorCode < 0) {
+                    DIAG_ERROR("I2C_INTERPRETER: error: I2C write of %d byte(s) to 0x%02x failed (%d).\n",
+                               pOp->pSnapshot->writeSequence.length,
+                               pOp->pSnapshot->deviceI2cAddress, errorCode);
+                }
+                i2cCommandSnapshotSetWriteSuccess(pOp->pSnapshot, errorCode >= 0);
+                numTransactions++;
+            break;
+            case I2C_OP_DELAY:
+                delay(pOp->pSnapshot->delay);
+            break;
+            case I2C_OP_READ:
+                sendReceive(i2cPort, NULL, pOp->pSnapshot);
+                numTransactions++;
+            break;
+            default:
+            break;
+        }
+    }
+
+    return numTransactions;
+}
+
+// End Of File
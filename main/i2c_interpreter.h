@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _I2C_INTERPRETER_H_
+#define _I2C_INTERPRETER_H_
+
+/* Carry out what the LWM2M server has asked for in instances of
+ * the I2C Generic Command object.  For each instance, in order:
+ *
+ * - the Write Sequence, if there is one, is written to the device
+ *   at Device I2C Address and Write Success is set to match,
+ * - the Delay, in microseconds, is waited for,
+ * - Response Size bytes, if non-zero, are read from the device into
+ *   Read Response.
+ *
+ * Before anything is done the instances are flattened into a list
+ * of bus operations.  A write followed, with no delay in between,
+ * by a read from the same device is then done as a single
+ * i2cSendReceive() call with a repeated start.  This applies both
+ * within one instance (Delay 0) and across consecutive instances,
+ * e.g. one instance setting a register pointer and the next reading
+ * from it, so the bus is held for the minimum time.
+ *
+ * Results go into the snapshots; it is up to the caller to write
+ * them back with i2cCommandSnapshotFlush().
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "i2c_command.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The most instances of the I2C Generic Command object that can
+ * be interpreted in one go.
+ */
+#ifndef I2C_INTERPRETER_MAX_INSTANCES
+# define I2C_INTERPRETER_MAX_INSTANCES 4
+#endif
+
+/** The longest Delay obeyed, in microseconds; longer ones are cut
+ * short so that a bad value from the server can't keep us awake.
+ */
+#ifndef I2C_INTERPRETER_MAX_DELAY_US
+# define I2C_INTERPRETER_MAX_DELAY_US 1000000
+#endif
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Carry out the commands in a set of snapshots.
+ *
+ * @param i2cPort      the I2C port.
+ * @param pSnapshots   the snapshots, in the order to do them.
+ * @param numSnapshots the number of snapshots, at most
+ *                     I2C_INTERPRETER_MAX_INSTANCES.
+ * @return             the number of I2C transactions performed,
+ *                     else negative error code if the snapshots
+ *                     could not be interpreted at all.
+ */
+int32_t i2cInterpreterRun(int32_t i2cPort, I2cCommandSnapshot *pSnapshots,
+                          int32_t numSnapshots);
+
+#endif // _I2C_INTERPRETER_H_
+
+// End Of File
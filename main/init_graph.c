@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "esp_timer.h" // For esp_timer_get_time()
+#include "diag.h"
+#include "init_graph.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// Set when a step which is not optional has failed.
+#define INIT_GRAPH_FAILED_BIT (1UL << INIT_GRAPH_MAX_STEPS)
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+// What the task on each core is given.
+typedef struct {
+    InitGraphStep *pSteps;
+    int32_t numSteps;
+    int32_t core;
+    EventGroupHandle_t eventGroup;
+    EventGroupHandle_t doneGroup;
+} InitGraphWorker;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// The task which runs the steps for one core.
+static void workerTask(void *pParam)
+{
+    InitGraphWorker *pWorker = (InitGraphWorker *) pParam;
+    InitGraphStep *pStep;
+    EventBits_t bits;
+
+    for (int32_t x = 0; x < pWorker->numSteps; x++) {
+        pStep = pWorker->pSteps + x;
+        if (pStep->core == pWorker->core) {
+            bits = 0;
+            if (pStep->dependsOn != 0) {
+                // Wait for what this step needs, or for
+                // something to go wrong
+                do {
+                    bits = xEventGroupWaitBits(pWorker->eventGroup,
+                                               pStep->dependsOn | INIT_GRAPH_FAILED_BIT,
+                                               pdFALSE, pdFALSE, portMAX_DELAY);
+                } while (((bits & pStep->dependsOn) != pStep->dependsOn) &&
+                         !(bits & INIT_GRAPH_FAILED_BIT));
+            } else {
+                bits = xEventGroupGetBits(pWorker->eventGroup);
+            }
+            if (!(bits & INIT_GRAPH_FAILED_BIT)) {
+                pStep->startUs = esp_timer_get_time();
+                pStep->errorCode = pStep->pFunction(pStep->pParam);
+                pStep->stopUs = esp_timer_get_time();
+                if ((pStep->errorCode != 0) && !pStep->optional) {
+                    xEventGroupSetBits(pWorker->eventGroup, INIT_GRAPH_FAILED_BIT);
+                }
+            }
+            xEventGroupSetBits(pWorker->eventGroup, INIT_GRAPH_DEPENDS_ON(x));
+        }
+    }
+
+    // Last thing: the caller may delete the event groups
+    // as soon as this is set
+    xEventGroupSetBits(pWorker->doneGroup, 1UL << pWorker->core);
+    vTaskDelete(NULL);
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Run the steps.
+int32_t initGraphRun(InitGraphStep *pSteps, int32_t numSteps)
+{
+    int32_t errorCode = -1;
+    InitGraphWorker worker[INIT_GRAPH_NUM_CORES];
+    EventGroupHandle_t eventGroup;
+    EventGroupHandle_t doneGroup;
+    EventBits_t doneBits = 0;
+
+    if ((numSteps < 0) || (numSteps > INIT_GRAPH_MAX_STEPS)) {
+        return errorCode;
+    }
+    // Each step may only depend on steps before it and must be
+    // on a core we have; anything else could deadlock
+    for (int32_t x = 0; x < numSteps; x++) {
+        if ((pSteps[x].dependsOn >= INIT_GRAPH_DEPENDS_ON(x)) ||
+            (pSteps[x].core < 0) || (pSteps[x].core >= INIT_GRAPH_NUM_CORES)) {
+            DIAG_ERROR("INIT_GRAPH: error: init step \"%s\" is out of order.\n", pSteps[x].pName);
+            return errorCode;
+        }
+        pSteps[x].errorCode = INIT_GRAPH_STEP_NOT_RUN;
+        pSteps[x].startUs = -1;
+        pSteps[x].stopUs = -1;
+    }
+
+    eventGroup = xEventGroupCreate();
+    doneGroup = xEventGroupCreate();
+    if ((eventGroup != NULL) && (doneGroup != NULL)) {
+        for (int32_t x = 0; x < INIT_GRAPH_NUM_CORES; x++) {
+            worker[x].pSteps = pSteps;
+            worker[x].numSteps = numSteps;
+            worker[x].core = x;
+            worker[x].eventGroup = eventGroup;
+            worker[x].doneGroup = doneGroup;
+            if (xTaskCreatePinnedToCore(workerTask, "init", INIT_GRAPH_TASK_STACK_SIZE,
+                                        &(worker[x]), INIT_GRAPH_TASK_PRIORITY,
+                                        NULL, x) == pdPASS) {
+                doneBits |= 1UL << x;
+            } else {
+                // Stop the workers already started
+                xEventGroupSetBits(eventGroup, INIT_GRAPH_FAILED_BIT);
+            }
+        }
+        if (doneBits != 0) {
+            xEventGroupWaitBits(doneGroup, doneBits, pdFALSE, pdTRUE, portMAX_DELAY);
+        }
+        if (!(xEventGroupGetBits(eventGroup) & INIT_GRAPH_FAILED_BIT)) {
+            errorCode = 0;
+        } else {
+            for (int32_t x = 0; (x < numSteps) && (errorCode == -1); x++) {
+                if (!pSteps[x].optional && (pSteps[x].errorCode != 0) &&
+                    (pSteps[x].errorCode != INIT_GRAPH_STEP_NOT_RUN)) {
+                    errorCode = pSteps[x].errorCode;
+                }
+            }
+        }
+    }
+    if (eventGroup != NULL) {
+        vEventGroupDelete(eventGroup);
+    }
+    if (doneGroup != NULL) {
+        vEventGroupDelete(doneGroup);
+    }
+
+    return errorCode;
+}
+
+// Print when each step ran.
+void initGraphPrint(const InitGraphStep *pSteps, int32_t numSteps)
+{
+    int64_t firstUs = -1;
+
+    for (int32_t x = 0; x < numSteps; x++) {
+        if ((pSteps[x].startUs >= 0) && ((firstUs < 0) || (pSteps[x].startUs < firstUs))) {
+            firstUs = pSteps[x].startUs;
+        }
+    }
+    for (int32_t x = 0; x < numSteps; x++) {
+        if (pSteps[x].startUs >= 0) {
+            DIAG_INFO("INIT_GRAPH: init step %-16s core %d, %6d to %6d ms (%d).\n",
+                      pSteps[x].pName, pSteps[x].core,
+                      (int) ((pSteps[x].startUs - firstUs) / 1000),
+                      (int) ((pSteps[x].stopUs - firstUs) / 1000),
+                      pSteps[x].errorCode);
+        } else {
+            DIAG_INFO("INIT_GRAPH: init step %-16s core %d, not run.\n",
+                      pSteps[x].pName, pSteps[x].core);
+        }
+    }
+}
+
+// End Of File
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _INIT_GRAPH_H_
+#define _INIT_GRAPH_H_
+
+/* Run initialisation steps on both ESP32 cores at once, each step
+ * waiting only for the steps it depends on.  The steps are given
+ * as an array in which every step comes after the steps it depends
+ * on; one task per core works through the steps assigned to that
+ * core in array order, so that steps which don't depend on each
+ * other (e.g. powering up the modem and setting up Wifi) overlap.
+ *
+ * If a step which is not optional fails, no further steps are
+ * started and initGraphRun() returns the failing step's error
+ * code.  Each step records when it started and stopped, for
+ * initGraphPrint().
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The maximum number of steps, limited by the number of bits
+ * in a FreeRTOS event group (24, one used internally).
+ */
+#define INIT_GRAPH_MAX_STEPS 23
+
+/** The number of cores to run steps on.
+ */
+#define INIT_GRAPH_NUM_CORES 2
+
+/** The stack size of the task that runs the steps on each core.
+ */
+#ifndef INIT_GRAPH_TASK_STACK_SIZE
+# define INIT_GRAPH_TASK_STACK_SIZE 4096
+#endif
+
+/** The priority of the task that runs the steps on each core.
+ */
+#ifndef INIT_GRAPH_TASK_PRIORITY
+# define INIT_GRAPH_TASK_PRIORITY 5
+#endif
+
+/** The error code of a step which was not run because an
+ * earlier step failed.
+ */
+#define INIT_GRAPH_STEP_NOT_RUN -1000
+
+/** Use in InitGraphStep.dependsOn to say that a step depends on
+ * the step at the given index.
+ */
+#define INIT_GRAPH_DEPENDS_ON(index) (1UL << (index))
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** An initialisation step.
+ */
+typedef struct {
+    const char *pName;                  //!< For initGraphPrint(); must last.
+    int32_t (*pFunction)(void *pParam); //!< Returns zero on success.
+    void *pParam;                       //!< Passed to pFunction.
+    uint32_t dependsOn;                 //!< INIT_GRAPH_DEPENDS_ON() bits.
+    int32_t core;                       //!< 0 or 1.
+    bool optional;                      //!< If true, failure is not fatal.
+    // Filled in by initGraphRun()
+    int32_t errorCode;                  //!< What pFunction returned.
+    int64_t startUs;                    //!< When the step started.
+    int64_t stopUs;                     //!< When the step ended.
+} InitGraphStep;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Run the steps, returning when they are all done.
+ *
+ * @param pSteps   the steps, each after those it depends on.
+ * @param numSteps the number of steps at pSteps.
+ * @return         zero on success, else the error code of the
+ *                 first non-optional step to fail or a negative
+ *                 value if the steps couldn't be run.
+ */
+int32_t initGraphRun(InitGraphStep *pSteps, int32_t numSteps);
+
+/** Print when each step ran, relative to the first.
+ *
+ * @param pSteps   the steps, after initGraphRun().
+ * @param numSteps the number of steps at pSteps.
+ */
+void initGraphPrint(const InitGraphStep *pSteps, int32_t numSteps);
+
+#endif // _INIT_GRAPH_H_
+
+// End Of File
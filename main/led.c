@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "whre_config.h"
+#include "led.h"
+
+#if LED_ENABLED
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// How long each colour is shown for by the start-up display.
+#define LED_SHOW_OFF_STEP_MS 250
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+// A queued flash.
+typedef struct {
+    LedState state;
+    int32_t timeMilliseconds;
+} LedFlash;
+
+// ----------------------------------------------------------------
+// PRIVATE VARIABLES
+// ----------------------------------------------------------------
+
+// Protects everything below.
+static portMUX_TYPE gLedMux = portMUX_INITIALIZER_UNLOCKED;
+
+// The timer which plays out the flashes.
+static esp_timer_handle_t gLedTimer = NULL;
+
+// The steady state.
+static LedState gLedSteadyState = LED_STATE_OFF;
+
+// The queue of flashes.
+static LedFlash gLedQueue[LED_QUEUE_LENGTH];
+static int32_t gLedQueueRead = 0;
+static int32_t gLedQueueCount = 0;
+
+// True while a flash is being shown.
+static bool gLedFlashing = false;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Drive the LED lines (which are active low) for a state.
+static void ledWrite(LedState state)
+{
+    bool red = true;
+    bool green = true;
+    bool blue = true;
+
+    switch (state) {
+        case LED_STATE_GOOD:
+            green = false;
+        break;
+        case LED_STATE_MIDDLIN:
+            red = false;
+            green = false;
+        break;
+        case LED_STATE_BAD:
+            red = false;
+        break;
+        case LED_STATE_BLUE:
+            blue = false;
+        break;
+        case LED_STATE_OFF:
+        default:
+        break;
+    }
+
+    gpio_set_level(CONFIG_PIN_DEBUG_LED_RED, red);
+    gpio_set_level(CONFIG_PIN_DEBUG_LED_GREEN, green);
+    gpio_set_level(CONFIG_PIN_DEBUG_LED_BLUE, blue);
+}
+
+// Show the next flash or, if there are none, go back to
+// the steady state.
+static void ledNextFlash()
+{
+    LedFlash flash;
+
+    portENTER_CRITICAL(&gLedMux);
+    gLedFlashing = (gLedQueueCount > 0);
+    if (gLedFlashing) {
+        flash = gLedQueue[gLedQueueRead];
+        gLedQueueRead = (gLedQueueRead + 1) % LED_QUEUE_LENGTH;
+        gLedQueueCount--;
+    } else {
+        flash.state = gLedSteadyState;
+        flash.timeMilliseconds = 0;
+    }
+    portEXIT_CRITICAL(&gLedMux);
+
+    ledWrite(flash.state);
+    if (flash.timeMilliseconds > 0) {
+        esp_timer_start_once(gLedTimer, ((uint64_t) flash.timeMilliseconds) * 1000);
+    }
+}
+
+// The timer callback, run in the esp_timer task.
+static void ledTimerCallback(void *pParam)
+{
+    (void) pParam;
+    ledNextFlash();
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Set up the LEDs.
+void ledInit(bool showOff)
+{
+    gpio_config_t config;
+    esp_timer_create_args_t timerArgs = {
+        .callback = ledTimerCallback,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "led"
+    };
+
+    config.intr_type = GPIO_PIN_INTR_DISABLE;
+    config.mode = GPIO_MODE_INPUT_OUTPUT;
+    config.pull_down_en = 0;
+    config.pull_up_en = 0;
+    config.pin_bit_mask = (1ULL << CONFIG_PIN_DEBUG_LED_RED) |
+                          (1ULL << CONFIG_PIN_DEBUG_LED_GREEN) |
+                          (1ULL << CONFIG_PIN_DEBUG_LED_BLUE);
+    gpio_config(&config);
+
+    gLedSteadyState = LED_STATE_OFF;
+    gLedQueueRead = 0;
+    gLedQueueCount = 0;
+    gLedFlashing = false;
+    ledWrite(LED_STATE_OFF);
+    if ((gLedTimer == NULL) && (esp_timer_create(&timerArgs, &gLedTimer) != ESP_OK)) {
+        gLedTimer = NULL;
+    }
+
+    if (showOff) {
+        ledFlash(LED_STATE_BAD, LED_SHOW_OFF_STEP_MS);
+        ledFlash(LED_STATE_GOOD, LED_SHOW_OFF_STEP_MS);
+        ledFlash(LED_STATE_BLUE, LED_SHOW_OFF_STEP_MS);
+        ledFlash(LED_STATE_OFF, LED_SHOW_OFF_STEP_MS);
+    }
+}
+
+// Set the steady state.
+void ledSet(LedState state)
+{
+    bool flashing;
+
+    portENTER_CRITICAL(&gLedMux);
+    gLedSteadyState = state;
+    flashing = gLedFlashing;
+    portEXIT_CRITICAL(&gLedMux);
+
+    if (!flashing) {
+        ledWrite(state);
+    }
+}
+
+// Queue a flash.
+void ledFlash(LedState state, int32_t timeMilliseconds)
+{
+    bool start = false;
+
+    if ((gLedTimer == NULL) || (timeMilliseconds <= 0)) {
+        return;
+    }
+
+    portENTER_CRITICAL(&gLedMux);
+    if (gLedQueueCount < LED_QUEUE_LENGTH) {
+        gLedQueue[(gLedQueueRead + gLedQueueCount) % LED_QUEUE_LENGTH].state = state;
+        gLedQueue[(gLedQueueRead + gLedQueueCount) % LED_QUEUE_LENGTH].timeMilliseconds = timeMilliseconds;
+        gLedQueueCount++;
+        if (!gLedFlashing) {
+            // Claim the timer here so that nothing else starts it
+            gLedFlashing = true;
+            start = true;
+        }
+    }
+    portEXIT_CRITICAL(&gLedMux);
+
+    if (start) {
+        ledNextFlash();
+    }
+}
+
+// Stop the LEDs.
+void ledDeinit()
+{
+    if (gLedTimer != NULL) {
+        esp_timer_stop(gLedTimer);
+        esp_timer_delete(gLedTimer);
+        gLedTimer = NULL;
+    }
+    portENTER_CRITICAL(&gLedMux);
+    gLedQueueCount = 0;
+    gLedFlashing = false;
+    gLedSteadyState = LED_STATE_OFF;
+    portEXIT_CRITICAL(&gLedMux);
+    ledWrite(LED_STATE_OFF);
+}
+
+#endif // LED_ENABLED
+
+// End Of File
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _LED_H_
+#define _LED_H_
+
+/* The debug LED.  The application sets a steady state with
+ * ledSet() and can queue temporary states ("flashes") with
+ * ledFlash(); the flashes are played out by an esp_timer, so
+ * nothing here ever blocks the caller.  When the queue of flashes
+ * is empty the LED returns to the steady state.
+ *
+ * For production builds the LED can be compiled out completely by
+ * defining LED_ENABLED to 0 (e.g. CFLAGS += -DLED_ENABLED=0 in
+ * main/component.mk).
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** Set to 0 to compile out the LED.
+ */
+#ifndef LED_ENABLED
+# define LED_ENABLED 1
+#endif
+
+/** The number of flashes that can be queued; any more are
+ * dropped.
+ */
+#ifndef LED_QUEUE_LENGTH
+# define LED_QUEUE_LENGTH 8
+#endif
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** The states of the LED.
+ */
+typedef enum {
+    LED_STATE_OFF,
+    LED_STATE_GOOD,      // == green
+    LED_STATE_MIDDLIN,   // == yellow
+    LED_STATE_BAD,       // == red
+    LED_STATE_BLUE       // == blue, used at start-up
+} LedState;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+#if LED_ENABLED
+
+/** Set up the IO lines for the LEDs and the timer that drives
+ * them.
+ *
+ * @param showOff if true, queue a run through the colours to
+ *                show that the LED works.
+ */
+void ledInit(bool showOff);
+
+/** Set the steady state of the LED; it is shown straight away
+ * unless a flash is in progress, in which case it is shown when
+ * the flashes are done.
+ *
+ * @param state the state.
+ */
+void ledSet(LedState state);
+
+/** Queue a temporary state of the LED; returns immediately.
+ *
+ * @param state            the state.
+ * @param timeMilliseconds how long to show it for.
+ */
+void ledFlash(LedState state, int32_t timeMilliseconds);
+
+/** Stop the timer and switch the LED off.
+ */
+void ledDeinit();
+
+#else
+
+# define ledInit(showOff) ((void) 0)
+# define ledSet(state) ((void) 0)
+# define ledFlash(state, timeMilliseconds) ((void) 0)
+# define ledDeinit() ((void) 0)
+
+#endif
+
+#endif // _LED_H_
+
+// End Of File
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "i2c_helper.h"
+#include "diag.h"
+#include "lis2dw_fifo.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+#if (LIS2DW_FIFO_WATERMARK < 1) || (LIS2DW_FIFO_WATERMARK >= LIS2DW_FIFO_DEPTH)
+# error LIS2DW_FIFO_WATERMARK must be between 1 and LIS2DW_FIFO_DEPTH - 1.
+#endif
+
+// The LIS2DW registers used here.
+#define REG_CTRL1        0x20
+#define REG_CTRL2        0x21
+#define REG_CTRL6        0x25
+#define REG_OUT_X_L      0x28
+#define REG_FIFO_CTRL    0x2e
+#define REG_FIFO_SAMPLES 0x2f
+
+// CTRL1: ODR in the top nibble, high performance mode.
+#if LIS2DW_FIFO_ODR_HZ == 25
+# define CTRL1_ODR 0x30
+#elif LIS2DW_FIFO_ODR_HZ == 50
+# define CTRL1_ODR 0x40
+#elif LIS2DW_FIFO_ODR_HZ == 100
+# define CTRL1_ODR 0x50
+#elif LIS2DW_FIFO_ODR_HZ == 200
+# define CTRL1_ODR 0x60
+#elif LIS2DW_FIFO_ODR_HZ == 400
+# define CTRL1_ODR 0x70
+#else
+# error LIS2DW_FIFO_ODR_HZ must be 25, 50, 100, 200 or 400.
+#endif
+#define CTRL1_MODE_HIGH_PERFORMANCE 0x04
+
+// CTRL2: block data update, so that the two bytes of an axis
+// always belong to the same sample, and address auto-increment,
+// for the burst.
+#define CTRL2_BDU        0x08
+#define CTRL2_IF_ADD_INC 0x04
+
+// CTRL6: ±2 g, bandwidth ODR / 2, low noise.
+#define CTRL6_CAPTURE 0x04
+
+// FIFO_CTRL: the mode in the top three bits, the threshold in the
+// rest; bypass mode empties the FIFO.
+#define FIFO_CTRL_BYPASS     0x00
+#define FIFO_CTRL_CONTINUOUS 0xc0
+
+// FIFO_SAMPLES: flags and the number of samples in the FIFO.
+#define FIFO_SAMPLES_FTH  0x80
+#define FIFO_SAMPLES_OVR  0x40
+#define FIFO_SAMPLES_DIFF 0x3f
+
+// The number of bytes in a sample, X, Y then Z, low byte first.
+#define SAMPLE_SIZE (MOTION_FEATURES_NUM_AXES * 2)
+
+// ----------------------------------------------------------------
+// PRIVATE VARIABLES
+// ----------------------------------------------------------------
+
+// The I2C port and address, -1 if not started.
+static int32_t gI2cPort = -1;
+static char gI2cAddress;
+
+// CTRL1 to CTRL6 and FIFO_CTRL as found by lis2dwFifoStart().
+static char gSavedCtrl[6];
+static char gSavedFifoCtrl;
+
+// The number of overruns since lis2dwFifoStart().
+static int32_t gOverruns = 0;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Read registers, starting at the given one.
+static int32_t readRegisters(char reg, char *pBuf, int32_t length)
+{
+    if (i2cSendReceive(gI2cPort, gI2cAddress, &reg, 1,
+                       pBuf, length) != length) {
+        return -1;
+    }
+
+    return 0;
+}
+
+// Write a register.
+static int32_t writeRegister(char reg, char value)
+{
+    char buf[2];
+
+    buf[0] = reg;
+    buf[1] = value;
+
+    return i2cSendReceive(gI2cPort, gI2cAddress, buf, sizeof(buf), NULL, 0);
+}
+
+// Sleep for the time it takes the given number of samples to
+// arrive, at least one tick.
+static void waitSamples(int32_t numSamples)
+{
+    TickType_t ticks = pdMS_TO_TICKS((numSamples * 1000) / LIS2DW_FIFO_ODR_HZ);
+
+    vTaskDelay((ticks > 0) ? ticks : 1);
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Start capturing samples into the FIFO.
+int32_t lis2dwFifoStart(int32_t i2cPort, int32_t i2cAddress)
+{
+    int32_t errorCode;
+
+    gI2cPort = i2cPort;
+    gI2cAddress = (char) i2cAddress;
+    gOverruns = 0;
+
+    // Nothing to put back if this fails
+    if ((readRegisters(REG_CTRL1, gSavedCtrl, sizeof(gSavedCtrl)) != 0) ||
+        (readRegisters(REG_FIFO_CTRL, &gSavedFifoCtrl, 1) != 0)) {
+        DIAG_ERROR("LIS2DW_FIFO: error: unable to read configuration.\n");
+        gI2cPort = -1;
+        return -1;
+    }
+
+    errorCode = writeRegister(REG_CTRL2, gSavedCtrl[REG_CTRL2 - REG_CTRL1] |
+                              CTRL2_BDU | CTRL2_IF_ADD_INC);
+    if (errorCode == 0) {
+        errorCode = writeRegister(REG_CTRL6, CTRL6_CAPTURE);
+    }
+    if (errorCode == 0) {
+        // Empty the FIFO before setting the mode, then start it
+        errorCode = writeRegister(REG_FIFO_CTRL, FIFO_CTRL_BYPASS);
+    }
+    if (errorCode == 0) {
+        errorCode = writeRegister(REG_FIFO_CTRL, FIFO_CTRL_CONTINUOUS |
+                                  LIS2DW_FIFO_WATERMARK);
+    }
+    if (errorCode == 0) {
+        errorCode = writeRegister(REG_CTRL1, CTRL1_ODR | CTRL1_MODE_HIGH_PERFORMANCE);
+    }
+    if (errorCode != 0) {
+        DIAG_ERROR("LIS2DW_FIFO: error: unable to start capture (%d).\n", errorCode);
+        lis2dwFifoStop();
+    }
+
+    return errorCode;
+}
+
+// Read samples out of the FIFO.
+int32_t lis2dwFifoRead(MotionFeaturesSample *pSamples, int32_t numSamples,
+                       int32_t timeoutMs)
+{
+    char burst[LIS2DW_FIFO_DEPTH * SAMPLE_SIZE];
+    char status;
+    int32_t level = 0;
+    int32_t numRead = 0;
+    int32_t length;
+    int64_t stopTimeMs = (esp_timer_get_time() / 1000) + timeoutMs;
+
+    if (gI2cPort < 0) {
+        return -1;
+    }
+
+    while ((numRead < numSamples) &&
+           ((esp_timer_get_time() / 1000) < stopTimeMs)) {
+        waitSamples(LIS2DW_FIFO_WATERMARK - level);
+        if (readRegisters(REG_FIFO_SAMPLES, &status, 1) != 0) {
+            break;
+        }
+        level = status & FIFO_SAMPLES_DIFF;
+        if (status & FIFO_SAMPLES_OVR) {
+            gOverruns++;
+        }
+        if (status & FIFO_SAMPLES_FTH) {
+            // Everything in the FIFO, or as much as is wanted, in
+            // one go
+            if (level > numSamples - numRead) {
+                level = numSamples - numRead;
+            }
+            length = level * SAMPLE_SIZE;
+            if (readRegisters(REG_OUT_X_L, burst, length) != 0) {
+                break;
+            }
+            for (int32_t x = 0; x < level; x++) {
+                for (int32_t a = 0; a < MOTION_FEATURES_NUM_AXES; a++) {
+                    pSamples[numRead][a] = (int16_t) (((uint16_t) (uint8_t) burst[x * SAMPLE_SIZE + a * 2]) |
+                                                      (((uint16_t) (uint8_t) burst[x * SAMPLE_SIZE + a * 2 + 1]) << 8));
+                }
+                numRead++;
+            }
+            level = 0;
+        }
+    }
+
+    return numRead;
+}
+
+// Return the number of overruns.
+int32_t lis2dwFifoOverruns()
+{
+    return gOverruns;
+}
+
+// Stop capturing and put the configuration back.
+int32_t lis2dwFifoStop()
+{
+    int32_t errorCode = 0;
+
+    if (gI2cPort >= 0) {
+        if ((writeRegister(REG_FIFO_CTRL, FIFO_CTRL_BYPASS) != 0) ||
+            (writeRegister(REG_FIFO_CTRL, gSavedFifoCtrl) != 0) ||
+            (writeRegister(REG_CTRL6, gSavedCtrl[REG_CTRL6 - REG_CTRL1]) != 0) ||
+            (writeRegister(REG_CTRL2, gSavedCtrl[REG_CTRL2 - REG_CTRL1]) != 0) ||
+            (writeRegister(REG_CTRL1, gSavedCtrl[REG_CTRL1 - REG_CTRL1]) != 0)) {
+            DIAG_ERROR("LIS2DW_FIFO: error: unable to restore configuration.\n");
+            errorCode = -1;
+        }
+        gI2cPort = -1;
+    }
+
+    return errorCode;
+}
+
+// End Of File
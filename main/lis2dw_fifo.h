@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _LIS2DW_FIFO_H_
+#define _LIS2DW_FIFO_H_
+
+/* Capture of a run of accelerometer samples through the 32 level
+ * FIFO of the LIS2DW, alongside the LIS2DW driver which is only
+ * concerned with the wake-up interrupt.  The FIFO is run in
+ * continuous mode with a watermark; each time the watermark is
+ * reached everything in the FIFO is read out in a single I2C burst
+ * from OUT_X_L, the LIS2DW rolling the address back from OUT_Z_H
+ * to OUT_X_L while the FIFO is enabled.
+ *
+ * The accelerometer interrupt pin is the EXT1 wake-up source and
+ * so is in RTC mode, where it can't raise a GPIO interrupt: the
+ * watermark is instead picked up from FIFO_SAMPLES after sleeping
+ * for the time the FIFO takes to fill to it.
+ *
+ * The registers changed by lis2dwFifoStart() are put back by
+ * lis2dwFifoStop(), so the driver's configuration is not
+ * disturbed.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "motion_features.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The number of samples the LIS2DW FIFO holds.
+ */
+#define LIS2DW_FIFO_DEPTH 32
+
+/** The FIFO level at which it is read out; below LIS2DW_FIFO_DEPTH
+ * to leave time for the read before samples are lost.
+ */
+#ifndef LIS2DW_FIFO_WATERMARK
+# define LIS2DW_FIFO_WATERMARK 24
+#endif
+
+/** The output data rate while capturing, in Hz; one of the rates
+ * the LIS2DW supports in high performance mode.
+ */
+#ifndef LIS2DW_FIFO_ODR_HZ
+# define LIS2DW_FIFO_ODR_HZ 100
+#endif
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Start capturing samples into the FIFO at LIS2DW_FIFO_ODR_HZ,
+ * ±2 g full scale; lis2dwInit() must have been called.
+ *
+ * @param i2cPort    the I2C port the LIS2DW is on.
+ * @param i2cAddress the I2C address of the LIS2DW.
+ * @return           zero on success, else negative error code.
+ */
+int32_t lis2dwFifoStart(int32_t i2cPort, int32_t i2cAddress);
+
+/** Read samples out of the FIFO, waiting for them to arrive.
+ *
+ * @param pSamples   place to put the samples.
+ * @param numSamples the number of samples to read.
+ * @param timeoutMs  how long to wait for the samples in total.
+ * @return           the number of samples read, which is
+ *                   numSamples unless the timeout expired or
+ *                   there was an I2C error, else negative error
+ *                   code.
+ */
+int32_t lis2dwFifoRead(MotionFeaturesSample *pSamples, int32_t numSamples,
+                       int32_t timeoutMs);
+
+/** Return the number of times the FIFO has overrun, i.e. samples
+ * have been lost, since lis2dwFifoStart() was called.
+ *
+ * @return the number of overruns.
+ */
+int32_t lis2dwFifoOverruns();
+
+/** Stop capturing and put back the LIS2DW configuration found by
+ * lis2dwFifoStart().
+ *
+ * @return zero on success, else negative error code.
+ */
+int32_t lis2dwFifoStop();
+
+#endif // _LIS2DW_FIFO_H_
+
+// End Of File
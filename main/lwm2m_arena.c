@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h" // For xTaskGetCurrentTaskHandle()
+#include "esp_heap_caps.h" // For heap_caps_get_free_size() etc.
+#include "lwm2m_arena.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// The alignment of allocations from the arena.
+#define ARENA_ALIGNMENT 8
+
+// Each arena allocation is preceded by a header of this size
+// holding its length, needed by realloc().
+#define ARENA_HEADER_SIZE ARENA_ALIGNMENT
+
+// ----------------------------------------------------------------
+// EXTERNAL FUNCTIONS
+// ----------------------------------------------------------------
+
+// The real allocator functions, thanks to -Wl,--wrap.
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t numItems, size_t size);
+void *__real_realloc(void *pMem, size_t size);
+void __real_free(void *pMem);
+
+// ----------------------------------------------------------------
+// PRIVATE VARIABLES
+// ----------------------------------------------------------------
+
+// The arena.
+static char gArena[LWM2M_ARENA_SIZE] __attribute__((aligned(ARENA_ALIGNMENT)));
+
+// The number of bytes of the arena in use.
+static int32_t gArenaUsed = 0;
+
+// The task which owns the current scope, NULL if none.
+static TaskHandle_t gArenaTask = NULL;
+
+// The nesting depth of the current scope.
+static int32_t gArenaDepth = 0;
+
+// The counters.
+static Lwm2mArenaStats gStats = {0};
+
+// Guards all of the above: malloc() and friends are wrapped for the
+// whole image, so tasks on both cores come through here.
+static portMUX_TYPE gArenaMux = portMUX_INITIALIZER_UNLOCKED;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Determine if a pointer is in the arena.
+static bool inArena(const void *pMem)
+{
+    return ((const char *) pMem >= gArena) &&
+           ((const char *) pMem < gArena + sizeof(gArena));
+}
+
+// Allocate from the arena if the calling task is in an arena
+// scope, returning NULL if it isn't or there's no room.
+static void *pArenaAlloc(size_t size)
+{
+    void *pMem = NULL;
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    size_t needed = ARENA_HEADER_SIZE +
+                    ((size + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1));
+
+    portENTER_CRITICAL(&gArenaMux);
+    if ((gArenaDepth > 0) && (gArenaTask == task)) {
+        if (needed <= sizeof(gArena) - gArenaUsed) {
+            *((size_t *) (gArena + gArenaUsed)) = size;
+            pMem = gArena + gArenaUsed + ARENA_HEADER_SIZE;
+            gArenaUsed += needed;
+            if (gArenaUsed > gStats.arenaPeakBytes) {
+                gStats.arenaPeakBytes = gArenaUsed;
+            }
+            gStats.arenaAllocs++;
+        } else {
+            gStats.arenaOverflows++;
+        }
+    }
+    portEXIT_CRITICAL(&gArenaMux);
+
+    return pMem;
+}
+
+// Count an allocation or a free served by the heap.
+static void countHeap(int32_t *pCounter)
+{
+    portENTER_CRITICAL(&gArenaMux);
+    (*pCounter)++;
+    portEXIT_CRITICAL(&gArenaMux);
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS: ALLOCATOR WRAPPERS
+// ----------------------------------------------------------------
+
+void *__wrap_malloc(size_t size)
+{
+    void *pMem;
+
+    pMem = pArenaAlloc(size);
+    if (pMem == NULL) {
+        pMem = __real_malloc(size);
+        if (pMem != NULL) {
+            countHeap(&gStats.heapAllocs);
+        }
+    }
+
+    return pMem;
+}
+
+void *__wrap_calloc(size_t numItems, size_t size)
+{
+    void *pMem = NULL;
+
+    if ((size == 0) || (numItems <= SIZE_MAX / size)) {
+        pMem = pArenaAlloc(numItems * size);
+        if (pMem != NULL) {
+            memset(pMem, 0, numItems * size);
+        }
+    }
+    if (pMem == NULL) {
+        pMem = __real_calloc(numItems, size);
+        if (pMem != NULL) {
+            countHeap(&gStats.heapAllocs);
+        }
+    }
+
+    return pMem;
+}
+
+void *__wrap_realloc(void *pMem, size_t size)
+{
+    void *pNewMem;
+    size_t oldSize;
+
+    if (pMem == NULL) {
+        return __wrap_malloc(size);
+    }
+    if (!inArena(pMem)) {
+        return __real_realloc(pMem, size);
+    }
+
+    // Move it, within the arena if possible
+    oldSize = *((size_t *) ((char *) pMem - ARENA_HEADER_SIZE));
+    pNewMem = __wrap_malloc(size);
+    if (pNewMem != NULL) {
+        memcpy(pNewMem, pMem, (oldSize < size) ? oldSize : size);
+    }
+
+    return pNewMem;
+}
+
+void __wrap_free(void *pMem)
+{
+    // Arena memory is released at the end of the scope
+    if ((pMem != NULL) && !inArena(pMem)) {
+        __real_free(pMem);
+        countHeap(&gStats.heapFrees);
+    }
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Start an arena scope.
+void lwm2mArenaStart()
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+
+    portENTER_CRITICAL(&gArenaMux);
+    if (gArenaDepth == 0) {
+        gArenaTask = task;
+        gArenaUsed = 0;
+        gStats.scopes++;
+    }
+    if (gArenaTask == task) {
+        gArenaDepth++;
+    }
+    portEXIT_CRITICAL(&gArenaMux);
+}
+
+// End an arena scope.
+void lwm2mArenaStop()
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+
+    portENTER_CRITICAL(&gArenaMux);
+    if ((gArenaDepth > 0) && (gArenaTask == task)) {
+        gArenaDepth--;
+        if (gArenaDepth == 0) {
+            gArenaUsed = 0;
+            gArenaTask = NULL;
+        }
+    }
+    portEXIT_CRITICAL(&gArenaMux);
+}
+
+// Get the allocation counters.
+void lwm2mArenaGetStats(Lwm2mArenaStats *pStats)
+{
+    portENTER_CRITICAL(&gArenaMux);
+    *pStats = gStats;
+    portEXIT_CRITICAL(&gArenaMux);
+    pStats->heapFreeBytes = (int32_t) heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    pStats->heapLargestFreeBlock = (int32_t) heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+}
+
+// Return the heap fragmentation as a percentage.
+int32_t lwm2mArenaHeapFragmentation(const Lwm2mArenaStats *pStats)
+{
+    int32_t fragmentation = 0;
+
+    if (pStats->heapFreeBytes > 0) {
+        fragmentation = 100 - (int32_t) (((int64_t) pStats->heapLargestFreeBlock * 100) /
+                                         pStats->heapFreeBytes);
+    }
+
+    return fragmentation;
+}
+
+// End Of File
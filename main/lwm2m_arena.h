@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _LWM2M_ARENA_H_
+#define _LWM2M_ARENA_H_
+
+/* A bump allocator for the short-lived allocations made while
+ * building, writing and freeing an LWM2M object
+ * (pLwm2mObjectPrepare(), lwm2mResourcePrepare(), lwm2mObjectGet(),
+ * lwm2mObjectUnprepare(), lwm2mObjectFree(), etc.).
+ *
+ * The LWM2M component calls malloc()/free() itself so, rather than
+ * change it, malloc(), calloc(), realloc() and free() are wrapped
+ * at link time (-Wl,--wrap, see main/component.mk and
+ * host/Makefile).  Between lwm2mArenaStart() and lwm2mArenaStop(),
+ * allocations made by the calling task come from a static arena
+ * and free() of them does nothing; lwm2mArenaStop() then releases
+ * the lot in O(1).  Allocations by other tasks, or outside a
+ * scope, go to the heap as normal.  If the arena runs out the
+ * heap is used and the overflow is counted.
+ *
+ * Anything allocated inside a scope must not be used after the
+ * scope has ended.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The size of the arena in bytes; it must hold the largest
+ * object built or read in one scope.  An Opaque value goes to
+ * the LWM2M component as a hex string, twice its length, so an
+ * object carrying a Sample Batch or an Event Log batch, up to
+ * 256 bytes each, is the biggest.
+ */
+#ifndef LWM2M_ARENA_SIZE
+# define LWM2M_ARENA_SIZE 4096
+#endif
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** Allocation counters; those for the heap count all allocations
+ * made through malloc() and friends, not just LWM2M ones.
+ */
+typedef struct {
+    int32_t scopes;              //!< Number of arena scopes run.
+    int32_t arenaAllocs;         //!< Allocations served by the arena.
+    int32_t arenaOverflows;      //!< In-scope allocations the arena couldn't hold.
+    int32_t arenaPeakBytes;      //!< Most of the arena ever in use.
+    int32_t heapAllocs;          //!< Allocations served by the heap.
+    int32_t heapFrees;           //!< Frees returned to the heap.
+    int32_t heapFreeBytes;       //!< Free heap when the stats were read.
+    int32_t heapLargestFreeBlock;//!< Largest free heap block then.
+} Lwm2mArenaStats;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Start an arena scope for the calling task: everything the
+ * task allocates from here on, e.g. while preparing, writing or
+ * reading an LWM2M object, is freed at the matching
+ * lwm2mArenaStop(), so nothing allocated in between need be freed
+ * on the way out.  Scopes may be nested, only the outermost one
+ * has any effect.
+ */
+void lwm2mArenaStart();
+
+/** End an arena scope, releasing everything allocated in it.
+ */
+void lwm2mArenaStop();
+
+/** Get the allocation counters.
+ *
+ * @param pStats place to put the counters.
+ */
+void lwm2mArenaGetStats(Lwm2mArenaStats *pStats);
+
+/** Return the heap fragmentation, as a percentage: 0 when the
+ * largest free block is all of the free heap, approaching 100
+ * when the free heap is in many small pieces.
+ *
+ * @param pStats counters returned by lwm2mArenaGetStats().
+ * @return       the fragmentation percentage.
+ */
+int32_t lwm2mArenaHeapFragmentation(const Lwm2mArenaStats *pStats);
+
+#endif // _LWM2M_ARENA_H_
+
+// End Of File
@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "esp_timer.h" // For esp_timer_get_time()
+#include "esp_task_wdt.h" // For esp_task_wdt_reset()
+#include "at_client.h"
+#include "diag.h"
+#include "lwm2m_events.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// The LWM2M status URC.
+#define LWM2M_EVENTS_URC_PREFIX "+UULWM2MSTAT:"
+
+// The <event> field of the URC.
+#define URC_EVENT_REGISTERED   1
+#define URC_EVENT_DEREGISTERED 2
+#define URC_EVENT_UPDATED      3
+#define URC_EVENT_WRITE        4
+#define URC_EVENT_EXECUTE      5
+
+// The longest to block in one go, so that the task
+// watchdog can be fed.
+#define LWM2M_EVENTS_MAX_BLOCK_MS 1000
+
+// ----------------------------------------------------------------
+// PRIVATE VARIABLES
+// ----------------------------------------------------------------
+
+// The event group.
+static EventGroupHandle_t gEventGroup = NULL;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Handle the LWM2M status URC, called by the AT client task.
+static void lwm2mStatusUrc(void *pParam)
+{
+    int event;
+    EventBits_t bits = 0;
+
+    (void) pParam;
+
+    if (at_client_recv("%d", &event)) {
+        switch (event) {
+            case URC_EVENT_REGISTERED:
+                bits = LWM2M_EVENT_REGISTERED;
+            break;
+            case URC_EVENT_DEREGISTERED:
+                bits = LWM2M_EVENT_DEREGISTERED;
+            break;
+            case URC_EVENT_UPDATED:
+                bits = LWM2M_EVENT_UPDATED;
+            break;
+            case URC_EVENT_WRITE:
+                bits = LWM2M_EVENT_WRITE;
+            break;
+            case URC_EVENT_EXECUTE:
+                bits = LWM2M_EVENT_EXECUTE;
+            break;
+            default:
+            break;
+        }
+        if ((bits != 0) && (gEventGroup != NULL)) {
+            xEventGroupSetBits(gEventGroup, bits);
+        }
+    }
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Initialise LWM2M event handling.
+int32_t lwm2mEventsInit()
+{
+    if (gEventGroup == NULL) {
+        gEventGroup = xEventGroupCreate();
+        if (gEventGroup == NULL) {
+            return -1;
+        }
+    }
+    xEventGroupClearBits(gEventGroup, LWM2M_EVENT_ALL);
+    at_client_oob(LWM2M_EVENTS_URC_PREFIX, lwm2mStatusUrc, NULL);
+
+    return 0;
+}
+
+// Switch the URC on.
+int32_t lwm2mEventsEnable()
+{
+    int32_t errorCode = -1;
+
+    if (at_client_send("AT+ULWM2MSTAT=1") && at_client_recv("OK")) {
+        errorCode = 0;
+    } else {
+        DIAG_WARN("LWM2M_EVENTS: warn: unable to switch on LWM2M status URC.\n");
+    }
+
+    return errorCode;
+}
+
+// Shut down LWM2M event handling.
+void lwm2mEventsDeinit()
+{
+    if (gEventGroup != NULL) {
+        vEventGroupDelete(gEventGroup);
+        gEventGroup = NULL;
+    }
+}
+
+// Send a registration update and wait for it to complete.
+int32_t lwm2mEventsUpdate(int32_t shortServerId, int32_t maxWaitMs)
+{
+    int64_t nowMs = esp_timer_get_time() / 1000;
+    int64_t stopTimeMs = nowMs + maxWaitMs;
+    int64_t blockMs;
+    EventBits_t bits = 0;
+
+    if (gEventGroup == NULL) {
+        return -1;
+    }
+
+    xEventGroupClearBits(gEventGroup, LWM2M_EVENT_REGISTERED | LWM2M_EVENT_UPDATED);
+    if (!at_client_send("AT+ULWM2MREG=%d", (int) shortServerId) ||
+        !at_client_recv("OK")) {
+        DIAG_WARN("LWM2M_EVENTS: warn: unable to ask for a registration update.\n");
+        return -1;
+    }
+    while ((bits == 0) && (nowMs < stopTimeMs)) {
+        blockMs = stopTimeMs - nowMs;
+        if (blockMs > LWM2M_EVENTS_MAX_BLOCK_MS) {
+            blockMs = LWM2M_EVENTS_MAX_BLOCK_MS;
+        }
+        // Only take the bits of interest, the rest are for
+        // lwm2mEventsWait()
+        bits = xEventGroupWaitBits(gEventGroup, LWM2M_EVENT_REGISTERED | LWM2M_EVENT_UPDATED,
+                                   pdTRUE, pdFALSE,
+                                   (blockMs + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS);
+        esp_task_wdt_reset();
+        nowMs = esp_timer_get_time() / 1000;
+        bits &= LWM2M_EVENT_REGISTERED | LWM2M_EVENT_UPDATED;
+    }
+
+    return (bits != 0) ? 0 : -1;
+}
+
+// Wait for the LWM2M server to finish.
+uint32_t lwm2mEventsWait(int32_t maxWaitMs, int32_t quietMs)
+{
+    int64_t nowMs = esp_timer_get_time() / 1000;
+    int64_t stopTimeMs = nowMs + maxWaitMs;
+    int64_t quietTimeMs = stopTimeMs;
+    int64_t blockMs;
+    EventBits_t bits;
+    uint32_t seen = 0;
+
+    if (gEventGroup == NULL) {
+        return 0;
+    }
+
+    while (nowMs < quietTimeMs) {
+        blockMs = quietTimeMs - nowMs;
+        if (blockMs > LWM2M_EVENTS_MAX_BLOCK_MS) {
+            blockMs = LWM2M_EVENTS_MAX_BLOCK_MS;
+        }
+        bits = xEventGroupWaitBits(gEventGroup, LWM2M_EVENT_ALL, pdTRUE, pdFALSE,
+                                   (blockMs + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS);
+        esp_task_wdt_reset();
+        nowMs = esp_timer_get_time() / 1000;
+        bits &= LWM2M_EVENT_ALL;
+        if (bits != 0) {
+            seen |= bits;
+            // The server is active: give it quietMs to do
+            // anything more
+            quietTimeMs = nowMs + quietMs;
+            if (quietTimeMs > stopTimeMs) {
+                quietTimeMs = stopTimeMs;
+            }
+            if (bits & LWM2M_EVENT_DEREGISTERED) {
+                // Nothing more is coming
+                quietTimeMs = nowMs;
+            }
+        }
+    }
+
+    return seen;
+}
+
+// End Of File
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _LWM2M_EVENTS_H_
+#define _LWM2M_EVENTS_H_
+
+/* Notification of what the LWM2M server is doing, driven by the
+ * LWM2M status URC from SARA-R4 rather than by polling:
+ *
+ * +UULWM2MSTAT: <event>[,<uri>]
+ *
+ * ...which SARA-R4 sends once AT+ULWM2MSTAT=1 has been issued.
+ * Each URC sets a bit in a FreeRTOS event group which the
+ * application blocks on with lwm2mEventsWait().
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** Registered with the LWM2M server.
+ */
+#define LWM2M_EVENT_REGISTERED    0x01
+
+/** A registration update has completed.
+ */
+#define LWM2M_EVENT_UPDATED       0x02
+
+/** Deregistered from the LWM2M server.
+ */
+#define LWM2M_EVENT_DEREGISTERED  0x04
+
+/** The LWM2M server has written to an object.
+ */
+#define LWM2M_EVENT_WRITE         0x08
+
+/** The LWM2M server has executed a resource.
+ */
+#define LWM2M_EVENT_EXECUTE       0x10
+
+/** All of the events.
+ */
+#define LWM2M_EVENT_ALL           (LWM2M_EVENT_REGISTERED |   \
+                                   LWM2M_EVENT_UPDATED |      \
+                                   LWM2M_EVENT_DEREGISTERED | \
+                                   LWM2M_EVENT_WRITE |        \
+                                   LWM2M_EVENT_EXECUTE)
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Initialise LWM2M event handling: must be called after
+ * at_client_init(); doesn't talk to SARA-R4.
+ *
+ * @return zero on success, else negative error code.
+ */
+int32_t lwm2mEventsInit();
+
+/** Ask SARA-R4 to send the LWM2M status URC; call this once
+ * LWM2M on SARA-R4 is ready.
+ *
+ * @return zero on success, else negative error code.
+ */
+int32_t lwm2mEventsEnable();
+
+/** Shut down LWM2M event handling.
+ */
+void lwm2mEventsDeinit();
+
+/** Ask SARA-R4 to send a registration update to the LWM2M server,
+ * e.g. because SARA-R4 has been kept registered through a sleep and
+ * the server, which is using queue mode, has to be told that the
+ * device can be reached; call this after lwm2mEventsEnable().
+ * Other events seen while waiting are left for lwm2mEventsWait().
+ *
+ * @param shortServerId the short server ID of the server.
+ * @param maxWaitMs     the longest to wait for the update to
+ *                      complete, in milliseconds.
+ * @return              zero if the registration was updated, or
+ *                      renewed, else negative error code.
+ */
+int32_t lwm2mEventsUpdate(int32_t shortServerId, int32_t maxWaitMs);
+
+/** Wait for the LWM2M server to finish what it is doing.  The
+ * wait ends quietMs after the last event, or after maxWaitMs,
+ * whichever is sooner; events which occurred before the call
+ * count as having happened at the start of it.  Events are
+ * cleared as they are collected.
+ *
+ * @param maxWaitMs the longest to wait in milliseconds.
+ * @param quietMs   how long the server must have been quiet for
+ *                  its operations to be considered complete.
+ * @return          the LWM2M_EVENT_xxx bits seen.
+ */
+uint32_t lwm2mEventsWait(int32_t maxWaitMs, int32_t quietMs);
+
+#endif // _LWM2M_EVENTS_H_
+
+// End Of File
@@ -0,0 +1,351 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lwm2m.h"
+#include "lwm2m_sara_r412m.h"
+#include "lwm2m_arena.h"
+#include "lwm2m_resource_table.h"
+#include "utilities.h"
+#include "diag.h"
+#include "lwm2m_object_desc.h"
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// The size of the value of a resource in the structure.
+static size_t valueSize(Lwm2mResourceType type)
+{
+    switch (type) {
+        case LWM2M_RESOURCE_TYPE_FLOAT:
+            return sizeof(float);
+        case LWM2M_RESOURCE_TYPE_BOOLEAN:
+            return sizeof(bool);
+        case LWM2M_RESOURCE_TYPE_STRING:
+            return sizeof(Lwm2mObjectDescString);
+        case LWM2M_RESOURCE_TYPE_OPAQUE:
+            return sizeof(Lwm2mObjectDescOpaque);
+        default:
+            return sizeof(int32_t);
+    }
+}
+
+// Add an instance of a resource to a prepared object, from a
+// value in the structure or, if pValue is NULL, zero or empty.
+// Opaque values are handed over as a hex string, freed once
+// lwm2mResourcePrepare() has taken a copy: if the arena has
+// overflowed it comes from the heap.
+static int32_t prepareValue(const Lwm2mObjectDescResource *pResource,
+                            int32_t instanceId, const uint8_t *pValue,
+                            Lwm2mObjectInstance *pObject)
+{
+    int32_t errorCode;
+    Lwm2mValue value;
+    const Lwm2mObjectDescString *pString;
+    const Lwm2mObjectDescOpaque *pOpaque;
+    char *pHex = NULL;
+    int32_t length;
+
+    memset(&value, 0, sizeof(value));
+    switch (pResource->type) {
+        case LWM2M_RESOURCE_TYPE_FLOAT:
+            if (pValue != NULL) {
+                value.number = *((const float *) pValue);
+            }
+        break;
+        case LWM2M_RESOURCE_TYPE_BOOLEAN:
+            if (pValue != NULL) {
+                value.boolean = *((const bool *) pValue);
+            }
+        break;
+        case LWM2M_RESOURCE_TYPE_STRING:
+            pString = (const Lwm2mObjectDescString *) pValue;
+            value.pString = "";
+            if ((pString != NULL) && (pString->pString != NULL)) {
+                value.pString = pString->pString;
+            }
+        break;
+        case LWM2M_RESOURCE_TYPE_OPAQUE:
+            pOpaque = (const Lwm2mObjectDescOpaque *) pValue;
+            value.pString = "";
+            if ((pOpaque != NULL) && (pOpaque->pBytes != NULL) &&
+                (pOpaque->length > 0)) {
+                pHex = (char *) malloc(pOpaque->length * 2 + 1);
+                if (pHex == NULL) {
+                    return SARA_R412M_LWM2M_OUT_OF_MEMORY;
+                }
+                length = utilitiesBytesToHexString((const char *) pOpaque->pBytes,
+                                                   pOpaque->length, pHex,
+                                                   pOpaque->length * 2);
+                pHex[length] = 0;
+                value.pString = pHex;
+            }
+        break;
+        default:
+            if (pValue != NULL) {
+                value.number = (float) *((const int32_t *) pValue);
+            }
+        break;
+    }
+
+    errorCode = lwm2mResourcePrepare(pResource->resourceId, instanceId,
+                                     pResource->type, value, pObject);
+    free(pHex);
+
+    return errorCode;
+}
+
+// Add the resources in a mask to a prepared object; if create is
+// true every instance of a multiple-instance resource is added.
+static int32_t prepareResources(const Lwm2mObjectDesc *pDesc,
+                                const uint8_t *pValues, uint32_t resources,
+                                bool create, Lwm2mObjectInstance *pObject)
+{
+    int32_t errorCode = 0;
+    const Lwm2mObjectDescResource *pResource;
+    size_t size;
+    int32_t count;
+    int32_t numInstances;
+
+    for (int32_t x = 0; (x < pDesc->numResources) && (errorCode == 0); x++) {
+        pResource = &(pDesc->pResources[x]);
+        if ((pResource->resourceId > LWM2M_OBJECT_DESC_MAX_RESOURCE_ID) ||
+            ((resources & LWM2M_OBJECT_DESC_RESOURCE(pResource->resourceId)) == 0)) {
+            continue;
+        }
+        if (pResource->maxInstances > 0) {
+            size = valueSize(pResource->type);
+            count = *((const int32_t *) (pValues + pResource->countOffset));
+            if (count > pResource->maxInstances) {
+                count = pResource->maxInstances;
+            }
+            numInstances = create ? pResource->maxInstances : count;
+            for (int32_t y = 0; (y < numInstances) && (errorCode == 0); y++) {
+                errorCode = prepareValue(pResource, y,
+                                         (y < count) ? pValues + pResource->offset + (y * size) : NULL,
+                                         pObject);
+            }
+        } else {
+            errorCode = prepareValue(pResource, -1, pValues + pResource->offset,
+                                     pObject);
+        }
+    }
+
+    return errorCode;
+}
+
+// Prepare an object and then create or write it.
+static int32_t prepareAndSend(const Lwm2mObjectDesc *pDesc,
+                              int32_t objectInstanceId, bool create,
+                              int32_t shortServerId,
+                              const void *pValues, uint32_t resources)
+{
+    int32_t errorCode = SARA_R412M_LWM2M_OUT_OF_MEMORY;
+    Lwm2mObjectInstance *pObject;
+
+    lwm2mArenaStart();
+
+    pObject = pLwm2mObjectPrepare(pDesc->omaId, objectInstanceId);
+    if (pObject != NULL) {
+        errorCode = prepareResources(pDesc, (const uint8_t *) pValues,
+                                     resources, create, pObject);
+        if (errorCode == 0) {
+            if (create) {
+                errorCode = lwm2mObjectCreate(pObject, shortServerId);
+            } else {
+                errorCode = lwm2mObjectSet(pObject);
+            }
+            if (errorCode != 0) {
+                DIAG_ERROR("LWM2M_OBJECT: error: unable to %s %s object /%d/%d (%d).\n",
+                           create ? "create" : "write to", pDesc->pName,
+                           pObject->omaId, pObject->instanceId, errorCode);
+            }
+        } else {
+            DIAG_ERROR("LWM2M_OBJECT: error: out of memory preparing resources for %s object /%d/%d (%d).\n",
+                       pDesc->pName, pObject->omaId, pObject->instanceId, errorCode);
+        }
+        lwm2mObjectUnprepare(pObject);
+    } else {
+        DIAG_ERROR("LWM2M_OBJECT: error: out of memory preparing %s object /%d/%d (%d).\n",
+                   pDesc->pName, pDesc->omaId, objectInstanceId, errorCode);
+    }
+
+    lwm2mArenaStop();
+
+    return errorCode;
+}
+
+// Put the value of a resource instance read from SARA-R4 into the
+// structure.
+static void getValue(const Lwm2mObjectDescResource *pResource,
+                     const Lwm2mValue *pSourceValue, uint8_t *pValue)
+{
+    Lwm2mObjectDescString *pString;
+    Lwm2mObjectDescOpaque *pOpaque;
+    const char *pSource = pSourceValue->pString;
+    size_t length;
+
+    switch (pResource->type) {
+        case LWM2M_RESOURCE_TYPE_FLOAT:
+            *((float *) pValue) = pSourceValue->number;
+        break;
+        case LWM2M_RESOURCE_TYPE_BOOLEAN:
+            *((bool *) pValue) = pSourceValue->boolean;
+        break;
+        case LWM2M_RESOURCE_TYPE_STRING:
+            pString = (Lwm2mObjectDescString *) pValue;
+            if ((pString->pString != NULL) && (pString->size > 0)) {
+                length = 0;
+                if (pSource != NULL) {
+                    length = strlen(pSource);
+                    if (length > (size_t) pString->size - 1) {
+                        length = pString->size - 1;
+                    }
+                    memcpy(pString->pString, pSource, length);
+                }
+                pString->pString[length] = 0;
+            }
+        break;
+        case LWM2M_RESOURCE_TYPE_OPAQUE:
+            pOpaque = (Lwm2mObjectDescOpaque *) pValue;
+            if ((pOpaque->pBytes != NULL) && (pSource != NULL)) {
+                // Opaque values are handed over as a hex string
+                pOpaque->length = utilitiesHexStringToBytes(pSource, strlen(pSource),
+                                                            (char *) pOpaque->pBytes,
+                                                            pOpaque->size);
+            }
+        break;
+        default:
+            *((int32_t *) pValue) = (int32_t) pSourceValue->number;
+        break;
+    }
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Create an instance of an object.
+int32_t lwm2mObjectDescCreate(const Lwm2mObjectDesc *pDesc,
+                              int32_t objectInstanceId,
+                              int32_t shortServerId,
+                              const void *pValues, uint32_t resources)
+{
+    return prepareAndSend(pDesc, objectInstanceId, true, shortServerId,
+                          pValues, resources);
+}
+
+// Write resources of an instance of an object.
+int32_t lwm2mObjectDescSet(const Lwm2mObjectDesc *pDesc,
+                           int32_t objectInstanceId,
+                           const void *pValues, uint32_t resources)
+{
+    return prepareAndSend(pDesc, objectInstanceId, false, -1,
+                          pValues, resources);
+}
+
+// Read an instance of an object.
+int32_t lwm2mObjectDescGet(const Lwm2mObjectDesc *pDesc,
+                           int32_t objectInstanceId,
+                           void *pValues, uint32_t *pPresent)
+{
+    int32_t errorCode;
+    Lwm2mObjectInstance *pObject;
+    Lwm2mResourceInstance *pInstance;
+    Lwm2mResourceTable table;
+    Lwm2mResourceTableEntry *pEntries;
+    Lwm2mResourceTableEntry *pEntry;
+    const Lwm2mObjectDescResource *pResource;
+    uint8_t *pBase = (uint8_t *) pValues;
+    int32_t *pCount;
+    int32_t instanceId;
+    int32_t numValues;
+    int32_t numEntries = 0;
+    uint32_t present = 0;
+
+    // Counts and lengths start from nothing
+    for (int32_t x = 0; x < pDesc->numResources; x++) {
+        pResource = &(pDesc->pResources[x]);
+        numValues = 1;
+        if (pResource->maxInstances > 0) {
+            *((int32_t *) (pBase + pResource->countOffset)) = 0;
+            numValues = pResource->maxInstances;
+        }
+        if (pResource->type == LWM2M_RESOURCE_TYPE_OPAQUE) {
+            for (int32_t y = 0; y < numValues; y++) {
+                ((Lwm2mObjectDescOpaque *) (pBase + pResource->offset))[y].length = 0;
+            }
+        }
+    }
+
+    lwm2mArenaStart();
+
+    // Read the whole object once and sort its resource instances,
+    // then look up each resource of the description in them
+    errorCode = lwm2mObjectGet(pDesc->omaId, objectInstanceId, &pObject);
+    if (errorCode == 0) {
+        for (pInstance = pObject->pResources; pInstance != NULL;
+             pInstance = pInstance->pNext) {
+            numEntries++;
+        }
+        // One spare, so that an empty object isn't taken for no memory
+        pEntries = (Lwm2mResourceTableEntry *) malloc((numEntries + 1) * sizeof(*pEntries));
+        if (pEntries != NULL) {
+            lwm2mResourceTableInit(&table, pDesc->omaId, objectInstanceId,
+                                   pEntries, numEntries);
+            lwm2mResourceTableFromObject(&table, pObject);
+            for (int32_t x = 0; x < pDesc->numResources; x++) {
+                pResource = &(pDesc->pResources[x]);
+                numValues = lwm2mResourceTableRange(&table, pResource->resourceId, &pEntry);
+                for (int32_t y = 0; y < numValues; y++, pEntry++) {
+                    if (pResource->maxInstances > 0) {
+                        // The single instance case comes as instance -1
+                        instanceId = (pEntry->instanceId < 0) ? 0 : pEntry->instanceId;
+                        if (instanceId < pResource->maxInstances) {
+                            getValue(pResource, &(pEntry->value),
+                                     pBase + pResource->offset +
+                                     (instanceId * valueSize(pResource->type)));
+                            pCount = (int32_t *) (pBase + pResource->countOffset);
+                            if (instanceId >= *pCount) {
+                                *pCount = instanceId + 1;
+                            }
+                        }
+                    } else {
+                        getValue(pResource, &(pEntry->value), pBase + pResource->offset);
+                    }
+                }
+                if ((numValues > 0) &&
+                    (pResource->resourceId <= LWM2M_OBJECT_DESC_MAX_RESOURCE_ID)) {
+                    present |= LWM2M_OBJECT_DESC_RESOURCE(pResource->resourceId);
+                }
+            }
+            free(pEntries);
+        } else {
+            errorCode = SARA_R412M_LWM2M_OUT_OF_MEMORY;
+        }
+        lwm2mObjectFree(&pObject);
+    }
+
+    lwm2mArenaStop();
+
+    if (pPresent != NULL) {
+        *pPresent = present;
+    }
+
+    return errorCode;
+}
+
+// End Of File
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _LWM2M_OBJECT_DESC_H_
+#define _LWM2M_OBJECT_DESC_H_
+
+/* Table-driven create, write and read of a whole LWM2M object
+ * instance.  An object is described by a table giving, for each
+ * resource, its ID, type, operations, number of instances and
+ * where its value is kept in a C structure of the object; the
+ * tables and structures are generated from the XML definitions
+ * in lwm2m_objects/ by lwm2m_objects/lwm2m_c_generator.lua, one
+ * lwm2m_object_<name>.h per object, so nothing here knows about
+ * any particular object.
+ *
+ * Each of lwm2mObjectDescCreate(), lwm2mObjectDescSet() and
+ * lwm2mObjectDescGet() moves the resources of an instance between
+ * the structure and SARA-R4 in a single LWM2M object operation,
+ * in place of a resource at a time.  The resources moved are
+ * chosen with a mask of LWM2M_OBJECT_DESC_RESOURCE() bits, so
+ * resource IDs must be below 32.
+ *
+ * In the structure an Integer or Time resource is an int32_t, a
+ * Float a float, a Boolean a bool, a String an
+ * Lwm2mObjectDescString and an Opaque an Lwm2mObjectDescOpaque;
+ * a multiple-instance resource is an array of these with an
+ * int32_t count of the instances in use beside it.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lwm2m.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The operations of a resource, as in the XML definitions.
+ */
+#define LWM2M_OBJECT_DESC_OPERATION_R 0x01
+#define LWM2M_OBJECT_DESC_OPERATION_W 0x02
+#define LWM2M_OBJECT_DESC_OPERATION_E 0x04
+
+/** The bit for a resource in a mask of resources.
+ */
+#define LWM2M_OBJECT_DESC_RESOURCE(resourceId) (1UL << (resourceId))
+
+/** The largest resource ID a mask can hold.
+ */
+#define LWM2M_OBJECT_DESC_MAX_RESOURCE_ID 31
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** The value of a String resource.  When writing, pString may
+ * be NULL for an empty string; when reading, up to size - 1
+ * characters are copied to pString, with a terminator, unless it
+ * is NULL.
+ */
+typedef struct {
+    char *pString;
+    int32_t size;
+} Lwm2mObjectDescString;
+
+/** The value of an Opaque resource.  When writing, length bytes
+ * are written from pBytes, which may be NULL if length is zero;
+ * when reading, up to size bytes are copied to pBytes, unless it
+ * is NULL, and length is set to the number copied.
+ */
+typedef struct {
+    uint8_t *pBytes;
+    int32_t length;
+    int32_t size;
+} Lwm2mObjectDescOpaque;
+
+/** A resource of an object.
+ */
+typedef struct {
+    int32_t resourceId;
+    Lwm2mResourceType type;
+    uint8_t operations;   //!< LWM2M_OBJECT_DESC_OPERATION_X bits.
+    bool mandatory;
+    int32_t maxInstances; //!< Zero for a single-instance resource.
+    size_t offset;        //!< Of the value, or the array of values, in the structure.
+    size_t countOffset;   //!< Of the count of instances; multiple-instance only.
+} Lwm2mObjectDescResource;
+
+/** An object.
+ */
+typedef struct {
+    int32_t omaId;
+    const char *pName;
+    const Lwm2mObjectDescResource *pResources;
+    int32_t numResources;
+} Lwm2mObjectDesc;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Create an instance of an object on SARA-R4 with a single LWM2M
+ * object create.  Every instance of a multiple-instance resource,
+ * up to its maximum, is created, those beyond the count being
+ * zero or empty, so that the instance has its full size from the
+ * start.
+ *
+ * @param pDesc            the object.
+ * @param objectInstanceId the instance of the object.
+ * @param shortServerId    the short server ID to create it for.
+ * @param pValues          the structure of the object.
+ * @param resources        the LWM2M_OBJECT_DESC_RESOURCE() bits
+ *                         of the resources to create.
+ * @return                 zero on success, else negative error
+ *                         code.
+ */
+int32_t lwm2mObjectDescCreate(const Lwm2mObjectDesc *pDesc,
+                              int32_t objectInstanceId,
+                              int32_t shortServerId,
+                              const void *pValues, uint32_t resources);
+
+/** Write resources of an instance of an object to SARA-R4 with a
+ * single LWM2M object write; only as many instances of a
+ * multiple-instance resource as its count are written.
+ *
+ * @param pDesc            the object.
+ * @param objectInstanceId the instance of the object.
+ * @param pValues          the structure of the object.
+ * @param resources        the LWM2M_OBJECT_DESC_RESOURCE() bits
+ *                         of the resources to write.
+ * @return                 zero on success, else negative error
+ *                         code.
+ */
+int32_t lwm2mObjectDescSet(const Lwm2mObjectDesc *pDesc,
+                           int32_t objectInstanceId,
+                           const void *pValues, uint32_t resources);
+
+/** Read an instance of an object from SARA-R4 with a single LWM2M
+ * object read.  The counts of multiple-instance resources and the
+ * lengths of Opaque resources start at zero; any other resource
+ * which is not there keeps the value it had, so the structure can
+ * be filled with defaults first.  Nothing is printed on error.
+ *
+ * @param pDesc            the object.
+ * @param objectInstanceId the instance of the object.
+ * @param pValues          the structure of the object.
+ * @param pPresent         place to put the LWM2M_OBJECT_DESC_RESOURCE()
+ *                         bits of the resources that were there;
+ *                         may be NULL.
+ * @return                 zero on success, else negative error
+ *                         code (e.g. if the instance doesn't
+ *                         exist).
+ */
+int32_t lwm2mObjectDescGet(const Lwm2mObjectDesc *pDesc,
+                           int32_t objectInstanceId,
+                           void *pValues, uint32_t *pPresent);
+
+#endif // _LWM2M_OBJECT_DESC_H_
+
+// End Of File
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _LWM2M_OBJECT_I2C_GENERIC_COMMAND_H_
+#define _LWM2M_OBJECT_I2C_GENERIC_COMMAND_H_
+
+/* GENERATED by lwm2m_objects/lwm2m_c_generator.lua 1.1 with:
+ *
+ * lwm2m_c_generator.lua i2c_generic_command.xml
+ *
+ * DO NOT EDIT: change the XML and generate this again.
+ *
+ * The I2C Generic Command object (33050).
+ *
+ * See lwm2m_object_desc.h for how the resources are held.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lwm2m.h"
+#include "lwm2m_object_desc.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The OMA ID of the I2C Generic Command object.
+ */
+#define LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND 33050
+
+/** The version of the I2C Generic Command object this was generated
+ * from; the Lua loaded into SARA-R412M must be the same version.
+ */
+#define LWM2M_OBJECT_VERSION_I2C_GENERIC_COMMAND "2.0"
+
+/** The resources of the I2C Generic Command object.
+ */
+#define LWM2M_I2C_GENERIC_COMMAND_RESOURCE_DEVICE_I2C_ADDRESS 1
+#define LWM2M_I2C_GENERIC_COMMAND_RESOURCE_DEVICE_NAME        2
+#define LWM2M_I2C_GENERIC_COMMAND_RESOURCE_COMMAND_NAME       3
+#define LWM2M_I2C_GENERIC_COMMAND_RESOURCE_TRIGGER_CONDITION  4
+#define LWM2M_I2C_GENERIC_COMMAND_RESOURCE_WRITE_SEQUENCE     5
+#define LWM2M_I2C_GENERIC_COMMAND_RESOURCE_WRITE_SUCCESS      6
+#define LWM2M_I2C_GENERIC_COMMAND_RESOURCE_DELAY              7
+#define LWM2M_I2C_GENERIC_COMMAND_RESOURCE_RESPONSE_SIZE      8
+#define LWM2M_I2C_GENERIC_COMMAND_RESOURCE_READ_RESPONSE      9
+#define LWM2M_I2C_GENERIC_COMMAND_RESOURCE_READ_TIMESTAMP     10
+#define LWM2M_I2C_GENERIC_COMMAND_RESOURCE_SAMPLE_BATCH       11
+
+/** The LWM2M_OBJECT_DESC_RESOURCE() bits of all of the resources
+ * of the I2C Generic Command object.
+ */
+#define LWM2M_I2C_GENERIC_COMMAND_RESOURCES_ALL (LWM2M_OBJECT_DESC_RESOURCE(1) | \
+                                                 LWM2M_OBJECT_DESC_RESOURCE(2) | \
+                                                 LWM2M_OBJECT_DESC_RESOURCE(3) | \
+                                                 LWM2M_OBJECT_DESC_RESOURCE(4) | \
+                                                 LWM2M_OBJECT_DESC_RESOURCE(5) | \
+                                                 LWM2M_OBJECT_DESC_RESOURCE(6) | \
+                                                 LWM2M_OBJECT_DESC_RESOURCE(7) | \
+                                                 LWM2M_OBJECT_DESC_RESOURCE(8) | \
+                                                 LWM2M_OBJECT_DESC_RESOURCE(9) | \
+                                                 LWM2M_OBJECT_DESC_RESOURCE(10) | \
+                                                 LWM2M_OBJECT_DESC_RESOURCE(11))
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** The resources of an instance of the I2C Generic Command object.
+ */
+typedef struct {
+    int32_t deviceI2cAddress;            //!< Device I2C Address (1).
+    Lwm2mObjectDescString deviceName;    //!< Device Name (2).
+    Lwm2mObjectDescString commandName;   //!< Command Name (3).
+    int32_t triggerCondition;            //!< Trigger Condition (4).
+    Lwm2mObjectDescOpaque writeSequence; //!< Write Sequence (5).
+    bool writeSuccess;                   //!< Write Success (6).
+    int32_t delay;                       //!< Delay (7).
+    int32_t responseSize;                //!< Response Size (8), B.
+    Lwm2mObjectDescOpaque readResponse;  //!< Read Response (9).
+    int32_t readTimestamp;               //!< Read Timestamp (10).
+    Lwm2mObjectDescOpaque sampleBatch;   //!< Sample Batch (11).
+} Lwm2mI2cGenericCommand;
+
+// ----------------------------------------------------------------
+// TABLES
+// ----------------------------------------------------------------
+
+/** The resources of the I2C Generic Command object, in order of ID.
+ */
+static const Lwm2mObjectDescResource gLwm2mI2cGenericCommandResources[] = {
+    {LWM2M_I2C_GENERIC_COMMAND_RESOURCE_DEVICE_I2C_ADDRESS, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true, 0,
+     offsetof(Lwm2mI2cGenericCommand, deviceI2cAddress), 0},
+    {LWM2M_I2C_GENERIC_COMMAND_RESOURCE_DEVICE_NAME, LWM2M_RESOURCE_TYPE_STRING,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, false, 0,
+     offsetof(Lwm2mI2cGenericCommand, deviceName), 0},
+    {LWM2M_I2C_GENERIC_COMMAND_RESOURCE_COMMAND_NAME, LWM2M_RESOURCE_TYPE_STRING,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, false, 0,
+     offsetof(Lwm2mI2cGenericCommand, commandName), 0},
+    {LWM2M_I2C_GENERIC_COMMAND_RESOURCE_TRIGGER_CONDITION, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true, 0,
+     offsetof(Lwm2mI2cGenericCommand, triggerCondition), 0},
+    {LWM2M_I2C_GENERIC_COMMAND_RESOURCE_WRITE_SEQUENCE, LWM2M_RESOURCE_TYPE_OPAQUE,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true, 0,
+     offsetof(Lwm2mI2cGenericCommand, writeSequence), 0},
+    {LWM2M_I2C_GENERIC_COMMAND_RESOURCE_WRITE_SUCCESS, LWM2M_RESOURCE_TYPE_BOOLEAN,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true, 0,
+     offsetof(Lwm2mI2cGenericCommand, writeSuccess), 0},
+    {LWM2M_I2C_GENERIC_COMMAND_RESOURCE_DELAY, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, false, 0,
+     offsetof(Lwm2mI2cGenericCommand, delay), 0},
+    {LWM2M_I2C_GENERIC_COMMAND_RESOURCE_RESPONSE_SIZE, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true, 0,
+     offsetof(Lwm2mI2cGenericCommand, responseSize), 0},
+    {LWM2M_I2C_GENERIC_COMMAND_RESOURCE_READ_RESPONSE, LWM2M_RESOURCE_TYPE_OPAQUE,
+     LWM2M_OBJECT_DESC_OPERATION_R, true, 0,
+     offsetof(Lwm2mI2cGenericCommand, readResponse), 0},
+    {LWM2M_I2C_GENERIC_COMMAND_RESOURCE_READ_TIMESTAMP, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R, false, 0,
+     offsetof(Lwm2mI2cGenericCommand, readTimestamp), 0},
+    {LWM2M_I2C_GENERIC_COMMAND_RESOURCE_SAMPLE_BATCH, LWM2M_RESOURCE_TYPE_OPAQUE,
+     LWM2M_OBJECT_DESC_OPERATION_R, false, 0,
+     offsetof(Lwm2mI2cGenericCommand, sampleBatch), 0}
+};
+
+/** The I2C Generic Command object.
+ */
+static const Lwm2mObjectDesc gLwm2mI2cGenericCommand = {
+    LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND, "I2C Generic Command",
+    gLwm2mI2cGenericCommandResources,
+    sizeof(gLwm2mI2cGenericCommandResources) / sizeof(gLwm2mI2cGenericCommandResources[0])
+};
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Create an instance of the I2C Generic Command object, see
+ * lwm2mObjectDescCreate().
+ */
+static inline int32_t lwm2mI2cGenericCommandCreate(int32_t objectInstanceId,
+                                                   int32_t shortServerId,
+                                                   const Lwm2mI2cGenericCommand *pValues,
+                                                   uint32_t resources)
+{
+    return lwm2mObjectDescCreate(&gLwm2mI2cGenericCommand, objectInstanceId,
+                                 shortServerId, pValues, resources);
+}
+
+/** Write resources of an instance of the I2C Generic Command object,
+ * see lwm2mObjectDescSet().
+ */
+static inline int32_t lwm2mI2cGenericCommandSet(int32_t objectInstanceId,
+                                                const Lwm2mI2cGenericCommand *pValues,
+                                                uint32_t resources)
+{
+    return lwm2mObjectDescSet(&gLwm2mI2cGenericCommand, objectInstanceId,
+                              pValues, resources);
+}
+
+/** Read an instance of the I2C Generic Command object, see
+ * lwm2mObjectDescGet().
+ */
+static inline int32_t lwm2mI2cGenericCommandGet(int32_t objectInstanceId,
+                                                Lwm2mI2cGenericCommand *pValues,
+                                                uint32_t *pPresent)
+{
+    return lwm2mObjectDescGet(&gLwm2mI2cGenericCommand, objectInstanceId,
+                              pValues, pPresent);
+}
+
+#endif // _LWM2M_OBJECT_I2C_GENERIC_COMMAND_H_
+
+// End Of File
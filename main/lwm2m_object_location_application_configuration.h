@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _LWM2M_OBJECT_LOCATION_APPLICATION_CONFIGURATION_H_
+#define _LWM2M_OBJECT_LOCATION_APPLICATION_CONFIGURATION_H_
+
+/* GENERATED by lwm2m_objects/lwm2m_c_generator.lua 1.1 with:
+ *
+ * lwm2m_c_generator.lua location_application_configuration.xml
+ *
+ * DO NOT EDIT: change the XML and generate this again.
+ *
+ * The Location Application Configuration object (33053):
+ *
+ * This object can be used to configure how the device determines
+ * location fix and desired accuracy versus time taken to produce
+ * the result.
+ *
+ * See lwm2m_object_desc.h for how the resources are held.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lwm2m.h"
+#include "lwm2m_object_desc.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The OMA ID of the Location Application Configuration object.
+ */
+#define LWM2M_OBJECT_OMA_ID_LOCATION_APPLICATION_CONFIGURATION 33053
+
+/** The version of the Location Application Configuration object this was generated
+ * from; the Lua loaded into SARA-R412M must be the same version.
+ */
+#define LWM2M_OBJECT_VERSION_LOCATION_APPLICATION_CONFIGURATION "1.0"
+
+/** The resources of the Location Application Configuration object.
+ */
+#define LWM2M_LOCATION_APPLICATION_CONFIGURATION_RESOURCE_WIFI_SCAN_REQUIRED                        1
+#define LWM2M_LOCATION_APPLICATION_CONFIGURATION_RESOURCE_GNSS_REQUIRED_FOR_LOCATION_FIX            2
+#define LWM2M_LOCATION_APPLICATION_CONFIGURATION_RESOURCE_GNSS_LOCATION_RADIUS                      3
+#define LWM2M_LOCATION_APPLICATION_CONFIGURATION_RESOURCE_GNSS_ALLOTTED_LOCATION_ESTABLISHMENT_TIME 4
+
+/** The LWM2M_OBJECT_DESC_RESOURCE() bits of all of the resources
+ * of the Location Application Configuration object.
+ */
+#define LWM2M_LOCATION_APPLICATION_CONFIGURATION_RESOURCES_ALL (LWM2M_OBJECT_DESC_RESOURCE(1) | \
+                                                                LWM2M_OBJECT_DESC_RESOURCE(2) | \
+                                                                LWM2M_OBJECT_DESC_RESOURCE(3) | \
+                                                                LWM2M_OBJECT_DESC_RESOURCE(4))
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** The resources of an instance of the Location Application Configuration object.
+ */
+typedef struct {
+    bool wifiScanRequired;                         //!< WiFi Scan Required (1).
+    bool gnssRequiredForLocationFix;               //!< GNSS Required for Location Fix (2).
+    float gnssLocationRadius;                      //!< GNSS Location Radius (3), m.
+    int32_t gnssAllottedLocationEstablishmentTime; //!< GNSS Allotted Location Establishment Time (4), s.
+} Lwm2mLocationApplicationConfiguration;
+
+// ----------------------------------------------------------------
+// TABLES
+// ----------------------------------------------------------------
+
+/** The resources of the Location Application Configuration object, in order of ID.
+ */
+static const Lwm2mObjectDescResource gLwm2mLocationApplicationConfigurationResources[] = {
+    {LWM2M_LOCATION_APPLICATION_CONFIGURATION_RESOURCE_WIFI_SCAN_REQUIRED, LWM2M_RESOURCE_TYPE_BOOLEAN,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true, 0,
+     offsetof(Lwm2mLocationApplicationConfiguration, wifiScanRequired), 0},
+    {LWM2M_LOCATION_APPLICATION_CONFIGURATION_RESOURCE_GNSS_REQUIRED_FOR_LOCATION_FIX, LWM2M_RESOURCE_TYPE_BOOLEAN,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true, 0,
+     offsetof(Lwm2mLocationApplicationConfiguration, gnssRequiredForLocationFix), 0},
+    {LWM2M_LOCATION_APPLICATION_CONFIGURATION_RESOURCE_GNSS_LOCATION_RADIUS, LWM2M_RESOURCE_TYPE_FLOAT,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true, 0,
+     offsetof(Lwm2mLocationApplicationConfiguration, gnssLocationRadius), 0},
+    {LWM2M_LOCATION_APPLICATION_CONFIGURATION_RESOURCE_GNSS_ALLOTTED_LOCATION_ESTABLISHMENT_TIME, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true, 0,
+     offsetof(Lwm2mLocationApplicationConfiguration, gnssAllottedLocationEstablishmentTime), 0}
+};
+
+/** The Location Application Configuration object.
+ */
+static const Lwm2mObjectDesc gLwm2mLocationApplicationConfiguration = {
+    LWM2M_OBJECT_OMA_ID_LOCATION_APPLICATION_CONFIGURATION, "Location Application Configuration",
+    gLwm2mLocationApplicationConfigurationResources,
+    sizeof(gLwm2mLocationApplicationConfigurationResources) / sizeof(gLwm2mLocationApplicationConfigurationResources[0])
+};
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Create an instance of the Location Application Configuration object, see
+ * lwm2mObjectDescCreate().
+ */
+static inline int32_t lwm2mLocationApplicationConfigurationCreate(int32_t objectInstanceId,
+                                                                  int32_t shortServerId,
+                                                                  const Lwm2mLocationApplicationConfiguration *pValues,
+                                                                  uint32_t resources)
+{
+    return lwm2mObjectDescCreate(&gLwm2mLocationApplicationConfiguration, objectInstanceId,
+                                 shortServerId, pValues, resources);
+}
+
+/** Write resources of an instance of the Location Application Configuration object,
+ * see lwm2mObjectDescSet().
+ */
+static inline int32_t lwm2mLocationApplicationConfigurationSet(int32_t objectInstanceId,
+                                                               const Lwm2mLocationApplicationConfiguration *pValues,
+                                                               uint32_t resources)
+{
+    return lwm2mObjectDescSet(&gLwm2mLocationApplicationConfiguration, objectInstanceId,
+                              pValues, resources);
+}
+
+/** Read an instance of the Location Application Configuration object, see
+ * lwm2mObjectDescGet().
+ */
+static inline int32_t lwm2mLocationApplicationConfigurationGet(int32_t objectInstanceId,
+                                                               Lwm2mLocationApplicationConfiguration *pValues,
+                                                               uint32_t *pPresent)
+{
+    return lwm2mObjectDescGet(&gLwm2mLocationApplicationConfiguration, objectInstanceId,
+                              pValues, pPresent);
+}
+
+#endif // _LWM2M_OBJECT_LOCATION_APPLICATION_CONFIGURATION_H_
+
+// End Of File
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _LWM2M_OBJECT_MODEM_CONFIGURATION_H_
+#define _LWM2M_OBJECT_MODEM_CONFIGURATION_H_
+
+/* GENERATED by lwm2m_objects/lwm2m_c_generator.lua 1.1 with:
+ *
+ * lwm2m_c_generator.lua modem_configuration.xml 4=8
+ *
+ * DO NOT EDIT: change the XML and generate this again.
+ *
+ * The Modem Configuration object (33051):
+ *
+ * This object specifies resources for power saving configuration of
+ * modem as well as controlling which RAT is selected in a multi RAT
+ * modem when appropriate. Apart from RAT List resource all the
+ * other resources of this object are already defined in OMA
+ * Cellular Connectivity Object, ID 10. Therefore, if RAT List
+ * resource is not required, it's recommended to use standard object
+ * instead of this one.
+ *
+ * See lwm2m_object_desc.h for how the resources are held.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lwm2m.h"
+#include "lwm2m_object_desc.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The OMA ID of the Modem Configuration object.
+ */
+#define LWM2M_OBJECT_OMA_ID_MODEM_CONFIGURATION 33051
+
+/** The version of the Modem Configuration object this was generated
+ * from; the Lua loaded into SARA-R412M must be the same version.
+ */
+#define LWM2M_OBJECT_VERSION_MODEM_CONFIGURATION "1.0"
+
+/** The resources of the Modem Configuration object.
+ */
+#define LWM2M_MODEM_CONFIGURATION_RESOURCE_PSM_TIMER                 1
+#define LWM2M_MODEM_CONFIGURATION_RESOURCE_ACTIVE_TIMER              2
+#define LWM2M_MODEM_CONFIGURATION_RESOURCE_EDRX                      3
+#define LWM2M_MODEM_CONFIGURATION_RESOURCE_RAT_LIST                  4
+#define LWM2M_MODEM_CONFIGURATION_RESOURCE_SERVING_PLMN_RATE_CONTROL 5
+
+/** The LWM2M_OBJECT_DESC_RESOURCE() bits of all of the resources
+ * of the Modem Configuration object.
+ */
+#define LWM2M_MODEM_CONFIGURATION_RESOURCES_ALL (LWM2M_OBJECT_DESC_RESOURCE(1) | \
+                                                 LWM2M_OBJECT_DESC_RESOURCE(2) | \
+                                                 LWM2M_OBJECT_DESC_RESOURCE(3) | \
+                                                 LWM2M_OBJECT_DESC_RESOURCE(4) | \
+                                                 LWM2M_OBJECT_DESC_RESOURCE(5))
+
+/** The most instances of the RAT List resource held.
+ */
+#ifndef LWM2M_MODEM_CONFIGURATION_RAT_LIST_MAX_INSTANCES
+# define LWM2M_MODEM_CONFIGURATION_RAT_LIST_MAX_INSTANCES 8
+#endif
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** The resources of an instance of the Modem Configuration object.
+ */
+typedef struct {
+    int32_t psmTimer;                  //!< PSM Timer (1), s.
+    Lwm2mObjectDescOpaque activeTimer; //!< Active Timer (2), s.
+    Lwm2mObjectDescOpaque edrx;        //!< eDRX (3), s.
+    int32_t ratList[LWM2M_MODEM_CONFIGURATION_RAT_LIST_MAX_INSTANCES]; //!< RAT List (4).
+    int32_t numRatList;                //!< The number of instances of RAT List.
+    int32_t servingPlmnRateControl;    //!< Serving PLMN Rate Control (5).
+} Lwm2mModemConfiguration;
+
+// ----------------------------------------------------------------
+// TABLES
+// ----------------------------------------------------------------
+
+/** The resources of the Modem Configuration object, in order of ID.
+ */
+static const Lwm2mObjectDescResource gLwm2mModemConfigurationResources[] = {
+    {LWM2M_MODEM_CONFIGURATION_RESOURCE_PSM_TIMER, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true, 0,
+     offsetof(Lwm2mModemConfiguration, psmTimer), 0},
+    {LWM2M_MODEM_CONFIGURATION_RESOURCE_ACTIVE_TIMER, LWM2M_RESOURCE_TYPE_OPAQUE,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true, 0,
+     offsetof(Lwm2mModemConfiguration, activeTimer), 0},
+    {LWM2M_MODEM_CONFIGURATION_RESOURCE_EDRX, LWM2M_RESOURCE_TYPE_OPAQUE,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, false, 0,
+     offsetof(Lwm2mModemConfiguration, edrx), 0},
+    {LWM2M_MODEM_CONFIGURATION_RESOURCE_RAT_LIST, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, false,
+     LWM2M_MODEM_CONFIGURATION_RAT_LIST_MAX_INSTANCES,
+     offsetof(Lwm2mModemConfiguration, ratList),
+     offsetof(Lwm2mModemConfiguration, numRatList)},
+    {LWM2M_MODEM_CONFIGURATION_RESOURCE_SERVING_PLMN_RATE_CONTROL, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R, false, 0,
+     offsetof(Lwm2mModemConfiguration, servingPlmnRateControl), 0}
+};
+
+/** The Modem Configuration object.
+ */
+static const Lwm2mObjectDesc gLwm2mModemConfiguration = {
+    LWM2M_OBJECT_OMA_ID_MODEM_CONFIGURATION, "Modem Configuration",
+    gLwm2mModemConfigurationResources,
+    sizeof(gLwm2mModemConfigurationResources) / sizeof(gLwm2mModemConfigurationResources[0])
+};
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Create an instance of the Modem Configuration object, see
+ * lwm2mObjectDescCreate().
+ */
+static inline int32_t lwm2mModemConfigurationCreate(int32_t objectInstanceId,
+                                                    int32_t shortServerId,
+                                                    const Lwm2mModemConfiguration *pValues,
+                                                    uint32_t resources)
+{
+    return lwm2mObjectDescCreate(&gLwm2mModemConfiguration, objectInstanceId,
+                                 shortServerId, pValues, resources);
+}
+
+/** Write resources of an instance of the Modem Configuration object,
+ * see lwm2mObjectDescSet().
+ */
+static inline int32_t lwm2mModemConfigurationSet(int32_t objectInstanceId,
+                                                 const Lwm2mModemConfiguration *pValues,
+                                                 uint32_t resources)
+{
+    return lwm2mObjectDescSet(&gLwm2mModemConfiguration, objectInstanceId,
+                              pValues, resources);
+}
+
+/** Read an instance of the Modem Configuration object, see
+ * lwm2mObjectDescGet().
+ */
+static inline int32_t lwm2mModemConfigurationGet(int32_t objectInstanceId,
+                                                 Lwm2mModemConfiguration *pValues,
+                                                 uint32_t *pPresent)
+{
+    return lwm2mObjectDescGet(&gLwm2mModemConfiguration, objectInstanceId,
+                              pValues, pPresent);
+}
+
+#endif // _LWM2M_OBJECT_MODEM_CONFIGURATION_H_
+
+// End Of File
@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _LWM2M_OBJECT_WHRE_CHANNEL_STATISTICS_H_
+#define _LWM2M_OBJECT_WHRE_CHANNEL_STATISTICS_H_
+
+/* GENERATED by lwm2m_objects/lwm2m_c_generator.lua 1.1 with:
+ *
+ * lwm2m_c_generator.lua whre_channel_statistics.xml 16
+ *
+ * DO NOT EDIT: change the XML and generate this again.
+ *
+ * The WHRE Channel Statistics object (33055):
+ *
+ * This object provides statistics of each sensor channel of a WHRE
+ * device over a reporting period, kept on the device as the samples
+ * are taken, so that one summary per report can be read rather than
+ * every sample
+ *
+ * See lwm2m_object_desc.h for how the resources are held.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lwm2m.h"
+#include "lwm2m_object_desc.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The OMA ID of the WHRE Channel Statistics object.
+ */
+#define LWM2M_OBJECT_OMA_ID_WHRE_CHANNEL_STATISTICS 33055
+
+/** The version of the WHRE Channel Statistics object this was generated
+ * from; the Lua loaded into SARA-R412M must be the same version.
+ */
+#define LWM2M_OBJECT_VERSION_WHRE_CHANNEL_STATISTICS "1.0"
+
+/** The resources of the WHRE Channel Statistics object.
+ */
+#define LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_NUMBER_OF_CHANNELS 1
+#define LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_PERIOD_START       2
+#define LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_CHANNEL            3
+#define LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_SAMPLE_COUNT       4
+#define LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_MINIMUM            5
+#define LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_MAXIMUM            6
+#define LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_MEAN               7
+#define LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_VARIANCE           8
+#define LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_LAST_VALUE         9
+#define LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_UNTRACKED_VALUES   10
+
+/** The LWM2M_OBJECT_DESC_RESOURCE() bits of all of the resources
+ * of the WHRE Channel Statistics object.
+ */
+#define LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCES_ALL (LWM2M_OBJECT_DESC_RESOURCE(1) | \
+                                                     LWM2M_OBJECT_DESC_RESOURCE(2) | \
+                                                     LWM2M_OBJECT_DESC_RESOURCE(3) | \
+                                                     LWM2M_OBJECT_DESC_RESOURCE(4) | \
+                                                     LWM2M_OBJECT_DESC_RESOURCE(5) | \
+                                                     LWM2M_OBJECT_DESC_RESOURCE(6) | \
+                                                     LWM2M_OBJECT_DESC_RESOURCE(7) | \
+                                                     LWM2M_OBJECT_DESC_RESOURCE(8) | \
+                                                     LWM2M_OBJECT_DESC_RESOURCE(9) | \
+                                                     LWM2M_OBJECT_DESC_RESOURCE(10))
+
+/** The most instances of the Channel resource held.
+ */
+#ifndef LWM2M_WHRE_CHANNEL_STATISTICS_CHANNEL_MAX_INSTANCES
+# define LWM2M_WHRE_CHANNEL_STATISTICS_CHANNEL_MAX_INSTANCES 16
+#endif
+
+/** The most instances of the Sample Count resource held.
+ */
+#ifndef LWM2M_WHRE_CHANNEL_STATISTICS_SAMPLE_COUNT_MAX_INSTANCES
+# define LWM2M_WHRE_CHANNEL_STATISTICS_SAMPLE_COUNT_MAX_INSTANCES 16
+#endif
+
+/** The most instances of the Minimum resource held.
+ */
+#ifndef LWM2M_WHRE_CHANNEL_STATISTICS_MINIMUM_MAX_INSTANCES
+# define LWM2M_WHRE_CHANNEL_STATISTICS_MINIMUM_MAX_INSTANCES 16
+#endif
+
+/** The most instances of the Maximum resource held.
+ */
+#ifndef LWM2M_WHRE_CHANNEL_STATISTICS_MAXIMUM_MAX_INSTANCES
+# define LWM2M_WHRE_CHANNEL_STATISTICS_MAXIMUM_MAX_INSTANCES 16
+#endif
+
+/** The most instances of the Mean resource held.
+ */
+#ifndef LWM2M_WHRE_CHANNEL_STATISTICS_MEAN_MAX_INSTANCES
+# define LWM2M_WHRE_CHANNEL_STATISTICS_MEAN_MAX_INSTANCES 16
+#endif
+
+/** The most instances of the Variance resource held.
+ */
+#ifndef LWM2M_WHRE_CHANNEL_STATISTICS_VARIANCE_MAX_INSTANCES
+# define LWM2M_WHRE_CHANNEL_STATISTICS_VARIANCE_MAX_INSTANCES 16
+#endif
+
+/** The most instances of the Last Value resource held.
+ */
+#ifndef LWM2M_WHRE_CHANNEL_STATISTICS_LAST_VALUE_MAX_INSTANCES
+# define LWM2M_WHRE_CHANNEL_STATISTICS_LAST_VALUE_MAX_INSTANCES 16
+#endif
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** The resources of an instance of the WHRE Channel Statistics object.
+ */
+typedef struct {
+    int32_t numberOfChannels; //!< Number of Channels (1).
+    int32_t periodStart;      //!< Period Start (2), s.
+    int32_t channel[LWM2M_WHRE_CHANNEL_STATISTICS_CHANNEL_MAX_INSTANCES]; //!< Channel (3).
+    int32_t numChannel;       //!< The number of instances of Channel.
+    int32_t sampleCount[LWM2M_WHRE_CHANNEL_STATISTICS_SAMPLE_COUNT_MAX_INSTANCES]; //!< Sample Count (4).
+    int32_t numSampleCount;   //!< The number of instances of Sample Count.
+    int32_t minimum[LWM2M_WHRE_CHANNEL_STATISTICS_MINIMUM_MAX_INSTANCES]; //!< Minimum (5).
+    int32_t numMinimum;       //!< The number of instances of Minimum.
+    int32_t maximum[LWM2M_WHRE_CHANNEL_STATISTICS_MAXIMUM_MAX_INSTANCES]; //!< Maximum (6).
+    int32_t numMaximum;       //!< The number of instances of Maximum.
+    float mean[LWM2M_WHRE_CHANNEL_STATISTICS_MEAN_MAX_INSTANCES]; //!< Mean (7).
+    int32_t numMean;          //!< The number of instances of Mean.
+    float variance[LWM2M_WHRE_CHANNEL_STATISTICS_VARIANCE_MAX_INSTANCES]; //!< Variance (8).
+    int32_t numVariance;      //!< The number of instances of Variance.
+    int32_t lastValue[LWM2M_WHRE_CHANNEL_STATISTICS_LAST_VALUE_MAX_INSTANCES]; //!< Last Value (9).
+    int32_t numLastValue;     //!< The number of instances of Last Value.
+    int32_t untrackedValues;  //!< Untracked Values (10).
+} Lwm2mWhreChannelStatistics;
+
+// ----------------------------------------------------------------
+// TABLES
+// ----------------------------------------------------------------
+
+/** The resources of the WHRE Channel Statistics object, in order of ID.
+ */
+static const Lwm2mObjectDescResource gLwm2mWhreChannelStatisticsResources[] = {
+    {LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_NUMBER_OF_CHANNELS, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R, true, 0,
+     offsetof(Lwm2mWhreChannelStatistics, numberOfChannels), 0},
+    {LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_PERIOD_START, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R, true, 0,
+     offsetof(Lwm2mWhreChannelStatistics, periodStart), 0},
+    {LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_CHANNEL, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R, true,
+     LWM2M_WHRE_CHANNEL_STATISTICS_CHANNEL_MAX_INSTANCES,
+     offsetof(Lwm2mWhreChannelStatistics, channel),
+     offsetof(Lwm2mWhreChannelStatistics, numChannel)},
+    {LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_SAMPLE_COUNT, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R, true,
+     LWM2M_WHRE_CHANNEL_STATISTICS_SAMPLE_COUNT_MAX_INSTANCES,
+     offsetof(Lwm2mWhreChannelStatistics, sampleCount),
+     offsetof(Lwm2mWhreChannelStatistics, numSampleCount)},
+    {LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_MINIMUM, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R, true,
+     LWM2M_WHRE_CHANNEL_STATISTICS_MINIMUM_MAX_INSTANCES,
+     offsetof(Lwm2mWhreChannelStatistics, minimum),
+     offsetof(Lwm2mWhreChannelStatistics, numMinimum)},
+    {LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_MAXIMUM, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R, true,
+     LWM2M_WHRE_CHANNEL_STATISTICS_MAXIMUM_MAX_INSTANCES,
+     offsetof(Lwm2mWhreChannelStatistics, maximum),
+     offsetof(Lwm2mWhreChannelStatistics, numMaximum)},
+    {LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_MEAN, LWM2M_RESOURCE_TYPE_FLOAT,
+     LWM2M_OBJECT_DESC_OPERATION_R, true,
+     LWM2M_WHRE_CHANNEL_STATISTICS_MEAN_MAX_INSTANCES,
+     offsetof(Lwm2mWhreChannelStatistics, mean),
+     offsetof(Lwm2mWhreChannelStatistics, numMean)},
+    {LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_VARIANCE, LWM2M_RESOURCE_TYPE_FLOAT,
+     LWM2M_OBJECT_DESC_OPERATION_R, true,
+     LWM2M_WHRE_CHANNEL_STATISTICS_VARIANCE_MAX_INSTANCES,
+     offsetof(Lwm2mWhreChannelStatistics, variance),
+     offsetof(Lwm2mWhreChannelStatistics, numVariance)},
+    {LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_LAST_VALUE, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R, true,
+     LWM2M_WHRE_CHANNEL_STATISTICS_LAST_VALUE_MAX_INSTANCES,
+     offsetof(Lwm2mWhreChannelStatistics, lastValue),
+     offsetof(Lwm2mWhreChannelStatistics, numLastValue)},
+    {LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCE_UNTRACKED_VALUES, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R, false, 0,
+     offsetof(Lwm2mWhreChannelStatistics, untrackedValues), 0}
+};
+
+/** The WHRE Channel Statistics object.
+ */
+static const Lwm2mObjectDesc gLwm2mWhreChannelStatistics = {
+    LWM2M_OBJECT_OMA_ID_WHRE_CHANNEL_STATISTICS, "WHRE Channel Statistics",
+    gLwm2mWhreChannelStatisticsResources,
+    sizeof(gLwm2mWhreChannelStatisticsResources) / sizeof(gLwm2mWhreChannelStatisticsResources[0])
+};
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Create an instance of the WHRE Channel Statistics object, see
+ * lwm2mObjectDescCreate().
+ */
+static inline int32_t lwm2mWhreChannelStatisticsCreate(int32_t objectInstanceId,
+                                                       int32_t shortServerId,
+                                                       const Lwm2mWhreChannelStatistics *pValues,
+                                                       uint32_t resources)
+{
+    return lwm2mObjectDescCreate(&gLwm2mWhreChannelStatistics, objectInstanceId,
+                                 shortServerId, pValues, resources);
+}
+
+/** Write resources of an instance of the WHRE Channel Statistics object,
+ * see lwm2mObjectDescSet().
+ */
+static inline int32_t lwm2mWhreChannelStatisticsSet(int32_t objectInstanceId,
+                                                    const Lwm2mWhreChannelStatistics *pValues,
+                                                    uint32_t resources)
+{
+    return lwm2mObjectDescSet(&gLwm2mWhreChannelStatistics, objectInstanceId,
+                              pValues, resources);
+}
+
+/** Read an instance of the WHRE Channel Statistics object, see
+ * lwm2mObjectDescGet().
+ */
+static inline int32_t lwm2mWhreChannelStatisticsGet(int32_t objectInstanceId,
+                                                    Lwm2mWhreChannelStatistics *pValues,
+                                                    uint32_t *pPresent)
+{
+    return lwm2mObjectDescGet(&gLwm2mWhreChannelStatistics, objectInstanceId,
+                              pValues, pPresent);
+}
+
+#endif // _LWM2M_OBJECT_WHRE_CHANNEL_STATISTICS_H_
+
+// End Of File
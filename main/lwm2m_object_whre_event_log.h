@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _LWM2M_OBJECT_WHRE_EVENT_LOG_H_
+#define _LWM2M_OBJECT_WHRE_EVENT_LOG_H_
+
+/* GENERATED by lwm2m_objects/lwm2m_c_generator.lua 1.1 with:
+ *
+ * lwm2m_c_generator.lua whre_event_log.xml
+ *
+ * DO NOT EDIT: change the XML and generate this again.
+ *
+ * The WHRE Event Log object (33057):
+ *
+ * This object carries the event log of a WHRE device, which the
+ * device keeps in flash so that it survives deep sleep and reset,
+ * in batches sent at each report
+ *
+ * See lwm2m_object_desc.h for how the resources are held.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lwm2m.h"
+#include "lwm2m_object_desc.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The OMA ID of the WHRE Event Log object.
+ */
+#define LWM2M_OBJECT_OMA_ID_WHRE_EVENT_LOG 33057
+
+/** The version of the WHRE Event Log object this was generated
+ * from; the Lua loaded into SARA-R412M must be the same version.
+ */
+#define LWM2M_OBJECT_VERSION_WHRE_EVENT_LOG "1.0"
+
+/** The resources of the WHRE Event Log object.
+ */
+#define LWM2M_WHRE_EVENT_LOG_RESOURCE_EVENT_BATCH 1
+#define LWM2M_WHRE_EVENT_LOG_RESOURCE_EVENTS_LOST 2
+
+/** The LWM2M_OBJECT_DESC_RESOURCE() bits of all of the resources
+ * of the WHRE Event Log object.
+ */
+#define LWM2M_WHRE_EVENT_LOG_RESOURCES_ALL (LWM2M_OBJECT_DESC_RESOURCE(1) | \
+                                            LWM2M_OBJECT_DESC_RESOURCE(2))
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** The resources of an instance of the WHRE Event Log object.
+ */
+typedef struct {
+    Lwm2mObjectDescOpaque eventBatch; //!< Event Batch (1).
+    int32_t eventsLost;               //!< Events Lost (2).
+} Lwm2mWhreEventLog;
+
+// ----------------------------------------------------------------
+// TABLES
+// ----------------------------------------------------------------
+
+/** The resources of the WHRE Event Log object, in order of ID.
+ */
+static const Lwm2mObjectDescResource gLwm2mWhreEventLogResources[] = {
+    {LWM2M_WHRE_EVENT_LOG_RESOURCE_EVENT_BATCH, LWM2M_RESOURCE_TYPE_OPAQUE,
+     LWM2M_OBJECT_DESC_OPERATION_R, true, 0,
+     offsetof(Lwm2mWhreEventLog, eventBatch), 0},
+    {LWM2M_WHRE_EVENT_LOG_RESOURCE_EVENTS_LOST, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R, true, 0,
+     offsetof(Lwm2mWhreEventLog, eventsLost), 0}
+};
+
+/** The WHRE Event Log object.
+ */
+static const Lwm2mObjectDesc gLwm2mWhreEventLog = {
+    LWM2M_OBJECT_OMA_ID_WHRE_EVENT_LOG, "WHRE Event Log",
+    gLwm2mWhreEventLogResources,
+    sizeof(gLwm2mWhreEventLogResources) / sizeof(gLwm2mWhreEventLogResources[0])
+};
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Create an instance of the WHRE Event Log object, see
+ * lwm2mObjectDescCreate().
+ */
+static inline int32_t lwm2mWhreEventLogCreate(int32_t objectInstanceId,
+                                              int32_t shortServerId,
+                                              const Lwm2mWhreEventLog *pValues,
+                                              uint32_t resources)
+{
+    return lwm2mObjectDescCreate(&gLwm2mWhreEventLog, objectInstanceId,
+                                 shortServerId, pValues, resources);
+}
+
+/** Write resources of an instance of the WHRE Event Log object,
+ * see lwm2mObjectDescSet().
+ */
+static inline int32_t lwm2mWhreEventLogSet(int32_t objectInstanceId,
+                                           const Lwm2mWhreEventLog *pValues,
+                                           uint32_t resources)
+{
+    return lwm2mObjectDescSet(&gLwm2mWhreEventLog, objectInstanceId,
+                              pValues, resources);
+}
+
+/** Read an instance of the WHRE Event Log object, see
+ * lwm2mObjectDescGet().
+ */
+static inline int32_t lwm2mWhreEventLogGet(int32_t objectInstanceId,
+                                           Lwm2mWhreEventLog *pValues,
+                                           uint32_t *pPresent)
+{
+    return lwm2mObjectDescGet(&gLwm2mWhreEventLog, objectInstanceId,
+                              pValues, pPresent);
+}
+
+#endif // _LWM2M_OBJECT_WHRE_EVENT_LOG_H_
+
+// End Of File
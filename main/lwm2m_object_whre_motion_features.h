@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _LWM2M_OBJECT_WHRE_MOTION_FEATURES_H_
+#define _LWM2M_OBJECT_WHRE_MOTION_FEATURES_H_
+
+/* GENERATED by lwm2m_objects/lwm2m_c_generator.lua 1.1 with:
+ *
+ * lwm2m_c_generator.lua whre_motion_features.xml
+ *
+ * DO NOT EDIT: change the XML and generate this again.
+ *
+ * The WHRE Motion Features object (33054):
+ *
+ * This object provides features of the motion of a WHRE device,
+ * computed on the device from a window of accelerometer samples
+ * captured each time the accelerometer wakes the device
+ *
+ * See lwm2m_object_desc.h for how the resources are held.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lwm2m.h"
+#include "lwm2m_object_desc.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The OMA ID of the WHRE Motion Features object.
+ */
+#define LWM2M_OBJECT_OMA_ID_WHRE_MOTION_FEATURES 33054
+
+/** The version of the WHRE Motion Features object this was generated
+ * from; the Lua loaded into SARA-R412M must be the same version.
+ */
+#define LWM2M_OBJECT_VERSION_WHRE_MOTION_FEATURES "1.0"
+
+/** The resources of the WHRE Motion Features object.
+ */
+#define LWM2M_WHRE_MOTION_FEATURES_RESOURCE_RMS_ACCELERATION  1
+#define LWM2M_WHRE_MOTION_FEATURES_RESOURCE_PEAK_ACCELERATION 2
+#define LWM2M_WHRE_MOTION_FEATURES_RESOURCE_ZERO_CROSSINGS    3
+#define LWM2M_WHRE_MOTION_FEATURES_RESOURCE_DOMINANT_AXIS     4
+#define LWM2M_WHRE_MOTION_FEATURES_RESOURCE_WINDOW_DURATION   5
+#define LWM2M_WHRE_MOTION_FEATURES_RESOURCE_FEATURE_BATCH     6
+
+/** The LWM2M_OBJECT_DESC_RESOURCE() bits of all of the resources
+ * of the WHRE Motion Features object.
+ */
+#define LWM2M_WHRE_MOTION_FEATURES_RESOURCES_ALL (LWM2M_OBJECT_DESC_RESOURCE(1) | \
+                                                  LWM2M_OBJECT_DESC_RESOURCE(2) | \
+                                                  LWM2M_OBJECT_DESC_RESOURCE(3) | \
+                                                  LWM2M_OBJECT_DESC_RESOURCE(4) | \
+                                                  LWM2M_OBJECT_DESC_RESOURCE(5) | \
+                                                  LWM2M_OBJECT_DESC_RESOURCE(6))
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** The resources of an instance of the WHRE Motion Features object.
+ */
+typedef struct {
+    int32_t rmsAcceleration;            //!< RMS Acceleration (1), mg.
+    int32_t peakAcceleration;           //!< Peak Acceleration (2), mg.
+    int32_t zeroCrossings;              //!< Zero Crossings (3).
+    int32_t dominantAxis;               //!< Dominant Axis (4).
+    int32_t windowDuration;             //!< Window Duration (5), ms.
+    Lwm2mObjectDescOpaque featureBatch; //!< Feature Batch (6).
+} Lwm2mWhreMotionFeatures;
+
+// ----------------------------------------------------------------
+// TABLES
+// ----------------------------------------------------------------
+
+/** The resources of the WHRE Motion Features object, in order of ID.
+ */
+static const Lwm2mObjectDescResource gLwm2mWhreMotionFeaturesResources[] = {
+    {LWM2M_WHRE_MOTION_FEATURES_RESOURCE_RMS_ACCELERATION, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R, true, 0,
+     offsetof(Lwm2mWhreMotionFeatures, rmsAcceleration), 0},
+    {LWM2M_WHRE_MOTION_FEATURES_RESOURCE_PEAK_ACCELERATION, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R, true, 0,
+     offsetof(Lwm2mWhreMotionFeatures, peakAcceleration), 0},
+    {LWM2M_WHRE_MOTION_FEATURES_RESOURCE_ZERO_CROSSINGS, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R, true, 0,
+     offsetof(Lwm2mWhreMotionFeatures, zeroCrossings), 0},
+    {LWM2M_WHRE_MOTION_FEATURES_RESOURCE_DOMINANT_AXIS, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R, true, 0,
+     offsetof(Lwm2mWhreMotionFeatures, dominantAxis), 0},
+    {LWM2M_WHRE_MOTION_FEATURES_RESOURCE_WINDOW_DURATION, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R, true, 0,
+     offsetof(Lwm2mWhreMotionFeatures, windowDuration), 0},
+    {LWM2M_WHRE_MOTION_FEATURES_RESOURCE_FEATURE_BATCH, LWM2M_RESOURCE_TYPE_OPAQUE,
+     LWM2M_OBJECT_DESC_OPERATION_R, false, 0,
+     offsetof(Lwm2mWhreMotionFeatures, featureBatch), 0}
+};
+
+/** The WHRE Motion Features object.
+ */
+static const Lwm2mObjectDesc gLwm2mWhreMotionFeatures = {
+    LWM2M_OBJECT_OMA_ID_WHRE_MOTION_FEATURES, "WHRE Motion Features",
+    gLwm2mWhreMotionFeaturesResources,
+    sizeof(gLwm2mWhreMotionFeaturesResources) / sizeof(gLwm2mWhreMotionFeaturesResources[0])
+};
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Create an instance of the WHRE Motion Features object, see
+ * lwm2mObjectDescCreate().
+ */
+static inline int32_t lwm2mWhreMotionFeaturesCreate(int32_t objectInstanceId,
+                                                    int32_t shortServerId,
+                                                    const Lwm2mWhreMotionFeatures *pValues,
+                                                    uint32_t resources)
+{
+    return lwm2mObjectDescCreate(&gLwm2mWhreMotionFeatures, objectInstanceId,
+                                 shortServerId, pValues, resources);
+}
+
+/** Write resources of an instance of the WHRE Motion Features object,
+ * see lwm2mObjectDescSet().
+ */
+static inline int32_t lwm2mWhreMotionFeaturesSet(int32_t objectInstanceId,
+                                                 const Lwm2mWhreMotionFeatures *pValues,
+                                                 uint32_t resources)
+{
+    return lwm2mObjectDescSet(&gLwm2mWhreMotionFeatures, objectInstanceId,
+                              pValues, resources);
+}
+
+/** Read an instance of the WHRE Motion Features object, see
+ * lwm2mObjectDescGet().
+ */
+static inline int32_t lwm2mWhreMotionFeaturesGet(int32_t objectInstanceId,
+                                                 Lwm2mWhreMotionFeatures *pValues,
+                                                 uint32_t *pPresent)
+{
+    return lwm2mObjectDescGet(&gLwm2mWhreMotionFeatures, objectInstanceId,
+                              pValues, pPresent);
+}
+
+#endif // _LWM2M_OBJECT_WHRE_MOTION_FEATURES_H_
+
+// End Of File
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _LWM2M_OBJECT_WHRE_OPERATING_PARAMETERS_H_
+#define _LWM2M_OBJECT_WHRE_OPERATING_PARAMETERS_H_
+
+/* GENERATED by lwm2m_objects/lwm2m_c_generator.lua 1.1 with:
+ *
+ * lwm2m_c_generator.lua whre_operating_parameters.xml
+ *
+ * DO NOT EDIT: change the XML and generate this again.
+ *
+ * The WHRE Operating Parameters object (33052):
+ *
+ * This object provides a range of parameters that can be configured
+ * to control dynamic behaviour of a WHRE device
+ *
+ * See lwm2m_object_desc.h for how the resources are held.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lwm2m.h"
+#include "lwm2m_object_desc.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The OMA ID of the WHRE Operating Parameters object.
+ */
+#define LWM2M_OBJECT_OMA_ID_WHRE_OPERATING_PARAMETERS 33052
+
+/** The version of the WHRE Operating Parameters object this was generated
+ * from; the Lua loaded into SARA-R412M must be the same version.
+ */
+#define LWM2M_OBJECT_VERSION_WHRE_OPERATING_PARAMETERS "1.0"
+
+/** The resources of the WHRE Operating Parameters object.
+ */
+#define LWM2M_WHRE_OPERATING_PARAMETERS_RESOURCE_HOST_WAKE_UP_INTERVAL       1
+#define LWM2M_WHRE_OPERATING_PARAMETERS_RESOURCE_REPORTING_INTERVAL          2
+#define LWM2M_WHRE_OPERATING_PARAMETERS_RESOURCE_HOST_MINIMUM_SLEEP_INTERVAL 3
+#define LWM2M_WHRE_OPERATING_PARAMETERS_RESOURCE_MINIMUM_MODEM_UP_TIME       4
+
+/** The LWM2M_OBJECT_DESC_RESOURCE() bits of all of the resources
+ * of the WHRE Operating Parameters object.
+ */
+#define LWM2M_WHRE_OPERATING_PARAMETERS_RESOURCES_ALL (LWM2M_OBJECT_DESC_RESOURCE(1) | \
+                                                       LWM2M_OBJECT_DESC_RESOURCE(2) | \
+                                                       LWM2M_OBJECT_DESC_RESOURCE(3) | \
+                                                       LWM2M_OBJECT_DESC_RESOURCE(4))
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** The resources of an instance of the WHRE Operating Parameters object.
+ */
+typedef struct {
+    int32_t hostWakeUpInterval;       //!< Host Wake up Interval (1), s.
+    int32_t reportingInterval;        //!< Reporting Interval (2), s.
+    int32_t hostMinimumSleepInterval; //!< Host Minimum Sleep Interval (3), s.
+    int32_t minimumModemUpTime;       //!< Minimum Modem up Time (4), s.
+} Lwm2mWhreOperatingParameters;
+
+// ----------------------------------------------------------------
+// TABLES
+// ----------------------------------------------------------------
+
+/** The resources of the WHRE Operating Parameters object, in order of ID.
+ */
+static const Lwm2mObjectDescResource gLwm2mWhreOperatingParametersResources[] = {
+    {LWM2M_WHRE_OPERATING_PARAMETERS_RESOURCE_HOST_WAKE_UP_INTERVAL, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true, 0,
+     offsetof(Lwm2mWhreOperatingParameters, hostWakeUpInterval), 0},
+    {LWM2M_WHRE_OPERATING_PARAMETERS_RESOURCE_REPORTING_INTERVAL, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true, 0,
+     offsetof(Lwm2mWhreOperatingParameters, reportingInterval), 0},
+    {LWM2M_WHRE_OPERATING_PARAMETERS_RESOURCE_HOST_MINIMUM_SLEEP_INTERVAL, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true, 0,
+     offsetof(Lwm2mWhreOperatingParameters, hostMinimumSleepInterval), 0},
+    {LWM2M_WHRE_OPERATING_PARAMETERS_RESOURCE_MINIMUM_MODEM_UP_TIME, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true, 0,
+     offsetof(Lwm2mWhreOperatingParameters, minimumModemUpTime), 0}
+};
+
+/** The WHRE Operating Parameters object.
+ */
+static const Lwm2mObjectDesc gLwm2mWhreOperatingParameters = {
+    LWM2M_OBJECT_OMA_ID_WHRE_OPERATING_PARAMETERS, "WHRE Operating Parameters",
+    gLwm2mWhreOperatingParametersResources,
+    sizeof(gLwm2mWhreOperatingParametersResources) / sizeof(gLwm2mWhreOperatingParametersResources[0])
+};
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Create an instance of the WHRE Operating Parameters object, see
+ * lwm2mObjectDescCreate().
+ */
+static inline int32_t lwm2mWhreOperatingParametersCreate(int32_t objectInstanceId,
+                                                         int32_t shortServerId,
+                                                         const Lwm2mWhreOperatingParameters *pValues,
+                                                         uint32_t resources)
+{
+    return lwm2mObjectDescCreate(&gLwm2mWhreOperatingParameters, objectInstanceId,
+                                 shortServerId, pValues, resources);
+}
+
+/** Write resources of an instance of the WHRE Operating Parameters object,
+ * see lwm2mObjectDescSet().
+ */
+static inline int32_t lwm2mWhreOperatingParametersSet(int32_t objectInstanceId,
+                                                      const Lwm2mWhreOperatingParameters *pValues,
+                                                      uint32_t resources)
+{
+    return lwm2mObjectDescSet(&gLwm2mWhreOperatingParameters, objectInstanceId,
+                              pValues, resources);
+}
+
+/** Read an instance of the WHRE Operating Parameters object, see
+ * lwm2mObjectDescGet().
+ */
+static inline int32_t lwm2mWhreOperatingParametersGet(int32_t objectInstanceId,
+                                                      Lwm2mWhreOperatingParameters *pValues,
+                                                      uint32_t *pPresent)
+{
+    return lwm2mObjectDescGet(&gLwm2mWhreOperatingParameters, objectInstanceId,
+                              pValues, pPresent);
+}
+
+#endif // _LWM2M_OBJECT_WHRE_OPERATING_PARAMETERS_H_
+
+// End Of File
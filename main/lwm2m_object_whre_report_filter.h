@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _LWM2M_OBJECT_WHRE_REPORT_FILTER_H_
+#define _LWM2M_OBJECT_WHRE_REPORT_FILTER_H_
+
+/* GENERATED by lwm2m_objects/lwm2m_c_generator.lua 1.1 with:
+ *
+ * lwm2m_c_generator.lua whre_report_filter.xml 16
+ *
+ * DO NOT EDIT: change the XML and generate this again.
+ *
+ * The WHRE Report Filter object (33056):
+ *
+ * This object configures report-on-change for a WHRE device: a
+ * report which is due by the clock is only made if a sensor channel
+ * has moved beyond its deadband since the last report or the
+ * maximum silence has expired, otherwise the device goes back to
+ * sleep without powering its modem
+ *
+ * See lwm2m_object_desc.h for how the resources are held.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lwm2m.h"
+#include "lwm2m_object_desc.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The OMA ID of the WHRE Report Filter object.
+ */
+#define LWM2M_OBJECT_OMA_ID_WHRE_REPORT_FILTER 33056
+
+/** The version of the WHRE Report Filter object this was generated
+ * from; the Lua loaded into SARA-R412M must be the same version.
+ */
+#define LWM2M_OBJECT_VERSION_WHRE_REPORT_FILTER "1.0"
+
+/** The resources of the WHRE Report Filter object.
+ */
+#define LWM2M_WHRE_REPORT_FILTER_RESOURCE_MAX_SILENCE        1
+#define LWM2M_WHRE_REPORT_FILTER_RESOURCE_NUMBER_OF_CHANNELS 2
+#define LWM2M_WHRE_REPORT_FILTER_RESOURCE_CHANNEL            3
+#define LWM2M_WHRE_REPORT_FILTER_RESOURCE_DEADBAND           4
+#define LWM2M_WHRE_REPORT_FILTER_RESOURCE_HYSTERESIS         5
+#define LWM2M_WHRE_REPORT_FILTER_RESOURCE_REPORTS_SENT       6
+#define LWM2M_WHRE_REPORT_FILTER_RESOURCE_REPORTS_SUPPRESSED 7
+
+/** The LWM2M_OBJECT_DESC_RESOURCE() bits of all of the resources
+ * of the WHRE Report Filter object.
+ */
+#define LWM2M_WHRE_REPORT_FILTER_RESOURCES_ALL (LWM2M_OBJECT_DESC_RESOURCE(1) | \
+                                                LWM2M_OBJECT_DESC_RESOURCE(2) | \
+                                                LWM2M_OBJECT_DESC_RESOURCE(3) | \
+                                                LWM2M_OBJECT_DESC_RESOURCE(4) | \
+                                                LWM2M_OBJECT_DESC_RESOURCE(5) | \
+                                                LWM2M_OBJECT_DESC_RESOURCE(6) | \
+                                                LWM2M_OBJECT_DESC_RESOURCE(7))
+
+/** The most instances of the Channel resource held.
+ */
+#ifndef LWM2M_WHRE_REPORT_FILTER_CHANNEL_MAX_INSTANCES
+# define LWM2M_WHRE_REPORT_FILTER_CHANNEL_MAX_INSTANCES 16
+#endif
+
+/** The most instances of the Deadband resource held.
+ */
+#ifndef LWM2M_WHRE_REPORT_FILTER_DEADBAND_MAX_INSTANCES
+# define LWM2M_WHRE_REPORT_FILTER_DEADBAND_MAX_INSTANCES 16
+#endif
+
+/** The most instances of the Hysteresis resource held.
+ */
+#ifndef LWM2M_WHRE_REPORT_FILTER_HYSTERESIS_MAX_INSTANCES
+# define LWM2M_WHRE_REPORT_FILTER_HYSTERESIS_MAX_INSTANCES 16
+#endif
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** The resources of an instance of the WHRE Report Filter object.
+ */
+typedef struct {
+    int32_t maxSilence;        //!< Max Silence (1), s.
+    int32_t numberOfChannels;  //!< Number of Channels (2).
+    int32_t channel[LWM2M_WHRE_REPORT_FILTER_CHANNEL_MAX_INSTANCES]; //!< Channel (3).
+    int32_t numChannel;        //!< The number of instances of Channel.
+    int32_t deadband[LWM2M_WHRE_REPORT_FILTER_DEADBAND_MAX_INSTANCES]; //!< Deadband (4).
+    int32_t numDeadband;       //!< The number of instances of Deadband.
+    int32_t hysteresis[LWM2M_WHRE_REPORT_FILTER_HYSTERESIS_MAX_INSTANCES]; //!< Hysteresis (5).
+    int32_t numHysteresis;     //!< The number of instances of Hysteresis.
+    int32_t reportsSent;       //!< Reports Sent (6).
+    int32_t reportsSuppressed; //!< Reports Suppressed (7).
+} Lwm2mWhreReportFilter;
+
+// ----------------------------------------------------------------
+// TABLES
+// ----------------------------------------------------------------
+
+/** The resources of the WHRE Report Filter object, in order of ID.
+ */
+static const Lwm2mObjectDescResource gLwm2mWhreReportFilterResources[] = {
+    {LWM2M_WHRE_REPORT_FILTER_RESOURCE_MAX_SILENCE, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true, 0,
+     offsetof(Lwm2mWhreReportFilter, maxSilence), 0},
+    {LWM2M_WHRE_REPORT_FILTER_RESOURCE_NUMBER_OF_CHANNELS, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true, 0,
+     offsetof(Lwm2mWhreReportFilter, numberOfChannels), 0},
+    {LWM2M_WHRE_REPORT_FILTER_RESOURCE_CHANNEL, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true,
+     LWM2M_WHRE_REPORT_FILTER_CHANNEL_MAX_INSTANCES,
+     offsetof(Lwm2mWhreReportFilter, channel),
+     offsetof(Lwm2mWhreReportFilter, numChannel)},
+    {LWM2M_WHRE_REPORT_FILTER_RESOURCE_DEADBAND, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true,
+     LWM2M_WHRE_REPORT_FILTER_DEADBAND_MAX_INSTANCES,
+     offsetof(Lwm2mWhreReportFilter, deadband),
+     offsetof(Lwm2mWhreReportFilter, numDeadband)},
+    {LWM2M_WHRE_REPORT_FILTER_RESOURCE_HYSTERESIS, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R | LWM2M_OBJECT_DESC_OPERATION_W, true,
+     LWM2M_WHRE_REPORT_FILTER_HYSTERESIS_MAX_INSTANCES,
+     offsetof(Lwm2mWhreReportFilter, hysteresis),
+     offsetof(Lwm2mWhreReportFilter, numHysteresis)},
+    {LWM2M_WHRE_REPORT_FILTER_RESOURCE_REPORTS_SENT, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R, true, 0,
+     offsetof(Lwm2mWhreReportFilter, reportsSent), 0},
+    {LWM2M_WHRE_REPORT_FILTER_RESOURCE_REPORTS_SUPPRESSED, LWM2M_RESOURCE_TYPE_INTEGER,
+     LWM2M_OBJECT_DESC_OPERATION_R, true, 0,
+     offsetof(Lwm2mWhreReportFilter, reportsSuppressed), 0}
+};
+
+/** The WHRE Report Filter object.
+ */
+static const Lwm2mObjectDesc gLwm2mWhreReportFilter = {
+    LWM2M_OBJECT_OMA_ID_WHRE_REPORT_FILTER, "WHRE Report Filter",
+    gLwm2mWhreReportFilterResources,
+    sizeof(gLwm2mWhreReportFilterResources) / sizeof(gLwm2mWhreReportFilterResources[0])
+};
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Create an instance of the WHRE Report Filter object, see
+ * lwm2mObjectDescCreate().
+ */
+static inline int32_t lwm2mWhreReportFilterCreate(int32_t objectInstanceId,
+                                                  int32_t shortServerId,
+                                                  const Lwm2mWhreReportFilter *pValues,
+                                                  uint32_t resources)
+{
+    return lwm2mObjectDescCreate(&gLwm2mWhreReportFilter, objectInstanceId,
+                                 shortServerId, pValues, resources);
+}
+
+/** Write resources of an instance of the WHRE Report Filter object,
+ * see lwm2mObjectDescSet().
+ */
+static inline int32_t lwm2mWhreReportFilterSet(int32_t objectInstanceId,
+                                               const Lwm2mWhreReportFilter *pValues,
+                                               uint32_t resources)
+{
+    return lwm2mObjectDescSet(&gLwm2mWhreReportFilter, objectInstanceId,
+                              pValues, resources);
+}
+
+/** Read an instance of the WHRE Report Filter object, see
+ * lwm2mObjectDescGet().
+ */
+static inline int32_t lwm2mWhreReportFilterGet(int32_t objectInstanceId,
+                                               Lwm2mWhreReportFilter *pValues,
+                                               uint32_t *pPresent)
+{
+    return lwm2mObjectDescGet(&gLwm2mWhreReportFilter, objectInstanceId,
+                              pValues, pPresent);
+}
+
+#endif // _LWM2M_OBJECT_WHRE_REPORT_FILTER_H_
+
+// End Of File
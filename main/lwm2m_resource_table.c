@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h> // For qsort()
+#include <string.h> // For memmove()
+#include "lwm2m.h"
+#include "lwm2m_resource_table.h"
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Compare (resource ID, instance ID) against an entry.
+static int32_t compare(int32_t resourceId, int32_t instanceId,
+                       const Lwm2mResourceTableEntry *pEntry)
+{
+    if (resourceId != pEntry->resourceId) {
+        return (resourceId < pEntry->resourceId) ? -1 : 1;
+    }
+    if (instanceId != pEntry->instanceId) {
+        return (instanceId < pEntry->instanceId) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+// Comparison function for qsort().
+static int compareEntries(const void *pA, const void *pB)
+{
+    const Lwm2mResourceTableEntry *pEntryA = (const Lwm2mResourceTableEntry *) pA;
+
+    return (int) compare(pEntryA->resourceId, pEntryA->instanceId,
+                         (const Lwm2mResourceTableEntry *) pB);
+}
+
+// Return the index of the first entry which is not less than
+// (resourceId, instanceId), which may be numEntries.
+static int32_t lowerBound(const Lwm2mResourceTable *pTable,
+                          int32_t resourceId, int32_t instanceId)
+{
+    int32_t low = 0;
+    int32_t high = pTable->numEntries;
+    int32_t middle;
+
+    while (low < high) {
+        middle = low + ((high - low) / 2);
+        if (compare(resourceId, instanceId, &(pTable->pEntries[middle])) > 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Initialise an empty table.
+void lwm2mResourceTableInit(Lwm2mResourceTable *pTable,
+                            int32_t objectOmaId, int32_t objectInstanceId,
+                            Lwm2mResourceTableEntry *pEntries,
+                            int32_t maxNumEntries)
+{
+    pTable->objectOmaId = objectOmaId;
+    pTable->objectInstanceId = objectInstanceId;
+    pTable->pEntries = pEntries;
+    pTable->numEntries = 0;
+    pTable->maxNumEntries = maxNumEntries;
+}
+
+// Fill a table from the resources of an object.
+int32_t lwm2mResourceTableFromObject(Lwm2mResourceTable *pTable,
+                                     const Lwm2mObjectInstance *pObject)
+{
+    const Lwm2mResourceInstance *pResource;
+    Lwm2mResourceTableEntry *pEntry;
+    Lwm2mResourceTableEntry swap;
+    bool ascending = true;
+    bool descending = true;
+    bool full = false;
+
+    pTable->objectOmaId = pObject->omaId;
+    pTable->objectInstanceId = pObject->instanceId;
+    pTable->numEntries = 0;
+
+    // One pass down the list to copy it, noting whether it
+    // happens to be in order already, or in reverse order
+    // (which is what building a list by prepending gives)
+    for (pResource = pObject->pResources; pResource != NULL;
+         pResource = pResource->pNext) {
+        if (pTable->numEntries >= pTable->maxNumEntries) {
+            full = true;
+            break;
+        }
+        pEntry = &(pTable->pEntries[pTable->numEntries]);
+        pEntry->resourceId = pResource->omaId;
+        pEntry->instanceId = pResource->instanceId;
+        pEntry->value = pResource->value;
+        if (pTable->numEntries > 0) {
+            if (compare(pEntry->resourceId, pEntry->instanceId, pEntry - 1) < 0) {
+                ascending = false;
+            } else {
+                descending = false;
+            }
+        }
+        pTable->numEntries++;
+    }
+
+    if (!ascending && descending) {
+        for (int32_t x = 0; x < pTable->numEntries / 2; x++) {
+            swap = pTable->pEntries[x];
+            pTable->pEntries[x] = pTable->pEntries[pTable->numEntries - x - 1];
+            pTable->pEntries[pTable->numEntries - x - 1] = swap;
+        }
+    } else if (!ascending) {
+        qsort(pTable->pEntries, pTable->numEntries,
+              sizeof(pTable->pEntries[0]), compareEntries);
+    }
+
+    return full ? -1 : pTable->numEntries;
+}
+
+// Add or update a resource instance.
+int32_t lwm2mResourceTableSet(Lwm2mResourceTable *pTable,
+                              int32_t resourceId, int32_t instanceId,
+                              Lwm2mValue value)
+{
+    int32_t index = lowerBound(pTable, resourceId, instanceId);
+    Lwm2mResourceTableEntry *pEntry = &(pTable->pEntries[index]);
+
+    if ((index >= pTable->numEntries) ||
+        (compare(resourceId, instanceId, pEntry) != 0)) {
+        if (pTable->numEntries >= pTable->maxNumEntries) {
+            return -1;
+        }
+        memmove(pEntry + 1, pEntry,
+                (pTable->numEntries - index) * sizeof(*pEntry));
+        pEntry->resourceId = resourceId;
+        pEntry->instanceId = instanceId;
+        pTable->numEntries++;
+    }
+    pEntry->value = value;
+
+    return 0;
+}
+
+// Find a resource instance.
+Lwm2mResourceTableEntry *pLwm2mResourceTableFind(const Lwm2mResourceTable *pTable,
+                                                 int32_t resourceId,
+                                                 int32_t instanceId)
+{
+    int32_t index = lowerBound(pTable, resourceId, instanceId);
+
+    if ((index < pTable->numEntries) &&
+        (compare(resourceId, instanceId, &(pTable->pEntries[index])) == 0)) {
+        return &(pTable->pEntries[index]);
+    }
+
+    return NULL;
+}
+
+// Find all of the instances of a resource.
+int32_t lwm2mResourceTableRange(const Lwm2mResourceTable *pTable,
+                                int32_t resourceId,
+                                Lwm2mResourceTableEntry **ppFirst)
+{
+    int32_t first = lowerBound(pTable, resourceId, INT32_MIN);
+    int32_t end = lowerBound(pTable, resourceId + 1, INT32_MIN);
+
+    if (ppFirst != NULL) {
+        *ppFirst = (end > first) ? &(pTable->pEntries[first]) : NULL;
+    }
+
+    return end - first;
+}
+
+// End Of File
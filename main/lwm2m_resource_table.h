@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _LWM2M_RESOURCE_TABLE_H_
+#define _LWM2M_RESOURCE_TABLE_H_
+
+/* An alternative representation of the resources of an
+ * Lwm2mObjectInstance: a contiguous array of resource instances
+ * kept sorted by (resource ID, resource instance ID), so that a
+ * resource instance is found by binary search and all of the
+ * instances of a multi-instance resource are adjacent, instead of
+ * walking the pResources linked list for every lookup.  This
+ * matters for objects with hundreds of resource instances, e.g.
+ * long I2C sequences or batches of readings.
+ *
+ * The entries are stored by the caller; nothing here allocates.
+ * String values are not copied: they point into the
+ * Lwm2mObjectInstance the table was filled from and so are only
+ * valid for as long as that is.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lwm2m.h"
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** A resource instance in a table; a single-instance resource
+ * has an instanceId of -1, as in Lwm2mResourceInstance.
+ */
+typedef struct {
+    int32_t resourceId;
+    int32_t instanceId;
+    Lwm2mValue value;
+} Lwm2mResourceTableEntry;
+
+/** A table of resource instances.
+ */
+typedef struct {
+    int32_t objectOmaId;
+    int32_t objectInstanceId;
+    Lwm2mResourceTableEntry *pEntries;
+    int32_t numEntries;
+    int32_t maxNumEntries;
+} Lwm2mResourceTable;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Initialise an empty table.
+ *
+ * @param pTable           the table.
+ * @param objectOmaId      the OMA ID of the object.
+ * @param objectInstanceId the instance of the object.
+ * @param pEntries         storage for the entries.
+ * @param maxNumEntries    the number of entries pEntries can hold.
+ */
+void lwm2mResourceTableInit(Lwm2mResourceTable *pTable,
+                            int32_t objectOmaId, int32_t objectInstanceId,
+                            Lwm2mResourceTableEntry *pEntries,
+                            int32_t maxNumEntries);
+
+/** Fill a table, which must have been initialised, from the
+ * resources of an object, e.g. as returned by lwm2mObjectGet().
+ * Any existing entries are discarded.
+ *
+ * @param pTable  the table.
+ * @param pObject the object.
+ * @return        the number of entries in the table, or negative
+ *                if the object has more resource instances than
+ *                the table can hold (in which case the table
+ *                holds as many as would fit).
+ */
+int32_t lwm2mResourceTableFromObject(Lwm2mResourceTable *pTable,
+                                     const Lwm2mObjectInstance *pObject);
+
+/** Add a resource instance to a table, or update it if it is
+ * already there.
+ *
+ * @param pTable     the table.
+ * @param resourceId the resource.
+ * @param instanceId the resource instance, -1 for a single
+ *                   instance resource.
+ * @param value      the value.
+ * @return           zero on success, negative if the table is
+ *                   full.
+ */
+int32_t lwm2mResourceTableSet(Lwm2mResourceTable *pTable,
+                              int32_t resourceId, int32_t instanceId,
+                              Lwm2mValue value);
+
+/** Find a resource instance in a table.
+ *
+ * @param pTable     the table.
+ * @param resourceId the resource.
+ * @param instanceId the resource instance, -1 for a single
+ *                   instance resource.
+ * @return           the entry or NULL if it is not there.
+ */
+Lwm2mResourceTableEntry *pLwm2mResourceTableFind(const Lwm2mResourceTable *pTable,
+                                                 int32_t resourceId,
+                                                 int32_t instanceId);
+
+/** Find all of the instances of a resource in a table; they are
+ * contiguous and in ascending order of instance ID.
+ *
+ * @param pTable     the table.
+ * @param resourceId the resource.
+ * @param ppFirst    place to put a pointer to the first
+ *                   instance; set to NULL if there are none.
+ * @return           the number of instances.
+ */
+int32_t lwm2mResourceTableRange(const Lwm2mResourceTable *pTable,
+                                int32_t resourceId,
+                                Lwm2mResourceTableEntry **ppFirst);
+
+#endif // _LWM2M_RESOURCE_TABLE_H_
+
+// End Of File
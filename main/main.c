@@ -22,6 +22,7 @@
 #include "esp_spi_flash.h" // For spi_flash_get_chip_size()
 #include "esp_timer.h" // For esp_timer_get_time()
 #include "esp_wifi.h"
+#include "esp_attr.h" // For RTC_DATA_ATTR
 #include "nvs_flash.h"
 #include "sys/time.h"
 #include "driver/rtc_io.h"
@@ -29,6 +30,35 @@
 #include "compile_time.h"
 #include "whre_config.h"
 #include "log.h"
+#include "log_events_app.h"
+#include "trace.h"
+#include "rtc_state.h"
+#include "i2c_command.h"
+#include "i2c_interpreter.h"
+#include "lwm2m_arena.h"
+#include "lwm2m_events.h"
+#include "led.h"
+#include "init_graph.h"
+#include "wifi_scan.h"
+#include "sample_store.h"
+#include "utilities.h"
+#include "ts_codec.h"
+#include "motion_features.h"
+#include "lis2dw_fifo.h"
+#include "channel_stats.h"
+#include "report_filter.h"
+#include "sleep_scheduler.h"
+#include "modem_psm.h"
+#include "modem_uart.h"
+#include "flash_log.h"
+#include "diag.h"
+#include "lwm2m_object_desc.h"
+#include "lwm2m_object_whre_motion_features.h"
+#include "lwm2m_object_whre_channel_statistics.h"
+#include "lwm2m_object_whre_report_filter.h"
+#include "lwm2m_object_whre_operating_parameters.h"
+#include "lwm2m_object_modem_configuration.h"
+#include "lwm2m_object_whre_event_log.h"
 
 #include "i2c_helper.h"
 #include "battery_charger.h"
@@ -48,37 +78,126 @@
  * MANIFEST CONSTANTS
  *************************************************************************/
 
-#define SHTC1_ADDR 0x20                          // SHTC1 I2C address 0x20
-//#define SHTC1_ADDR 0x5D                        // SHTC1 I2C address 0x70
-//#define SHTC1_MEASUREMENT_CMD 0x7866           // Measurement Command, Clock Stretching Disabled Read T First 
  
 
 #define LWM2M_WAKEUP_WAIT_SECONDS           15
-#define SLEEP_TIME_USECONDS                 (60 * 1000000)
-#define LWM2M_REGISTRATION_LIFETIME_SECONDS 60 // Deliberately a small value
-                                               // in order that the lifetime
-                                               // will have expired at each
-                                               // wakeup and hence the server
-                                               // will be contacted when we
-                                               // awake
-#define LWM2M_SERVER_REGISTRATION_UPDATE_RETRIES   10
+#define LWM2M_READY_RETRY_MS                250 // How often to check if
+                                                // LWM2M is ready
+// The registration with the LWM2M server outlives many reports:
+// the server uses queue mode (binding "UQ"), holding anything for
+// the device until it next hears from it.  If SARA-R4 was kept
+// registered through the sleep (see modem_psm.h) a registration
+// update is sent when we awake, over the DTLS session SARA-R4 still
+// has, rather than a full handshake and registration; otherwise
+// SARA-R4 registers afresh when it boots.  The Reporting Interval
+// is held below half of this so that the registration never lapses.
+#define LWM2M_REGISTRATION_LIFETIME_SECONDS (24 * 60 * 60)
+#define LWM2M_SERVER_REGISTRATION_UPDATE_RETRIES   3
+#define LWM2M_REGISTRATION_UPDATE_WAIT_MS   5000
 #define LWM2M_SERVER_WAIT_TIME_SECONDS      10
+#define LWM2M_SERVER_QUIET_TIME_MS          2000 // The server is taken to have
+                                                 // finished when it has done
+                                                 // nothing for this long
 #define WHRE_LWM2M_SERVER_SHORT_ID          100
 
-// The OMA IDs for the custom objects
-#define LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND               33059 //33050
+// Scan for Wifi access points only on the channels they were seen on
+// last time, doing a full scan every WIFI_SCAN_FULL_SCAN_INTERVAL
+// wakes to pick up any new ones.  The scan runs while registering
+// with the cellular network; WIFI_SCAN_WAIT_MS is the most to wait
+// for it afterwards.
+#define WIFI_SCAN_LAST_CHANNELS_ONLY        true
+#define WIFI_SCAN_FULL_SCAN_INTERVAL        10
+#define WIFI_SCAN_WAIT_MS                   2000
+
+// Long enough for the 128 byte FIFO of the console UART to empty
+// at 115200 bit/s before sleep, which would lose what is left.
+#define CONSOLE_DRAIN_MS                    20
+
+// When to wake is decided by the sleep scheduler (see
+// sleep_scheduler.h) from the deadlines of sampling, reporting and
+// getting a location fix.  The modem is only powered up to talk to
+// the LWM2M server when a report or a location fix is due; on the
+// wakes in between the I2C commands the server last asked for are
+// run with the modem off and the results stored in RTC memory (see
+// sample_store.h), to be sent in one batch at the next report.
+// The intervals below are the defaults of the resources of the WHRE
+// Operating Parameters object, which the server may change.
+#define HOST_WAKE_UP_INTERVAL_SECONDS       60
+#define REPORTING_INTERVAL_SECONDS          600
+#define HOST_MINIMUM_SLEEP_INTERVAL_SECONDS 10
+#define MINIMUM_MODEM_UP_TIME_SECONDS       0
+
+// The defaults of the resources of the Modem Configuration object.
+// With a PSM Timer of zero and no eDRX SARA-R4 is powered off at the
+// end of every report and attaches from cold at the next; otherwise
+// it is left registered, in PSM or eDRX (see modem_psm.h), and at
+// the next report is only woken.
+#define MODEM_PSM_TIMER_SECONDS             0
+#define MODEM_ACTIVE_TIMER_SECONDS          10
+
+// How often to get a location fix; there is no resource for this.
+#define LOCATION_FIX_INTERVAL_SECONDS       3600
+
+// Deadlines within this many seconds of a wake are dealt with on
+// that wake rather than having a wake of their own.
+#define SLEEP_COALESCE_TOLERANCE_SECONDS    15
+
+// A report that fails is tried again this much later, rather than
+// a whole Reporting Interval later, unless that comes sooner.
+#define REPORT_RETRY_SECONDS                120
+
+// When the accelerometer wakes us, a window of its samples is
+// captured through its FIFO (see lis2dw_fifo.h) while the modem
+// powers up and the features of the window (see motion_features.h)
+// are stored alongside the other samples, to go to the WHRE Motion
+// Features object.  This is how long the capture may take.
+#define MOTION_CAPTURE_TIMEOUT_MS           (((MOTION_FEATURES_WINDOW_SIZE * 1000) / \
+                                              LIS2DW_FIFO_ODR_HZ) + 1000)
+
+// Keep RTC slow memory powered in deep sleep so that what has been
+// verified about SARA-R4 and LWM2M (see rtc_state.h) is remembered
+// and need not be checked again on a warm wake; costs a few uA.
+#define RTC_STATE_KEEP_POWERED              true
+
+// The most of the flash event log (see flash_log.h) sent to the
+// WHRE Event Log object at one report.
+#define EVENT_LOG_BATCH_MAX_SIZE            256
+
+// Log one of the events of log_events_app.h both to the log
+// component's RAM buffer and, so that it survives deep sleep and
+// reset, to the flash event log.
+#define LOG_EVENT(event, value)  do {LOGX(event, value);               \
+                                     flashLogAppend(LOG_APP_##event, value);} while (0)
+
+// Changes with every build, so that state retained in RTC memory
+// by one firmware build is never trusted by another.
+#define FIRMWARE_VERSION_ID ((uint32_t) (SYSTEM_VERSION_INT ^ __COMPILE_TIME_UNIX__))
 
 // Instances to use for objects
 #define LWM2M_OBJECT_INSTANCE_ID_SECURITY              2
 #define LWM2M_OBJECT_INSTANCE_ID_SERVER                2
 #define LWM2M_OBJECT_INSTANCE_ID_I2C_GENERIC_COMMAND   1
 #define LWM2M_OBJECT_INSTANCE_ID_LOCATION              0 // Has to be zero, a single instance resource
-
-// The maximum number of entries in an I2C sequence: any bigger
-// than this and the I2C object is too big for SARA-R412M
-#define I2C_SEQUENCE_WRITE_MAX_LENGTH 5
-#define I2C_SEQUENCE_READ_MAX_LENGTH 10
-#define I2C_SEQUENCE_MAX_LENGTH I2C_SEQUENCE_READ_MAX_LENGTH
+#define LWM2M_OBJECT_INSTANCE_ID_MOTION_FEATURES       0 // Has to be zero, a single instance resource
+#define LWM2M_OBJECT_INSTANCE_ID_CHANNEL_STATISTICS    0 // Has to be zero, a single instance resource
+#define LWM2M_OBJECT_INSTANCE_ID_REPORT_FILTER         0 // Has to be zero, a single instance resource
+#define LWM2M_OBJECT_INSTANCE_ID_OPERATING_PARAMETERS  0 // Has to be zero, a single instance resource
+#define LWM2M_OBJECT_INSTANCE_ID_MODEM_CONFIGURATION   0 // Has to be zero, a single instance resource
+#define LWM2M_OBJECT_INSTANCE_ID_EVENT_LOG             0 // Has to be zero, a single instance resource
+
+// The maximum number of channels held must fit the objects
+#if CHANNEL_STATS_MAX_CHANNELS > LWM2M_WHRE_CHANNEL_STATISTICS_CHANNEL_MAX_INSTANCES
+# error CHANNEL_STATS_MAX_CHANNELS is more than the WHRE Channel Statistics object holds.
+#endif
+#if REPORT_FILTER_MAX_CHANNELS > LWM2M_WHRE_REPORT_FILTER_CHANNEL_MAX_INSTANCES
+# error REPORT_FILTER_MAX_CHANNELS is more than the WHRE Report Filter object holds.
+#endif
+
+// Motion features are stored as a sample
+#if (MOTION_FEATURES_PACKED_SIZE > SAMPLE_STORE_MAX_DATA_LENGTH) || \
+    (MOTION_FEATURES_NUM_VALUES > SAMPLE_STORE_MAX_DATA_LENGTH)
+# error SAMPLE_STORE_MAX_DATA_LENGTH is too small for motion features.
+#endif
 
 /**************************************************************************
  * TYPES
@@ -90,18 +209,62 @@ typedef struct Bssid {
    struct Bssid *pNext;
 } Bssid;
 
+// The initialisation steps, in the order they appear in
+// gInitSteps[], each after those it depends on.
+typedef enum {
+    INIT_STEP_I2C,
+    INIT_STEP_BQ24295,
+    INIT_STEP_LIS2DW,
+    INIT_STEP_PINS,
+    INIT_STEP_NVS,
+    INIT_STEP_NETWORK,
+    INIT_STEP_WIFI,
+    INIT_STEP_MOTION,
+    INIT_STEP_UART,
+    INIT_STEP_AT_CLIENT,
+    INIT_STEP_SARA_R412M,
+    INIT_STEP_LOCATION,
+    INIT_STEP_LWM2M,
+    INIT_STEP_MODEM_POWER_ON,
+    NUM_INIT_STEPS
+} InitStep;
+
+// The initialisation steps for a wake where only a sample is taken,
+// in the order they appear in gSampleInitSteps[].
 typedef enum {
-    LED_STATE_OFF,
-    LED_STATE_GOOD,      // == green
-    LED_STATE_MIDDLIN,   // == yellow
-    LED_STATE_BAD        // == red
-} LedState;
+    SAMPLE_INIT_STEP_I2C,
+    SAMPLE_INIT_STEP_LIS2DW,
+    SAMPLE_INIT_STEP_PINS,
+    NUM_SAMPLE_INIT_STEPS
+} SampleInitStep;
+
+// The numbers of the events of log_events_app.h in the flash event
+// log: their positions in the list.
+#define LOG_APP_EVENT_NUMBER(event, string) LOG_APP_##event,
+typedef enum {
+    LOG_EVENTS_APP(LOG_APP_EVENT_NUMBER)
+    LOG_APP_NUM_EVENTS
+} LogAppEvent;
+#undef LOG_APP_EVENT_NUMBER
 
-// Structure to hold an I2C read or write sequence.
+// The settings of the WHRE Operating Parameters object.
 typedef struct {
-    int32_t length;
-    uint8_t sequence[I2C_SEQUENCE_MAX_LENGTH];
-} I2cSequence;
+    int32_t wakeUpIntervalSeconds;
+    int32_t reportingIntervalSeconds;
+    int32_t minSleepSeconds;
+    int32_t minModemUpSeconds;
+} OperatingParameters;
+
+// An LWM2M object which cfgLwm2m() makes sure exists on SARA-R4:
+// the bit for it in rtc_state.h and the function which creates it
+// with its default values.
+typedef struct {
+    uint32_t verified;
+    int32_t objectId;
+    int32_t objectInstanceId;
+    int32_t (*pCreate)(int32_t objectInstanceId, int32_t shortServerId);
+} Lwm2mObjectCfg;
+
 
 /**************************************************************************
  * LOCAL VARIABLES
@@ -113,11 +276,32 @@ static char gLoggingBuffer[LOG_STORE_SIZE];
 // Stop time for keepGoingCallback().
 static int64_t gStopTimeCellularMS;
 
+// Whether to capture motion features during init(), set if the
+// accelerometer woke us.
+static bool gCaptureMotion = false;
+
+// Storage for a window of accelerometer samples, kept off the
+// stack of the init task.
+static MotionFeaturesSample gMotionSamples[MOTION_FEATURES_WINDOW_SIZE];
+
 // Stop time for getting a location fix.
 static int64_t gStopTimeLocationMS;
 
-// Stop time for waiting for LWM2M operations by the serve.
-static int64_t gStopTimeLwm2mMS;
+// The Wifi access points handed to the location component.
+static LocationWifiAp gLocationWifiAps[WIFI_SCAN_MAX_APS];
+
+// Snapshots of the I2C Generic Command instances, used in turn by
+// takeSample() and doI2cCommands() and kept off the stack of the
+// main task.
+static I2cCommandSnapshot gSnapshots[I2C_INTERPRETER_MAX_INSTANCES];
+
+// Working storage for sendSamples(), also kept off the stack of
+// the main task; the values are big enough for motion features too.
+static uint8_t gSampleBatch[I2C_COMMAND_SAMPLE_BATCH_MAX_SIZE];
+static TsCodec gSampleCodec;
+static TsCodecValue gSampleValues[SAMPLE_STORE_MAX_DATA_LENGTH];
+static TsCodecValue gSampleLatest[SAMPLE_STORE_MAX_DATA_LENGTH];
+static bool gSampleRemove[SAMPLE_STORE_MAX_SAMPLES];
 
 // Event queue for the UART driver.
 static QueueHandle_t gUartEventQueue;
@@ -129,55 +313,13 @@ static float gRadiusMetres = 0;
 static float gAltitudeMetres = 0;
 static bool  gGotLocationFix = false;
 
+// When to wake, kept in RTC slow memory with rtc_state.c.
+static RTC_DATA_ATTR SleepScheduler gSleepScheduler;
+
 /**************************************************************************
  * STATIC FUNCTIONS
  *************************************************************************/
 
-// Set the state of the LEDs permanently
-static void ledSet(LedState state)
-{
-    switch (state) {
-        case LED_STATE_OFF:
-            gpio_set_level(CONFIG_PIN_DEBUG_LED_RED, 1);
-            gpio_set_level(CONFIG_PIN_DEBUG_LED_GREEN, 1);
-            gpio_set_level(CONFIG_PIN_DEBUG_LED_BLUE, 1);
-        break;
-        case LED_STATE_GOOD:
-            gpio_set_level(CONFIG_PIN_DEBUG_LED_RED, 1);
-            gpio_set_level(CONFIG_PIN_DEBUG_LED_GREEN, 0);
-            gpio_set_level(CONFIG_PIN_DEBUG_LED_BLUE, 1);
-        break;
-        case LED_STATE_MIDDLIN:
-            gpio_set_level(CONFIG_PIN_DEBUG_LED_RED, 0);
-            gpio_set_level(CONFIG_PIN_DEBUG_LED_GREEN, 0);
-            gpio_set_level(CONFIG_PIN_DEBUG_LED_BLUE, 1);
-        break;
-        case LED_STATE_BAD:
-            gpio_set_level(CONFIG_PIN_DEBUG_LED_RED, 0);
-            gpio_set_level(CONFIG_PIN_DEBUG_LED_GREEN, 1);
-            gpio_set_level(CONFIG_PIN_DEBUG_LED_BLUE, 1);
-        break;
-        default:
-        break;
-    }
-}
-
-// Set the state of the LED for a given time and
-// then return to what they were previously
-static void ledSetTemporary(LedState state, int32_t timeMilliseconds)
-{
-    bool red = gpio_get_level(CONFIG_PIN_DEBUG_LED_RED);
-    bool green = gpio_get_level(CONFIG_PIN_DEBUG_LED_GREEN);
-    bool blue = gpio_get_level(CONFIG_PIN_DEBUG_LED_BLUE);
-
-    ledSet(state);
-    vTaskDelay(timeMilliseconds / portTICK_PERIOD_MS);
-
-    gpio_set_level(CONFIG_PIN_DEBUG_LED_RED, red);
-    gpio_set_level(CONFIG_PIN_DEBUG_LED_GREEN, green);
-    gpio_set_level(CONFIG_PIN_DEBUG_LED_BLUE, blue);
-}
-
 // Callback function for the cellular connect and
 // location establishment processes
 static bool keepGoingCallback()
@@ -187,9 +329,9 @@ static bool keepGoingCallback()
     esp_task_wdt_reset();
     if ((esp_timer_get_time() / 1000) > gStopTimeCellularMS) {
         keepGoing = false;
-        ledSetTemporary(LED_STATE_BAD, 100);
+        ledFlash(LED_STATE_BAD, 100);
     } else {
-        ledSetTemporary(LED_STATE_MIDDLIN, 100);
+        ledFlash(LED_STATE_MIDDLIN, 100);
     }
 
     return keepGoing;
@@ -212,10 +354,10 @@ static void locationFixCallback(int32_t latitudeX10e7,
     gAltitudeMetres = (float) altitudeMetres;
 
     gGotLocationFix = true;
-    printf("MAIN: location call-back called, location is %.6f/%.6f +/-%d metres, %d metre(s) high.\n",
-           gLatitudeDegrees, gLongitudeDegrees, radiusMetres, altitudeMetres);
-    printf("MAIN: paste this into a browser: https://maps.google.com/?q=%.6f,%.6f\n",
-           gLatitudeDegrees, gLongitudeDegrees);
+    DIAG_INFO("MAIN: location call-back called, location is %.6f/%.6f +/-%d metres, %d metre(s) high.\n",
+              gLatitudeDegrees, gLongitudeDegrees, radiusMetres, altitudeMetres);
+    DIAG_DEBUG("MAIN: paste this into a browser: https://maps.google.com/?q=%.6f,%.6f\n",
+               gLatitudeDegrees, gLongitudeDegrees);
 }
 
 // Convert from ESP32 Wifi authentication mode enum to our bitmap.
@@ -282,60 +424,63 @@ static uint8_t convertFromEsp32Cipher(wifi_cipher_type_t cipher)
     return cipherBitmap;
 }
 
-// Set up the IO lines for the LEDs
-static void ledInit()
-{
-    gpio_config_t config;
-
-    config.intr_type = GPIO_PIN_INTR_DISABLE;
-    config.mode = GPIO_MODE_INPUT_OUTPUT;
-    config.pull_down_en = 0;
-    config.pull_up_en = 0;
-    config.pin_bit_mask = (1ULL << CONFIG_PIN_DEBUG_LED_RED);
-    gpio_config(&config);
-    gpio_set_level(CONFIG_PIN_DEBUG_LED_RED, 1);
-    config.pin_bit_mask = (1ULL << CONFIG_PIN_DEBUG_LED_GREEN);
-    gpio_config(&config);
-    gpio_set_level(CONFIG_PIN_DEBUG_LED_GREEN, 1);
-    config.pin_bit_mask = (1ULL << CONFIG_PIN_DEBUG_LED_BLUE);
-    gpio_config(&config);
-    gpio_set_level(CONFIG_PIN_DEBUG_LED_BLUE, 1);
-
-    gpio_set_level(CONFIG_PIN_DEBUG_LED_RED, 0);
-    gpio_set_level(CONFIG_PIN_DEBUG_LED_GREEN, 1);
-    gpio_set_level(CONFIG_PIN_DEBUG_LED_BLUE, 1);
-    vTaskDelay(250 / portTICK_PERIOD_MS);
-    gpio_set_level(CONFIG_PIN_DEBUG_LED_RED, 1);
-    gpio_set_level(CONFIG_PIN_DEBUG_LED_GREEN, 0);
-    gpio_set_level(CONFIG_PIN_DEBUG_LED_BLUE, 1);
-    vTaskDelay(250 / portTICK_PERIOD_MS);
-    gpio_set_level(CONFIG_PIN_DEBUG_LED_RED, 1);
-    gpio_set_level(CONFIG_PIN_DEBUG_LED_GREEN, 1);
-    gpio_set_level(CONFIG_PIN_DEBUG_LED_BLUE, 0);
-    vTaskDelay(250 / portTICK_PERIOD_MS);
-    gpio_set_level(CONFIG_PIN_DEBUG_LED_RED, 1);
-    gpio_set_level(CONFIG_PIN_DEBUG_LED_GREEN, 1);
-    gpio_set_level(CONFIG_PIN_DEBUG_LED_BLUE, 1);
-    vTaskDelay(250 / portTICK_PERIOD_MS);
+// Collect the access points found by the Wifi scan, switch Wifi
+// off and start getting a location fix with them
+static int32_t locationStart()
+{
+    int32_t errorCode;
+    const wifi_ap_record_t *pEsp32WifiRecords;
+    int32_t numWifiApsFound = 0;
+    LocationWifiAp *pWifiRecord = NULL;
+
+    if (wifiScanWait(WIFI_SCAN_WAIT_MS)) {
+        numWifiApsFound = wifiScanGetAps(&pEsp32WifiRecords);
+    }
+    // Build the list backwards so that the strongest is first
+    for (int32_t x = numWifiApsFound - 1; x >= 0; x--) {
+        memcpy(gLocationWifiAps[x].macAddress, pEsp32WifiRecords[x].bssid,
+               sizeof(gLocationWifiAps[x].macAddress));
+        strncpy(gLocationWifiAps[x].ssid, (const char *) pEsp32WifiRecords[x].ssid,
+                sizeof(gLocationWifiAps[x].ssid));
+        gLocationWifiAps[x].ssid[sizeof(gLocationWifiAps[x].ssid) - 1] = 0;
+        gLocationWifiAps[x].channel = pEsp32WifiRecords[x].primary;
+        gLocationWifiAps[x].rssiDbm = pEsp32WifiRecords[x].rssi;
+        gLocationWifiAps[x].authModeBitmap = convertFromEsp32AuthMode(pEsp32WifiRecords[x].authmode);
+        gLocationWifiAps[x].pairwiseCipherBitmap = convertFromEsp32Cipher(pEsp32WifiRecords[x].pairwise_cipher);
+        gLocationWifiAps[x].groupCipherBitmap = convertFromEsp32Cipher(pEsp32WifiRecords[x].group_cipher);
+        gLocationWifiAps[x].pNext = pWifiRecord;
+        pWifiRecord = &(gLocationWifiAps[x]);
+    }
+    wifiScanStop();
+    DIAG_INFO("MAIN: %d Wifi AP(s) for location.\n", numWifiApsFound);
+
+    gGotLocationFix = false;
+    errorCode = locationGetStart(pWifiRecord, keepGoingCallback, locationFixCallback);
+    if (errorCode != 0) {
+        DIAG_ERROR("MAIN: error: unable to start a location fix (%d).\n", errorCode);
+    }
+
+    return errorCode;
 }
 
 // Required for Wifi
 static esp_err_t wifi_event_handler(void *ctx, system_event_t *event)
 {
-    printf("MAIN: Wifi event, ID %d.\n", event->event_id);
+    DIAG_DEBUG("MAIN: Wifi event, ID %d.\n", event->event_id);
 
     switch (event->event_id) {
         case SYSTEM_EVENT_STA_START:
-            printf("MAIN: Wifi scan started.\n");
+            DIAG_DEBUG("MAIN: Wifi scan started.\n");
         break;
         case SYSTEM_EVENT_SCAN_DONE:
-            printf("MAIN: Wifi scan (ID %d) done, status %d, %d AP(s) found.\n",
-                   event->event_info.scan_done.scan_id,
-                   event->event_info.scan_done.status,
-                   event->event_info.scan_done.number);
+            DIAG_DEBUG("MAIN: Wifi scan (ID %d) done, status %d, %d AP(s) found.\n",
+                       event->event_info.scan_done.scan_id,
+                       event->event_info.scan_done.status,
+                       event->event_info.scan_done.number);
+            wifiScanHandleEvent(event);
         break;
         case SYSTEM_EVENT_STA_STOP:
-            printf("MAIN: Wifi scan stopped.\n");
+            DIAG_DEBUG("MAIN: Wifi scan stopped.\n");
         break;
         default:
         break;
@@ -356,6 +501,8 @@ static int32_t locationSetLocation(int32_t objectInstanceId,
     Lwm2mObjectInstance *pObject;
     Lwm2mValue value;
  
+    lwm2mArenaStart();
+
     // Prepare the entire object
     pObject = pLwm2mObjectPrepare(LWM2M_OBJECT_ID_LOCATION,
                                   objectInstanceId);
@@ -390,300 +537,21 @@ static int32_t locationSetLocation(int32_t objectInstanceId,
             // Now write to the object
             errorCode = lwm2mObjectSet(pObject);
             if (errorCode != 0) {
-                printf("MAIN: error: unable to write to /%d/%d (%d).\n",
-                       pObject->omaId, pObject->instanceId, errorCode);
+                DIAG_ERROR("MAIN: error: unable to write to /%d/%d (%d).\n",
+                           pObject->omaId, pObject->instanceId, errorCode);
             }
         } else {
-            printf("MAIN: error: out of memory preparing resource for object /%d/%d (%d).\n",
-                   pObject->omaId, pObject->instanceId, errorCode);
-        }
-        lwm2mObjectUnprepare(pObject);
-    } else {
-        printf("MAIN: error: out of memory preparing object /%d/%d (%d).\n",
-               LWM2M_OBJECT_ID_LOCATION, objectInstanceId, errorCode);
-    }
-
-    return errorCode;
-}
-
-// Read the 7-bit I2C address from the given instance of the
-// I2C Generic Command object.  Returns zero on succesa, otherwise
-// negative error code.
-static int32_t i2cGenericCommandGetDeviceI2cAddress(int32_t objectInstanceId,
-                                                    char *pI2cAddress)
-{
-    int32_t errorCode;
-    Lwm2mResourceDescription resourceDescription;
-    Lwm2mValue value;
- 
-    resourceDescription.objectOmaId = LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND;
-    resourceDescription.objectInstanceId = objectInstanceId;
-    // Device I2C Address resource
-    resourceDescription.resourceOmaId = 1;
-    resourceDescription.resourceInstanceId = -1;
-    resourceDescription.resourceType = LWM2M_RESOURCE_TYPE_INTEGER;
-    errorCode = lwm2mResourceGet(&resourceDescription, &value, NULL);
-    if (errorCode == 0) {
-        if (pI2cAddress != NULL) {
-            *pI2cAddress = (char) ((int32_t) SHTC1_ADDR) & 0x7F; //hack!
-        }
-    } else {
-        printf("MAIN: error: failed to read Device I2C Address resource from /%d/%d (%d).\n",
-               LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND, objectInstanceId, errorCode);
-    }
-
-    return errorCode;
-}
-
-// Read the trigger condition from the given instance of the
-// I2C Generic Command object  Returns zero on succesa, otherwise
-// negative error code.
-static int32_t i2cGenericCommandGetTriggerCondition(int32_t objectInstanceId,
-                                                    int32_t *pTriggerCondition)
-{
-    int32_t errorCode;
-    Lwm2mResourceDescription resourceDescription;
-    Lwm2mValue value;
- 
-    resourceDescription.objectOmaId = LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND;
-    resourceDescription.objectInstanceId = objectInstanceId;
-    // Trigger Condition resource
-    resourceDescription.resourceOmaId = 4;
-    resourceDescription.resourceInstanceId = -1;
-    resourceDescription.resourceType = LWM2M_RESOURCE_TYPE_INTEGER;
-    errorCode = lwm2mResourceGet(&resourceDescription, &value, NULL);
-    if (errorCode == 0) {
-        if (pTriggerCondition != NULL) {
-            *pTriggerCondition = (int32_t) value.number;
-        }
-    } else {
-        printf("MAIN: error: failed to read Trigger Condition resource from /%d/%d (%d).\n",
-               LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND, objectInstanceId, errorCode);
-    }
-
-    return errorCode;
-}
-
-// Read the write sequence from the given instance of the
-// I2C Generic Command object  Returns zero on succesa, otherwise
-// negative error code.
-static int32_t i2cGenericCommandGetWriteSequence(int32_t objectInstanceId,
-                                                 I2cSequence *pI2cSequence)
-{
-    int32_t errorCode;
-    Lwm2mObjectInstance *pObject;
-    Lwm2mResourceInstance *pResource;
- 
-    // Read the whole object this time, as the write sequence is a
-    // multi-instance resource and we need all of them
-    errorCode = lwm2mObjectGet(LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND,
-                               objectInstanceId, &pObject);
-    if (errorCode == 0) {
-        if (pI2cSequence != NULL) {
-            // Read all of the instances of the Write Sequence resource
-            pI2cSequence->length = 0;
-            pResource = pObject->pResources;
-			
-            while (pResource != NULL) {
-                if (pResource->omaId == 5) { 
-				    // 5 is the Write Sequence resource
-                    // Handle the single instance case (in which 
-                    // the instance ID will be set to -1)
-                    if (pResource->instanceId < 0) {
-                        pResource->instanceId = 0;
-                    }
-                    if (pResource->instanceId < I2C_SEQUENCE_WRITE_MAX_LENGTH) {
-                        pI2cSequence->sequence[pResource->instanceId] =
-                            (uint8_t) pResource->value.number;
-                        (pI2cSequence->length)++;
-                    }
-                }
-                pResource = pResource->pNext;
-            }
-        }
-		// HACK
-		pI2cSequence->length = 2;
-		pI2cSequence->sequence[0] = 0xFF;
-		pI2cSequence->sequence[1] = 0xFF;
-		
-        lwm2mObjectFree(&pObject);
-    } else {
-        printf("MAIN: error: unable to read /%d/%d (%d).\n",
-               LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND,
-               objectInstanceId, errorCode);
-    }
-
-    return errorCode;
-}
-
-// Set the Write Success resource in the given instance of the
-// I2C Generic Command object.  Returns zero on succesa, otherwise
-// negative error code.
-static int32_t i2cGenericCommandSetWriteSuccess(int32_t objectInstanceId,
-                                                bool writeSuccess)
-{
-    int32_t errorCode;
-    Lwm2mResourceDescription resourceDescription;
-    Lwm2mValue value;
- 
-    resourceDescription.objectOmaId = LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND;
-    resourceDescription.objectInstanceId = objectInstanceId;
-    // Device Write Success resource
-    resourceDescription.resourceOmaId = 6;
-    resourceDescription.resourceInstanceId = -1;
-    resourceDescription.resourceType = LWM2M_RESOURCE_TYPE_BOOLEAN;
-    value.boolean = writeSuccess;
-    errorCode = lwm2mResourceSet(&resourceDescription, value);
-    if (errorCode != 0) {
-        printf("MAIN: error: failed to write Write Success resource in object /%d/%d (%d).\n",
-               LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND, objectInstanceId, errorCode);
-    }
-
-    return errorCode;
-}
-
-// Read the Delay resource from the given instance of the
-// I2C Generic Command object.  Returns zero on success, otherwise
-// negative error code.
-static int32_t i2cGenericCommandGetDelay(int32_t objectInstanceId,
-                                         int32_t *pDelay)
-{
-    int32_t errorCode;
-    Lwm2mResourceDescription resourceDescription;
-    Lwm2mValue value;
- 
-    resourceDescription.objectOmaId = LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND;
-    resourceDescription.objectInstanceId = objectInstanceId;
-    // Delay resource
-    resourceDescription.resourceOmaId = 7;
-    resourceDescription.resourceInstanceId = -1;
-    resourceDescription.resourceType = LWM2M_RESOURCE_TYPE_INTEGER;
-    errorCode = lwm2mResourceGet(&resourceDescription, &value, NULL);
-    if (errorCode == 0) {
-        if (pDelay != NULL) {
-            *pDelay = (int32_t) 60000.0; //HACK
-        }
-    } else {
-        printf("MAIN: error: failed to read Delay resource from /%d/%d (%d).\n",
-               LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND, objectInstanceId, errorCode);
-    }
-
-    return errorCode;
-}
-
-
-
-
-// return the value of 33059/1/5
-static int32_t web_sensor_demo(int32_t *v)
-{
-    int32_t errorCode;
-    Lwm2mResourceDescription resourceDescription;
-    Lwm2mValue value;
- 
-    resourceDescription.objectOmaId = LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND;
-    resourceDescription.objectInstanceId = 1 ;
-    // Delay resource
-    resourceDescription.resourceOmaId = 5;
-    resourceDescription.resourceInstanceId = -1;
-    resourceDescription.resourceType = LWM2M_RESOURCE_TYPE_INTEGER;
-    errorCode = lwm2mResourceGet(&resourceDescription, &value, NULL);
-    if (errorCode == 0) {
-		printf("--> web_sensor_demo: value:%f \n\n", value.number);
-        *v = (int32_t) value.number;
-    } else {
-        printf("--> web_sensor_demo:\n");
-    }
-
-    return errorCode;
-}
-
-
-
-
-
-// Get the number of instance of Read Response in the given instance of the
-// I2C Generic Command object.  Returns zero on success, otherwise
-// negative error code.
-static int32_t i2cGenericCommandGetReadResponseLength(int32_t objectInstanceId,
-                                                      int32_t *pReadResponseLength)
-{
-    int32_t errorCode;
-    Lwm2mObjectInstance *pObject;
-    Lwm2mResourceInstance *pResource;
- 
-    // Read the whole object to count the Read Response instances
-    errorCode = lwm2mObjectGet(LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND,
-                               objectInstanceId, &pObject);
-    if (errorCode == 0) {
-        if (pReadResponseLength != NULL) {
-            // Read all of the instances of the Read Response resource
-            *pReadResponseLength = 0;
-            pResource = pObject->pResources;
-            while (pResource != NULL) {
-                if (pResource->omaId == 9) { // 9 is the Read Response resource
-                    (*pReadResponseLength)++;
-                }
-                pResource = pResource->pNext;
-            }
-        }
-		//HACK
-		*pReadResponseLength = (int32_t) 6.0;
-        lwm2mObjectFree(&pObject);
-    } else {
-        printf("MAIN: error: unable to read /%d/%d (%d).\n",
-               LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND,
-               objectInstanceId, errorCode);
-    }
-
-    return errorCode;
-}
-
-// Write the Response Size and Read Response into the given
-// instance of the I2C Generic Command object  Returns zero
-// on succesa, otherwise negative error code.
-static int32_t i2cGenericCommandSetReadResponse(int32_t objectInstanceId,
-                                                I2cSequence *pI2cSequence)
-{
-    int32_t errorCode = SARA_R412M_LWM2M_OUT_OF_MEMORY;
-    int32_t x;
-    Lwm2mObjectInstance *pObject;
-    Lwm2mValue value;
- 
-    // Prepare an object which matches the instance but only
-    // populate the resources we want to modify
-    pObject = pLwm2mObjectPrepare(LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND,
-                                  objectInstanceId);
-    if (pObject != NULL) {
-        // Add the Response Size resource instances
-        value.number = (float) pI2cSequence->length;
-        errorCode = lwm2mResourcePrepare(8, -1, /* the Response Size resource */
-                                         LWM2M_RESOURCE_TYPE_INTEGER,
-                                         value, pObject);
-        // Add the Read Response resource instances
-        for (x = 0; (x < pI2cSequence->length) && (errorCode == 0); x++) {
-            value.number = (float) pI2cSequence->sequence[x];
-            errorCode = lwm2mResourcePrepare(9, x, /* the Read Response resource */
-                                             LWM2M_RESOURCE_TYPE_INTEGER,
-                                             value, pObject);
-        }
-        if (errorCode == 0) {
-            // Now write to the object
-            errorCode = lwm2mObjectSet(pObject);
-            if (errorCode != 0) {
-                printf("MAIN: error: unable to write to /%d/%d (%d).\n",
+            DIAG_ERROR("MAIN: error: out of memory preparing resource for object /%d/%d (%d).\n",
                        pObject->omaId, pObject->instanceId, errorCode);
-            }
-        } else {
-            printf("MAIN: error: out of memory preparing resources for object /%d/%d (%d).\n",
-                   pObject->omaId, pObject->instanceId, errorCode);
         }
         lwm2mObjectUnprepare(pObject);
     } else {
-        printf("MAIN: error: out of memory preparing object /%d/%d (%d).\n",
-               LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND, objectInstanceId, errorCode);
+        DIAG_ERROR("MAIN: error: out of memory preparing object /%d/%d (%d).\n",
+                   LWM2M_OBJECT_ID_LOCATION, objectInstanceId, errorCode);
     }
 
+    lwm2mArenaStop();
+
     return errorCode;
 }
 
@@ -695,6 +563,8 @@ static int32_t createObjectWhreLwm2mSecurity(int32_t objectInstanceId,
     Lwm2mObjectInstance *pObject;
     Lwm2mValue value;
  
+    lwm2mArenaStart();
+
     // Prepare an object
     pObject = pLwm2mObjectPrepare(LWM2M_OBJECT_ID_SECURITY,
                                   objectInstanceId);
@@ -743,19 +613,21 @@ static int32_t createObjectWhreLwm2mSecurity(int32_t objectInstanceId,
             // Now create the object
             errorCode = lwm2mObjectCreate(pObject, shortServerId);
             if (errorCode != 0) {
-                printf("MAIN: error: unable to create object /%d/%d (%d).\n",
-                       pObject->omaId, pObject->instanceId, errorCode);
+                DIAG_ERROR("MAIN: error: unable to create object /%d/%d (%d).\n",
+                           pObject->omaId, pObject->instanceId, errorCode);
             }
         } else {
-            printf("MAIN: error: out of memory preparing resources for object /%d/%d (%d).\n",
-                   pObject->omaId, pObject->instanceId, errorCode);
+            DIAG_ERROR("MAIN: error: out of memory preparing resources for object /%d/%d (%d).\n",
+                       pObject->omaId, pObject->instanceId, errorCode);
         }
         lwm2mObjectUnprepare(pObject);
     } else {
-        printf("MAIN: error: out of memory preparing object /%d/%d (%d).\n",
-               LWM2M_OBJECT_ID_SECURITY, objectInstanceId, errorCode);
+        DIAG_ERROR("MAIN: error: out of memory preparing object /%d/%d (%d).\n",
+                   LWM2M_OBJECT_ID_SECURITY, objectInstanceId, errorCode);
     }
 
+    lwm2mArenaStop();
+
     return errorCode;
 }
 
@@ -769,6 +641,8 @@ static int32_t createObjectWhreLwm2mServer(int32_t objectInstanceId,
     Lwm2mObjectInstance *pObject;
     Lwm2mValue value;
  
+    lwm2mArenaStart();
+
     // Prepare an object
     pObject = pLwm2mObjectPrepare(LWM2M_OBJECT_ID_SERVER,
                                   objectInstanceId);
@@ -812,19 +686,59 @@ static int32_t createObjectWhreLwm2mServer(int32_t objectInstanceId,
             // Now create the object
             errorCode = lwm2mObjectCreate(pObject, shortServerId);
             if (errorCode != 0) {
-                printf("MAIN: error: unable to create object /%d/%d (%d).\n",
+                DIAG_ERROR("MAIN: error: unable to create object /%d/%d (%d).\n",
+                           pObject->omaId, pObject->instanceId, errorCode);
+            }
+        } else {
+            DIAG_ERROR("MAIN: error: out of memory preparing resources for object /%d/%d (%d).\n",
                        pObject->omaId, pObject->instanceId, errorCode);
+        }
+        lwm2mObjectUnprepare(pObject);
+    } else {
+        DIAG_ERROR("MAIN: error: out of memory preparing object /%d/%d (%d).\n",
+                   LWM2M_OBJECT_ID_SERVER, objectInstanceId, errorCode);
+    }
+
+    lwm2mArenaStop();
+
+    return errorCode;
+}
+
+// Set the registration lifetime in an existing LWM2M Server object,
+// e.g. one created by an earlier build with a different lifetime.
+static int32_t setLwm2mServerLifetime(int32_t objectInstanceId,
+                                      int32_t lifetimeSeconds)
+{
+    int32_t errorCode = SARA_R412M_LWM2M_OUT_OF_MEMORY;
+    Lwm2mObjectInstance *pObject;
+    Lwm2mValue value;
+
+    lwm2mArenaStart();
+
+    pObject = pLwm2mObjectPrepare(LWM2M_OBJECT_ID_SERVER, objectInstanceId);
+    if (pObject != NULL) {
+        value.number = (float) lifetimeSeconds;
+        errorCode = lwm2mResourcePrepare(1, -1, /* the Lifetime resource */
+                                         LWM2M_RESOURCE_TYPE_INTEGER,
+                                         value, pObject);
+        if (errorCode == 0) {
+            errorCode = lwm2mObjectSet(pObject);
+            if (errorCode != 0) {
+                DIAG_ERROR("MAIN: error: unable to write to /%d/%d (%d).\n",
+                           pObject->omaId, pObject->instanceId, errorCode);
             }
         } else {
-            printf("MAIN: error: out of memory preparing resources for object /%d/%d (%d).\n",
-                   pObject->omaId, pObject->instanceId, errorCode);
+            DIAG_ERROR("MAIN: error: out of memory preparing resources for object /%d/%d (%d).\n",
+                       pObject->omaId, pObject->instanceId, errorCode);
         }
         lwm2mObjectUnprepare(pObject);
     } else {
-        printf("MAIN: error: out of memory preparing object /%d/%d (%d).\n",
-               LWM2M_OBJECT_ID_SERVER, objectInstanceId, errorCode);
+        DIAG_ERROR("MAIN: error: out of memory preparing object /%d/%d (%d).\n",
+                   LWM2M_OBJECT_ID_SERVER, objectInstanceId, errorCode);
     }
 
+    lwm2mArenaStop();
+
     return errorCode;
 }
 
@@ -836,6 +750,8 @@ static int32_t createObjectLocation(int32_t objectInstanceId,
     Lwm2mObjectInstance *pObject;
     Lwm2mValue value;
  
+    lwm2mArenaStart();
+
     // Prepare an object
     pObject = pLwm2mObjectPrepare(LWM2M_OBJECT_ID_LOCATION,
                                   objectInstanceId);
@@ -873,19 +789,21 @@ static int32_t createObjectLocation(int32_t objectInstanceId,
             // Now create the object
             errorCode = lwm2mObjectCreate(pObject, shortServerId);
             if (errorCode != 0) {
-                printf("MAIN: error: unable to create object /%d/%d (%d).\n",
-                       pObject->omaId, pObject->instanceId, errorCode);
+                DIAG_ERROR("MAIN: error: unable to create object /%d/%d (%d).\n",
+                           pObject->omaId, pObject->instanceId, errorCode);
             }
         } else {
-            printf("MAIN: error: out of memory preparing resources for object /%d/%d (%d).\n",
-                   pObject->omaId, pObject->instanceId, errorCode);
+            DIAG_ERROR("MAIN: error: out of memory preparing resources for object /%d/%d (%d).\n",
+                       pObject->omaId, pObject->instanceId, errorCode);
         }
         lwm2mObjectUnprepare(pObject);
     } else {
-        printf("MAIN: error: out of memory preparing object /%d/%d (%d).\n",
-               LWM2M_OBJECT_ID_LOCATION, objectInstanceId, errorCode);
+        DIAG_ERROR("MAIN: error: out of memory preparing object /%d/%d (%d).\n",
+                   LWM2M_OBJECT_ID_LOCATION, objectInstanceId, errorCode);
     }
 
+    lwm2mArenaStop();
+
     return errorCode;
 }
 
@@ -893,235 +811,729 @@ static int32_t createObjectLocation(int32_t objectInstanceId,
 static int32_t createObjectGenericI2c(int32_t objectInstanceId,
                                       int32_t shortServerId)
 {
-    int32_t errorCode = SARA_R412M_LWM2M_OUT_OF_MEMORY;
-    Lwm2mObjectInstance *pObject;
-    Lwm2mValue value;
- 
-    // Prepare an object
-    pObject = pLwm2mObjectPrepare(LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND,
-                                  objectInstanceId);
-    if (pObject != NULL) {
-        // Add the single Device I2C Address resource instance
-        value.number = 0;
-        errorCode = lwm2mResourcePrepare(1, -1, /* the Device I2C Address resource */
-                                         LWM2M_RESOURCE_TYPE_INTEGER,
-                                         value, pObject);
-        if (errorCode == 0) {
-            // Add the single Device Name resource instance
-            value.pString = "";
-            errorCode = lwm2mResourcePrepare(2, -1, /* the Device Name resource */
-                                             LWM2M_RESOURCE_TYPE_STRING,
-                                             value, pObject);
-        }
+    Lwm2mI2cGenericCommand values;
+
+    // The Write Sequence and Read Response resources are created
+    // empty.
+    // TODO: leaving out the Read Timestamp resource for now as it might upset SARA-R412M
+    memset(&values, 0, sizeof(values));
+    return lwm2mI2cGenericCommandCreate(objectInstanceId, shortServerId, &values,
+                                        LWM2M_I2C_GENERIC_COMMAND_RESOURCES_ALL &
+                                        ~LWM2M_OBJECT_DESC_RESOURCE(LWM2M_I2C_GENERIC_COMMAND_RESOURCE_READ_TIMESTAMP));
+}
+
+// Create the WHRE Motion Features object.
+static int32_t createObjectMotionFeatures(int32_t objectInstanceId,
+                                          int32_t shortServerId)
+{
+    Lwm2mWhreMotionFeatures values;
+
+    memset(&values, 0, sizeof(values));
+    values.windowDuration = (MOTION_FEATURES_WINDOW_SIZE * 1000) / LIS2DW_FIFO_ODR_HZ;
+    return lwm2mWhreMotionFeaturesCreate(objectInstanceId, shortServerId, &values,
+                                         LWM2M_WHRE_MOTION_FEATURES_RESOURCES_ALL);
+}
+
+// Write a batch of motion features, encoded with ts_codec.c, and
+// the latest of them to the WHRE Motion Features object.
+static int32_t setMotionFeatures(const MotionFeatures *pLatest,
+                                 const uint8_t *pBatch, int32_t length)
+{
+    Lwm2mWhreMotionFeatures values;
+
+    if ((length < 0) || (length > I2C_COMMAND_SAMPLE_BATCH_MAX_SIZE)) {
+        return -1;
+    }
+
+    memset(&values, 0, sizeof(values));
+    values.rmsAcceleration = pLatest->rmsMg;
+    values.peakAcceleration = pLatest->peakMg;
+    values.zeroCrossings = pLatest->zeroCrossings;
+    values.dominantAxis = pLatest->dominantAxis;
+    values.featureBatch.pBytes = (uint8_t *) pBatch;
+    values.featureBatch.length = length;
+
+    // Everything but the Window Duration, which doesn't change
+    return lwm2mWhreMotionFeaturesSet(LWM2M_OBJECT_INSTANCE_ID_MOTION_FEATURES, &values,
+                                      LWM2M_WHRE_MOTION_FEATURES_RESOURCES_ALL &
+                                      ~LWM2M_OBJECT_DESC_RESOURCE(LWM2M_WHRE_MOTION_FEATURES_RESOURCE_WINDOW_DURATION));
+}
+
+// Create the WHRE Channel Statistics object; every instance of the
+// per-channel resources is created, zeroed.
+static int32_t createObjectChannelStatistics(int32_t objectInstanceId,
+                                             int32_t shortServerId)
+{
+    Lwm2mWhreChannelStatistics values;
+
+    memset(&values, 0, sizeof(values));
+    return lwm2mWhreChannelStatisticsCreate(objectInstanceId, shortServerId, &values,
+                                            LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCES_ALL);
+}
+
+// Write the statistics of each channel (see channel_stats.h) to
+// the WHRE Channel Statistics object.
+static int32_t setChannelStatistics()
+{
+    int32_t errorCode = 0;
+    Lwm2mWhreChannelStatistics values;
+    ChannelStats stats;
+    int32_t numChannels = channelStatsCount();
+
+    memset(&values, 0, sizeof(values));
+    values.numberOfChannels = numChannels;
+    values.periodStart = channelStatsPeriodStart();
+    for (int32_t x = 0; (x < numChannels) && (errorCode == 0); x++) {
+        errorCode = channelStatsGet(x, &stats);
         if (errorCode == 0) {
-            // Add the single Command Name resource instance
-            value.pString = "";
-            errorCode = lwm2mResourcePrepare(3, -1, /* the Command Name resource */
-                                             LWM2M_RESOURCE_TYPE_STRING,
-                                             value, pObject);
+            values.channel[x] = stats.channelId;
+            values.sampleCount[x] = stats.count;
+            values.minimum[x] = stats.minimum;
+            values.maximum[x] = stats.maximum;
+            values.mean[x] = stats.mean;
+            values.variance[x] = stats.variance;
+            values.lastValue[x] = stats.last;
         }
-        if (errorCode == 0) {
-            // Add the single Trigger Condition resource instance
-            value.number = 0;
-            errorCode = lwm2mResourcePrepare(4, -1, /* the Trigger Condition resource */
-                                             LWM2M_RESOURCE_TYPE_INTEGER,
-                                             value, pObject);
+    }
+    values.numChannel = numChannels;
+    values.numSampleCount = numChannels;
+    values.numMinimum = numChannels;
+    values.numMaximum = numChannels;
+    values.numMean = numChannels;
+    values.numVariance = numChannels;
+    values.numLastValue = numChannels;
+    values.untrackedValues = channelStatsUntracked();
+
+    if (errorCode == 0) {
+        errorCode = lwm2mWhreChannelStatisticsSet(LWM2M_OBJECT_INSTANCE_ID_CHANNEL_STATISTICS,
+                                                  &values,
+                                                  LWM2M_WHRE_CHANNEL_STATISTICS_RESOURCES_ALL);
+    }
+
+    return errorCode;
+}
+
+// Create the WHRE Report Filter object, with no channels
+// configured; every instance of the per-channel resources is
+// created, zeroed.
+static int32_t createObjectReportFilter(int32_t objectInstanceId,
+                                        int32_t shortServerId)
+{
+    Lwm2mWhreReportFilter values;
+
+    memset(&values, 0, sizeof(values));
+    return lwm2mWhreReportFilterCreate(objectInstanceId, shortServerId, &values,
+                                       LWM2M_WHRE_REPORT_FILTER_RESOURCES_ALL);
+}
+
+// Read the settings the server has written to the WHRE Report
+// Filter object.
+static int32_t getReportFilterConfig(ReportFilterConfig *pConfig)
+{
+    int32_t errorCode;
+    Lwm2mWhreReportFilter values;
+    ReportFilterChannel *pChannel;
+    int32_t numChannels;
+
+    memset(pConfig, 0, sizeof(*pConfig));
+    memset(&values, 0, sizeof(values));
+    errorCode = lwm2mWhreReportFilterGet(LWM2M_OBJECT_INSTANCE_ID_REPORT_FILTER,
+                                         &values, NULL);
+    if (errorCode == 0) {
+        pConfig->maxSilenceSeconds = values.maxSilence;
+        numChannels = values.numberOfChannels;
+        if (numChannels > REPORT_FILTER_MAX_CHANNELS) {
+            numChannels = REPORT_FILTER_MAX_CHANNELS;
         }
-        if (errorCode == 0) {
-            // Add the Write Sequence resource instances
-            for (size_t x = 0; (x < I2C_SEQUENCE_WRITE_MAX_LENGTH) && (errorCode == 0); x++) {
-                value.number = 0;
-                errorCode = lwm2mResourcePrepare(5, x, /* the Write Sequence resource */
-                                                 LWM2M_RESOURCE_TYPE_INTEGER,
-                                                 value, pObject);
+        pConfig->numChannels = (numChannels > 0) ? numChannels : 0;
+        for (int32_t x = 0; x < REPORT_FILTER_MAX_CHANNELS; x++) {
+            pChannel = &(pConfig->channels[x]);
+            if (x < values.numChannel) {
+                pChannel->channelId = values.channel[x];
+            }
+            if (x < values.numDeadband) {
+                pChannel->deadband = values.deadband[x];
+            }
+            if (x < values.numHysteresis) {
+                pChannel->hysteresis = values.hysteresis[x];
             }
         }
-        if (errorCode == 0) {
-            // Add the single Write Success resource instance
-            value.boolean = 0;
-            errorCode = lwm2mResourcePrepare(6, -1, /* the Write Success resource */
-                                             LWM2M_RESOURCE_TYPE_BOOLEAN,
-                                             value, pObject);
-        }
-        if (errorCode == 0) {
-            // Add the single Delay resource instance
-            value.number = 0;
-            errorCode = lwm2mResourcePrepare(7, -1, /* the Delay resource */
-                                             LWM2M_RESOURCE_TYPE_INTEGER,
-                                             value, pObject);
+    }
+
+    return errorCode;
+}
+
+// Write the counts of reports sent and suppressed to the WHRE
+// Report Filter object.
+static int32_t setReportFilterCounts()
+{
+    Lwm2mWhreReportFilter values;
+    uint32_t counts[2];
+
+    reportFilterGetCounts(&(counts[0]), &(counts[1]));
+
+    memset(&values, 0, sizeof(values));
+    values.reportsSent = counts[0];
+    values.reportsSuppressed = counts[1];
+    return lwm2mWhreReportFilterSet(LWM2M_OBJECT_INSTANCE_ID_REPORT_FILTER, &values,
+                                    LWM2M_OBJECT_DESC_RESOURCE(LWM2M_WHRE_REPORT_FILTER_RESOURCE_REPORTS_SENT) |
+                                    LWM2M_OBJECT_DESC_RESOURCE(LWM2M_WHRE_REPORT_FILTER_RESOURCE_REPORTS_SUPPRESSED));
+}
+
+// The default settings of the WHRE Operating Parameters object.
+static void getDefaultOperatingParameters(OperatingParameters *pParameters)
+{
+    pParameters->wakeUpIntervalSeconds = HOST_WAKE_UP_INTERVAL_SECONDS;
+    pParameters->reportingIntervalSeconds = REPORTING_INTERVAL_SECONDS;
+    pParameters->minSleepSeconds = HOST_MINIMUM_SLEEP_INTERVAL_SECONDS;
+    pParameters->minModemUpSeconds = MINIMUM_MODEM_UP_TIME_SECONDS;
+}
+
+// Create the WHRE Operating Parameters object, with the default
+// settings.
+static int32_t createObjectOperatingParameters(int32_t objectInstanceId,
+                                               int32_t shortServerId)
+{
+    Lwm2mWhreOperatingParameters values;
+    OperatingParameters parameters;
+
+    getDefaultOperatingParameters(&parameters);
+    values.hostWakeUpInterval = parameters.wakeUpIntervalSeconds;
+    values.reportingInterval = parameters.reportingIntervalSeconds;
+    values.hostMinimumSleepInterval = parameters.minSleepSeconds;
+    values.minimumModemUpTime = parameters.minModemUpSeconds;
+
+    return lwm2mWhreOperatingParametersCreate(objectInstanceId, shortServerId, &values,
+                                              LWM2M_WHRE_OPERATING_PARAMETERS_RESOURCES_ALL);
+}
+
+// Read the settings the server has written to the WHRE Operating
+// Parameters object; intervals of less than a second, which would
+// leave the device never sleeping or never reporting, are taken
+// as the default and a Reporting Interval which would let the LWM2M
+// registration lapse is shortened.
+static int32_t getOperatingParameters(OperatingParameters *pParameters)
+{
+    int32_t errorCode;
+    Lwm2mWhreOperatingParameters values;
+
+    // Anything not there keeps its default
+    getDefaultOperatingParameters(pParameters);
+    values.hostWakeUpInterval = pParameters->wakeUpIntervalSeconds;
+    values.reportingInterval = pParameters->reportingIntervalSeconds;
+    values.hostMinimumSleepInterval = pParameters->minSleepSeconds;
+    values.minimumModemUpTime = pParameters->minModemUpSeconds;
+    errorCode = lwm2mWhreOperatingParametersGet(LWM2M_OBJECT_INSTANCE_ID_OPERATING_PARAMETERS,
+                                                &values, NULL);
+    if (errorCode == 0) {
+        if (values.hostWakeUpInterval > 0) {
+            pParameters->wakeUpIntervalSeconds = values.hostWakeUpInterval;
         }
-        if (errorCode == 0) {
-            // Add the single Response Size resource instance
-            value.number = 0;
-            errorCode = lwm2mResourcePrepare(8, -1, /* the Response Size resource */
-                                             LWM2M_RESOURCE_TYPE_INTEGER,
-                                             value, pObject);
+        if (values.reportingInterval > LWM2M_REGISTRATION_LIFETIME_SECONDS / 2) {
+            values.reportingInterval = LWM2M_REGISTRATION_LIFETIME_SECONDS / 2;
         }
-        if (errorCode == 0) {
-            // Add the Read Response resource instances
-            for (size_t x = 0; (x < I2C_SEQUENCE_READ_MAX_LENGTH) && (errorCode == 0); x++) {
-                value.number = 0;
-                errorCode = lwm2mResourcePrepare(9, x, /* the Read Response resource */
-                                                 LWM2M_RESOURCE_TYPE_INTEGER,
-                                                 value, pObject);
-            }
+        if (values.reportingInterval > 0) {
+            pParameters->reportingIntervalSeconds = values.reportingInterval;
         }
-        // TODO: leaving out the Read Timestamp resource for now as it might upset SARA-R412M
-        if (errorCode == 0) {
-            // Now create the object
-            errorCode = lwm2mObjectCreate(pObject, shortServerId);
-            if (errorCode != 0) {
-                printf("MAIN: error: unable to create object /%d/%d (%d).\n",
-                       pObject->omaId, pObject->instanceId, errorCode);
-            }
-        } else {
-            printf("MAIN: error: out of memory preparing resources for object /%d/%d (%d).\n",
-                   pObject->omaId, pObject->instanceId, errorCode);
+        pParameters->minSleepSeconds = (values.hostMinimumSleepInterval > 0) ?
+                                       values.hostMinimumSleepInterval : 0;
+        pParameters->minModemUpSeconds = (values.minimumModemUpTime > 0) ?
+                                         values.minimumModemUpTime : 0;
+    }
+
+    return errorCode;
+}
+
+// Give the sleep scheduler the intervals of a set of WHRE Operating
+// Parameters.
+static void setSleepSchedule(const OperatingParameters *pParameters,
+                             uint32_t timeSeconds)
+{
+    sleepSchedulerSetLimits(&gSleepScheduler, pParameters->minSleepSeconds,
+                            SLEEP_COALESCE_TOLERANCE_SECONDS);
+    sleepSchedulerSetInterval(&gSleepScheduler, SLEEP_SCHEDULER_ACTIVITY_SAMPLE,
+                              pParameters->wakeUpIntervalSeconds, timeSeconds);
+    sleepSchedulerSetInterval(&gSleepScheduler, SLEEP_SCHEDULER_ACTIVITY_REPORT,
+                              pParameters->reportingIntervalSeconds, timeSeconds);
+    sleepSchedulerSetInterval(&gSleepScheduler, SLEEP_SCHEDULER_ACTIVITY_LOCATION,
+                              LOCATION_FIX_INTERVAL_SECONDS, timeSeconds);
+}
+
+// Create the Modem Configuration object, with the default
+// settings; the Active Timer goes as a GPRS Timer 2 octet and, with
+// eDRX off, the eDRX resource is empty.
+static int32_t createObjectModemConfiguration(int32_t objectInstanceId,
+                                              int32_t shortServerId)
+{
+    Lwm2mModemConfiguration values;
+    uint8_t octet = modemPsmEncodeT3324(MODEM_ACTIVE_TIMER_SECONDS);
+
+    memset(&values, 0, sizeof(values));
+    values.psmTimer = MODEM_PSM_TIMER_SECONDS;
+    values.activeTimer.pBytes = &octet;
+    values.activeTimer.length = 1;
+
+    // Not the RAT List or Serving PLMN Rate Control resources
+    return lwm2mModemConfigurationCreate(objectInstanceId, shortServerId, &values,
+                                         LWM2M_OBJECT_DESC_RESOURCE(LWM2M_MODEM_CONFIGURATION_RESOURCE_PSM_TIMER) |
+                                         LWM2M_OBJECT_DESC_RESOURCE(LWM2M_MODEM_CONFIGURATION_RESOURCE_ACTIVE_TIMER) |
+                                         LWM2M_OBJECT_DESC_RESOURCE(LWM2M_MODEM_CONFIGURATION_RESOURCE_EDRX));
+}
+
+// Read the power saving settings the server has written to the
+// Modem Configuration object.  The Active Timer may be a GPRS
+// Timer 2 octet, as in 3GPP, or two bytes of seconds, as its range
+// suggests; an empty eDRX resource means eDRX off.
+static int32_t getModemConfiguration(ModemPsmConfig *pConfig)
+{
+    int32_t errorCode;
+    Lwm2mModemConfiguration values;
+    uint8_t activeTimer[2];
+    uint8_t edrx[1];
+
+    pConfig->periodicTauSeconds = MODEM_PSM_TIMER_SECONDS;
+    pConfig->activeTimeSeconds = MODEM_ACTIVE_TIMER_SECONDS;
+    pConfig->edrx = MODEM_PSM_EDRX_OFF;
+
+    memset(&values, 0, sizeof(values));
+    values.psmTimer = pConfig->periodicTauSeconds;
+    values.activeTimer.pBytes = activeTimer;
+    values.activeTimer.size = sizeof(activeTimer);
+    values.edrx.pBytes = edrx;
+    values.edrx.size = sizeof(edrx);
+    errorCode = lwm2mModemConfigurationGet(LWM2M_OBJECT_INSTANCE_ID_MODEM_CONFIGURATION,
+                                           &values, NULL);
+    if (errorCode == 0) {
+        pConfig->periodicTauSeconds = values.psmTimer;
+        if (values.activeTimer.length == 1) {
+            pConfig->activeTimeSeconds = modemPsmDecodeT3324(activeTimer[0]);
+        } else if (values.activeTimer.length == 2) {
+            pConfig->activeTimeSeconds = (((int32_t) activeTimer[0]) << 8) | activeTimer[1];
+        }
+        if (values.edrx.length > 0) {
+            pConfig->edrx = edrx[0];
         }
-        lwm2mObjectUnprepare(pObject);
-    } else {
-        printf("MAIN: error: out of memory preparing object /%d/%d (%d).\n",
-               LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND, objectInstanceId, errorCode);
     }
 
     return errorCode;
 }
 
-// Initialise everything.
-// Warning: here be multiple return statements
-static bool init()
+// Create the WHRE Event Log object.
+static int32_t createObjectEventLog(int32_t objectInstanceId,
+                                    int32_t shortServerId)
+{
+    Lwm2mWhreEventLog values;
+
+    memset(&values, 0, sizeof(values));
+    return lwm2mWhreEventLogCreate(objectInstanceId, shortServerId, &values,
+                                   LWM2M_WHRE_EVENT_LOG_RESOURCES_ALL);
+}
+
+// Write a batch of the flash event log, and the number of events
+// lost, to the WHRE Event Log object.
+static int32_t setEventLog(const uint8_t *pBatch, int32_t length, int32_t lost)
+{
+    Lwm2mWhreEventLog values;
+
+    if ((length < 0) || (length > EVENT_LOG_BATCH_MAX_SIZE)) {
+        return -1;
+    }
+
+    memset(&values, 0, sizeof(values));
+    values.eventBatch.pBytes = (uint8_t *) pBatch;
+    values.eventBatch.length = length;
+    values.eventsLost = lost;
+    return lwm2mWhreEventLogSet(LWM2M_OBJECT_INSTANCE_ID_EVENT_LOG, &values,
+                                LWM2M_WHRE_EVENT_LOG_RESOURCES_ALL);
+}
+
+// Add the values of the channels of a reading to their statistics
+// and check them against the deadbands of the report filter.
+static void addReadingValues(int32_t objectInstanceId, const int32_t *pValues,
+                             int32_t numValues)
+{
+    channelStatsAdd(objectInstanceId, pValues, numValues);
+    reportFilterAdd(objectInstanceId, pValues, numValues);
+}
+
+// Init step: non-volatile storage (required by Wifi for some reason).
+static int32_t initNvs(void *pParam)
 {
     esp_err_t espError;
-    int32_t errorCode;
-    wifi_init_config_t wifiConfig = WIFI_INIT_CONFIG_DEFAULT();
-    esp_chip_info_t chipInfo;
 
-    // Initialise non-volatile storage (required by Wifi for some reason)
+    (void) pParam;
     espError = nvs_flash_init();
     if (espError != 0) {
-        printf("MAIN: error: unable to initialise flash non-volatile storage (0x%x).\n",
-                espError);
-        return false;
+        DIAG_ERROR("MAIN: error: unable to initialise flash non-volatile storage (0x%x).\n",
+                    espError);
     }
-    // Initialise TCP-IP (required by Wifi, even though we only want to scan)
+
+    return (int32_t) espError;
+}
+
+// Init step: TCP-IP (required by Wifi, even though we only want
+// to scan) and event loops (Wifi needs them).
+static int32_t initNetwork(void *pParam)
+{
+    esp_err_t espError;
+
+    (void) pParam;
     tcpip_adapter_init();
-    // Initialise event loops (Wifi needs them)
     espError = esp_event_loop_init(wifi_event_handler, NULL);
     if (espError != 0) {
-        printf("MAIN: error: unable to initialise event loops (0x%x).\n",
-                espError);
-        return false;
+        DIAG_ERROR("MAIN: error: unable to initialise event loops (0x%x).\n",
+                    espError);
     }
-    // Initialise Wifi
+
+    return (int32_t) espError;
+}
+
+// Init step: Wifi, in station mode.
+static int32_t initWifi(void *pParam)
+{
+    esp_err_t espError;
+    wifi_init_config_t wifiConfig = WIFI_INIT_CONFIG_DEFAULT();
+
+    (void) pParam;
     espError = esp_wifi_init(&wifiConfig);
     if (espError != 0) {
-        printf("MAIN: error: unable to initialise Wifi (0x%x).\n", espError);
-        return false;
+        DIAG_ERROR("MAIN: error: unable to initialise Wifi (0x%x).\n", espError);
+        return (int32_t) espError;
     }
-    // Set Wifi to station mode
     espError = esp_wifi_set_mode(WIFI_MODE_STA);
     if (espError != 0) {
-        printf("MAIN: error: unable to set Wifi to station mode (0x%x).\n", espError);
-        return false;
+        DIAG_ERROR("MAIN: error: unable to set Wifi to station mode (0x%x).\n", espError);
     }
-    // Initialise I2C helper
+
+    return (int32_t) espError;
+}
+
+// Init step: I2C helper.
+static int32_t initI2c(void *pParam)
+{
+    int32_t errorCode;
+
+    (void) pParam;
     errorCode = i2cInit(CONFIG_I2C_PORT, CONFIG_PIN_I2C_SDA, CONFIG_PIN_I2C_SCL);
     if (errorCode != 0) {
-        printf("MAIN: error: unable to initialise I2C helper (%d).\n", errorCode);
-        return false;
+        DIAG_ERROR("MAIN: error: unable to initialise I2C helper (%d).\n", errorCode);
     }
-    // Initialise BQ24295, if it's there
-    if (bq24295Init(CONFIG_I2C_PORT, CONFIG_BQ24295_DEFAULT_ADDRESS) != 0) {
-        printf("MAIN: warn: unable to find BQ24295 (%d), guess we're not in a development carrier.\n", errorCode);
+
+    return errorCode;
+}
+
+// Init step: BQ24295, if it's there.
+static int32_t initBq24295(void *pParam)
+{
+    int32_t errorCode;
+
+    (void) pParam;
+    errorCode = bq24295Init(CONFIG_I2C_PORT, CONFIG_BQ24295_DEFAULT_ADDRESS);
+    if (errorCode != 0) {
+        DIAG_WARN("MAIN: warn: unable to find BQ24295 (%d), guess we're not in a development carrier.\n", errorCode);
     }
-    // Initialise LIS2DW
+
+    return errorCode;
+}
+
+// Init step: LIS2DW.
+static int32_t initLis2dw(void *pParam)
+{
+    int32_t errorCode;
+
+    (void) pParam;
     errorCode =  lis2dwInit(CONFIG_I2C_PORT, CONFIG_LIS2DW_DEFAULT_ADDRESS,
                             CONFIG_PIN_INT_ACCELEROMETER, CONFIG_LIS2DW_USE_INTERRUPT_2,
                             CONFIG_LIS2DW_INTERRUPT_IS_OPEN_DRAIN);
     if (errorCode != 0) {
-        printf("MAIN: error: unable to initialise LIS2DW driver (%d).\n", errorCode);
-        return false;
+        DIAG_ERROR("MAIN: error: unable to initialise LIS2DW driver (%d).\n", errorCode);
+    }
+
+    return errorCode;
+}
+
+// Init step: the accelerometer wake-up pin and the pin that
+// monitors M_STAT from SARA-R4.
+static int32_t initPins(void *pParam)
+{
+    (void) pParam;
+
+    // Set external wake-up interrupt pin to be RTC pin
+    if (rtc_gpio_init(CONFIG_PIN_INT_ACCELEROMETER) != ESP_OK) {
+        DIAG_ERROR("MAIN: error: unable to initalise accelerometer GPIO (ESP32 GPIO %d) pin.\n", CONFIG_PIN_INT_ACCELEROMETER);
+        return -1;
     }
-    // Initialise UART helper
+    // Set external wake-up interrupt pin direction as input
+    // Note: BE CAREFUL to use RTC_GPIO_MODE_* here, not GPIO_MODE_*, they are different!
+    if (rtc_gpio_set_direction(CONFIG_PIN_INT_ACCELEROMETER, RTC_GPIO_MODE_INPUT_ONLY) != ESP_OK) {
+        DIAG_ERROR("MAIN: error: unable to set accelerometer GPIO (ESP32 GPIO %d) pin as input.\n", CONFIG_PIN_INT_ACCELEROMETER);
+        return -1;
+    }
+    // Set no pullp on external wake-up pin
+    if ((gpio_pulldown_dis(CONFIG_PIN_INT_ACCELEROMETER) != ESP_OK) ||
+        (gpio_pullup_dis(CONFIG_PIN_INT_ACCELEROMETER) != ESP_OK)) {
+        DIAG_ERROR("MAIN: error: unable to set accelerometer GPIO (ESP32 GPIO %d) pin as no-pull.\n", CONFIG_PIN_INT_ACCELEROMETER);
+        return -1;
+    }
+
+    // Set pin that monitors M_STAT from SARA-R4 as input
+    if (gpio_set_direction(CONFIG_PIN_CELLULAR_M_STAT, GPIO_MODE_INPUT) != ESP_OK) {
+        DIAG_ERROR("MAIN: error: unable to set cellular M_STAT GPIO (ESP32 GPIO %d) pin as input.\n", CONFIG_PIN_CELLULAR_M_STAT);
+        return -1;
+    }
+    // Set pin that monitors M_STAT from SARA-R4 as no-pull
+    if (gpio_set_pull_mode(CONFIG_PIN_CELLULAR_M_STAT, GPIO_FLOATING) != ESP_OK) {
+        DIAG_ERROR("MAIN: error: unable to set cellular M_STAT GPIO (ESP32 GPIO %d) pin as no-pull.\n", CONFIG_PIN_CELLULAR_M_STAT);
+        return -1;
+    }
+
+    return 0;
+}
+
+// Init step: UART helper.
+static int32_t initUart(void *pParam)
+{
+    int32_t errorCode;
+
+    (void) pParam;
     errorCode = uartInit(CONFIG_CELLULAR_UART_PORT, CONFIG_PIN_UART_TXD_CELLULAR,
                          CONFIG_PIN_UART_RXD_CELLULAR, CONFIG_CELLULAR_UART_BAUD_RATE,
                          false, &gUartEventQueue);
     if (errorCode != 0) {
-        printf("MAIN: error: unable to UART I2C helper (%d).\n", errorCode);
-        return false;
+        DIAG_ERROR("MAIN: error: unable to UART I2C helper (%d).\n", errorCode);
+    } else if (modemPsmIsRegistered()) {
+        // SARA-R4 has stayed powered since the rate was negotiated
+        errorCode = modemUartResume(CONFIG_CELLULAR_UART_PORT);
+        if (errorCode != 0) {
+            DIAG_ERROR("MAIN: error: unable to set cellular UART rate (%d).\n", errorCode);
+        }
     }
-    // Initialise AT client
+
+    return errorCode;
+}
+
+// Init step: AT client and, on it, listening for what the LWM2M
+// server is up to.
+static int32_t initAtClient(void *pParam)
+{
+    int32_t errorCode;
+
+    (void) pParam;
     errorCode = at_client_init(CONFIG_CELLULAR_UART_PORT, gUartEventQueue, 8000, "\r", 0);
     if (errorCode != 0) {
-        printf("MAIN: error: unable to initialise AT client (%d).\n", errorCode);
-        return false;
+        DIAG_ERROR("MAIN: error: unable to initialise AT client (%d).\n", errorCode);
+        return errorCode;
     }
-    // Initialise SARA-R412M component
+    errorCode = lwm2mEventsInit();
+    if (errorCode != 0) {
+        DIAG_ERROR("MAIN: error: unable to initialise LWM2M events (%d).\n", errorCode);
+    }
+
+    return errorCode;
+}
+
+// Init step: SARA-R412M component.
+static int32_t initSaraR412m(void *pParam)
+{
+    int32_t errorCode;
+
+    (void) pParam;
     errorCode = saraR412mInit(CONFIG_PIN_CELLULAR_ENABLE_POWER,
                               CONFIG_PIN_CELLULAR_CP_ON,
                               CONFIG_PIN_CELLULAR_VINT);
     if (errorCode != 0) {
-        printf("MAIN: error: unable to initialise SARA-R412M component (%d).\n", errorCode);
-        return false;
+        DIAG_ERROR("MAIN: error: unable to initialise SARA-R412M component (%d).\n", errorCode);
     }
-    // Initialise location component
+
+    return errorCode;
+}
+
+// Init step: location component.
+static int32_t initLocation(void *pParam)
+{
+    int32_t errorCode;
+
+    (void) pParam;
     errorCode = locationInit();
     if (errorCode != 0) {
-        printf("MAIN: error: unable to initialise location component (%d).\n", errorCode);
-        return false;
+        DIAG_ERROR("MAIN: error: unable to initialise location component (%d).\n", errorCode);
     }
-    // Initialise LWM2M component
+
+    return errorCode;
+}
+
+// Init step: LWM2M component.
+static int32_t initLwm2m(void *pParam)
+{
+    int32_t errorCode;
+
+    (void) pParam;
     errorCode = lwm2mInit();
     if (errorCode != 0) {
-        printf("MAIN: error: unable to initialise LWM2M component (%d).\n", errorCode);
-        return false;
+        DIAG_ERROR("MAIN: error: unable to initialise LWM2M component (%d).\n", errorCode);
     }
 
-    // Set external wake-up interrupt pin to be RTC pin
-    if (rtc_gpio_init(CONFIG_PIN_INT_ACCELEROMETER) != ESP_OK) {
-        printf("MAIN: error: unable to initalise accelerometer GPIO (ESP32 GPIO %d) pin.\n", CONFIG_PIN_INT_ACCELEROMETER);
-        errorCode = -1;
-        return false;
+    return errorCode;
+}
+
+// Init step: if the accelerometer woke us, capture a window of
+// its samples and store their features.  This takes a second or so
+// and hence is overlapped with powering up the modem; it is
+// optional, losing the features is not a reason to stop.
+static int32_t initMotion(void *pParam)
+{
+    MotionFeatures features;
+    uint8_t packed[MOTION_FEATURES_PACKED_SIZE];
+    int32_t values[MOTION_FEATURES_NUM_VALUES];
+    struct timeval now;
+    int32_t numSamples;
+    int32_t errorCode;
+
+    (void) pParam;
+    if (!gCaptureMotion) {
+        return 0;
     }
-    // Set external wake-up interrupt pin direction as input
-    // Note: BE CAREFUL to use RTC_GPIO_MODE_* here, not GPIO_MODE_*, they are different!
-    if (rtc_gpio_set_direction(CONFIG_PIN_INT_ACCELEROMETER, RTC_GPIO_MODE_INPUT_ONLY) != ESP_OK) {
-        printf("MAIN: error: unable to set accelerometer GPIO (ESP32 GPIO %d) pin as input.\n", CONFIG_PIN_INT_ACCELEROMETER);
-        errorCode = -1;
-        return false;
+
+    gettimeofday(&now, NULL);
+    errorCode = lis2dwFifoStart(CONFIG_I2C_PORT, CONFIG_LIS2DW_DEFAULT_ADDRESS);
+    if (errorCode == 0) {
+        numSamples = lis2dwFifoRead(gMotionSamples, MOTION_FEATURES_WINDOW_SIZE,
+                                    MOTION_CAPTURE_TIMEOUT_MS);
+        lis2dwFifoStop();
+        if (numSamples == MOTION_FEATURES_WINDOW_SIZE) {
+            motionFeaturesCompute(gMotionSamples, &features);
+            motionFeaturesPack(&features, packed);
+            values[0] = features.rmsMg;
+            values[1] = features.peakMg;
+            values[2] = features.zeroCrossings;
+            values[3] = features.dominantAxis;
+            sampleStoreAddData(SAMPLE_STORE_INSTANCE_ID_MOTION, packed,
+                               sizeof(packed), (uint32_t) now.tv_sec);
+            addReadingValues(SAMPLE_STORE_INSTANCE_ID_MOTION, values,
+                             MOTION_FEATURES_NUM_VALUES);
+            DIAG_INFO("MAIN: motion RMS %d mg, peak %d mg, %d zero crossing(s) on axis %d,"
+                      " %d FIFO overrun(s).\n", features.rmsMg, features.peakMg,
+                      features.zeroCrossings, features.dominantAxis, lis2dwFifoOverruns());
+        } else {
+            DIAG_ERROR("MAIN: error: only %d of %d accelerometer sample(s) captured.\n",
+                       numSamples, MOTION_FEATURES_WINDOW_SIZE);
+            errorCode = -1;
+        }
     }
-    // Set no pullp on external wake-up pin
-    if ((gpio_pulldown_dis(CONFIG_PIN_INT_ACCELEROMETER) != ESP_OK) ||
-        (gpio_pullup_dis(CONFIG_PIN_INT_ACCELEROMETER) != ESP_OK)) {
-        printf("MAIN: error: unable to set accelerometer GPIO (ESP32 GPIO %d) pin as no-pull.\n", CONFIG_PIN_INT_ACCELEROMETER);
-        errorCode = -1;
-        return false;
+
+    return errorCode;
+}
+
+// Init step: power up SARA-R4, which takes seconds and so is
+// overlapped with everything that doesn't need it, then move the
+// UART to the fastest rate that works.  This step is optional:
+// app_main() checks how it went.
+static int32_t initModemPowerOn(void *pParam)
+{
+    int32_t errorCode;
+
+    (void) pParam;
+    DIAG_INFO("MAIN: powering up SARA-R4...\n");
+    errorCode = cellularPowerOn(NULL);
+    // If SARA-R4 was left registered its power pin has been held
+    // through deep sleep, whatever saraR412mInit() set it to; now
+    // that cellularPowerOn() has set it to power SARA-R4 again the
+    // hold can go
+    gpio_hold_dis(CONFIG_PIN_CELLULAR_ENABLE_POWER);
+    if ((errorCode != 0) && (modemUartBaudRate() != CONFIG_CELLULAR_UART_BAUD_RATE)) {
+        // SARA-R4 must have lost power since it was left at the
+        // faster rate
+        DIAG_WARN("MAIN: warn: no answer at %d bit/s, trying the default rate.\n",
+                  modemUartBaudRate());
+        modemUartFallBack(CONFIG_CELLULAR_UART_PORT);
+        errorCode = cellularPowerOn(NULL);
+    }
+    if ((errorCode == 0) &&
+        (modemUartNegotiate(CONFIG_CELLULAR_UART_PORT) == MODEM_UART_ERROR_LOST)) {
+        // SARA-R4 is at a rate that doesn't work: power-cycling
+        // puts it back to the default, the next try stays below it
+        cellularPowerOff();
+        errorCode = cellularPowerOn(NULL);
     }
 
-    // Set pin that monitors M_STAT from SARA-R4 as input
-    if (gpio_set_direction(CONFIG_PIN_CELLULAR_M_STAT, GPIO_MODE_INPUT) != ESP_OK) {
-        printf("MAIN: error: unable to set cellular M_STAT GPIO (ESP32 GPIO %d) pin as input.\n", CONFIG_PIN_CELLULAR_M_STAT);
-        errorCode = -1;
-        return false;
+    return errorCode;
+}
+
+// The initialisation steps: modem bring-up on one core, everything
+// else on the other.
+static InitGraphStep gInitSteps[NUM_INIT_STEPS] = {
+    [INIT_STEP_I2C] =             {"I2C", initI2c, NULL, 0, 0, false},
+    [INIT_STEP_BQ24295] =         {"BQ24295", initBq24295, NULL,
+                                   INIT_GRAPH_DEPENDS_ON(INIT_STEP_I2C), 0, true},
+    [INIT_STEP_LIS2DW] =          {"LIS2DW", initLis2dw, NULL,
+                                   INIT_GRAPH_DEPENDS_ON(INIT_STEP_I2C), 0, false},
+    [INIT_STEP_PINS] =            {"pins", initPins, NULL,
+                                   INIT_GRAPH_DEPENDS_ON(INIT_STEP_LIS2DW), 0, false},
+    [INIT_STEP_NVS] =             {"NVS", initNvs, NULL, 0, 0, false},
+    [INIT_STEP_NETWORK] =         {"network", initNetwork, NULL,
+                                   INIT_GRAPH_DEPENDS_ON(INIT_STEP_NVS), 0, false},
+    [INIT_STEP_WIFI] =            {"Wifi", initWifi, NULL,
+                                   INIT_GRAPH_DEPENDS_ON(INIT_STEP_NETWORK), 0, false},
+    [INIT_STEP_MOTION] =          {"motion", initMotion, NULL,
+                                   INIT_GRAPH_DEPENDS_ON(INIT_STEP_LIS2DW), 0, true},
+    [INIT_STEP_UART] =            {"UART", initUart, NULL, 0, 1, false},
+    [INIT_STEP_AT_CLIENT] =       {"AT client", initAtClient, NULL,
+                                   INIT_GRAPH_DEPENDS_ON(INIT_STEP_UART), 1, false},
+    [INIT_STEP_SARA_R412M] =      {"SARA-R412M", initSaraR412m, NULL,
+                                   INIT_GRAPH_DEPENDS_ON(INIT_STEP_AT_CLIENT), 1, false},
+    [INIT_STEP_LOCATION] =        {"location", initLocation, NULL,
+                                   INIT_GRAPH_DEPENDS_ON(INIT_STEP_SARA_R412M), 1, false},
+    [INIT_STEP_LWM2M] =           {"LWM2M", initLwm2m, NULL,
+                                   INIT_GRAPH_DEPENDS_ON(INIT_STEP_LOCATION), 1, false},
+    [INIT_STEP_MODEM_POWER_ON] =  {"modem power on", initModemPowerOn, NULL,
+                                   INIT_GRAPH_DEPENDS_ON(INIT_STEP_LWM2M), 1, true}
+};
+
+// The initialisation steps for a wake where only a sample is taken:
+// just enough to run I2C commands and be woken by the accelerometer.
+static InitGraphStep gSampleInitSteps[NUM_SAMPLE_INIT_STEPS] = {
+    [SAMPLE_INIT_STEP_I2C] =      {"I2C", initI2c, NULL, 0, 0, false},
+    [SAMPLE_INIT_STEP_LIS2DW] =   {"LIS2DW", initLis2dw, NULL,
+                                   INIT_GRAPH_DEPENDS_ON(SAMPLE_INIT_STEP_I2C), 0, false},
+    [SAMPLE_INIT_STEP_PINS] =     {"pins", initPins, NULL,
+                                   INIT_GRAPH_DEPENDS_ON(SAMPLE_INIT_STEP_LIS2DW), 0, false}
+};
+
+// Bring everything up, returning true if everything but the modem
+// is up; gInitSteps[INIT_STEP_MODEM_POWER_ON].errorCode says if the
+// modem is powered.
+static bool init()
+{
+    bool success;
+    esp_chip_info_t chipInfo;
+
+    success = (initGraphRun(gInitSteps, NUM_INIT_STEPS) == 0);
+    initGraphPrint(gInitSteps, NUM_INIT_STEPS);
+    if (gInitSteps[INIT_STEP_MODEM_POWER_ON].startUs >= 0) {
+        traceAdd(TRACE_ID_MODEM_POWER_ON, gInitSteps[INIT_STEP_MODEM_POWER_ON].startUs,
+                 gInitSteps[INIT_STEP_MODEM_POWER_ON].stopUs);
     }
-    // Set pin that monitors M_STAT from SARA-R4 as no-pull
-    if (gpio_set_pull_mode(CONFIG_PIN_CELLULAR_M_STAT, GPIO_FLOATING) != ESP_OK) {
-        printf("MAIN: error: unable to set cellular M_STAT GPIO (ESP32 GPIO %d) pin as no-pull.\n", CONFIG_PIN_CELLULAR_M_STAT);
-        errorCode = -1;
+    if (!success && (gInitSteps[INIT_STEP_MODEM_POWER_ON].errorCode == 0)) {
+        // Don't leave the modem on if we're not going to use it
+        cellularPowerOff();
+        modemPsmSetRegistered(false);
+        gInitSteps[INIT_STEP_MODEM_POWER_ON].errorCode = INIT_GRAPH_STEP_NOT_RUN;
+    }
+    if (!success) {
         return false;
     }
 
     // Print chip information
     esp_chip_info(&chipInfo);
-    printf("MAIN: this is an ESP32 chip with %d CPU core(s), Wifi%s%s, ",
-           chipInfo.cores,
-           (chipInfo.features & CHIP_FEATURE_BT) ? "/BT" : "",
-           (chipInfo.features & CHIP_FEATURE_BLE) ? "/BLE" : "");
+    DIAG_DEBUG("MAIN: this is an ESP32 chip with %d CPU core(s), Wifi%s%s, ",
+               chipInfo.cores,
+               (chipInfo.features & CHIP_FEATURE_BT) ? "/BT" : "",
+               (chipInfo.features & CHIP_FEATURE_BLE) ? "/BLE" : "");
 
-    printf("silicon revision %d, ", chipInfo.revision);
+    DIAG_DEBUG("silicon revision %d, ", chipInfo.revision);
 
-    printf("%d Mbyte(s) %s flash.\n", spi_flash_get_chip_size() / (1024 * 1024),
-           (chipInfo.features & CHIP_FEATURE_EMB_FLASH) ? "embedded" : "external");
+    DIAG_DEBUG("%d Mbyte(s) %s flash.\n", spi_flash_get_chip_size() / (1024 * 1024),
+               (chipInfo.features & CHIP_FEATURE_EMB_FLASH) ? "embedded" : "external");
 
     return true;
 }
@@ -1132,6 +1544,7 @@ static void deInit()
     lwm2mDeinit();
     locationDeinit();
     saraR412mDeinit();
+    lwm2mEventsDeinit();
     at_client_deinit();
     uartDeinit(CONFIG_CELLULAR_UART_PORT);
     lis2dwDeinit();
@@ -1140,21 +1553,277 @@ static void deInit()
     esp_wifi_deinit();
 }
 
-// Configure SARA-R4
+// Bring up what's needed to take a sample, returning true on success
+static bool initSample()
+{
+    bool success;
+
+    success = (initGraphRun(gSampleInitSteps, NUM_SAMPLE_INIT_STEPS) == 0);
+    initGraphPrint(gSampleInitSteps, NUM_SAMPLE_INIT_STEPS);
+
+    return success;
+}
+
+// Shut down what initSample() brought up
+static void deInitSample()
+{
+    lis2dwDeinit();
+    i2cDeinit(CONFIG_I2C_PORT);
+}
+
+// Decide whether this wake must be one on which to power the modem
+// and talk to the LWM2M server, whatever the sleep scheduler says
+static bool isReportWake(bool warmWake, bool externalWake)
+{
+    return !RTC_STATE_KEEP_POWERED || !warmWake ||
+           // Woken by the accelerometer: something has happened
+           externalWake ||
+           // Nothing to run until the server has been asked
+           (sampleStoreGetCommands(NULL) == 0) ||
+           sampleStoreIsFull();
+}
+
+// Check the sleep scheduler at wake-up, starting it with the
+// default WHRE Operating Parameters if it was not kept; the server's
+// settings are read again at the next report
+static void initSleepScheduler(bool warmWake, uint32_t timeSeconds)
+{
+    OperatingParameters parameters;
+
+    if (!sleepSchedulerInit(&gSleepScheduler, FIRMWARE_VERSION_ID, warmWake)) {
+        getDefaultOperatingParameters(&parameters);
+        setSleepSchedule(&parameters, timeSeconds);
+    }
+}
+
+// Add what a set of I2C Generic Command instances read back to the
+// statistics and the report filter, one channel per byte as for
+// the samples
+static void addReadings(const I2cCommandSnapshot *pSnapshots,
+                        int32_t numSnapshots)
+{
+    int32_t values[I2C_SEQUENCE_MAX_LENGTH];
+    int32_t length;
+
+    for (int32_t x = 0; x < numSnapshots; x++) {
+        length = pSnapshots[x].readResponse.length;
+        if (length > I2C_SEQUENCE_MAX_LENGTH) {
+            length = I2C_SEQUENCE_MAX_LENGTH;
+        }
+        for (int32_t y = 0; y < length; y++) {
+            values[y] = pSnapshots[x].readResponse.sequence[y];
+        }
+        addReadingValues(pSnapshots[x].objectInstanceId, values, length);
+    }
+}
+
+// Run the I2C commands the server last asked for, with the modem
+// off, and store what they read back; returns the number of
+// samples stored
+static int32_t takeSample()
+{
+    int32_t numSnapshots;
+    int32_t numSamples = 0;
+    struct timeval now;
+
+    numSnapshots = sampleStoreGetCommands(gSnapshots);
+    if (numSnapshots > 0) {
+        i2cInterpreterRun(CONFIG_I2C_PORT, gSnapshots, numSnapshots);
+        gettimeofday(&now, NULL);
+        numSamples = sampleStoreAdd(gSnapshots, numSnapshots, (uint32_t) now.tv_sec);
+        addReadings(gSnapshots, numSnapshots);
+    }
+    DIAG_INFO("MAIN: %d sample(s) taken, %d stored, %u dropped.\n", numSamples,
+              sampleStoreCount(), sampleStoreDropped());
+
+    return numSamples;
+}
+
+// Get the channel values of a stored sample, returning the number
+// of channels: for motion features one channel per feature, else
+// one channel per byte read back
+static int32_t sampleValues(const SampleStoreSample *pSample, TsCodecValue *pValues)
+{
+    MotionFeatures features;
+
+    if (pSample->objectInstanceId == SAMPLE_STORE_INSTANCE_ID_MOTION) {
+        motionFeaturesUnpack(pSample->data, &features);
+        pValues[0].integer = features.rmsMg;
+        pValues[1].integer = features.peakMg;
+        pValues[2].integer = features.zeroCrossings;
+        pValues[3].integer = features.dominantAxis;
+        return MOTION_FEATURES_NUM_VALUES;
+    }
+
+    for (int32_t x = 0; x < pSample->length; x++) {
+        pValues[x].integer = pSample->data[x];
+    }
+
+    return pSample->length;
+}
+
+// Write one batch of samples, if there is anything in it, to
+// the Sample Batch resource of the I2C Generic Command instance
+// they came from or, for motion features, to the WHRE Motion
+// Features object along with the latest of them
+static int32_t sendSampleBatch(int32_t objectInstanceId, const TsCodec *pCodec,
+                               const uint8_t *pBatch, const TsCodecValue *pLatest)
+{
+    MotionFeatures features;
+    int32_t errorCode = 0;
+
+    if (tsCodecEncodedLength(pCodec) > 0) {
+        if (objectInstanceId == SAMPLE_STORE_INSTANCE_ID_MOTION) {
+            features.rmsMg = pLatest[0].integer;
+            features.peakMg = pLatest[1].integer;
+            features.zeroCrossings = pLatest[2].integer;
+            features.dominantAxis = pLatest[3].integer;
+            errorCode = setMotionFeatures(&features, pBatch,
+                                          tsCodecEncodedLength(pCodec));
+        } else {
+            errorCode = i2cCommandSetSampleBatch(objectInstanceId, pBatch,
+                                                 tsCodecEncodedLength(pCodec));
+        }
+    }
+
+    return errorCode;
+}
+
+// Write the stored samples, encoded with ts_codec.c, at most one
+// batch to each object instance since the Sample Batch resource
+// holds only one; the samples sent are removed and the rest, those
+// that didn't fit and any with a different number of channels to
+// the first, wait for the next report.  Returns true if anything
+// was sent
+static bool sendSamples(const I2cCommandSnapshot *pSnapshots, int32_t numSnapshots)
+{
+    SampleStoreSample sample;
+    int32_t objectInstanceIds[I2C_INTERPRETER_MAX_INSTANCES + 1];
+    int32_t numObjectInstanceIds = 0;
+    int32_t numSamples = sampleStoreCount();
+    int32_t numChannels;
+    int32_t numInBatch;
+    int32_t numSent = 0;
+    int32_t numGone = 0;
+    int32_t numBatches = 0;
+    int32_t errorCode = 0;
+    bool full;
+    bool found;
+
+    memset(gSampleRemove, 0, sizeof(gSampleRemove));
+    // Samples go to the I2C Generic Command instances they came
+    // from, then motion features to their own object
+    for (int32_t x = 0; x < numSnapshots; x++) {
+        objectInstanceIds[numObjectInstanceIds] = pSnapshots[x].objectInstanceId;
+        numObjectInstanceIds++;
+    }
+    objectInstanceIds[numObjectInstanceIds] = SAMPLE_STORE_INSTANCE_ID_MOTION;
+    numObjectInstanceIds++;
+
+    for (int32_t x = 0; (x < numObjectInstanceIds) && (errorCode == 0); x++) {
+        // The batch takes the number of channels of the oldest sample
+        numChannels = 0;
+        numInBatch = 0;
+        full = false;
+        for (int32_t y = 0; (y < numSamples) && !full && (errorCode == 0); y++) {
+            if ((sampleStoreGet(y, &sample) != 0) ||
+                (sample.objectInstanceId != objectInstanceIds[x])) {
+                continue;
+            }
+            if (numChannels == 0) {
+                numChannels = sampleValues(&sample, gSampleValues);
+                errorCode = tsCodecEncodeStart(&gSampleCodec, gSampleBatch,
+                                               sizeof(gSampleBatch),
+                                               numChannels, 0);
+            }
+            if ((errorCode == 0) && (sampleValues(&sample, gSampleValues) == numChannels)) {
+                errorCode = tsCodecEncode(&gSampleCodec, sample.timeSeconds, gSampleValues);
+                if (errorCode == TS_CODEC_ERROR_FULL) {
+                    // The rest wait for the next report
+                    errorCode = 0;
+                    full = true;
+                } else if (errorCode == 0) {
+                    memcpy(gSampleLatest, gSampleValues, sizeof(gSampleLatest));
+                    gSampleRemove[y] = true;
+                    numInBatch++;
+                }
+            }
+        }
+        if ((errorCode == 0) && (numInBatch > 0)) {
+            errorCode = sendSampleBatch(objectInstanceIds[x], &gSampleCodec,
+                                        gSampleBatch, gSampleLatest);
+            if (errorCode == 0) {
+                numSent += numInBatch;
+                numBatches++;
+            }
+        }
+        if (errorCode != 0) {
+            // Keep this batch to send again
+            for (int32_t y = 0; y < numSamples; y++) {
+                if ((sampleStoreGet(y, &sample) == 0) &&
+                    (sample.objectInstanceId == objectInstanceIds[x])) {
+                    gSampleRemove[y] = false;
+                }
+            }
+        }
+    }
+
+    // Samples from instances which have since gone go too
+    for (int32_t y = 0; y < numSamples; y++) {
+        if (sampleStoreGet(y, &sample) == 0) {
+            found = false;
+            for (int32_t x = 0; (x < numObjectInstanceIds) && !found; x++) {
+                found = (sample.objectInstanceId == objectInstanceIds[x]);
+            }
+            if (!found) {
+                gSampleRemove[y] = true;
+                numGone++;
+            }
+        }
+    }
+    sampleStoreRemove(gSampleRemove, numSamples);
+
+    if (errorCode == 0) {
+        DIAG_INFO("MAIN: %d stored sample(s) sent in %d batch(es), %d kept for"
+                  " the next report.\n", numSent, numBatches, sampleStoreCount());
+    } else {
+        DIAG_ERROR("MAIN: error: unable to send stored samples (%d), %d sent,"
+                   " %d kept.\n", errorCode, numSent, sampleStoreCount());
+    }
+    if (numGone > 0) {
+        DIAG_WARN("MAIN: warn: %d sample(s) of deleted object instances"
+                  " discarded.\n", numGone);
+    }
+
+    return numBatches > 0;
+}
+
+// Configure SARA-R4, skipping the checks of MNO profile and
+// RAT if they've been verified since the last cold start
 static bool cfgSaraR4()
 {
     int32_t errorCode = 0;
 
-    if (saraR412mGetMnoProfile() != 100) {
-        errorCode = saraR412mSetMnoProfile(100);
+    if (!rtcStateIsVerified(RTC_STATE_VERIFIED_MNO_PROFILE)) {
+        if (saraR412mGetMnoProfile() != 100) {
+            errorCode = saraR412mSetMnoProfile(100);
+            if (errorCode == 0) {
+                errorCode = cellularReboot();
+            }
+        }
         if (errorCode == 0) {
-            errorCode = cellularReboot();
+            rtcStateSetVerified(RTC_STATE_VERIFIED_MNO_PROFILE);
         }
     }
-    if ((errorCode == 0) && (cellularGetRat(0) != CELLULAR_RAT_GPRS)) {
-        errorCode = cellularSetRatRank(CELLULAR_RAT_GPRS, 0);
+    if ((errorCode == 0) && !rtcStateIsVerified(RTC_STATE_VERIFIED_RAT)) {
+        if (cellularGetRat(0) != CELLULAR_RAT_GPRS) {
+            errorCode = cellularSetRatRank(CELLULAR_RAT_GPRS, 0);
+            if (errorCode == 0) {
+                errorCode = cellularReboot();
+            }
+        }
         if (errorCode == 0) {
-            errorCode = cellularReboot();
+            rtcStateSetVerified(RTC_STATE_VERIFIED_RAT);
         }
     }
 
@@ -1173,30 +1842,103 @@ static bool lwm2mReady()
     return (lwm2mObjectGet(LWM2M_OBJECT_ID_SERVER, 1, NULL) == 0);
 } 
 
-// Configure LWM2M
+// Wait for LWM2M to be ready, checking every
+// LWM2M_READY_RETRY_MS for up to waitMs
+static bool lwm2mWaitReady(int32_t waitMs)
+{
+    int64_t stopTimeMs = esp_timer_get_time() / 1000 + waitMs;
+    bool ready = lwm2mReady();
+
+    while (!ready && (esp_timer_get_time() / 1000 < stopTimeMs)) {
+        DIAG_DEBUG("MAIN: waiting for LWM2M on SARA-R4 to be ready...\n");
+        ledFlash(LED_STATE_BAD, LWM2M_READY_RETRY_MS / 2);
+        vTaskDelay(LWM2M_READY_RETRY_MS / portTICK_PERIOD_MS);
+        esp_task_wdt_reset();
+        ready = lwm2mReady();
+    }
+
+    return ready;
+}
+
+// The LWM2M Security object, which has to exist, along with the
+// LWM2M Server object, before the objects that follow can be
+// created.
+static const Lwm2mObjectCfg gLwm2mSecurityCfg =
+    {RTC_STATE_VERIFIED_LWM2M_SECURITY, LWM2M_OBJECT_ID_SECURITY,
+     LWM2M_OBJECT_INSTANCE_ID_SECURITY, createObjectWhreLwm2mSecurity};
+
+// The LWM2M objects of the application.
+static const Lwm2mObjectCfg gLwm2mObjectCfgs[] = {
+    {RTC_STATE_VERIFIED_LWM2M_I2C, LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND,
+     LWM2M_OBJECT_INSTANCE_ID_I2C_GENERIC_COMMAND, createObjectGenericI2c},
+    {RTC_STATE_VERIFIED_LWM2M_MOTION, LWM2M_OBJECT_OMA_ID_WHRE_MOTION_FEATURES,
+     LWM2M_OBJECT_INSTANCE_ID_MOTION_FEATURES, createObjectMotionFeatures},
+    {RTC_STATE_VERIFIED_LWM2M_STATISTICS, LWM2M_OBJECT_OMA_ID_WHRE_CHANNEL_STATISTICS,
+     LWM2M_OBJECT_INSTANCE_ID_CHANNEL_STATISTICS, createObjectChannelStatistics},
+    {RTC_STATE_VERIFIED_LWM2M_FILTER, LWM2M_OBJECT_OMA_ID_WHRE_REPORT_FILTER,
+     LWM2M_OBJECT_INSTANCE_ID_REPORT_FILTER, createObjectReportFilter},
+    {RTC_STATE_VERIFIED_LWM2M_OPERATING, LWM2M_OBJECT_OMA_ID_WHRE_OPERATING_PARAMETERS,
+     LWM2M_OBJECT_INSTANCE_ID_OPERATING_PARAMETERS, createObjectOperatingParameters},
+    {RTC_STATE_VERIFIED_LWM2M_MODEM, LWM2M_OBJECT_OMA_ID_MODEM_CONFIGURATION,
+     LWM2M_OBJECT_INSTANCE_ID_MODEM_CONFIGURATION, createObjectModemConfiguration},
+    {RTC_STATE_VERIFIED_LWM2M_EVENT_LOG, LWM2M_OBJECT_OMA_ID_WHRE_EVENT_LOG,
+     LWM2M_OBJECT_INSTANCE_ID_EVENT_LOG, createObjectEventLog},
+    {RTC_STATE_VERIFIED_LWM2M_LOCATION, LWM2M_OBJECT_ID_LOCATION,
+     LWM2M_OBJECT_INSTANCE_ID_LOCATION, createObjectLocation}
+};
+
+// Make sure that an LWM2M object exists, creating it with its
+// default values if it doesn't, unless it has been verified to
+// exist since the last cold start; returns true if the object had
+// to be created, in which case SARA-R4 must be rebooted.
+static bool cfgLwm2mObject(const Lwm2mObjectCfg *pCfg, uint32_t *pVerified)
+{
+    bool created = false;
+
+    if (rtcStateIsVerified(pCfg->verified) ||
+        (lwm2mObjectGet(pCfg->objectId, pCfg->objectInstanceId, NULL) == 0)) {
+        *pVerified |= pCfg->verified;
+    } else {
+        if (pCfg->pCreate(pCfg->objectInstanceId, WHRE_LWM2M_SERVER_SHORT_ID) == 0) {
+            *pVerified |= pCfg->verified;
+        }
+        created = true;
+    }
+
+    return created;
+}
+
+// Configure LWM2M, skipping the checks for objects which have
+// been verified to exist since the last cold start
 static bool cfgLwm2m()
 {
     int32_t errorCode = 0;
     bool rebootRequired = false;
+    uint32_t verified = 0;
 
     // Configure LWM2M to use context ID 1
 	// TOOD: ignoring return value for now
 	//saraR412mLwm2mConfigure(WHRE_LWM2M_SERVER_SHORT_ID, 1, false);
 
-    // Check that the required objects exist
-    if (lwm2mObjectGet(LWM2M_OBJECT_ID_SECURITY,
-                       LWM2M_OBJECT_INSTANCE_ID_SECURITY,
-                       NULL) != 0) {
-        createObjectWhreLwm2mSecurity(LWM2M_OBJECT_INSTANCE_ID_SECURITY,
-                                      WHRE_LWM2M_SERVER_SHORT_ID);
-        rebootRequired = true;
+    if (rtcStateIsVerified(RTC_STATE_VERIFIED_LWM2M_ALL)) {
+        return true;
     }
-    if (lwm2mObjectGet(LWM2M_OBJECT_ID_SERVER,
-                       LWM2M_OBJECT_INSTANCE_ID_SERVER,
-                       NULL) != 0) {
-        createObjectWhreLwm2mServer(LWM2M_OBJECT_INSTANCE_ID_SERVER,
-                                    LWM2M_REGISTRATION_LIFETIME_SECONDS,
-                                    WHRE_LWM2M_SERVER_SHORT_ID);
+
+    // Check that the required objects exist
+    rebootRequired = cfgLwm2mObject(&gLwm2mSecurityCfg, &verified);
+    if (rtcStateIsVerified(RTC_STATE_VERIFIED_LWM2M_SERVER) ||
+        ((lwm2mObjectGet(LWM2M_OBJECT_ID_SERVER,
+                         LWM2M_OBJECT_INSTANCE_ID_SERVER,
+                         NULL) == 0) &&
+         (setLwm2mServerLifetime(LWM2M_OBJECT_INSTANCE_ID_SERVER,
+                                 LWM2M_REGISTRATION_LIFETIME_SECONDS) == 0))) {
+        verified |= RTC_STATE_VERIFIED_LWM2M_SERVER;
+    } else {
+        if (createObjectWhreLwm2mServer(LWM2M_OBJECT_INSTANCE_ID_SERVER,
+                                        LWM2M_REGISTRATION_LIFETIME_SECONDS,
+                                        WHRE_LWM2M_SERVER_SHORT_ID) == 0) {
+            verified |= RTC_STATE_VERIFIED_LWM2M_SERVER;
+        }
         rebootRequired = true;
     }
     
@@ -1209,80 +1951,160 @@ static bool cfgLwm2m()
         lwm2mReady();
     }
 
-    if (lwm2mObjectGet(LWM2M_OBJECT_OMA_ID_I2C_GENERIC_COMMAND,
-                       LWM2M_OBJECT_INSTANCE_ID_I2C_GENERIC_COMMAND,
-                       NULL) != 0) {
-        createObjectGenericI2c(LWM2M_OBJECT_INSTANCE_ID_I2C_GENERIC_COMMAND,
-                               WHRE_LWM2M_SERVER_SHORT_ID);
-        rebootRequired = true;
-    }
-    if (lwm2mObjectGet(LWM2M_OBJECT_ID_LOCATION,
-                       LWM2M_OBJECT_INSTANCE_ID_LOCATION,
-                       NULL) != 0) {
-        createObjectLocation(LWM2M_OBJECT_INSTANCE_ID_LOCATION,
-                             WHRE_LWM2M_SERVER_SHORT_ID);
-        rebootRequired = true;
+    for (size_t x = 0; x < sizeof(gLwm2mObjectCfgs) / sizeof(gLwm2mObjectCfgs[0]); x++) {
+        if (cfgLwm2mObject(&(gLwm2mObjectCfgs[x]), &verified)) {
+            rebootRequired = true;
+        }
     }
     
     if (rebootRequired) {
         errorCode = cellularReboot();
     }
+    if (errorCode == 0) {
+        rtcStateSetVerified(verified);
+    }
 
     return (errorCode == 0);
 }
 
-// Perform the I2C demo operation
-static bool doI2cDemo()
-{
-    bool success = false;
-    char i2cAddress;
-    int32_t triggerCondition;
-    I2cSequence writeSequence;
-    I2cSequence readSequence;
-    int32_t bytesReadOrError = -1;
-    int32_t writeError = 0;
-    int32_t delayUS;
-    bool writeSuccess = false;
-	int32_t hamedsNewByte;
-	uint8_t firstArray[]     = {0, 0}; //ori = {9, 255}
-	uint8_t hamedsNewArray[] = {9, 0}; //ori = {0, 0}
-	
-	//Power-up and measurement within 1 ms 
-	vTaskDelay((1 / 1000) / portTICK_PERIOD_MS);
-
-    if (i2cGenericCommandGetDeviceI2cAddress(LWM2M_OBJECT_INSTANCE_ID_I2C_GENERIC_COMMAND, //0x20
-                                             &i2cAddress) == 0) {
-        if (i2cGenericCommandGetTriggerCondition(LWM2M_OBJECT_INSTANCE_ID_I2C_GENERIC_COMMAND,
-                                                 &triggerCondition) == 0) {
-            if (web_sensor_demo(&hamedsNewByte) == 0) {
-				hamedsNewArray[1] = (uint8_t) hamedsNewByte;
-				
-				writeError = i2cSendReceive(CONFIG_I2C_PORT,
-											i2cAddress,
-											firstArray,
-											sizeof(firstArray) / sizeof(firstArray[0]),
-											NULL, 0);
-											
-				
-				
-				writeError = i2cSendReceive(CONFIG_I2C_PORT,
-											i2cAddress,
-											hamedsNewArray,
-											sizeof(hamedsNewArray) / sizeof(hamedsNewArray[0]),
-											NULL, 0);
-											
-				printf("-> MAIN: Hamed I2C write operation returned %d.\n", writeError);
-            } else {
-                printf("-> MAIN: error: unable to read Write Sequence from I2C Generic Command object.\n");
-            }
-        } else {
-            printf("-> MAIN: error: unable to read Trigge Condition from I2C Generic Command object.\n");
+// Carry out the I2C commands the server has written to the
+// I2C Generic Command object instances and write back the results;
+// returns true if there are new results for the server
+static bool doI2cCommands()
+{
+    int32_t numSnapshots = 0;
+    int32_t numTransactions;
+    int32_t traceHandle;
+    struct timeval now;
+    bool dataReady = false;
+
+    // Read each instance once, everything below works from the
+    // snapshots; instances which don't exist are skipped
+    for (int32_t x = 0; x < I2C_INTERPRETER_MAX_INSTANCES; x++) {
+        if (i2cCommandSnapshotGet(x, &(gSnapshots[numSnapshots])) == 0) {
+            numSnapshots++;
         }
+    }
+    if (numSnapshots == 0) {
+        DIAG_ERROR("MAIN: error: unable to read I2C Generic Command object.\n");
+        return false;
+    }
+
+    // Anything sampled since the last report goes first, so that
+    // the server gets the readings in the order they were taken
+    if (sampleStoreCount() > 0) {
+        traceHandle = traceStart(TRACE_ID_SEND_SAMPLES);
+        dataReady = sendSamples(gSnapshots, numSnapshots);
+        traceStop(traceHandle);
+    }
+
+    numTransactions = i2cInterpreterRun(CONFIG_I2C_PORT, gSnapshots, numSnapshots);
+    DIAG_INFO("MAIN: %d I2C Generic Command instance(s), %d I2C transaction(s).\n",
+              numSnapshots, numTransactions);
+    addReadings(gSnapshots, numSnapshots);
+
+    // Write back only what has changed, if anything
+    for (int32_t x = 0; x < numSnapshots; x++) {
+        if ((gSnapshots[x].dirty != 0) &&
+            (i2cCommandSnapshotFlush(&(gSnapshots[x])) == 0)) {
+            dataReady = true;
+        }
+    }
+    // One summary of the period since the last report; if it
+    // can't be sent the period carries on to the next report
+    if ((channelStatsCount() > 0) && (setChannelStatistics() == 0)) {
+        DIAG_INFO("MAIN: statistics of %d channel(s) since %u second(s) sent.\n",
+                  channelStatsCount(), channelStatsPeriodStart());
+        gettimeofday(&now, NULL);
+        channelStatsReset((uint32_t) now.tv_sec);
+        dataReady = true;
+    }
+    // Remember what to do on the wakes before the next report
+    sampleStoreSetCommands(gSnapshots, numSnapshots);
+
+    return dataReady;
+}
+
+// Record that a report has been made, write the counts of reports
+// made and suppressed to the server and pick up any changes the
+// server has made to the settings of the report filter; returns
+// true if there is new data for the server
+static bool doReportFilter()
+{
+    ReportFilterConfig config;
+    struct timeval now;
+    uint32_t sent;
+    uint32_t suppressed;
+    bool dataReady;
+
+    gettimeofday(&now, NULL);
+    reportFilterReported((uint32_t) now.tv_sec);
+    reportFilterGetCounts(&sent, &suppressed);
+    DIAG_INFO("MAIN: report filter: %u report(s) made, %u suppressed.\n",
+              sent, suppressed);
+    dataReady = (setReportFilterCounts() == 0);
+    if (getReportFilterConfig(&config) == 0) {
+        reportFilterSetConfig(&config);
+    }
+
+    return dataReady;
+}
+
+// Read the WHRE Operating Parameters the server has written and
+// give them to the sleep scheduler, returning the Minimum Modem up
+// Time
+static int32_t doOperatingParameters()
+{
+    OperatingParameters parameters;
+    struct timeval now;
+
+    if (getOperatingParameters(&parameters) == 0) {
+        gettimeofday(&now, NULL);
+        setSleepSchedule(&parameters, (uint32_t) now.tv_sec);
+        DIAG_INFO("MAIN: operating parameters: wake up every %d second(s),"
+                  " report every %d second(s), sleep at least %d second(s),"
+                  " modem up at least %d second(s).\n",
+                  parameters.wakeUpIntervalSeconds, parameters.reportingIntervalSeconds,
+                  parameters.minSleepSeconds, parameters.minModemUpSeconds);
     } else {
-        printf("-> MAIN: error: unable to read I2C Device Address from I2C Generic Command object.\n");
+        getDefaultOperatingParameters(&parameters);
     }
 
-    return success;
+    return parameters.minModemUpSeconds;
+}
+
+// Read the power saving settings the server has written to the
+// Modem Configuration object and send them to SARA-R4
+static void doModemConfiguration()
+{
+    ModemPsmConfig config;
+
+    if (getModemConfiguration(&config) == 0) {
+        modemPsmApply(&config);
+    }
+}
+
+// Send as much of the flash event log as fits in one batch to the
+// WHRE Event Log object; this is only done while the modem is up
+// for a report anyway.  Returns true if anything was sent
+static bool sendEventLog()
+{
+    uint8_t batch[EVENT_LOG_BATCH_MAX_SIZE];
+    int32_t length;
+    bool sent = false;
+
+    // Include what has been logged on this wake
+    flashLogFlush();
+    length = flashLogGetBatch(batch, sizeof(batch));
+    if (((length > 0) || (flashLogLost() > 0)) &&
+        (setEventLog(batch, length > 0 ? length : 0, flashLogLost()) == 0)) {
+        DIAG_INFO("MAIN: %d byte(s) of event log sent, %d event(s) lost.\n",
+                  length, flashLogLost());
+        flashLogBatchSent();
+        sent = true;
+    }
+
+    return sent;
 }
 
 /**************************************************************************
@@ -1293,22 +2115,84 @@ void app_main()
 {
     esp_err_t espError = 0;
     int32_t errorCode = 0;
-    wifi_scan_config_t wifiScanConfig;
-    uint16_t numWifiApsFound;
-    wifi_ap_record_t *pEsp32WifiRecords;
-    LocationWifiAp *pWifiRecord;
     bool lwm2mSuccess = false;
     bool dataReady = false;
     int32_t wakeupCause = esp_sleep_get_wakeup_cause();
     struct timeval now;
+    bool initialised;
+    bool warmWake;
+    bool externalWake;
+    bool sampleWake;
+    bool reportWake;
+    bool filterWake;
+    bool locate;
+    bool stayRegistered = false;
+    bool reported = false;
+    bool resumed = false;
+    bool updated = true;
+    uint32_t due;
+    uint32_t suppressed;
+    int32_t minModemUpSeconds = MINIMUM_MODEM_UP_TIME_SECONDS;
+    int64_t modemUpMs;
+    int32_t sleepSeconds;
+    int32_t traceWake;
+    int32_t traceHandle;
+    Lwm2mArenaStats arenaStats;
+    uint32_t lwm2mEvents;
 
     gettimeofday(&now, NULL);
+    traceInit((uint32_t) now.tv_sec);
+    traceWake = traceStart(TRACE_ID_WAKE);
 
     logInit(gLoggingBuffer);
-    ledInit();
+    diagInit();
+    // If RTC memory has been kept powered, find out what
+    // we already know from the previous wake
+    warmWake = rtcStateInit(FIRMWARE_VERSION_ID,
+                            (wakeupCause == ESP_SLEEP_WAKEUP_TIMER) ||
+                            (wakeupCause == ESP_SLEEP_WAKEUP_EXT1));
+    sampleStoreInit(FIRMWARE_VERSION_ID, warmWake);
+    channelStatsInit(FIRMWARE_VERSION_ID, warmWake, (uint32_t) now.tv_sec);
+    reportFilterInit(FIRMWARE_VERSION_ID, warmWake, (uint32_t) now.tv_sec);
+    initSleepScheduler(warmWake, (uint32_t) now.tv_sec);
+    modemPsmInit(FIRMWARE_VERSION_ID, warmWake);
+    modemUartInit(FIRMWARE_VERSION_ID, warmWake, CONFIG_CELLULAR_UART_BAUD_RATE);
+    flashLogInit(FIRMWARE_VERSION_ID, warmWake);
+    externalWake = (wakeupCause == ESP_SLEEP_WAKEUP_EXT1);
+    if (externalWake && sleepSchedulerIsTooSoon(&gSleepScheduler, (uint32_t) now.tv_sec)) {
+        // Woken by the accelerometer sooner than the Host Minimum
+        // Sleep Interval allows: deal with it once that is up
+        sleepSchedulerSetDeadline(&gSleepScheduler, SLEEP_SCHEDULER_ACTIVITY_I2C_TRIGGER,
+                                  sleepSchedulerMinSleepEnd(&gSleepScheduler));
+        externalWake = false;
+    }
+    due = sleepSchedulerDue(&gSleepScheduler, (uint32_t) now.tv_sec);
+    reportWake = isReportWake(warmWake, externalWake) ||
+                 ((due & (SLEEP_SCHEDULER_BIT(SLEEP_SCHEDULER_ACTIVITY_LOCATION) |
+                          SLEEP_SCHEDULER_BIT(SLEEP_SCHEDULER_ACTIVITY_I2C_TRIGGER))) != 0);
+    // A report due by the clock waits for the sample if the report
+    // filter might suppress it
+    filterWake = !reportWake && reportFilterIsEnabled() &&
+                 ((due & SLEEP_SCHEDULER_BIT(SLEEP_SCHEDULER_ACTIVITY_REPORT)) != 0);
+    reportWake = reportWake ||
+                 (!filterWake && ((due & SLEEP_SCHEDULER_BIT(SLEEP_SCHEDULER_ACTIVITY_REPORT)) != 0));
+    sampleWake = reportWake || filterWake ||
+                 ((due & SLEEP_SCHEDULER_BIT(SLEEP_SCHEDULER_ACTIVITY_SAMPLE)) != 0);
+    if (sampleWake) {
+        sleepSchedulerWake(&gSleepScheduler, (uint32_t) now.tv_sec);
+    }
+    // Only look for Wifi APs and get a location fix when one is due
+    // or something has happened
+    locate = externalWake ||
+             ((due & (SLEEP_SCHEDULER_BIT(SLEEP_SCHEDULER_ACTIVITY_LOCATION) |
+                      SLEEP_SCHEDULER_BIT(SLEEP_SCHEDULER_ACTIVITY_I2C_TRIGGER))) != 0);
+    gCaptureMotion = externalWake;
+    ledInit(!rtcStateIsVerified(RTC_STATE_VERIFIED_LED_INIT));
+    rtcStateSetVerified(RTC_STATE_VERIFIED_LED_INIT);
 
     // Log some fundamentals
-    LOGX(EVENT_SYSTEM_VERSION, SYSTEM_VERSION_INT);
+    LOG_EVENT(EVENT_SYSTEM_VERSION, SYSTEM_VERSION_INT);
+    LOG_EVENT(EVENT_WAKE_CAUSE, wakeupCause);
     // Note: the following line will log the time that THIS file was
     // last built so, when doing a formal release, make sure
     // it is a clean build
@@ -1316,29 +2200,88 @@ void app_main()
 
     switch (wakeupCause) {
         case ESP_SLEEP_WAKEUP_TIMER:
-            printf("Wake up from RTC alarm at %d second(s).\n", (int) now.tv_sec);
+            DIAG_INFO("Wake up from RTC alarm at %d second(s).\n", (int) now.tv_sec);
         break;
         case ESP_SLEEP_WAKEUP_EXT1:
-            printf("Wake up from EXT1 interrupt at %d second(s).\n", (int) now.tv_sec);
+            DIAG_INFO("Wake up from EXT1 interrupt at %d second(s).\n", (int) now.tv_sec);
         default:
-            printf("Wake up at %d second(s), cause %d.\n", (int) now.tv_sec, wakeupCause);
+            DIAG_INFO("Wake up at %d second(s), cause %d.\n", (int) now.tv_sec, wakeupCause);
         break;
     }
 
     // Start everything up
-    printf("MAIN: starting up...\n");
-    if (init()) {
-        ledSetTemporary(LED_STATE_GOOD, 100);
-        printf("MAIN: powering up SARA-R4...\n");
-        errorCode = cellularPowerOn(NULL);
+    DIAG_INFO("MAIN: starting up (%s wake, %s, due 0x%02x)...\n", warmWake ? "warm" : "cold",
+              reportWake ? "reporting" : (sampleWake ? "sampling only" : "nothing to do"),
+              (unsigned int) due);
+    initialised = true;
+    if (sampleWake) {
+        traceHandle = traceStart(TRACE_ID_INIT);
+        initialised = reportWake ? init() : initSample();
+        traceStop(traceHandle);
+    }
+    if (initialised && sampleWake && !reportWake) {
+        // Leave the modem off, just store a sample for the next report
+        traceHandle = traceStart(TRACE_ID_SAMPLE);
+        takeSample();
+        traceStop(traceHandle);
+        if (filterWake) {
+            // The sample has been checked against the deadbands:
+            // only bring up the rest, modem included, if it is
+            // worth it
+            gettimeofday(&now, NULL);
+            if (reportFilterIsDue((uint32_t) now.tv_sec)) {
+                DIAG_INFO("MAIN: report filter: report due.\n");
+                deInitSample();
+                reportWake = true;
+                traceHandle = traceStart(TRACE_ID_INIT);
+                initialised = init();
+                traceStop(traceHandle);
+            } else {
+                reportFilterSuppressed();
+                reportFilterGetCounts(NULL, &suppressed);
+                LOG_EVENT(EVENT_REPORT_SUPPRESSED, (int32_t) suppressed);
+                DIAG_INFO("MAIN: report filter: nothing has changed, report suppressed.\n");
+            }
+        }
+    }
+    if (initialised && reportWake) {
+        ledFlash(LED_STATE_GOOD, 100);
+        // SARA-R4 was powered up as part of init()
+        errorCode = gInitSteps[INIT_STEP_MODEM_POWER_ON].errorCode;
         if (errorCode == 0) {
-            ledSetTemporary(LED_STATE_GOOD, 100);
-            printf("MAIN: configuring SARA-R4...\n");
-            if (cfgSaraR4()) {
-                printf("MAIN: registering with the cellular network...\n");
-                gStopTimeCellularMS = esp_timer_get_time() / 1000 + (240 * 1000);
-                errorCode = cellularRegister(keepGoingCallback, NULL, NULL, NULL);
+            ledFlash(LED_STATE_GOOD, 100);
+            DIAG_INFO("MAIN: configuring SARA-R4...\n");
+            traceHandle = traceStart(TRACE_ID_CFG_SARA_R4);
+            initialised = cfgSaraR4();
+            traceStop(traceHandle);
+            if (initialised) {
+                if (locate) {
+                    // Scan for Wifi APs while registering, for location
+                    wifiScanStart(WIFI_SCAN_LAST_CHANNELS_ONLY &&
+                                  ((rtcStateWarmWakeCount() % WIFI_SCAN_FULL_SCAN_INTERVAL) != 0));
+                }
+                traceHandle = traceStart(TRACE_ID_REGISTER);
+                if (modemPsmIsRegistered() && (cellularGetRegisteredRan() >= 0)) {
+                    // Woken out of PSM/eDRX with the registration intact
+                    DIAG_INFO("MAIN: still registered with the cellular network.\n");
+                    errorCode = 0;
+                    resumed = true;
+                } else {
+                    DIAG_INFO("MAIN: registering with the cellular network...\n");
+                    gStopTimeCellularMS = esp_timer_get_time() / 1000 + (240 * 1000);
+                    errorCode = cellularRegister(keepGoingCallback, NULL, NULL, NULL);
+                }
+                traceStop(traceHandle);
                 if (errorCode == 0) {
+                    traceAdd(TRACE_ID_BOOT_TO_REGISTERED, 0, esp_timer_get_time());
+                    LOG_EVENT(EVENT_REGISTERED_MS, (int32_t) (esp_timer_get_time() / 1000));
+                    DIAG_INFO("MAIN: registered %d ms after boot.\n",
+                              (int) (esp_timer_get_time() / 1000));
+                    if (locate) {
+                        traceHandle = traceStart(TRACE_ID_LOCATION_START);
+                        locationStart();
+                        traceStop(traceHandle);
+                    }
 					// While we're waiting for the location, configure LWM2M
 					// and tell the server we're up.  Note that if
 					// this is our first time to be awake then configuring
@@ -1346,117 +2289,213 @@ void app_main()
 					// will stop the location fix and the connection, but it's
 					// better than waiting around for LWM2M to be ready at
 					// startup each time to find out.
-					for (int x = 0; (x < LWM2M_WAKEUP_WAIT_SECONDS) && !lwm2mSuccess; x++) {
-						lwm2mSuccess = lwm2mReady();
-						printf("MAIN: waiting for LWM2M on SARA-R4 to be ready...\n");
-						ledSetTemporary(LED_STATE_BAD, 1000);
+					traceHandle = traceStart(TRACE_ID_LWM2M_READY);
+					lwm2mSuccess = lwm2mWaitReady(LWM2M_WAKEUP_WAIT_SECONDS * 1000);
+					traceStop(traceHandle);
+					if (lwm2mSuccess) {
+						traceHandle = traceStart(TRACE_ID_CFG_LWM2M);
+						lwm2mSuccess = cfgLwm2m();
+						traceStop(traceHandle);
 					}
-					if (lwm2mSuccess && cfgLwm2m()) {
+					if (lwm2mSuccess) {
 						// Check if configuring LWM2M may have caused a reboot of the
 						// system, in which case reconnect
 						if (cellularGetRegisteredRan() < 0) {
 							if (errorCode == 0) {
 								// Wait for LWM2M to come back again
 								lwm2mSuccess = false;
-								for (int x = 0; (errorCode == 0) && (x < LWM2M_WAKEUP_WAIT_SECONDS) && !lwm2mSuccess; x++) {
-									lwm2mSuccess = lwm2mReady();
-									printf("MAIN: waiting for LWM2M on SARA-R4 to be ready again...\n");
-									ledSetTemporary(LED_STATE_BAD, 1000);
-								}
+								traceHandle = traceStart(TRACE_ID_LWM2M_READY);
+								lwm2mSuccess = lwm2mWaitReady(LWM2M_WAKEUP_WAIT_SECONDS * 1000);
+								traceStop(traceHandle);
 							} else {
-								ledSetTemporary(LED_STATE_BAD, 1000);
-								printf("MAIN: error: unable to re-start a location fix.\n");
+								ledFlash(LED_STATE_BAD, 1000);
+								DIAG_ERROR("MAIN: error: unable to re-start a location fix.\n");
 							}
 						}
 						if (errorCode == 0) {
 							// If we've got here we have LWM2M configured, we're connected
 							// with the network once more and LWM2M is awake.
-							while (lwm2mSuccess) {
-								// Wait for the server to write stuff if it wants to
-								gStopTimeLwm2mMS = esp_timer_get_time() / 1000 + (LWM2M_SERVER_WAIT_TIME_SECONDS * 500);
-								printf("MAIN: waiting for LWM2M server to do stuff if it wants to...\n");
-								while ((esp_timer_get_time() / 1000) < gStopTimeLwm2mMS) {
-									// For debug
-									lwm2mRegistrationStatus(WHRE_LWM2M_SERVER_SHORT_ID);
-									esp_task_wdt_reset();
-									vTaskDelay(100 / portTICK_PERIOD_MS);
-									ledSetTemporary(LED_STATE_MIDDLIN, 100);
+							lwm2mEventsEnable();
+							if (lwm2mSuccess && resumed) {
+								// SARA-R4 is still registered with the LWM2M
+								// server from last time: let it know we're here
+								DIAG_INFO("MAIN: sending LWM2M registration update...\n");
+								traceHandle = traceStart(TRACE_ID_LWM2M_UPDATE);
+								updated = false;
+								for (int32_t x = 0; (x < LWM2M_SERVER_REGISTRATION_UPDATE_RETRIES) &&
+								                    !updated; x++) {
+									updated = (lwm2mEventsUpdate(WHRE_LWM2M_SERVER_SHORT_ID,
+									                             LWM2M_REGISTRATION_UPDATE_WAIT_MS) == 0);
+								}
+								traceStop(traceHandle);
+								if (!updated) {
+									// Start again from cold next time
+									LOG_EVENT(EVENT_LWM2M_UPDATE_FAILED, 0);
+									DIAG_WARN("MAIN: warning: LWM2M registration update failed.\n");
 								}
+							}
+							if (lwm2mSuccess) {
+								// Wait for the server to write stuff if it wants to,
+								// leaving as soon as it has gone quiet
+								DIAG_INFO("MAIN: waiting for LWM2M server to do stuff if it wants to...\n");
+								traceHandle = traceStart(TRACE_ID_SERVER_WAIT);
+								ledSet(LED_STATE_MIDDLIN);
+								lwm2mEvents = lwm2mEventsWait(LWM2M_SERVER_WAIT_TIME_SECONDS * 500,
+								                              LWM2M_SERVER_QUIET_TIME_MS);
+								ledSet(LED_STATE_OFF);
+								traceStop(traceHandle);
+								DIAG_INFO("MAIN: LWM2M server events 0x%02x.\n", lwm2mEvents);
 								// Now read out stuff from the objects which the server might
-								// have written to.  All I do here is do some demo I2C
-								// operations for now
-								dataReady = doI2cDemo();
+								// have written to and do the I2C operations it has
+								// asked for
+								traceHandle = traceStart(TRACE_ID_I2C);
+								dataReady = doI2cCommands();
+								traceStop(traceHandle);
+								dataReady = doReportFilter() || dataReady;
+								minModemUpSeconds = doOperatingParameters();
+								doModemConfiguration();
+								dataReady = sendEventLog() || dataReady;
 								if (dataReady) {
 									// If we have updated some data in LWM2M,
 									// hang around for it to get to the server
-									gStopTimeLwm2mMS = esp_timer_get_time() / 1000 + (LWM2M_SERVER_WAIT_TIME_SECONDS * 1000);
-									printf("MAIN: waiting for LWM2M server to get new data...\n");
-									while ((esp_timer_get_time() / 1000) < gStopTimeLwm2mMS) {
-										// For debug
-										lwm2mRegistrationStatus(WHRE_LWM2M_SERVER_SHORT_ID);
-										esp_task_wdt_reset();
-										vTaskDelay(100 / portTICK_PERIOD_MS);
-										ledSetTemporary(LED_STATE_MIDDLIN, 100);
-									}
+									DIAG_INFO("MAIN: waiting for LWM2M server to get new data...\n");
+									traceHandle = traceStart(TRACE_ID_SERVER_WAIT_DATA);
+									ledSet(LED_STATE_MIDDLIN);
+									lwm2mEventsWait(LWM2M_SERVER_WAIT_TIME_SECONDS * 1000,
+									                LWM2M_SERVER_QUIET_TIME_MS);
+									ledSet(LED_STATE_OFF);
+									traceStop(traceHandle);
+								}
+								// Stay up for the Minimum Modem up Time,
+								// so that the server can reach us
+								modemUpMs = (esp_timer_get_time() -
+								             gInitSteps[INIT_STEP_MODEM_POWER_ON].stopUs) / 1000;
+								if (modemUpMs < minModemUpSeconds * 1000LL) {
+									DIAG_INFO("MAIN: keeping the modem up for another %d ms...\n",
+									          (int) (minModemUpSeconds * 1000LL - modemUpMs));
+									lwm2mEventsWait(minModemUpSeconds * 1000 - (int32_t) modemUpMs,
+									                minModemUpSeconds * 1000 - (int32_t) modemUpMs);
 								}
+								reported = true;
 							}
 						} else {
 							ledSet(LED_STATE_BAD);
-							printf("MAIN: error: unable to re-register with the cellular network (%d).\n", errorCode);
+							DIAG_ERROR("MAIN: error: unable to re-register with the cellular network (%d).\n", errorCode);
 						}
 					} else {
-						printf("MAIN: warning: unable to configure LWM2M on SARA-R4.\n");
+						DIAG_WARN("MAIN: warning: unable to configure LWM2M on SARA-R4.\n");
 						ledSet(LED_STATE_BAD);
+						// Check everything properly next time
+						rtcStateClearVerified(RTC_STATE_VERIFIED_LWM2M_ALL);
 					}
-                    cellularDisconnect();
+                    // With PSM or eDRX on, stay registered for next time
+                    stayRegistered = lwm2mSuccess && (errorCode == 0) && updated &&
+                                     modemPsmIsEnabled();
+                    if (!stayRegistered) {
+                        cellularDisconnect();
+                    }
                 } else {
+                    wifiScanStop();
                     ledSet(LED_STATE_BAD);
-                    printf("MAIN: error: unable to register with the cellular network (%d).\n", errorCode);
+                    LOG_EVENT(EVENT_REGISTRATION_FAILED, errorCode);
+                    DIAG_ERROR("MAIN: error: unable to register with the cellular network (%d).\n", errorCode);
                 }
             } else {
                 ledSet(LED_STATE_BAD);
-                printf("MAIN: error: unable to configure SARA-R4.\n");
+                DIAG_ERROR("MAIN: error: unable to configure SARA-R4.\n");
+                rtcStateClearVerified(RTC_STATE_VERIFIED_MNO_PROFILE | RTC_STATE_VERIFIED_RAT);
             }
-            cellularPowerOff();
+            if (stayRegistered) {
+                // SARA-R4 goes into PSM by itself when its active timer
+                // is up and is woken by cellularPowerOn() next time
+                DIAG_INFO("MAIN: leaving SARA-R4 registered, in PSM/eDRX.\n");
+            } else {
+                traceHandle = traceStart(TRACE_ID_MODEM_POWER_OFF);
+                cellularPowerOff();
+                traceStop(traceHandle);
+            }
+            modemPsmSetRegistered(stayRegistered);
         } else {
             ledSet(LED_STATE_BAD);
-            printf("MAIN: error: unable to power up SARA-R4 (%d).\n", errorCode);
+            DIAG_ERROR("MAIN: error: unable to power up SARA-R4 (%d).\n", errorCode);
         }
-    } else {
+    } else if (!initialised) {
         ledSet(LED_STATE_BAD);
     }
 
-    // Set ext1 interrupt, which uses RTC HW, unlike ext 0 which requires the RTC peripherals to remain powered)
-    if (esp_sleep_enable_ext1_wakeup(1ULL << CONFIG_PIN_INT_ACCELEROMETER, ESP_EXT1_WAKEUP_ALL_LOW) == ESP_OK) {
-        printf("MAIN: accelerometer GPIO (ESP32 GPIO %d) set as EXT1 wake-up source, low level.\n", CONFIG_PIN_INT_ACCELEROMETER);
+    // Set ext1 interrupt, which uses RTC HW, unlike ext 0 which requires the RTC peripherals to remain powered),
+    // unless an accelerometer wake has already been put off, in which case another would be too soon
+    if (sleepSchedulerIsPending(&gSleepScheduler, SLEEP_SCHEDULER_ACTIVITY_I2C_TRIGGER)) {
+        DIAG_INFO("MAIN: accelerometer wake put off until %d second(s).\n",
+                  (int) sleepSchedulerMinSleepEnd(&gSleepScheduler));
+    } else if (esp_sleep_enable_ext1_wakeup(1ULL << CONFIG_PIN_INT_ACCELEROMETER, ESP_EXT1_WAKEUP_ALL_LOW) == ESP_OK) {
+        DIAG_INFO("MAIN: accelerometer GPIO (ESP32 GPIO %d) set as EXT1 wake-up source, low level.\n", CONFIG_PIN_INT_ACCELEROMETER);
     }
-    // Install ISR
-    if (gpio_install_isr_service(ESP_INTR_FLAG_LOWMED) == ESP_OK) {
-        printf("MAIN: GPIO service installed with flags 0x%02x.\n", ESP_INTR_FLAG_LOWMED);
-    }
-    // Set up accelerometer interrupt
-    errorCode = accelerometerSetInterruptThreshold(CONFIG_LIS2DW_INTERRUPT_THRESHOLD_MG,
-                                                   CONFIG_LIS2DW_INTERRUPT_DURATION_SECONDS);
-    if (errorCode == 0) {
-        errorCode = accelerometerSetInterruptEnable(true, NULL, NULL);
+    if (sampleWake) {
+        // Install ISR and set up the accelerometer interrupt; I2C
+        // is only up if something was done, otherwise the
+        // accelerometer keeps the settings it had
+        if (gpio_install_isr_service(ESP_INTR_FLAG_LOWMED) == ESP_OK) {
+            DIAG_DEBUG("MAIN: GPIO service installed with flags 0x%02x.\n", ESP_INTR_FLAG_LOWMED);
+        }
+        // Set up accelerometer interrupt
+        errorCode = accelerometerSetInterruptThreshold(CONFIG_LIS2DW_INTERRUPT_THRESHOLD_MG,
+                                                       CONFIG_LIS2DW_INTERRUPT_DURATION_SECONDS);
         if (errorCode == 0) {
-            printf("MAIN: accelerometer threshold enabled, set to %d mg for %d second(s)\n",
-                   CONFIG_LIS2DW_INTERRUPT_THRESHOLD_MG, CONFIG_LIS2DW_INTERRUPT_DURATION_SECONDS);
+            errorCode = accelerometerSetInterruptEnable(true, NULL, NULL);
+            if (errorCode == 0) {
+                DIAG_INFO("MAIN: accelerometer threshold enabled, set to %d mg for %d second(s)\n",
+                          CONFIG_LIS2DW_INTERRUPT_THRESHOLD_MG, CONFIG_LIS2DW_INTERRUPT_DURATION_SECONDS);
+            } else {
+                DIAG_ERROR("MAIN: error, unable to set enable accelerometer interrupt (%d).\n",
+                           errorCode);
+            }
         } else {
-            printf("MAIN: error, unable to set enable accelerometer interrupt (%d).\n",
-                   errorCode);
+            DIAG_ERROR("MAIN: error, unable to set accelerometer threshold to %d mg for %d second(s) (%d).\n",
+                       CONFIG_LIS2DW_INTERRUPT_THRESHOLD_MG, CONFIG_LIS2DW_INTERRUPT_DURATION_SECONDS, errorCode);
         }
-    } else {
-        printf("MAIN: error, unable to set accelerometer threshold to %d mg for %d second(s) (%d).\n",
-               CONFIG_LIS2DW_INTERRUPT_THRESHOLD_MG, CONFIG_LIS2DW_INTERRUPT_DURATION_SECONDS, errorCode);
     }
 
-    deInit();
+    traceHandle = traceStart(TRACE_ID_DEINIT);
+    if (reportWake) {
+        deInit();
+    } else if (sampleWake) {
+        deInitSample();
+    }
+    traceStop(traceHandle);
+    traceStop(traceWake);
+    lwm2mArenaGetStats(&arenaStats);
+    DIAG_INFO("MAIN: LWM2M arena: %d allocation(s) in %d scope(s), %d overflow(s), peak %d byte(s).\n",
+              arenaStats.arenaAllocs, arenaStats.scopes, arenaStats.arenaOverflows,
+              arenaStats.arenaPeakBytes);
+    DIAG_INFO("MAIN: heap: %d allocation(s), %d free(s), %d byte(s) free, %d%% fragmented.\n",
+              arenaStats.heapAllocs, arenaStats.heapFrees, arenaStats.heapFreeBytes,
+              lwm2mArenaHeapFragmentation(&arenaStats));
     gettimeofday(&now, NULL);
-    printf("MAIN: entering hibernate for %d second(s) at %d second(s)...\n",
-           SLEEP_TIME_USECONDS / 1000000, (int) (now.tv_sec) + 1);
-    ledSet(LED_STATE_OFF);
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
+    // Move on the deadlines of what was due and sleep until the
+    // next, counting from when the sleep starts, below; a report
+    // that didn't get through is tried again soon
+    if (reportWake && !reported) {
+        DIAG_WARN("MAIN: warn: report failed, trying again in %d second(s).\n",
+                  REPORT_RETRY_SECONDS);
+        sleepSchedulerRetry(&gSleepScheduler,
+                            due & SLEEP_SCHEDULER_BIT(SLEEP_SCHEDULER_ACTIVITY_REPORT),
+                            REPORT_RETRY_SECONDS, (uint32_t) now.tv_sec);
+        due &= ~SLEEP_SCHEDULER_BIT(SLEEP_SCHEDULER_ACTIVITY_REPORT);
+    }
+    sleepSchedulerDone(&gSleepScheduler, due, (uint32_t) now.tv_sec);
+    sleepSeconds = sleepSchedulerSleepSeconds(&gSleepScheduler, (uint32_t) now.tv_sec + 1);
+    DIAG_INFO("MAIN: entering hibernate for %d second(s) at %d second(s)...\n",
+              (int) sleepSeconds, (int) (now.tv_sec) + 1);
+    // The flash writes of the event log are left until now, when
+    // nothing else is waiting on them
+    LOG_EVENT(EVENT_SLEEP_SECONDS, sleepSeconds);
+    flashLogFlush();
+    // Anything not yet written to the console has to go now
+    diagStop();
+    traceDump();
+    ledDeinit();
+    vTaskDelay(CONSOLE_DRAIN_MS / portTICK_PERIOD_MS);
 
     // The ESP32 SW API reference doesn't refer to hibernate but, from this
     // forum question: https://www.esp32.com/viewtopic.php?f=2&t=3083, it seems
@@ -1464,11 +2503,21 @@ void app_main()
     // hibernate. See also this example:
     // https://github.com/espressif/esp-idf/blob/cc5673435be92c4beceb7108c738d6741ea7230f/examples/system/deep_sleep/main/deep_sleep_example_main.c
     // This should put the processor into hibernate, from which it
-    // can awake via RTC timer or ext1 interrupt.
-    esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_SLOW_MEM, ESP_PD_OPTION_OFF);
+    // can awake via RTC timer or ext1 interrupt.  RTC slow memory
+    // may be kept on to retain the state in rtc_state.c.  SARA-R4,
+    // if left registered, only stays powered if the pin powering
+    // it is held, and the hold of an RTC GPIO needs the RTC
+    // peripherals to stay powered.
+    if (modemPsmIsRegistered()) {
+        gpio_hold_en(CONFIG_PIN_CELLULAR_ENABLE_POWER);
+        gpio_deep_sleep_hold_en();
+    }
+    esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_SLOW_MEM,
+                        RTC_STATE_KEEP_POWERED ? ESP_PD_OPTION_ON : ESP_PD_OPTION_OFF);
     esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_FAST_MEM, ESP_PD_OPTION_OFF);
-    esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH, ESP_PD_OPTION_OFF);
-    esp_sleep_enable_timer_wakeup(SLEEP_TIME_USECONDS);
+    esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH,
+                        modemPsmIsRegistered() ? ESP_PD_OPTION_ON : ESP_PD_OPTION_OFF);
+    esp_sleep_enable_timer_wakeup(sleepSeconds * 1000000ULL);
     esp_deep_sleep_start();
 }
 
@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "esp_attr.h" // For RTC_DATA_ATTR
+#include "at_batch.h"
+#include "utilities.h"
+#include "diag.h"
+#include "modem_psm.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// Marks the start of a valid block.
+#define MODEM_PSM_MAGIC 0x50534d21 // "PSM!"
+
+// The <AcT-type> of AT+CEDRXS: E-UTRAN WB-S1 (LTE-M), the mode the
+// eDRX resource of the Modem Configuration object is for.
+#define MODEM_PSM_EDRX_ACT_TYPE 4
+
+// The value in bits 8 to 6 of a GPRS Timer 2 or 3 octet which
+// means deactivated.
+#define MODEM_PSM_TIMER_DEACTIVATED 0x07
+
+// The largest number of units in a GPRS Timer 2 or 3 octet.
+#define MODEM_PSM_TIMER_MAX_VALUE 31
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+// A unit of a GPRS Timer 2 or 3 octet.
+typedef struct {
+    uint8_t code;    // Bits 8 to 6 of the octet.
+    int32_t seconds; // The length of the unit.
+} ModemPsmTimerUnit;
+
+// The block kept in RTC memory.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t firmwareVersion;
+    bool applied;          // config has been sent to SARA-R412M.
+    bool registered;       // SARA-R412M was left registered.
+    ModemPsmConfig config;
+    uint32_t crc; // Must be last
+} ModemPsm;
+
+// ----------------------------------------------------------------
+// PRIVATE VARIABLES
+// ----------------------------------------------------------------
+
+// The units of GPRS Timer 3, shortest first.
+static const ModemPsmTimerUnit gT3412Units[] = {{3, 2}, {4, 30}, {5, 60},
+                                                {0, 600}, {1, 3600},
+                                                {2, 36000}, {6, 1152000}};
+
+// The units of GPRS Timer 2, shortest first.
+static const ModemPsmTimerUnit gT3324Units[] = {{0, 2}, {1, 60}, {2, 360}};
+
+// The block itself, in RTC slow memory.
+static RTC_DATA_ATTR ModemPsm gModemPsm;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// The CRC of everything except the CRC.
+static uint32_t calculateCrc()
+{
+    return utilitiesCrc32(0, &gModemPsm, offsetof(ModemPsm, crc));
+}
+
+// Update the CRC after a change.
+static void commit()
+{
+    gModemPsm.crc = calculateCrc();
+}
+
+// Encode a time in the shortest unit which can hold it, rounding
+// up; the longest time there is if none can.
+static uint8_t encodeTimer(const ModemPsmTimerUnit *pUnits, size_t numUnits,
+                           int32_t seconds)
+{
+    int32_t value;
+
+    for (size_t x = 0; x < numUnits; x++) {
+        value = (seconds + pUnits[x].seconds - 1) / pUnits[x].seconds;
+        if (value <= MODEM_PSM_TIMER_MAX_VALUE) {
+            return (uint8_t) ((pUnits[x].code << 5) | value);
+        }
+    }
+
+    return (uint8_t) ((pUnits[numUnits - 1].code << 5) | MODEM_PSM_TIMER_MAX_VALUE);
+}
+
+// Write the bottom bits of a number as a string of '0's and '1's,
+// as the timers of AT+CPSMS and AT+CEDRXS are given.
+static void toBinaryString(uint32_t number, int32_t numBits, char *pBuffer)
+{
+    for (int32_t x = 0; x < numBits; x++) {
+        pBuffer[x] = (number & (1UL << (numBits - x - 1))) ? '1' : '0';
+    }
+    pBuffer[numBits] = 0;
+}
+
+// Send a batch of AT commands which only get "OK" back; the
+// commands are built on the stack, so a failure is reported by
+// position rather than by text, since diag formats it later.
+static int32_t sendCommands(AtBatch *pBatch)
+{
+    int32_t errorCode = 0;
+
+    if (atBatchRun(pBatch) < pBatch->numCommands) {
+        errorCode = -1;
+        for (int32_t x = 0; x < pBatch->numCommands; x++) {
+            if (atBatchResult(pBatch, x) != 0) {
+                DIAG_ERROR("MODEM_PSM: error: command %d of %d failed (%d).\n",
+                           x + 1, pBatch->numCommands, atBatchResult(pBatch, x));
+            }
+        }
+    }
+
+    return errorCode;
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Check the block at wake-up.
+bool modemPsmInit(uint32_t firmwareVersion, bool keep)
+{
+    bool valid = keep &&
+                 (gModemPsm.magic == MODEM_PSM_MAGIC) &&
+                 (gModemPsm.version == MODEM_PSM_VERSION) &&
+                 (gModemPsm.firmwareVersion == firmwareVersion) &&
+                 (gModemPsm.crc == calculateCrc());
+
+    if (!valid) {
+        memset(&gModemPsm, 0, sizeof(gModemPsm));
+        gModemPsm.magic = MODEM_PSM_MAGIC;
+        gModemPsm.version = MODEM_PSM_VERSION;
+        gModemPsm.firmwareVersion = firmwareVersion;
+        gModemPsm.config.edrx = MODEM_PSM_EDRX_OFF;
+        commit();
+    }
+
+    return gModemPsm.registered;
+}
+
+// Send the settings to SARA-R412M.
+int32_t modemPsmApply(const ModemPsmConfig *pConfig)
+{
+    int32_t errorCode = 0;
+    AtBatch batch;
+    char psmCommand[64];
+    char edrxCommand[64];
+    char t3412[9];
+    char t3324[9];
+    char edrx[5];
+    bool psmChanged = !gModemPsm.applied ||
+                      (pConfig->periodicTauSeconds != gModemPsm.config.periodicTauSeconds) ||
+                      (pConfig->activeTimeSeconds != gModemPsm.config.activeTimeSeconds);
+    bool edrxChanged = !gModemPsm.applied ||
+                       (pConfig->edrx != gModemPsm.config.edrx);
+
+    // Both go in one batch, without waiting for one to be
+    // answered before sending the other
+    atBatchInit(&batch, 0);
+    if (psmChanged) {
+        if (pConfig->periodicTauSeconds > 0) {
+            toBinaryString(modemPsmEncodeT3412(pConfig->periodicTauSeconds), 8, t3412);
+            toBinaryString(modemPsmEncodeT3324(pConfig->activeTimeSeconds), 8, t3324);
+            snprintf(psmCommand, sizeof(psmCommand), "AT+CPSMS=1,,,\"%s\",\"%s\"",
+                     t3412, t3324);
+        } else {
+            snprintf(psmCommand, sizeof(psmCommand), "AT+CPSMS=0");
+        }
+        atBatchAdd(&batch, psmCommand);
+    }
+    if (edrxChanged) {
+        if (pConfig->edrx >= 0) {
+            toBinaryString(pConfig->edrx & 0x0f, 4, edrx);
+            snprintf(edrxCommand, sizeof(edrxCommand), "AT+CEDRXS=1,%d,\"%s\"",
+                     MODEM_PSM_EDRX_ACT_TYPE, edrx);
+        } else {
+            snprintf(edrxCommand, sizeof(edrxCommand), "AT+CEDRXS=0,%d",
+                     MODEM_PSM_EDRX_ACT_TYPE);
+        }
+        atBatchAdd(&batch, edrxCommand);
+    }
+    if (psmChanged || edrxChanged) {
+        errorCode = sendCommands(&batch);
+        if (errorCode == 0) {
+            gModemPsm.config = *pConfig;
+            if (gModemPsm.config.edrx < 0) {
+                gModemPsm.config.edrx = MODEM_PSM_EDRX_OFF;
+            }
+            gModemPsm.applied = true;
+            DIAG_INFO("MODEM_PSM: PSM %s (TAU %d s, active time %d s), eDRX %s.\n",
+                      (pConfig->periodicTauSeconds > 0) ? "on" : "off",
+                      pConfig->periodicTauSeconds, pConfig->activeTimeSeconds,
+                      (pConfig->edrx >= 0) ? "on" : "off");
+        } else {
+            // Try them all again next time
+            gModemPsm.applied = false;
+        }
+        commit();
+    }
+
+    return errorCode;
+}
+
+// Determine whether PSM or eDRX is on.
+bool modemPsmIsEnabled()
+{
+    return gModemPsm.applied &&
+           ((gModemPsm.config.periodicTauSeconds > 0) ||
+            (gModemPsm.config.edrx >= 0));
+}
+
+// Record whether SARA-R412M has been left registered.
+void modemPsmSetRegistered(bool registered)
+{
+    gModemPsm.registered = registered;
+    commit();
+}
+
+// Determine whether SARA-R412M was left registered.
+bool modemPsmIsRegistered()
+{
+    return gModemPsm.registered;
+}
+
+// Encode the extended T3412.
+uint8_t modemPsmEncodeT3412(int32_t seconds)
+{
+    if (seconds <= 0) {
+        return MODEM_PSM_TIMER_DEACTIVATED << 5;
+    }
+
+    return encodeTimer(gT3412Units, sizeof(gT3412Units) / sizeof(gT3412Units[0]),
+                       seconds);
+}
+
+// Encode T3324.
+uint8_t modemPsmEncodeT3324(int32_t seconds)
+{
+    if (seconds < 0) {
+        return MODEM_PSM_TIMER_DEACTIVATED << 5;
+    }
+
+    return encodeTimer(gT3324Units, sizeof(gT3324Units) / sizeof(gT3324Units[0]),
+                       seconds);
+}
+
+// Decode T3324.
+int32_t modemPsmDecodeT3324(uint8_t octet)
+{
+    uint8_t code = octet >> 5;
+
+    for (size_t x = 0; x < sizeof(gT3324Units) / sizeof(gT3324Units[0]); x++) {
+        if (gT3324Units[x].code == code) {
+            return (octet & MODEM_PSM_TIMER_MAX_VALUE) * gT3324Units[x].seconds;
+        }
+    }
+
+    // Deactivated, or a unit this version of 3GPP doesn't know
+    return -1;
+}
+
+// End Of File
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _MODEM_PSM_H_
+#define _MODEM_PSM_H_
+
+/* 3GPP power saving for SARA-R412M: rather than being powered off
+ * at the end of every report and attaching from cold at the next,
+ * the module can be left registered with the network, in power
+ * saving mode (PSM) and/or with extended DRX, and at the next report
+ * is only woken and carries on with the registration it has.
+ *
+ * The timers come from the Modem Configuration object and are sent
+ * to SARA-R412M with AT+CPSMS and AT+CEDRXS, as one batch through
+ * the AT client (see at_batch.h); what was last sent, and whether
+ * the module was left registered, is kept in a CRC-protected block
+ * of RTC slow memory, like sample_store.c, so that the settings are
+ * only written to SARA-R412M, which keeps them in NVM, when they
+ * change.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The version of the PSM block; increment this when the layout
+ * of the block changes.
+ */
+#define MODEM_PSM_VERSION 1
+
+/** The value of edrx in ModemPsmConfig for eDRX off.
+ */
+#define MODEM_PSM_EDRX_OFF -1
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** The power saving settings, as written by the LWM2M server.
+ */
+typedef struct {
+    int32_t periodicTauSeconds; //!< The PSM Timer (extended T3412),
+                                //!< zero for PSM off.
+    int32_t activeTimeSeconds;  //!< The Active Timer (T3324).
+    int32_t edrx;               //!< Octet 3 of the eDRX IE of
+                                //!< 3GPP TS 24.008: the eDRX value
+                                //!< in bits 4 to 1, or
+                                //!< MODEM_PSM_EDRX_OFF.
+} ModemPsmConfig;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Check the PSM block at wake-up, resetting it if it is not
+ * valid, in which case the settings are sent to SARA-R412M again at
+ * the next modemPsmApply().  Call this once, after rtcStateInit().
+ *
+ * @param firmwareVersion as passed to rtcStateInit().
+ * @param keep            false to reset regardless, e.g. because
+ *                        this is not a warm wake.
+ * @return                true if SARA-R412M was left registered at
+ *                        the end of the previous wake.
+ */
+bool modemPsmInit(uint32_t firmwareVersion, bool keep);
+
+/** Send the power saving settings to SARA-R412M, if they differ
+ * from those last sent; it must be powered and the AT client
+ * running.  They take effect at the next registration or tracking
+ * area update.
+ *
+ * @param pConfig the settings.
+ * @return        zero on success, else negative error code.
+ */
+int32_t modemPsmApply(const ModemPsmConfig *pConfig);
+
+/** Determine whether the settings last sent to SARA-R412M have PSM
+ * or eDRX on, i.e. whether it should be left registered at the end
+ * of a report rather than powered off.
+ *
+ * @return true if PSM or eDRX is on.
+ */
+bool modemPsmIsEnabled();
+
+/** Record whether SARA-R412M has been left registered, to be
+ * woken at the next report, or has been powered off.
+ *
+ * @param registered true if it has been left registered.
+ */
+void modemPsmSetRegistered(bool registered);
+
+/** Determine whether SARA-R412M was left registered.
+ *
+ * @return true if it was left registered.
+ */
+bool modemPsmIsRegistered();
+
+/** Encode a time as a GPRS Timer 3 octet (3GPP TS 24.008
+ * 10.5.7.4a), as used for the extended T3412, rounding up to the
+ * nearest value that can be represented.
+ *
+ * @param seconds the time; zero or negative for deactivated.
+ * @return        the octet.
+ */
+uint8_t modemPsmEncodeT3412(int32_t seconds);
+
+/** Encode a time as a GPRS Timer 2 octet (3GPP TS 24.008
+ * 10.5.7.4), as used for T3324, rounding up to the nearest value
+ * that can be represented.
+ *
+ * @param seconds the time; negative for deactivated.
+ * @return        the octet.
+ */
+uint8_t modemPsmEncodeT3324(int32_t seconds);
+
+/** Decode a GPRS Timer 2 octet.
+ *
+ * @param octet the octet.
+ * @return      the time in seconds, negative if deactivated.
+ */
+int32_t modemPsmDecodeT3324(uint8_t octet);
+
+#endif // _MODEM_PSM_H_
+
+// End Of File
@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h" // For RTC_DATA_ATTR
+#include "esp_timer.h" // For esp_timer_get_time()
+#include "driver/uart.h"
+#include "whre_config.h"
+#include "at_client.h"
+#include "at_batch.h"
+#include "utilities.h"
+#include "diag.h"
+#include "modem_uart.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// Marks the start of a valid block.
+#define MODEM_UART_MAGIC 0x55415254 // "UART"
+
+// Hardware flow control needs the RTS and CTS lines of SARA-R412M
+// to be wired to the ESP32.
+#if defined(CONFIG_PIN_UART_RTS_CELLULAR) && defined(CONFIG_PIN_UART_CTS_CELLULAR)
+# define MODEM_UART_FLOW_CONTROL_PINS 1
+#else
+# define MODEM_UART_FLOW_CONTROL_PINS 0
+#endif
+
+// The level of the 128 byte receive FIFO of the ESP32 at which
+// it holds SARA-R412M off with RTS.
+#define MODEM_UART_RX_FLOW_THRESHOLD 122
+
+// The bytes on the line for one "AT" of a probe: "AT\r" and, with
+// echo off, "\r\nOK\r\n".
+#define MODEM_UART_PROBE_BYTES 9
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+// The block kept in RTC memory.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t firmwareVersion;
+    int32_t baudRate;       // Negotiated, zero if not yet.
+    int32_t failedBaudRate; // Lost SARA-R412M, zero if none has.
+    bool flowControl;       // Negotiated with flow control.
+    uint32_t crc; // Must be last
+} ModemUart;
+
+// ----------------------------------------------------------------
+// PRIVATE VARIABLES
+// ----------------------------------------------------------------
+
+// The rates of SARA-R412M above its default, fastest first.
+static const int32_t gBaudRates[] = {921600, 460800, 230400};
+
+// The block itself, in RTC slow memory.
+static RTC_DATA_ATTR ModemUart gModemUart;
+
+// The rate SARA-R412M powers up at.
+static int32_t gDefaultBaudRate = 0;
+
+// Where the ESP32 end of the UART is.
+static int32_t gBaudRate = 0;
+static bool gFlowControl = false;
+
+// True if the ESP32 end was moved to the negotiated rate at
+// wake-up, SARA-R412M having stayed at it.
+static bool gResumed = false;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// The CRC of everything except the CRC.
+static uint32_t calculateCrc()
+{
+    return utilitiesCrc32(0, &gModemUart, offsetof(ModemUart, crc));
+}
+
+// Update the CRC after a change.
+static void commit()
+{
+    gModemUart.crc = calculateCrc();
+}
+
+// Set the ESP32 end of the UART.
+static int32_t setUart(int32_t uart, int32_t baudRate, bool flowControl)
+{
+    int32_t errorCode = 0;
+
+    if (uart_set_baudrate(uart, baudRate) != ESP_OK) {
+        errorCode = -1;
+    }
+#if MODEM_UART_FLOW_CONTROL_PINS
+    if ((errorCode == 0) && flowControl &&
+        (uart_set_pin(uart, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE,
+                      CONFIG_PIN_UART_RTS_CELLULAR,
+                      CONFIG_PIN_UART_CTS_CELLULAR) != ESP_OK)) {
+        errorCode = -1;
+    }
+    if ((errorCode == 0) &&
+        (uart_set_hw_flow_ctrl(uart, flowControl ? UART_HW_FLOWCTRL_CTS_RTS :
+                                                   UART_HW_FLOWCTRL_DISABLE,
+                               MODEM_UART_RX_FLOW_THRESHOLD) != ESP_OK)) {
+        errorCode = -1;
+    }
+#else
+    flowControl = false;
+#endif
+    if (errorCode == 0) {
+        gBaudRate = baudRate;
+        gFlowControl = flowControl;
+    }
+
+    return errorCode;
+}
+
+// Send a batch of "AT"s and print how fast they went, returning
+// true if they were all answered.
+static bool probe()
+{
+    AtBatch batch;
+    int64_t startUs;
+    int64_t timeUs;
+    bool success;
+
+    atBatchInit(&batch, 0);
+    for (int32_t x = 0; x < MODEM_UART_PROBE_COUNT; x++) {
+        atBatchAdd(&batch, "AT");
+    }
+    startUs = esp_timer_get_time();
+    success = (atBatchRun(&batch) == batch.numCommands);
+    timeUs = esp_timer_get_time() - startUs;
+
+    if (success) {
+        DIAG_INFO("MODEM_UART: %d bit/s, flow control %s: %d byte(s)/s on the line,"
+                  " %d byte(s)/s effective.\n", gBaudRate, gFlowControl ? "on" : "off",
+                  gBaudRate / 10,
+                  (int32_t) ((((int64_t) MODEM_UART_PROBE_COUNT) *
+                              MODEM_UART_PROBE_BYTES * 1000000) / (timeUs + 1)));
+    } else {
+        DIAG_INFO("MODEM_UART: %d bit/s, flow control %s: no answer to probe.\n",
+                  gBaudRate, gFlowControl ? "on" : "off");
+    }
+
+    return success;
+}
+
+// Have SARA-R412M and then the ESP32 use RTS/CTS, returning true
+// on success.
+static bool startFlowControl(int32_t uart)
+{
+    bool success = false;
+
+#if MODEM_UART_FLOW_CONTROL_PINS
+    if (at_client_send("AT+IFC=2,2") && at_client_recv("OK")) {
+        success = (setUart(uart, gBaudRate, true) == 0);
+        if (!success && at_client_send("AT+IFC=0,0")) {
+            at_client_recv("OK");
+        }
+    }
+#else
+    (void) uart;
+#endif
+
+    return success;
+}
+
+// Move both ends to a rate and probe it, going back to the rate
+// before if the probe fails.  Returns zero on success, a negative
+// error code if the rate is no good but SARA-R412M is still there,
+// else MODEM_UART_ERROR_LOST.
+static int32_t tryBaudRate(int32_t uart, int32_t baudRate)
+{
+    int32_t oldBaudRate = gBaudRate;
+
+    if (!at_client_send("AT+IPR=%d", baudRate) || !at_client_recv("OK")) {
+        DIAG_INFO("MODEM_UART: %d bit/s refused by SARA-R412M.\n", baudRate);
+        return -1;
+    }
+    vTaskDelay(MODEM_UART_SETTLE_MS / portTICK_PERIOD_MS);
+    if ((setUart(uart, baudRate, gFlowControl) == 0) && probe()) {
+        return 0;
+    }
+
+    // SARA-R412M may not have moved; if it has there is no way
+    // of telling it to move back
+    setUart(uart, oldBaudRate, gFlowControl);
+    if (at_client_send("AT") && at_client_recv("OK")) {
+        return -1;
+    }
+
+    return MODEM_UART_ERROR_LOST;
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Check the block at wake-up.
+void modemUartInit(uint32_t firmwareVersion, bool keep,
+                   int32_t defaultBaudRate)
+{
+    bool valid = keep &&
+                 (gModemUart.magic == MODEM_UART_MAGIC) &&
+                 (gModemUart.version == MODEM_UART_VERSION) &&
+                 (gModemUart.firmwareVersion == firmwareVersion) &&
+                 (gModemUart.crc == calculateCrc());
+
+    if (!valid) {
+        memset(&gModemUart, 0, sizeof(gModemUart));
+        gModemUart.magic = MODEM_UART_MAGIC;
+        gModemUart.version = MODEM_UART_VERSION;
+        gModemUart.firmwareVersion = firmwareVersion;
+        commit();
+    }
+    gDefaultBaudRate = defaultBaudRate;
+    gBaudRate = defaultBaudRate;
+    gFlowControl = false;
+    gResumed = false;
+}
+
+// Move the ESP32 end to the negotiated rate.
+int32_t modemUartResume(int32_t uart)
+{
+    int32_t errorCode = 0;
+
+    if (gModemUart.baudRate > 0) {
+        errorCode = setUart(uart, gModemUart.baudRate, gModemUart.flowControl);
+        gResumed = (errorCode == 0);
+    }
+
+    return errorCode;
+}
+
+// Move both ends to the fastest rate that works.
+int32_t modemUartNegotiate(int32_t uart)
+{
+    int32_t errorCode = -1;
+    int32_t baudRate = 0;
+
+    if (gResumed) {
+        // Powering up has shown that the link works
+        return 0;
+    }
+
+    // Flow control first, so that the faster rates have it
+    if ((gModemUart.baudRate == 0) || gModemUart.flowControl) {
+        startFlowControl(uart);
+    }
+
+    if (gModemUart.baudRate == 0) {
+        // Nothing found yet: try everything, reporting where
+        // SARA-R412M is now for comparison
+        probe();
+    }
+    for (size_t x = 0; (x < sizeof(gBaudRates) / sizeof(gBaudRates[0])) &&
+                       (gBaudRates[x] > gBaudRate) && (errorCode != 0) &&
+                       (errorCode != MODEM_UART_ERROR_LOST); x++) {
+        baudRate = gBaudRates[x];
+        if ((baudRate <= MODEM_UART_MAX_BAUD_RATE) &&
+            ((gModemUart.failedBaudRate == 0) || (baudRate < gModemUart.failedBaudRate)) &&
+            ((gModemUart.baudRate == 0) || (baudRate == gModemUart.baudRate))) {
+            errorCode = tryBaudRate(uart, baudRate);
+        }
+    }
+
+    if (errorCode == MODEM_UART_ERROR_LOST) {
+        // Don't go as far again
+        DIAG_ERROR("MODEM_UART: error: SARA-R412M lost at %d bit/s.\n", baudRate);
+        gModemUart.baudRate = 0;
+        gModemUart.failedBaudRate = baudRate;
+        commit();
+        modemUartFallBack(uart);
+        return errorCode;
+    }
+
+    if ((errorCode == 0) || (gModemUart.baudRate == 0) ||
+        (gModemUart.baudRate == gBaudRate)) {
+        // Where SARA-R412M is now is the best there is
+        gModemUart.baudRate = gBaudRate;
+        gModemUart.flowControl = gFlowControl;
+    } else {
+        // The rate found before no longer works: search again
+        // next time
+        gModemUart.baudRate = 0;
+    }
+    commit();
+
+    return 0;
+}
+
+// Put the ESP32 end back to the default rate.
+void modemUartFallBack(int32_t uart)
+{
+    setUart(uart, gDefaultBaudRate, false);
+    gResumed = false;
+}
+
+// Get the rate of the ESP32 end.
+int32_t modemUartBaudRate()
+{
+    return gBaudRate;
+}
+
+// End Of File
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _MODEM_UART_H_
+#define _MODEM_UART_H_
+
+/* The speed of the UART to SARA-R412M.  The module powers up at its
+ * default rate, without hardware flow control as far as the ESP32 is
+ * concerned; once it is up, modemUartNegotiate() turns on flow
+ * control, if the RTS and CTS lines are wired, and then moves both
+ * ends to the fastest rate that works (AT+IPR), checking each with a
+ * probe of a few "AT"s and falling back if the probe fails.
+ *
+ * The rate arrived at is kept in a CRC-protected block of RTC slow
+ * memory, like modem_psm.c, so that later wakes go straight to it
+ * rather than searching again, and so that the ESP32 can open the
+ * UART at it when SARA-R412M has stayed powered, registered, since.
+ * AT+IPR is not saved to the profile of SARA-R412M (no AT&W), so
+ * after a power-off it is back at its default rate.
+ *
+ * The line rate and the effective rate of the probe, in bytes per
+ * second, are printed for every setting tried.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The version of the UART block; increment this when the layout
+ * of the block changes.
+ */
+#define MODEM_UART_VERSION 1
+
+/** The fastest rate to try, at most the 921600 of SARA-R412M.
+ */
+#ifndef MODEM_UART_MAX_BAUD_RATE
+# define MODEM_UART_MAX_BAUD_RATE 921600
+#endif
+
+/** The number of "AT"s in a probe.
+ */
+#ifndef MODEM_UART_PROBE_COUNT
+# define MODEM_UART_PROBE_COUNT 8
+#endif
+
+/** How long to leave SARA-R412M after it has answered AT+IPR before
+ * talking to it at the new rate.
+ */
+#ifndef MODEM_UART_SETTLE_MS
+# define MODEM_UART_SETTLE_MS 100
+#endif
+
+/** The error code of modemUartNegotiate() when SARA-R412M has been
+ * left at a rate that doesn't work and must be powered off.
+ */
+#define MODEM_UART_ERROR_LOST -2
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Check the UART block at wake-up, resetting it if it is not
+ * valid, in which case the rates are searched again at the next
+ * modemUartNegotiate().  Call this once, after rtcStateInit().
+ *
+ * @param firmwareVersion as passed to rtcStateInit().
+ * @param keep            false to reset regardless, e.g. because
+ *                        this is not a warm wake.
+ * @param defaultBaudRate the rate SARA-R412M powers up at, which
+ *                        the UART must be opened at.
+ */
+void modemUartInit(uint32_t firmwareVersion, bool keep,
+                   int32_t defaultBaudRate);
+
+/** Move the ESP32 end of the UART to the rate and flow control
+ * last negotiated, for when SARA-R412M has stayed powered since;
+ * call this after the UART is opened and before talking to
+ * SARA-R412M.
+ *
+ * @param uart the UART port.
+ * @return     zero on success, else negative error code.
+ */
+int32_t modemUartResume(int32_t uart);
+
+/** Move SARA-R412M and the ESP32 to the fastest rate that works;
+ * SARA-R412M must be powered and the AT client running.  If the
+ * link was resumed at the negotiated rate this does nothing.  If
+ * the probe fails at a new rate and SARA-R412M can't be reached at
+ * the old one either, the ESP32 end is put back to the default rate,
+ * the rate is not tried again and MODEM_UART_ERROR_LOST is returned:
+ * SARA-R412M should then be powered off and on again.
+ *
+ * @param uart the UART port.
+ * @return     zero if the link works, at whatever rate, else
+ *             negative error code.
+ */
+int32_t modemUartNegotiate(int32_t uart);
+
+/** Put the ESP32 end of the UART back to the default rate with no
+ * flow control, as SARA-R412M is after a power-off.
+ *
+ * @param uart the UART port.
+ */
+void modemUartFallBack(int32_t uart);
+
+/** Get the rate the ESP32 end of the UART is at.
+ *
+ * @return the baud rate.
+ */
+int32_t modemUartBaudRate();
+
+#endif // _MODEM_UART_H_
+
+// End Of File
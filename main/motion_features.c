@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "motion_features.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+#if (MOTION_FEATURES_WINDOW_SIZE < 2) || (MOTION_FEATURES_WINDOW_SIZE > 256)
+# error MOTION_FEATURES_WINDOW_SIZE must be between 2 and 256.
+#endif
+
+#if MOTION_FEATURES_NUM_AXES != 3
+# error motionFeaturesCompute() is written for three axes.
+#endif
+
+// The shift which takes a left-justified sample down to the
+// 12 bits the kernel works on, few enough that the square of the
+// largest difference from the mean, 4095, summed over 256 samples
+// fits in a uint32_t.
+#define SAMPLE_SHIFT 4
+
+// The number of fractional bits kept when taking the square root
+// for the RMS, which would otherwise be only as good as the 1 mg
+// resolution of the samples.
+#define RMS_FRACTION_BITS 3
+
+// Convert the 12-bit samples, with the given number of fractional
+// bits, to mg at ±2 g: 4000 mg / 4096, rounded.
+#define LSB_TO_MG(lsb, fractionBits) ((int32_t) (((((int64_t) (lsb)) * 125) + \
+                                                 (1LL << (6 + (fractionBits)))) >> \
+                                                (7 + (fractionBits))))
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+// What is kept for an axis while computing the features.
+typedef struct {
+    int32_t mean;
+    uint32_t sumSquares;
+    int32_t peak;
+    int32_t crossings;
+    int32_t side; // Which side of the hysteresis band the axis was
+                  // last seen, zero until it has first left it.
+} MotionFeaturesAxis;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Add a sample of an axis to the energy, peak and crossings.  This
+// is written without branches on the data, which for a noisy signal
+// the processor could not predict.
+static inline void axisAdd(MotionFeaturesAxis *pAxis, int16_t sample)
+{
+    int32_t delta = (sample >> SAMPLE_SHIFT) - pAxis->mean;
+    int32_t magnitude = (delta < 0) ? -delta : delta;
+    bool above = (delta > MOTION_FEATURES_HYSTERESIS_LSB);
+    bool below = (delta < -MOTION_FEATURES_HYSTERESIS_LSB);
+
+    pAxis->sumSquares += (uint32_t) (delta * delta);
+    pAxis->peak = (magnitude > pAxis->peak) ? magnitude : pAxis->peak;
+    pAxis->crossings += (above & (pAxis->side < 0)) | (below & (pAxis->side > 0));
+    pAxis->side = above ? 1 : (below ? -1 : pAxis->side);
+}
+
+// Integer square root, rounded down.
+static uint32_t isqrt(uint64_t value)
+{
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint32_t) root;
+}
+
+// Saturate a value to the range of a uint16_t.
+static uint16_t saturateU16(int32_t value)
+{
+    if (value < 0) {
+        return 0;
+    }
+    if (value > 0xffff) {
+        return 0xffff;
+    }
+
+    return (uint16_t) value;
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Compute the features of a window of samples.
+void motionFeaturesCompute(const MotionFeaturesSample *pSamples,
+                           MotionFeatures *pFeatures)
+{
+    int32_t sum[MOTION_FEATURES_NUM_AXES] = {0};
+    MotionFeaturesAxis axes[MOTION_FEATURES_NUM_AXES] = {{0}};
+    uint64_t total = 0;
+    int32_t dominant = 0;
+
+    // The axes are written out, rather than being an inner loop,
+    // so that what is kept for each stays in registers
+
+    // First pass: the mean of each axis
+    for (int32_t x = 0; x < MOTION_FEATURES_WINDOW_SIZE; x++) {
+        sum[0] += pSamples[x][0] >> SAMPLE_SHIFT;
+        sum[1] += pSamples[x][1] >> SAMPLE_SHIFT;
+        sum[2] += pSamples[x][2] >> SAMPLE_SHIFT;
+    }
+    for (int32_t a = 0; a < MOTION_FEATURES_NUM_AXES; a++) {
+        axes[a].mean = sum[a] / MOTION_FEATURES_WINDOW_SIZE;
+    }
+
+    // Second pass: energy, peak and crossings about the mean
+    for (int32_t x = 0; x < MOTION_FEATURES_WINDOW_SIZE; x++) {
+        axisAdd(&(axes[0]), pSamples[x][0]);
+        axisAdd(&(axes[1]), pSamples[x][1]);
+        axisAdd(&(axes[2]), pSamples[x][2]);
+    }
+
+    pFeatures->peakMg = 0;
+    for (int32_t a = 0; a < MOTION_FEATURES_NUM_AXES; a++) {
+        total += axes[a].sumSquares;
+        if (axes[a].sumSquares > axes[dominant].sumSquares) {
+            dominant = a;
+        }
+        if (axes[a].peak > pFeatures->peakMg) {
+            pFeatures->peakMg = axes[a].peak;
+        }
+    }
+    pFeatures->rmsMg = LSB_TO_MG(isqrt((total << (RMS_FRACTION_BITS * 2)) /
+                                       MOTION_FEATURES_WINDOW_SIZE), RMS_FRACTION_BITS);
+    pFeatures->peakMg = LSB_TO_MG(pFeatures->peakMg, 0);
+    pFeatures->zeroCrossings = axes[dominant].crossings;
+    pFeatures->dominantAxis = dominant;
+}
+
+// Pack features into bytes.
+void motionFeaturesPack(const MotionFeatures *pFeatures, uint8_t *pBuf)
+{
+    uint16_t value;
+
+    value = saturateU16(pFeatures->rmsMg);
+    pBuf[0] = (uint8_t) value;
+    pBuf[1] = (uint8_t) (value >> 8);
+    value = saturateU16(pFeatures->peakMg);
+    pBuf[2] = (uint8_t) value;
+    pBuf[3] = (uint8_t) (value >> 8);
+    // There can't be more crossings than samples
+    pBuf[4] = (uint8_t) ((pFeatures->zeroCrossings > 0xff) ? 0xff : pFeatures->zeroCrossings);
+    pBuf[5] = (uint8_t) pFeatures->dominantAxis;
+}
+
+// Unpack what motionFeaturesPack() wrote.
+void motionFeaturesUnpack(const uint8_t *pBuf, MotionFeatures *pFeatures)
+{
+    pFeatures->rmsMg = ((int32_t) pBuf[0]) | (((int32_t) pBuf[1]) << 8);
+    pFeatures->peakMg = ((int32_t) pBuf[2]) | (((int32_t) pBuf[3]) << 8);
+    pFeatures->zeroCrossings = pBuf[4];
+    pFeatures->dominantAxis = pBuf[5];
+}
+
+// End Of File
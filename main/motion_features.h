@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _MOTION_FEATURES_H_
+#define _MOTION_FEATURES_H_
+
+/* Features of a window of accelerometer samples, computed on the
+ * device so that a handful of numbers go to the LWM2M server
+ * rather than the samples themselves.  For each axis the mean
+ * (i.e. gravity plus any steady acceleration) is taken out first,
+ * then:
+ *
+ * - RMS:            the RMS of the vector of what remains, i.e.
+ *                   how much the device is being shaken,
+ * - peak:           the largest excursion of any axis from its
+ *                   mean,
+ * - dominant axis:  the axis with the most energy,
+ * - zero crossings: the number of times the dominant axis crosses
+ *                   its mean, with MOTION_FEATURES_HYSTERESIS_LSB
+ *                   of hysteresis so that noise at rest doesn't
+ *                   count; with the window length this gives the
+ *                   frequency of the motion.
+ *
+ * The kernel is all integer arithmetic on a fixed length window
+ * with the axes as the inner loop, so that the compiler can unroll
+ * it; it runs on samples as read from the LIS2DW FIFO by
+ * lis2dw_fifo.c at ±2 g full scale.
+ *
+ * This file is also compiled on the host by the benchmark so it
+ * must not depend on ESP-IDF.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The number of axes in a sample.
+ */
+#define MOTION_FEATURES_NUM_AXES 3
+
+/** The number of samples in a window; at most 256 so that the
+ * sums of squares fit in 32 bits.
+ */
+#ifndef MOTION_FEATURES_WINDOW_SIZE
+# define MOTION_FEATURES_WINDOW_SIZE 128
+#endif
+
+/** The hysteresis applied when counting zero crossings, in units
+ * of the 12-bit samples the kernel works on (about 1 mg).
+ */
+#ifndef MOTION_FEATURES_HYSTERESIS_LSB
+# define MOTION_FEATURES_HYSTERESIS_LSB 16
+#endif
+
+/** The number of values in MotionFeatures, e.g. the number of
+ * channels when encoding them with ts_codec.c.
+ */
+#define MOTION_FEATURES_NUM_VALUES 4
+
+/** The number of bytes motionFeaturesPack() writes.
+ */
+#define MOTION_FEATURES_PACKED_SIZE 6
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** A sample: the left-justified output of each axis at ±2 g full
+ * scale, as read from OUT_X_L to OUT_Z_H.
+ */
+typedef int16_t MotionFeaturesSample[MOTION_FEATURES_NUM_AXES];
+
+/** The features of a window.
+ */
+typedef struct {
+    int32_t rmsMg;         //!< RMS of the acceleration about its mean.
+    int32_t peakMg;        //!< Largest excursion of any axis.
+    int32_t zeroCrossings; //!< Mean-crossings of the dominant axis.
+    int32_t dominantAxis;  //!< 0 for X, 1 for Y, 2 for Z.
+} MotionFeatures;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Compute the features of a window of samples.
+ *
+ * @param pSamples  MOTION_FEATURES_WINDOW_SIZE samples.
+ * @param pFeatures place to put the features.
+ */
+void motionFeaturesCompute(const MotionFeaturesSample *pSamples,
+                           MotionFeatures *pFeatures);
+
+/** Pack features into MOTION_FEATURES_PACKED_SIZE bytes, e.g. to
+ * keep them in the sample store; values which don't fit are
+ * saturated.
+ *
+ * @param pFeatures the features.
+ * @param pBuf      place to put MOTION_FEATURES_PACKED_SIZE bytes.
+ */
+void motionFeaturesPack(const MotionFeatures *pFeatures, uint8_t *pBuf);
+
+/** Unpack what motionFeaturesPack() wrote.
+ *
+ * @param pBuf      MOTION_FEATURES_PACKED_SIZE bytes.
+ * @param pFeatures place to put the features.
+ */
+void motionFeaturesUnpack(const uint8_t *pBuf, MotionFeatures *pFeatures);
+
+#endif // _MOTION_FEATURES_H_
+
+// End Of File
@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "esp_attr.h" // For RTC_DATA_ATTR
+#include "utilities.h"
+#include "channel_stats.h"
+#include "report_filter.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// Marks the start of a valid block.
+#define REPORT_FILTER_MAGIC 0x46494c54 // "FILT"
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+// What is kept for a channel.
+typedef struct {
+    ReportFilterChannel config;
+    int32_t reference;    // The value last reported.
+    int32_t latest;       // The value most recently added.
+    int32_t direction;    // The sign of the last reported move.
+    uint8_t hasReference;
+    uint8_t hasLatest;
+} ReportFilterChannelState;
+
+// The block kept in RTC memory.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t firmwareVersion;
+    int32_t maxSilenceSeconds;
+    uint32_t lastReportSeconds;
+    uint32_t sent;
+    uint32_t suppressed;
+    bool changed;
+    int32_t numChannels;
+    ReportFilterChannelState channels[REPORT_FILTER_MAX_CHANNELS];
+    uint32_t crc; // Must be last
+} ReportFilter;
+
+// ----------------------------------------------------------------
+// PRIVATE VARIABLES
+// ----------------------------------------------------------------
+
+// The block itself, in RTC slow memory.
+static RTC_DATA_ATTR ReportFilter gReportFilter;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// The CRC of everything except the CRC.
+static uint32_t calculateCrc()
+{
+    return utilitiesCrc32(0, &gReportFilter, offsetof(ReportFilter, crc));
+}
+
+// Update the CRC after a change.
+static void commit()
+{
+    gReportFilter.crc = calculateCrc();
+}
+
+// Find a configured channel, NULL if it isn't.
+static ReportFilterChannelState *pFindChannel(int32_t channelId)
+{
+    for (int32_t x = 0; x < gReportFilter.numChannels; x++) {
+        if (gReportFilter.channels[x].config.channelId == channelId) {
+            return &(gReportFilter.channels[x]);
+        }
+    }
+
+    return NULL;
+}
+
+// Determine whether a value of a channel is beyond its deadband.
+static bool isBeyondDeadband(const ReportFilterChannelState *pChannel,
+                             int32_t value)
+{
+    int32_t delta;
+    int32_t threshold;
+
+    if (!pChannel->hasReference) {
+        // Never reported
+        return true;
+    }
+    delta = value - pChannel->reference;
+    threshold = pChannel->config.deadband;
+    if (((delta > 0) && (pChannel->direction < 0)) ||
+        ((delta < 0) && (pChannel->direction > 0))) {
+        // Going back the way it came
+        threshold += pChannel->config.hysteresis;
+    }
+    if (delta < 0) {
+        delta = -delta;
+    }
+
+    return delta > threshold;
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Check the block at wake-up.
+int32_t reportFilterInit(uint32_t firmwareVersion, bool keep,
+                         uint32_t timeSeconds)
+{
+    bool valid = keep &&
+                 (gReportFilter.magic == REPORT_FILTER_MAGIC) &&
+                 (gReportFilter.version == REPORT_FILTER_VERSION) &&
+                 (gReportFilter.firmwareVersion == firmwareVersion) &&
+                 (gReportFilter.numChannels >= 0) &&
+                 (gReportFilter.numChannels <= REPORT_FILTER_MAX_CHANNELS) &&
+                 (gReportFilter.crc == calculateCrc());
+
+    if (!valid) {
+        memset(&gReportFilter, 0, sizeof(gReportFilter));
+        gReportFilter.magic = REPORT_FILTER_MAGIC;
+        gReportFilter.version = REPORT_FILTER_VERSION;
+        gReportFilter.firmwareVersion = firmwareVersion;
+        gReportFilter.lastReportSeconds = timeSeconds;
+        commit();
+    }
+
+    return gReportFilter.numChannels;
+}
+
+// Set the settings.
+void reportFilterSetConfig(const ReportFilterConfig *pConfig)
+{
+    ReportFilterChannelState channels[REPORT_FILTER_MAX_CHANNELS];
+    ReportFilterChannelState *pChannel;
+    int32_t numChannels = pConfig->numChannels;
+
+    if (numChannels > REPORT_FILTER_MAX_CHANNELS) {
+        numChannels = REPORT_FILTER_MAX_CHANNELS;
+    }
+    if (numChannels < 0) {
+        numChannels = 0;
+    }
+    memset(channels, 0, sizeof(channels));
+    for (int32_t x = 0; x < numChannels; x++) {
+        // Carry over what is known of channels already configured
+        pChannel = pFindChannel(pConfig->channels[x].channelId);
+        if (pChannel != NULL) {
+            channels[x] = *pChannel;
+        }
+        channels[x].config = pConfig->channels[x];
+    }
+    memcpy(gReportFilter.channels, channels, sizeof(channels));
+    gReportFilter.numChannels = numChannels;
+    gReportFilter.maxSilenceSeconds = pConfig->maxSilenceSeconds;
+    commit();
+}
+
+// Determine whether the filter is in use.
+bool reportFilterIsEnabled()
+{
+    return (gReportFilter.numChannels > 0) ||
+           (gReportFilter.maxSilenceSeconds > 0);
+}
+
+// Compare the values of a sample with their deadbands.
+bool reportFilterAdd(int32_t objectInstanceId, const int32_t *pValues,
+                     int32_t numValues)
+{
+    ReportFilterChannelState *pChannel;
+    bool found = false;
+
+    for (int32_t x = 0; x < numValues; x++) {
+        pChannel = pFindChannel(CHANNEL_STATS_ID(objectInstanceId, x));
+        if (pChannel != NULL) {
+            if (isBeyondDeadband(pChannel, pValues[x])) {
+                gReportFilter.changed = true;
+            }
+            pChannel->latest = pValues[x];
+            pChannel->hasLatest = true;
+            found = true;
+        }
+    }
+    if (found) {
+        commit();
+    }
+
+    return gReportFilter.changed;
+}
+
+// Determine whether a report is wanted.
+bool reportFilterIsDue(uint32_t timeSeconds)
+{
+    return !reportFilterIsEnabled() || gReportFilter.changed ||
+           ((gReportFilter.maxSilenceSeconds > 0) &&
+            (timeSeconds - gReportFilter.lastReportSeconds >=
+             (uint32_t) gReportFilter.maxSilenceSeconds));
+}
+
+// Record that a report was not wanted.
+void reportFilterSuppressed()
+{
+    gReportFilter.suppressed++;
+    commit();
+}
+
+// Record that a report has been made.
+void reportFilterReported(uint32_t timeSeconds)
+{
+    ReportFilterChannelState *pChannel;
+
+    for (int32_t x = 0; x < gReportFilter.numChannels; x++) {
+        pChannel = &(gReportFilter.channels[x]);
+        if (pChannel->hasLatest) {
+            if (pChannel->hasReference && (pChannel->latest != pChannel->reference)) {
+                pChannel->direction = (pChannel->latest > pChannel->reference) ? 1 : -1;
+            }
+            pChannel->reference = pChannel->latest;
+            pChannel->hasReference = true;
+        }
+    }
+    gReportFilter.changed = false;
+    gReportFilter.lastReportSeconds = timeSeconds;
+    gReportFilter.sent++;
+    commit();
+}
+
+// Get the number of reports made and suppressed.
+void reportFilterGetCounts(uint32_t *pSent, uint32_t *pSuppressed)
+{
+    if (pSent != NULL) {
+        *pSent = gReportFilter.sent;
+    }
+    if (pSuppressed != NULL) {
+        *pSuppressed = gReportFilter.suppressed;
+    }
+}
+
+// End Of File
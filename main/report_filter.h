@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _REPORT_FILTER_H_
+#define _REPORT_FILTER_H_
+
+/* Report-on-change: decides whether a wake on which a report is
+ * due by the clock is worth powering the modem for.  The LWM2M
+ * server sets, for any of the channels of channel_stats.h, a
+ * deadband and a hysteresis; every value of those channels is
+ * compared with the value last reported and a report is only
+ * wanted once one of them has moved by more than its deadband, or
+ * when nothing has been reported for longer than a maximum
+ * silence.
+ *
+ * The hysteresis is added to the deadband when a channel moves
+ * back the way it came, so that a reading dithering between two
+ * values doesn't cause a report every time while a steady drift is
+ * still reported as soon as it passes the deadband.
+ *
+ * With no channels configured every report goes ahead, as before.
+ * Like sample_store.c the settings and state are kept in a
+ * CRC-protected block of RTC slow memory, which is thrown away by
+ * reportFilterInit() if it doesn't check out.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The version of the report filter block; increment this when
+ * the layout of the block changes.
+ */
+#define REPORT_FILTER_VERSION 1
+
+/** The number of channels which can have a deadband.
+ */
+#ifndef REPORT_FILTER_MAX_CHANNELS
+# define REPORT_FILTER_MAX_CHANNELS 16
+#endif
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** The settings of a channel.
+ */
+typedef struct {
+    int32_t channelId;  //!< As made by CHANNEL_STATS_ID().
+    int32_t deadband;   //!< How far the channel must move from the
+                        //!< value last reported for a report.
+    int32_t hysteresis; //!< Added to deadband when the channel
+                        //!< moves back the way it last moved.
+} ReportFilterChannel;
+
+/** The settings of the filter, as written by the LWM2M server.
+ */
+typedef struct {
+    int32_t maxSilenceSeconds; //!< The longest time without a
+                               //!< report, zero for no limit.
+    int32_t numChannels;
+    ReportFilterChannel channels[REPORT_FILTER_MAX_CHANNELS];
+} ReportFilterConfig;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Check the report filter at wake-up, resetting it if the block
+ * is not valid; the settings are then lost until the server is
+ * next read.  Call this once, after rtcStateInit().
+ *
+ * @param firmwareVersion as passed to rtcStateInit().
+ * @param keep            false to reset regardless, e.g. because
+ *                        this is not a warm wake.
+ * @param timeSeconds     the time now.
+ * @return                the number of channels configured.
+ */
+int32_t reportFilterInit(uint32_t firmwareVersion, bool keep,
+                         uint32_t timeSeconds);
+
+/** Set the settings, as read from the LWM2M server.  The values
+ * last reported are kept for channels which were already
+ * configured.
+ *
+ * @param pConfig the settings; anything beyond
+ *                REPORT_FILTER_MAX_CHANNELS is ignored.
+ */
+void reportFilterSetConfig(const ReportFilterConfig *pConfig);
+
+/** Determine whether the filter is in use, i.e. whether the
+ * server has configured any channels or a maximum silence.
+ *
+ * @return true if the filter is in use.
+ */
+bool reportFilterIsEnabled();
+
+/** Compare the values of a sample with the deadbands of their
+ * channels; values of channels which aren't configured are
+ * ignored.
+ *
+ * @param objectInstanceId the I2C Generic Command instance the
+ *                         values came from, or
+ *                         SAMPLE_STORE_INSTANCE_ID_MOTION.
+ * @param pValues          the values, one per channel.
+ * @param numValues        the number of values.
+ * @return                 true if a channel has moved beyond its
+ *                         deadband since the last report.
+ */
+bool reportFilterAdd(int32_t objectInstanceId, const int32_t *pValues,
+                     int32_t numValues);
+
+/** Determine whether a report is wanted: a channel has moved
+ * beyond its deadband, the maximum silence has expired or the
+ * filter is not in use.
+ *
+ * @param timeSeconds the time now.
+ * @return            true if a report is wanted.
+ */
+bool reportFilterIsDue(uint32_t timeSeconds);
+
+/** Record that a report was due by the clock but was not wanted.
+ */
+void reportFilterSuppressed();
+
+/** Record that a report has been made: the latest value of each
+ * channel becomes the value it is compared with from now on.
+ *
+ * @param timeSeconds the time now.
+ */
+void reportFilterReported(uint32_t timeSeconds);
+
+/** Get the number of reports made and suppressed since the block
+ * was last reset.
+ *
+ * @param pSent       place to put the number of reports made; may
+ *                    be NULL.
+ * @param pSuppressed place to put the number of reports
+ *                    suppressed; may be NULL.
+ */
+void reportFilterGetCounts(uint32_t *pSent, uint32_t *pSuppressed);
+
+#endif // _REPORT_FILTER_H_
+
+// End Of File
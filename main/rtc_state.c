@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "esp_attr.h" // For RTC_DATA_ATTR
+#include "utilities.h"
+#include "rtc_state.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// Marks the start of a valid block.
+#define RTC_STATE_MAGIC 0x57485245 // "WHRE"
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+// The block kept in RTC memory.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t firmwareVersion;
+    uint32_t verifiedFlags;
+    uint32_t warmWakeCount;
+    uint32_t wifiChannels;
+    uint32_t crc; // Must be last
+} RtcState;
+
+// ----------------------------------------------------------------
+// PRIVATE VARIABLES
+// ----------------------------------------------------------------
+
+// The block itself, in RTC slow memory.
+static RTC_DATA_ATTR RtcState gRtcState;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// The CRC of everything except the CRC.
+static uint32_t calculateCrc()
+{
+    return utilitiesCrc32(0, &gRtcState, offsetof(RtcState, crc));
+}
+
+// Update the CRC after a change.
+static void commit()
+{
+    gRtcState.crc = calculateCrc();
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Check the block at wake-up.
+bool rtcStateInit(uint32_t firmwareVersion, bool warmWake)
+{
+    bool valid = warmWake &&
+                 (gRtcState.magic == RTC_STATE_MAGIC) &&
+                 (gRtcState.version == RTC_STATE_VERSION) &&
+                 (gRtcState.firmwareVersion == firmwareVersion) &&
+                 (gRtcState.crc == calculateCrc());
+
+    if (valid) {
+        gRtcState.warmWakeCount++;
+    } else {
+        memset(&gRtcState, 0, sizeof(gRtcState));
+        gRtcState.magic = RTC_STATE_MAGIC;
+        gRtcState.version = RTC_STATE_VERSION;
+        gRtcState.firmwareVersion = firmwareVersion;
+    }
+    commit();
+
+    return valid;
+}
+
+// Determine whether a set of flags is verified.
+bool rtcStateIsVerified(uint32_t flags)
+{
+    return (gRtcState.verifiedFlags & flags) == flags;
+}
+
+// Mark flags as verified.
+void rtcStateSetVerified(uint32_t flags)
+{
+    gRtcState.verifiedFlags |= flags;
+    commit();
+}
+
+// Mark flags as no longer verified.
+void rtcStateClearVerified(uint32_t flags)
+{
+    gRtcState.verifiedFlags &= ~flags;
+    commit();
+}
+
+// Return the number of consecutive warm wakes.
+uint32_t rtcStateWarmWakeCount()
+{
+    return gRtcState.warmWakeCount;
+}
+
+// Return the Wifi channels seen last time.
+uint32_t rtcStateGetWifiChannels()
+{
+    return gRtcState.wifiChannels;
+}
+
+// Remember the Wifi channels seen.
+void rtcStateSetWifiChannels(uint32_t channelBitmap)
+{
+    gRtcState.wifiChannels = channelBitmap;
+    commit();
+}
+
+// End Of File
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _RTC_STATE_H_
+#define _RTC_STATE_H_
+
+/* State that survives deep sleep in RTC slow memory, recording
+ * what has already been verified about SARA-R4 and LWM2M so that
+ * warm wakes can skip the AT round-trips which check it again.
+ * The block is versioned and CRC-protected: if the CRC is wrong
+ * (e.g. RTC memory was not kept powered) or the firmware has
+ * changed, everything is considered unverified.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The version of the RTC state block; increment this when the
+ * layout of RtcState changes.
+ */
+#define RTC_STATE_VERSION 2
+
+/** SARA-R4 has been found to have the right MNO profile.
+ */
+#define RTC_STATE_VERIFIED_MNO_PROFILE      0x0001
+
+/** SARA-R4 has been found to have the right RAT.
+ */
+#define RTC_STATE_VERIFIED_RAT              0x0002
+
+/** The WHRE LWM2M Security object exists.
+ */
+#define RTC_STATE_VERIFIED_LWM2M_SECURITY   0x0004
+
+/** The WHRE LWM2M Server object exists.
+ */
+#define RTC_STATE_VERIFIED_LWM2M_SERVER     0x0008
+
+/** The I2C Generic Command object exists.
+ */
+#define RTC_STATE_VERIFIED_LWM2M_I2C        0x0010
+
+/** The Location object exists.
+ */
+#define RTC_STATE_VERIFIED_LWM2M_LOCATION   0x0020
+
+/** The LEDs have been through their start-up display.
+ */
+#define RTC_STATE_VERIFIED_LED_INIT         0x0040
+
+/** The WHRE Motion Features object exists.
+ */
+#define RTC_STATE_VERIFIED_LWM2M_MOTION     0x0080
+
+/** The WHRE Channel Statistics object exists.
+ */
+#define RTC_STATE_VERIFIED_LWM2M_STATISTICS 0x0100
+
+/** The WHRE Report Filter object exists.
+ */
+#define RTC_STATE_VERIFIED_LWM2M_FILTER     0x0200
+
+/** The WHRE Operating Parameters object exists.
+ */
+#define RTC_STATE_VERIFIED_LWM2M_OPERATING  0x0400
+
+/** The Modem Configuration object exists.
+ */
+#define RTC_STATE_VERIFIED_LWM2M_MODEM      0x0800
+
+/** The WHRE Event Log object exists.
+ */
+#define RTC_STATE_VERIFIED_LWM2M_EVENT_LOG  0x1000
+
+/** All of the LWM2M objects exist.
+ */
+#define RTC_STATE_VERIFIED_LWM2M_ALL        (RTC_STATE_VERIFIED_LWM2M_SECURITY | \
+                                             RTC_STATE_VERIFIED_LWM2M_SERVER |   \
+                                             RTC_STATE_VERIFIED_LWM2M_I2C |      \
+                                             RTC_STATE_VERIFIED_LWM2M_LOCATION | \
+                                             RTC_STATE_VERIFIED_LWM2M_MOTION |   \
+                                             RTC_STATE_VERIFIED_LWM2M_STATISTICS | \
+                                             RTC_STATE_VERIFIED_LWM2M_FILTER |   \
+                                             RTC_STATE_VERIFIED_LWM2M_OPERATING | \
+                                             RTC_STATE_VERIFIED_LWM2M_MODEM |    \
+                                             RTC_STATE_VERIFIED_LWM2M_EVENT_LOG)
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Check the RTC state block, resetting it if it is invalid or
+ * belongs to different firmware.  Call this once at wake-up.
+ *
+ * @param firmwareVersion a value which changes with every
+ *                        firmware build.
+ * @param warmWake        true if this is a wake from deep sleep
+ *                        (timer or EXT1); on any other wake the
+ *                        block is reset.
+ * @return                true if the block was valid, i.e. this
+ *                        is a warm wake with retained state.
+ */
+bool rtcStateInit(uint32_t firmwareVersion, bool warmWake);
+
+/** Determine whether everything in a set of flags has been
+ * verified.
+ *
+ * @param flags a bitmap of RTC_STATE_VERIFIED_xxx flags.
+ * @return      true if all of them are verified.
+ */
+bool rtcStateIsVerified(uint32_t flags);
+
+/** Mark a set of flags as verified.
+ *
+ * @param flags a bitmap of RTC_STATE_VERIFIED_xxx flags.
+ */
+void rtcStateSetVerified(uint32_t flags);
+
+/** Mark a set of flags as no longer verified, e.g. because
+ * something that depended on them failed.
+ *
+ * @param flags a bitmap of RTC_STATE_VERIFIED_xxx flags.
+ */
+void rtcStateClearVerified(uint32_t flags);
+
+/** Return the number of consecutive warm wakes.
+ *
+ * @return the number of warm wakes since the block was reset.
+ */
+uint32_t rtcStateWarmWakeCount();
+
+/** Return the Wifi channels on which access points were seen
+ * during the last scan.
+ *
+ * @return a bitmap, bit n set for channel n; zero if unknown.
+ */
+uint32_t rtcStateGetWifiChannels();
+
+/** Remember the Wifi channels on which access points were seen.
+ *
+ * @param channelBitmap bit n set for channel n.
+ */
+void rtcStateSetWifiChannels(uint32_t channelBitmap);
+
+#endif // _RTC_STATE_H_
+
+// End Of File
@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "esp_attr.h" // For RTC_DATA_ATTR
+#include "utilities.h"
+#include "sample_store.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// Marks the start of a valid block.
+#define SAMPLE_STORE_MAGIC 0x53414d50 // "SAMP"
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+// The block kept in RTC memory.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t firmwareVersion;
+    int32_t oldest;       // Index of the oldest sample in samples[].
+    int32_t count;        // Number of samples in samples[].
+    uint32_t dropped;
+    int32_t numCommands;
+    I2cCommandSnapshot commands[I2C_INTERPRETER_MAX_INSTANCES];
+    SampleStoreSample samples[SAMPLE_STORE_MAX_SAMPLES];
+    uint32_t crc; // Must be last
+} SampleStore;
+
+// ----------------------------------------------------------------
+// PRIVATE VARIABLES
+// ----------------------------------------------------------------
+
+// The block itself, in RTC slow memory.
+static RTC_DATA_ATTR SampleStore gSampleStore;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// The CRC of everything except the CRC.
+static uint32_t calculateCrc()
+{
+    return utilitiesCrc32(0, &gSampleStore, offsetof(SampleStore, crc));
+}
+
+// Update the CRC after a change.
+static void commit()
+{
+    gSampleStore.crc = calculateCrc();
+}
+
+// Add a sample to the ring, without updating the CRC.
+static void addSample(int32_t objectInstanceId, const uint8_t *pData,
+                      int32_t length, uint32_t timeSeconds)
+{
+    SampleStoreSample *pSample;
+
+    if (gSampleStore.count >= SAMPLE_STORE_MAX_SAMPLES) {
+        // Full: lose the oldest
+        gSampleStore.oldest = (gSampleStore.oldest + 1) % SAMPLE_STORE_MAX_SAMPLES;
+        gSampleStore.count--;
+        gSampleStore.dropped++;
+    }
+    pSample = &(gSampleStore.samples[(gSampleStore.oldest + gSampleStore.count) %
+                                     SAMPLE_STORE_MAX_SAMPLES]);
+    pSample->timeSeconds = timeSeconds;
+    pSample->objectInstanceId = (uint8_t) objectInstanceId;
+    if (length > (int32_t) sizeof(pSample->data)) {
+        length = sizeof(pSample->data);
+    }
+    pSample->length = (uint8_t) length;
+    memcpy(pSample->data, pData, length);
+    gSampleStore.count++;
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Check the block at wake-up.
+int32_t sampleStoreInit(uint32_t firmwareVersion, bool keep)
+{
+    bool valid = keep &&
+                 (gSampleStore.magic == SAMPLE_STORE_MAGIC) &&
+                 (gSampleStore.version == SAMPLE_STORE_VERSION) &&
+                 (gSampleStore.firmwareVersion == firmwareVersion) &&
+                 (gSampleStore.oldest >= 0) &&
+                 (gSampleStore.oldest < SAMPLE_STORE_MAX_SAMPLES) &&
+                 (gSampleStore.count >= 0) &&
+                 (gSampleStore.count <= SAMPLE_STORE_MAX_SAMPLES) &&
+                 (gSampleStore.numCommands >= 0) &&
+                 (gSampleStore.numCommands <= I2C_INTERPRETER_MAX_INSTANCES) &&
+                 (gSampleStore.crc == calculateCrc());
+
+    if (!valid) {
+        memset(&gSampleStore, 0, sizeof(gSampleStore));
+        gSampleStore.magic = SAMPLE_STORE_MAGIC;
+        gSampleStore.version = SAMPLE_STORE_VERSION;
+        gSampleStore.firmwareVersion = firmwareVersion;
+        commit();
+    }
+
+    return gSampleStore.count;
+}
+
+// Remember the I2C Generic Command instances.
+void sampleStoreSetCommands(const I2cCommandSnapshot *pSnapshots,
+                            int32_t numSnapshots)
+{
+    if (numSnapshots > I2C_INTERPRETER_MAX_INSTANCES) {
+        numSnapshots = I2C_INTERPRETER_MAX_INSTANCES;
+    }
+    if (numSnapshots < 0) {
+        numSnapshots = 0;
+    }
+    memcpy(gSampleStore.commands, pSnapshots, numSnapshots * sizeof(pSnapshots[0]));
+    gSampleStore.numCommands = numSnapshots;
+    commit();
+}
+
+// Get a copy of the remembered I2C Generic Command instances.
+int32_t sampleStoreGetCommands(I2cCommandSnapshot *pSnapshots)
+{
+    for (int32_t x = 0; (pSnapshots != NULL) && (x < gSampleStore.numCommands); x++) {
+        pSnapshots[x] = gSampleStore.commands[x];
+        pSnapshots[x].dirty = 0;
+    }
+
+    return gSampleStore.numCommands;
+}
+
+// Add the readings in a set of snapshots to the ring.
+int32_t sampleStoreAdd(const I2cCommandSnapshot *pSnapshots,
+                       int32_t numSnapshots, uint32_t timeSeconds)
+{
+    int32_t numAdded = 0;
+
+    for (int32_t x = 0; x < numSnapshots; x++) {
+        if (pSnapshots[x].readResponse.length > 0) {
+            addSample(pSnapshots[x].objectInstanceId,
+                      pSnapshots[x].readResponse.sequence,
+                      pSnapshots[x].readResponse.length, timeSeconds);
+            numAdded++;
+        }
+    }
+    if (numAdded > 0) {
+        commit();
+    }
+
+    return numAdded;
+}
+
+// Add a sample that didn't come from a snapshot.
+void sampleStoreAddData(int32_t objectInstanceId, const uint8_t *pData,
+                        int32_t length, uint32_t timeSeconds)
+{
+    addSample(objectInstanceId, pData, length, timeSeconds);
+    commit();
+}
+
+// Return the number of samples in the ring.
+int32_t sampleStoreCount()
+{
+    return gSampleStore.count;
+}
+
+// Determine whether the ring is full.
+bool sampleStoreIsFull()
+{
+    return gSampleStore.count >= SAMPLE_STORE_MAX_SAMPLES;
+}
+
+// Get a sample.
+int32_t sampleStoreGet(int32_t index, SampleStoreSample *pSample)
+{
+    if ((index < 0) || (index >= gSampleStore.count)) {
+        return -1;
+    }
+    *pSample = gSampleStore.samples[(gSampleStore.oldest + index) %
+                                    SAMPLE_STORE_MAX_SAMPLES];
+
+    return 0;
+}
+
+// Remove samples, oldest first.
+void sampleStoreDiscard(int32_t count)
+{
+    if (count > gSampleStore.count) {
+        count = gSampleStore.count;
+    }
+    if (count > 0) {
+        gSampleStore.oldest = (gSampleStore.oldest + count) % SAMPLE_STORE_MAX_SAMPLES;
+        gSampleStore.count -= count;
+        commit();
+    }
+}
+
+// Remove chosen samples.
+int32_t sampleStoreRemove(const bool *pRemove, int32_t count)
+{
+    int32_t numKept = 0;
+
+    if (count > gSampleStore.count) {
+        count = gSampleStore.count;
+    }
+    // Move each sample that stays down over those that go
+    for (int32_t x = 0; x < gSampleStore.count; x++) {
+        if ((x >= count) || !pRemove[x]) {
+            if (numKept != x) {
+                gSampleStore.samples[(gSampleStore.oldest + numKept) % SAMPLE_STORE_MAX_SAMPLES] =
+                    gSampleStore.samples[(gSampleStore.oldest + x) % SAMPLE_STORE_MAX_SAMPLES];
+            }
+            numKept++;
+        }
+    }
+    count = gSampleStore.count - numKept;
+    if (count > 0) {
+        gSampleStore.count = numKept;
+        commit();
+    }
+
+    return count;
+}
+
+// Return the number of samples dropped.
+uint32_t sampleStoreDropped()
+{
+    return gSampleStore.dropped;
+}
+
+// End Of File
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _SAMPLE_STORE_H_
+#define _SAMPLE_STORE_H_
+
+/* A ring buffer of timestamped sensor samples in RTC slow memory,
+ * so that sensors can be read on wakes where the modem is left
+ * off and the samples sent to the LWM2M server in one batch on a
+ * later wake.  When the ring is full the oldest sample is
+ * overwritten and counted as dropped.
+ *
+ * The I2C Generic Command instances last read from the server are
+ * kept alongside the samples: they are the "program" that is run
+ * on wakes where the server can't be asked for it.
+ *
+ * Like rtc_state.c the block is CRC-protected; anything that
+ * doesn't check out is thrown away by sampleStoreInit().
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "i2c_command.h"
+#include "i2c_interpreter.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The version of the sample store block; increment this when
+ * the layout of SampleStoreSample or the block changes.
+ */
+#define SAMPLE_STORE_VERSION 2
+
+/** The number of samples the ring can hold; each takes
+ * sizeof(SampleStoreSample) bytes of the 8 kbytes of RTC slow
+ * memory.
+ */
+#ifndef SAMPLE_STORE_MAX_SAMPLES
+# define SAMPLE_STORE_MAX_SAMPLES 128
+#endif
+
+/** The most bytes of a reading kept in a sample, which is also
+ * the most channels a sample can have in a batch; the rest of a
+ * longer Read Response is not stored.  This is kept well below
+ * I2C_SEQUENCE_READ_MAX_LENGTH since there are
+ * SAMPLE_STORE_MAX_SAMPLES of them in RTC memory.
+ */
+#ifndef SAMPLE_STORE_MAX_DATA_LENGTH
+# define SAMPLE_STORE_MAX_DATA_LENGTH 10
+#endif
+
+/** The objectInstanceId of samples which are the features of a
+ * window of accelerometer samples (see motion_features.h) rather
+ * than the readings of an I2C Generic Command instance.
+ */
+#define SAMPLE_STORE_INSTANCE_ID_MOTION 0xff
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** A sample: what one I2C Generic Command instance read back.
+ */
+typedef struct {
+    uint32_t timeSeconds;     //!< When, from gettimeofday().
+    uint8_t objectInstanceId; //!< The I2C Generic Command instance.
+    uint8_t length;           //!< The number of bytes in data[].
+    uint8_t data[SAMPLE_STORE_MAX_DATA_LENGTH];
+} SampleStoreSample;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Check the sample store at wake-up, emptying it if the block
+ * is not valid.  Call this once, after rtcStateInit().
+ *
+ * @param firmwareVersion as passed to rtcStateInit().
+ * @param keep            false to empty the store regardless,
+ *                        e.g. because this is not a warm wake.
+ * @return                the number of samples kept.
+ */
+int32_t sampleStoreInit(uint32_t firmwareVersion, bool keep);
+
+/** Remember the I2C Generic Command instances to run on wakes
+ * where the server can't be asked for them.
+ *
+ * @param pSnapshots   the instances, as read from the server.
+ * @param numSnapshots the number of instances, at most
+ *                     I2C_INTERPRETER_MAX_INSTANCES.
+ */
+void sampleStoreSetCommands(const I2cCommandSnapshot *pSnapshots,
+                            int32_t numSnapshots);
+
+/** Get a copy of the remembered I2C Generic Command instances.
+ *
+ * @param pSnapshots storage for I2C_INTERPRETER_MAX_INSTANCES
+ *                   snapshots; may be NULL to just find out how
+ *                   many there are.
+ * @return           the number of snapshots copied, zero if there
+ *                   are none.
+ */
+int32_t sampleStoreGetCommands(I2cCommandSnapshot *pSnapshots);
+
+/** Add the readings in a set of snapshots to the ring as samples,
+ * one for each snapshot which read something back.
+ *
+ * @param pSnapshots   the snapshots, after i2cInterpreterRun().
+ * @param numSnapshots the number of snapshots.
+ * @param timeSeconds  the time to stamp the samples with.
+ * @return             the number of samples added.
+ */
+int32_t sampleStoreAdd(const I2cCommandSnapshot *pSnapshots,
+                       int32_t numSnapshots, uint32_t timeSeconds);
+
+/** Add a sample which did not come from an I2C Generic Command
+ * instance, e.g. motion features.
+ *
+ * @param objectInstanceId what the sample is, e.g.
+ *                         SAMPLE_STORE_INSTANCE_ID_MOTION.
+ * @param pData            the data.
+ * @param length           the number of bytes at pData; anything
+ *                         beyond SAMPLE_STORE_MAX_DATA_LENGTH is
+ *                         lost.
+ * @param timeSeconds      the time to stamp the sample with.
+ */
+void sampleStoreAddData(int32_t objectInstanceId, const uint8_t *pData,
+                        int32_t length, uint32_t timeSeconds);
+
+/** Return the number of samples in the ring.
+ *
+ * @return the number of samples.
+ */
+int32_t sampleStoreCount();
+
+/** Determine whether the ring is full, i.e. the next sample
+ * added will overwrite the oldest.
+ *
+ * @return true if the ring is full.
+ */
+bool sampleStoreIsFull();
+
+/** Get a sample, without removing it.
+ *
+ * @param index   0 for the oldest sample.
+ * @param pSample place to put the sample.
+ * @return        zero on success, else negative error code.
+ */
+int32_t sampleStoreGet(int32_t index, SampleStoreSample *pSample);
+
+/** Remove samples, oldest first, e.g. once they have been sent.
+ *
+ * @param count the number of samples to remove.
+ */
+void sampleStoreDiscard(int32_t count);
+
+/** Remove chosen samples, e.g. those that have been sent, keeping
+ * the rest in order.
+ *
+ * @param pRemove true for each sample to remove, index 0 being
+ *                the oldest.
+ * @param count   the number of entries at pRemove; samples beyond
+ *                them are kept.
+ * @return        the number of samples removed.
+ */
+int32_t sampleStoreRemove(const bool *pRemove, int32_t count);
+
+/** Return the number of samples overwritten before they could be
+ * sent since the store was last emptied by sampleStoreInit().
+ *
+ * @return the number of samples dropped.
+ */
+uint32_t sampleStoreDropped();
+
+#endif // _SAMPLE_STORE_H_
+
+// End Of File
@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "utilities.h"
+#include "sleep_scheduler.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// Marks a valid scheduler.
+#define SLEEP_SCHEDULER_MAGIC 0x534c4550 // "SLEP"
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// The CRC of everything except the CRC.
+static uint32_t calculateCrc(const SleepScheduler *pScheduler)
+{
+    return utilitiesCrc32(0, pScheduler, offsetof(SleepScheduler, crc));
+}
+
+// Update the CRC after a change.
+static void commit(SleepScheduler *pScheduler)
+{
+    pScheduler->crc = calculateCrc(pScheduler);
+}
+
+// The number of seconds from one time to another, negative if the
+// second is earlier; correct across the wrap of a uint32_t.
+static int32_t secondsUntil(uint32_t fromSeconds, uint32_t toSeconds)
+{
+    return (int32_t) (toSeconds - fromSeconds);
+}
+
+// The deadline of a periodic activity after the one just done,
+// keeping the phase and skipping deadlines already missed.
+static uint32_t nextDeadline(const SleepScheduler *pScheduler,
+                             int32_t activity, uint32_t timeSeconds)
+{
+    int32_t interval = pScheduler->intervalSeconds[activity];
+    int32_t late = secondsUntil(pScheduler->deadlineSeconds[activity], timeSeconds);
+
+    if (late < 0) {
+        // Done early, inside the tolerance window
+        return pScheduler->deadlineSeconds[activity] + interval;
+    }
+
+    return pScheduler->deadlineSeconds[activity] + (((late / interval) + 1) * interval);
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Check the scheduler at wake-up.
+bool sleepSchedulerInit(SleepScheduler *pScheduler,
+                        uint32_t firmwareVersion, bool keep)
+{
+    bool valid = keep &&
+                 (pScheduler->magic == SLEEP_SCHEDULER_MAGIC) &&
+                 (pScheduler->version == SLEEP_SCHEDULER_VERSION) &&
+                 (pScheduler->firmwareVersion == firmwareVersion) &&
+                 (pScheduler->crc == calculateCrc(pScheduler));
+
+    if (!valid) {
+        memset(pScheduler, 0, sizeof(*pScheduler));
+        pScheduler->magic = SLEEP_SCHEDULER_MAGIC;
+        pScheduler->version = SLEEP_SCHEDULER_VERSION;
+        pScheduler->firmwareVersion = firmwareVersion;
+        commit(pScheduler);
+    }
+
+    return valid;
+}
+
+// Set the interval of a periodic activity.
+void sleepSchedulerSetInterval(SleepScheduler *pScheduler,
+                               SleepSchedulerActivity activity,
+                               int32_t intervalSeconds,
+                               uint32_t timeSeconds)
+{
+    uint32_t bit = SLEEP_SCHEDULER_BIT(activity);
+
+    if (intervalSeconds < 0) {
+        intervalSeconds = 0;
+    }
+    if (intervalSeconds > 0) {
+        if ((pScheduler->pending & bit) == 0) {
+            // Never done: due now
+            pScheduler->deadlineSeconds[activity] = timeSeconds;
+            pScheduler->pending |= bit;
+        } else if (secondsUntil(timeSeconds,
+                                pScheduler->deadlineSeconds[activity]) > intervalSeconds) {
+            pScheduler->deadlineSeconds[activity] = timeSeconds + intervalSeconds;
+        }
+    }
+    pScheduler->intervalSeconds[activity] = intervalSeconds;
+    commit(pScheduler);
+}
+
+// Set the deadline of an activity.
+void sleepSchedulerSetDeadline(SleepScheduler *pScheduler,
+                               SleepSchedulerActivity activity,
+                               uint32_t deadlineSeconds)
+{
+    uint32_t bit = SLEEP_SCHEDULER_BIT(activity);
+
+    if (((pScheduler->pending & bit) == 0) ||
+        (secondsUntil(pScheduler->deadlineSeconds[activity], deadlineSeconds) < 0)) {
+        pScheduler->deadlineSeconds[activity] = deadlineSeconds;
+        pScheduler->pending |= bit;
+        commit(pScheduler);
+    }
+}
+
+// Set the shortest sleep and the tolerance window.
+void sleepSchedulerSetLimits(SleepScheduler *pScheduler,
+                             int32_t minSleepSeconds,
+                             int32_t toleranceSeconds)
+{
+    pScheduler->minSleepSeconds = (minSleepSeconds > 0) ? minSleepSeconds : 0;
+    pScheduler->toleranceSeconds = (toleranceSeconds > 0) ? toleranceSeconds : 0;
+    commit(pScheduler);
+}
+
+// Record a wake.
+void sleepSchedulerWake(SleepScheduler *pScheduler, uint32_t timeSeconds)
+{
+    pScheduler->lastWakeSeconds = timeSeconds;
+    commit(pScheduler);
+}
+
+// Determine whether a wake is too soon after the previous one.
+bool sleepSchedulerIsTooSoon(const SleepScheduler *pScheduler,
+                             uint32_t timeSeconds)
+{
+    return secondsUntil(timeSeconds, sleepSchedulerMinSleepEnd(pScheduler)) > 0;
+}
+
+// Return the time at which the shortest sleep is up.
+uint32_t sleepSchedulerMinSleepEnd(const SleepScheduler *pScheduler)
+{
+    return pScheduler->lastWakeSeconds + pScheduler->minSleepSeconds;
+}
+
+// Determine whether an activity has a deadline.
+bool sleepSchedulerIsPending(const SleepScheduler *pScheduler,
+                             SleepSchedulerActivity activity)
+{
+    return (pScheduler->pending & SLEEP_SCHEDULER_BIT(activity)) != 0;
+}
+
+// Get the activities which are due.
+uint32_t sleepSchedulerDue(const SleepScheduler *pScheduler,
+                           uint32_t timeSeconds)
+{
+    uint32_t due = 0;
+
+    for (int32_t x = 0; x < SLEEP_SCHEDULER_NUM_ACTIVITIES; x++) {
+        if ((pScheduler->pending & SLEEP_SCHEDULER_BIT(x)) &&
+            (secondsUntil(timeSeconds, pScheduler->deadlineSeconds[x]) <=
+             pScheduler->toleranceSeconds)) {
+            due |= SLEEP_SCHEDULER_BIT(x);
+        }
+    }
+
+    return due;
+}
+
+// Record that activities have been done.
+void sleepSchedulerDone(SleepScheduler *pScheduler, uint32_t activities,
+                        uint32_t timeSeconds)
+{
+    activities &= pScheduler->pending;
+    for (int32_t x = 0; x < SLEEP_SCHEDULER_NUM_ACTIVITIES; x++) {
+        if (activities & SLEEP_SCHEDULER_BIT(x)) {
+            if (pScheduler->intervalSeconds[x] > 0) {
+                pScheduler->deadlineSeconds[x] = nextDeadline(pScheduler, x,
+                                                              timeSeconds);
+            } else {
+                pScheduler->pending &= ~SLEEP_SCHEDULER_BIT(x);
+            }
+        }
+    }
+    commit(pScheduler);
+}
+
+// Record that activities have failed.
+void sleepSchedulerRetry(SleepScheduler *pScheduler, uint32_t activities,
+                         int32_t backOffSeconds, uint32_t timeSeconds)
+{
+    uint32_t retrySeconds = timeSeconds + ((backOffSeconds > 0) ? backOffSeconds : 0);
+    uint32_t deadlineSeconds;
+
+    activities &= pScheduler->pending;
+    for (int32_t x = 0; x < SLEEP_SCHEDULER_NUM_ACTIVITIES; x++) {
+        if (activities & SLEEP_SCHEDULER_BIT(x)) {
+            deadlineSeconds = retrySeconds;
+            if ((pScheduler->intervalSeconds[x] > 0) &&
+                (secondsUntil(retrySeconds, nextDeadline(pScheduler, x, timeSeconds)) <= 0)) {
+                deadlineSeconds = nextDeadline(pScheduler, x, timeSeconds);
+            }
+            pScheduler->deadlineSeconds[x] = deadlineSeconds;
+        }
+    }
+    commit(pScheduler);
+}
+
+// Get how long to sleep for.
+int32_t sleepSchedulerSleepSeconds(const SleepScheduler *pScheduler,
+                                   uint32_t timeSeconds)
+{
+    int32_t sleepSeconds = SLEEP_SCHEDULER_MAX_SLEEP_SECONDS;
+    int32_t untilDeadline;
+
+    for (int32_t x = 0; x < SLEEP_SCHEDULER_NUM_ACTIVITIES; x++) {
+        if (pScheduler->pending & SLEEP_SCHEDULER_BIT(x)) {
+            untilDeadline = secondsUntil(timeSeconds, pScheduler->deadlineSeconds[x]);
+            if (untilDeadline < sleepSeconds) {
+                sleepSeconds = untilDeadline;
+            }
+        }
+    }
+    if (sleepSeconds < pScheduler->minSleepSeconds) {
+        sleepSeconds = pScheduler->minSleepSeconds;
+    }
+    if (sleepSeconds < 1) {
+        sleepSeconds = 1;
+    }
+
+    return sleepSeconds;
+}
+
+// End Of File
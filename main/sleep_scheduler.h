@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _SLEEP_SCHEDULER_H_
+#define _SLEEP_SCHEDULER_H_
+
+/* Decides when to wake up.  Each activity (taking a sample,
+ * reporting, getting a location fix, an I2C trigger) has its next
+ * deadline; the RTC timer is set for the earliest of them and, on
+ * waking, every activity whose deadline falls within a tolerance
+ * window of now is done as well, so that one wake serves several
+ * deadlines which are close together instead of each having a wake
+ * of its own.  Periodic activities keep their phase: the next
+ * deadline is the last one plus the interval, not the time the
+ * activity happened to be done plus the interval.
+ *
+ * The intervals come from the WHRE Operating Parameters object:
+ * Host Wake up Interval for samples, Reporting Interval for reports
+ * and Host Minimum Sleep Interval, below which the device never
+ * sleeps and inside which external wakes are put off.
+ *
+ * The state is a SleepScheduler which the caller keeps, in RTC
+ * slow memory on the target; like rtc_state.c it is CRC-protected
+ * and anything that doesn't check out is thrown away by
+ * sleepSchedulerInit().  This file is also compiled on the host by
+ * the schedule simulator so it must not depend on ESP-IDF.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The version of SleepScheduler; increment this when its layout
+ * changes.
+ */
+#define SLEEP_SCHEDULER_VERSION 1
+
+/** The longest the device sleeps for, when nothing has a deadline.
+ */
+#ifndef SLEEP_SCHEDULER_MAX_SLEEP_SECONDS
+# define SLEEP_SCHEDULER_MAX_SLEEP_SECONDS (24 * 60 * 60)
+#endif
+
+/** The bit for an activity in a set of activities.
+ */
+#define SLEEP_SCHEDULER_BIT(activity) (1UL << (activity))
+
+/** The activities which need the modem.
+ */
+#define SLEEP_SCHEDULER_MODEM_ACTIVITIES (SLEEP_SCHEDULER_BIT(SLEEP_SCHEDULER_ACTIVITY_REPORT) |   \
+                                          SLEEP_SCHEDULER_BIT(SLEEP_SCHEDULER_ACTIVITY_LOCATION) | \
+                                          SLEEP_SCHEDULER_BIT(SLEEP_SCHEDULER_ACTIVITY_I2C_TRIGGER))
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** The activities which have deadlines.
+ */
+typedef enum {
+    SLEEP_SCHEDULER_ACTIVITY_SAMPLE,      //!< Run the I2C commands, modem off.
+    SLEEP_SCHEDULER_ACTIVITY_REPORT,      //!< Talk to the LWM2M server.
+    SLEEP_SCHEDULER_ACTIVITY_LOCATION,    //!< Get a location fix.
+    SLEEP_SCHEDULER_ACTIVITY_I2C_TRIGGER, //!< Handle an external (I2C
+                                          //!< sensor) trigger which
+                                          //!< was put off.
+    SLEEP_SCHEDULER_NUM_ACTIVITIES
+} SleepSchedulerActivity;
+
+/** The state of the scheduler; the contents are private.
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t firmwareVersion;
+    int32_t intervalSeconds[SLEEP_SCHEDULER_NUM_ACTIVITIES];
+    uint32_t deadlineSeconds[SLEEP_SCHEDULER_NUM_ACTIVITIES];
+    uint32_t pending; // SLEEP_SCHEDULER_BIT()s of activities with a deadline
+    int32_t minSleepSeconds;
+    int32_t toleranceSeconds;
+    uint32_t lastWakeSeconds;
+    uint32_t crc; // Must be last
+} SleepScheduler;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Check the scheduler at wake-up, resetting it if it is not
+ * valid.  After a reset no activity has an interval and nothing
+ * has a deadline; set them with sleepSchedulerSetInterval().
+ *
+ * @param pScheduler      the scheduler.
+ * @param firmwareVersion as passed to rtcStateInit().
+ * @param keep            false to reset regardless, e.g. because
+ *                        this is not a warm wake.
+ * @return                true if the scheduler was kept.
+ */
+bool sleepSchedulerInit(SleepScheduler *pScheduler,
+                        uint32_t firmwareVersion, bool keep);
+
+/** Set the interval of a periodic activity.  An activity which
+ * had no interval is due straight away; one whose deadline is
+ * further off than the new interval is brought forward to it.
+ *
+ * @param pScheduler      the scheduler.
+ * @param activity        the activity.
+ * @param intervalSeconds the interval, zero or negative to make
+ *                        the activity one-off.
+ * @param timeSeconds     the time now.
+ */
+void sleepSchedulerSetInterval(SleepScheduler *pScheduler,
+                               SleepSchedulerActivity activity,
+                               int32_t intervalSeconds,
+                               uint32_t timeSeconds);
+
+/** Set the deadline of an activity, e.g. a one-off; a deadline
+ * which is already earlier is kept.
+ *
+ * @param pScheduler      the scheduler.
+ * @param activity        the activity.
+ * @param deadlineSeconds the time by which it should be done.
+ */
+void sleepSchedulerSetDeadline(SleepScheduler *pScheduler,
+                               SleepSchedulerActivity activity,
+                               uint32_t deadlineSeconds);
+
+/** Set the shortest sleep and the tolerance window within which
+ * deadlines are taken together.
+ *
+ * @param pScheduler       the scheduler.
+ * @param minSleepSeconds  the shortest sleep; external wakes
+ *                         sooner than this after the previous wake
+ *                         should be put off.
+ * @param toleranceSeconds how far ahead of its deadline an
+ *                         activity may be done so as to share a
+ *                         wake.
+ */
+void sleepSchedulerSetLimits(SleepScheduler *pScheduler,
+                             int32_t minSleepSeconds,
+                             int32_t toleranceSeconds);
+
+/** Record a wake, e.g. for sleepSchedulerIsTooSoon().
+ *
+ * @param pScheduler  the scheduler.
+ * @param timeSeconds the time now.
+ */
+void sleepSchedulerWake(SleepScheduler *pScheduler, uint32_t timeSeconds);
+
+/** Determine whether a wake is sooner than the shortest sleep
+ * after the previous one, i.e. an external wake which should be
+ * put off; call this before sleepSchedulerWake().
+ *
+ * @param pScheduler  the scheduler.
+ * @param timeSeconds the time now.
+ * @return            true if the wake is too soon.
+ */
+bool sleepSchedulerIsTooSoon(const SleepScheduler *pScheduler,
+                             uint32_t timeSeconds);
+
+/** Return the time at which the shortest sleep after the previous
+ * wake is up, e.g. the deadline for an external wake put off.
+ *
+ * @param pScheduler the scheduler.
+ * @return           the time.
+ */
+uint32_t sleepSchedulerMinSleepEnd(const SleepScheduler *pScheduler);
+
+/** Determine whether an activity has a deadline, e.g. whether an
+ * external wake has already been put off.
+ *
+ * @param pScheduler the scheduler.
+ * @param activity   the activity.
+ * @return           true if the activity has a deadline.
+ */
+bool sleepSchedulerIsPending(const SleepScheduler *pScheduler,
+                             SleepSchedulerActivity activity);
+
+/** Get the activities which are due: those with a deadline
+ * within the tolerance window of now.
+ *
+ * @param pScheduler  the scheduler.
+ * @param timeSeconds the time now.
+ * @return            the SLEEP_SCHEDULER_BIT()s of the activities.
+ */
+uint32_t sleepSchedulerDue(const SleepScheduler *pScheduler,
+                           uint32_t timeSeconds);
+
+/** Record that activities have been done: periodic activities move
+ * on to their next deadline, skipping any that have been missed,
+ * one-off activities no longer have a deadline.
+ *
+ * @param pScheduler  the scheduler.
+ * @param activities  the SLEEP_SCHEDULER_BIT()s of the activities.
+ * @param timeSeconds the time now.
+ */
+void sleepSchedulerDone(SleepScheduler *pScheduler, uint32_t activities,
+                        uint32_t timeSeconds);
+
+/** Record that activities which were due have failed, so that they
+ * are tried again after a back-off rather than a whole interval
+ * later.  A periodic activity whose next deadline comes sooner than
+ * the back-off is moved on to that deadline, as by
+ * sleepSchedulerDone(); otherwise its deadline, and so its phase
+ * from then on, becomes the time of the retry.
+ *
+ * @param pScheduler     the scheduler.
+ * @param activities     the SLEEP_SCHEDULER_BIT()s of the activities.
+ * @param backOffSeconds how long to wait before trying again.
+ * @param timeSeconds    the time now.
+ */
+void sleepSchedulerRetry(SleepScheduler *pScheduler, uint32_t activities,
+                         int32_t backOffSeconds, uint32_t timeSeconds);
+
+/** Get how long to sleep for: until the earliest deadline, but
+ * no less than the shortest sleep and no more than
+ * SLEEP_SCHEDULER_MAX_SLEEP_SECONDS.
+ *
+ * @param pScheduler  the scheduler.
+ * @param timeSeconds the time now.
+ * @return            the time to sleep for, at least one second.
+ */
+int32_t sleepSchedulerSleepSeconds(const SleepScheduler *pScheduler,
+                                   uint32_t timeSeconds);
+
+#endif // _SLEEP_SCHEDULER_H_
+
+// End Of File
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#ifndef TRACE_DECODE_ONLY
+# include "esp_timer.h" // For esp_timer_get_time()
+# include "diag.h"
+#endif
+#include "utilities.h"
+#include "trace.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// Marks a span which has not been stopped.
+#define TRACE_DURATION_OPEN 0xFFFFFFFF
+
+// The size of the binary trace buffer.
+#define TRACE_BUFFER_SIZE (TRACE_HEADER_SIZE + (TRACE_MAX_SPANS * TRACE_RECORD_SIZE))
+
+// ----------------------------------------------------------------
+// PRIVATE VARIABLES
+// ----------------------------------------------------------------
+
+#define TRACE_ID_NAME(id, name) name,
+
+// The names of the trace points.
+static const char *const gTraceNames[] = {TRACE_IDS(TRACE_ID_NAME)};
+
+#ifndef TRACE_DECODE_ONLY
+
+// The binary trace: a header followed by the records, all little-endian:
+//
+// header: magic (2), version (1), count (1), wake time (4),
+//         dropped (2), reserved (2)
+// record: id (1), depth (1), start us (4), duration us (4)
+static char gTraceBuffer[TRACE_BUFFER_SIZE];
+
+// The number of spans recorded.
+static int32_t gNumSpans = 0;
+
+// The number of spans that wouldn't fit.
+static int32_t gNumDropped = 0;
+
+// The current nesting depth.
+static int32_t gDepth = 0;
+
+#endif
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+#ifndef TRACE_DECODE_ONLY
+
+static void put16(char *pBuf, uint16_t value)
+{
+    pBuf[0] = (char) value;
+    pBuf[1] = (char) (value >> 8);
+}
+
+static void put32(char *pBuf, uint32_t value)
+{
+    put16(pBuf, (uint16_t) value);
+    put16(pBuf + 2, (uint16_t) (value >> 16));
+}
+
+// Count a span there is no room for, warning of the first; the
+// count goes in the header too.
+static void drop()
+{
+    gNumDropped++;
+    put16(gTraceBuffer + 8, (uint16_t) gNumDropped);
+    if (gNumDropped == 1) {
+        DIAG_WARN("MAIN: warn: trace span(s) dropped, increase TRACE_MAX_SPANS.\n");
+    }
+}
+
+#endif
+
+static uint16_t get16(const char *pBuf)
+{
+    return (uint16_t) (((uint8_t) pBuf[0]) | (((uint8_t) pBuf[1]) << 8));
+}
+
+static uint32_t get32(const char *pBuf)
+{
+    return ((uint32_t) get16(pBuf)) | (((uint32_t) get16(pBuf + 2)) << 16);
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+#ifndef TRACE_DECODE_ONLY
+
+// Start a new trace.
+void traceInit(uint32_t wakeTimeSeconds)
+{
+    memset(gTraceBuffer, 0, sizeof(gTraceBuffer));
+    put16(gTraceBuffer, TRACE_MAGIC);
+    gTraceBuffer[2] = TRACE_VERSION;
+    put32(gTraceBuffer + 4, wakeTimeSeconds);
+    gNumSpans = 0;
+    gNumDropped = 0;
+    gDepth = 0;
+}
+
+// Start a span.
+int32_t traceStart(TraceId id)
+{
+    int32_t handle = -1;
+    char *pRecord;
+
+    if (gNumSpans < TRACE_MAX_SPANS) {
+        handle = gNumSpans;
+        pRecord = gTraceBuffer + TRACE_HEADER_SIZE + (handle * TRACE_RECORD_SIZE);
+        pRecord[0] = (char) id;
+        pRecord[1] = (char) gDepth;
+        put32(pRecord + 2, (uint32_t) esp_timer_get_time());
+        put32(pRecord + 6, TRACE_DURATION_OPEN);
+        gNumSpans++;
+        gTraceBuffer[3] = (char) gNumSpans;
+        gDepth++;
+    } else {
+        drop();
+    }
+
+    return handle;
+}
+
+// Stop a span.
+void traceStop(int32_t handle)
+{
+    char *pRecord;
+
+    if ((handle >= 0) && (handle < gNumSpans)) {
+        pRecord = gTraceBuffer + TRACE_HEADER_SIZE + (handle * TRACE_RECORD_SIZE);
+        if (get32(pRecord + 6) == TRACE_DURATION_OPEN) {
+            put32(pRecord + 6, (uint32_t) esp_timer_get_time() - get32(pRecord + 2));
+            if (gDepth > 0) {
+                gDepth--;
+            }
+        }
+    }
+}
+
+// Add a finished span.
+void traceAdd(TraceId id, int64_t startUs, int64_t stopUs)
+{
+    char *pRecord;
+
+    if (gNumSpans < TRACE_MAX_SPANS) {
+        pRecord = gTraceBuffer + TRACE_HEADER_SIZE + (gNumSpans * TRACE_RECORD_SIZE);
+        pRecord[0] = (char) id;
+        pRecord[1] = (char) gDepth;
+        put32(pRecord + 2, (uint32_t) startUs);
+        put32(pRecord + 6, (uint32_t) (stopUs - startUs));
+        gNumSpans++;
+        gTraceBuffer[3] = (char) gNumSpans;
+    } else {
+        drop();
+    }
+}
+
+// Get the binary trace.
+int32_t traceGet(const char **ppBuf)
+{
+    if (ppBuf != NULL) {
+        *ppBuf = gTraceBuffer;
+    }
+
+    return TRACE_HEADER_SIZE + (gNumSpans * TRACE_RECORD_SIZE);
+}
+
+// Print the binary trace as one hex line, directly since it is
+// longer than a line of diag.
+void traceDump()
+{
+    char hex[(TRACE_RECORD_SIZE * 2) + 1];
+    int32_t length = traceGet(NULL);
+    int32_t thisLength;
+
+    printf(TRACE_CONSOLE_PREFIX);
+    // Do it in chunks to keep the stack small
+    for (int32_t x = 0; x < length; x += thisLength) {
+        thisLength = length - x;
+        if (thisLength > TRACE_RECORD_SIZE) {
+            thisLength = TRACE_RECORD_SIZE;
+        }
+        hex[utilitiesBytesToHexString(gTraceBuffer + x, thisLength, hex, sizeof(hex) - 1)] = 0;
+        printf("%s", hex);
+    }
+    printf("\n");
+}
+
+#endif // TRACE_DECODE_ONLY
+
+// Return the name of a trace point.
+const char *pTraceName(TraceId id)
+{
+    const char *pName = "unknown";
+
+    if ((((int32_t) id) >= 0) && (((size_t) id) < ARRAY_SIZE(gTraceNames))) {
+        pName = gTraceNames[id];
+    }
+
+    return pName;
+}
+
+// Decode a binary trace.
+int32_t traceDecode(const char *pBuf, int32_t len, uint32_t *pWakeTimeSeconds,
+                    TraceSpan *pSpans, int32_t maxNumSpans)
+{
+    int32_t numSpans;
+    const char *pRecord;
+
+    if ((len < TRACE_HEADER_SIZE) || (get16(pBuf) != TRACE_MAGIC) ||
+        (pBuf[2] != TRACE_VERSION)) {
+        return -1;
+    }
+    numSpans = (uint8_t) pBuf[3];
+    if (len < TRACE_HEADER_SIZE + (numSpans * TRACE_RECORD_SIZE)) {
+        return -1;
+    }
+    if (pWakeTimeSeconds != NULL) {
+        *pWakeTimeSeconds = get32(pBuf + 4);
+    }
+    if (numSpans > maxNumSpans) {
+        numSpans = maxNumSpans;
+    }
+    for (int32_t x = 0; x < numSpans; x++) {
+        pRecord = pBuf + TRACE_HEADER_SIZE + (x * TRACE_RECORD_SIZE);
+        pSpans[x].id = (TraceId) (uint8_t) pRecord[0];
+        pSpans[x].depth = (uint8_t) pRecord[1];
+        pSpans[x].startUs = get32(pRecord + 2);
+        pSpans[x].durationUs = get32(pRecord + 6);
+    }
+
+    return numSpans;
+}
+
+// End Of File
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+/* Lightweight span tracing of the phases of a wake cycle.  Spans
+ * are kept in a fixed-size binary buffer and dumped at the end of
+ * the wake as a single hex line, prefixed with TRACE_CONSOLE_PREFIX,
+ * which host/trace_to_chrome converts to Chrome trace JSON for
+ * chrome://tracing or https://ui.perfetto.dev.
+ *
+ * This file is also compiled on the host by the converter so it
+ * must not depend on ESP-IDF.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The maximum number of spans recorded in one wake cycle.
+ */
+#ifndef TRACE_MAX_SPANS
+# define TRACE_MAX_SPANS 64
+#endif
+
+/** The value at the start of a binary trace buffer.
+ */
+#define TRACE_MAGIC 0x5754 // "TW", little-endian
+
+/** The version of the binary trace buffer format.
+ */
+#define TRACE_VERSION 1
+
+/** The prefix of the line written by traceDump().
+ */
+#define TRACE_CONSOLE_PREFIX "TRACE: "
+
+/** The size of the binary trace header in bytes.
+ */
+#define TRACE_HEADER_SIZE 12
+
+/** The size of a binary trace record in bytes.
+ */
+#define TRACE_RECORD_SIZE 10
+
+/** The trace points: name and description.  Add new ones
+ * at the end so that old traces still decode.
+ */
+#define TRACE_IDS(X) \
+    X(TRACE_ID_WAKE,                 "wake") \
+    X(TRACE_ID_INIT,                 "init") \
+    X(TRACE_ID_MODEM_POWER_ON,       "cellularPowerOn") \
+    X(TRACE_ID_CFG_SARA_R4,          "cfgSaraR4") \
+    X(TRACE_ID_REGISTER,             "cellularRegister") \
+    X(TRACE_ID_LWM2M_READY,          "lwm2mReady") \
+    X(TRACE_ID_CFG_LWM2M,            "cfgLwm2m") \
+    X(TRACE_ID_SERVER_WAIT,          "server wait") \
+    X(TRACE_ID_I2C,                  "doI2cCommands") \
+    X(TRACE_ID_SERVER_WAIT_DATA,     "server wait for data") \
+    X(TRACE_ID_MODEM_POWER_OFF,      "cellularPowerOff") \
+    X(TRACE_ID_DEINIT,               "deInit") \
+    X(TRACE_ID_BOOT_TO_REGISTERED,   "boot to registered") \
+    X(TRACE_ID_LOCATION_START,       "locationStart") \
+    X(TRACE_ID_SAMPLE,               "takeSample") \
+    X(TRACE_ID_SEND_SAMPLES,         "sendSamples") \
+    X(TRACE_ID_LWM2M_UPDATE,         "lwm2mEventsUpdate")
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+#define TRACE_ID_ENUM(id, name) id,
+
+/** The trace points.
+ */
+typedef enum {
+    TRACE_IDS(TRACE_ID_ENUM)
+    MAX_NUM_TRACE_IDS
+} TraceId;
+
+/** A decoded span, as used by traceDecode().
+ */
+typedef struct {
+    TraceId id;
+    uint8_t depth;       //!< Nesting depth, 0 being outermost.
+    uint32_t startUs;    //!< From the start of the wake cycle.
+    uint32_t durationUs; //!< 0xFFFFFFFF if never stopped.
+} TraceSpan;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Start a new trace, discarding any previous one.
+ *
+ * @param wakeTimeSeconds the time of day at wake-up, recorded in
+ *                        the trace header so that traces from
+ *                        successive wakes can be laid end to end.
+ */
+void traceInit(uint32_t wakeTimeSeconds);
+
+/** Start a span.
+ *
+ * @param id the trace point.
+ * @return   a handle to pass to traceStop(), negative if the
+ *           trace buffer is full.
+ */
+int32_t traceStart(TraceId id);
+
+/** Stop a span.
+ *
+ * @param handle the handle returned by traceStart(); negative
+ *               values are ignored.
+ */
+void traceStop(int32_t handle);
+
+/** Add a span that has already finished, e.g. one timed by
+ * another task; it is recorded as nested in whatever span is
+ * open at the time of the call.
+ *
+ * @param id      the trace point.
+ * @param startUs when the span started, from esp_timer_get_time().
+ * @param stopUs  when the span stopped, from esp_timer_get_time().
+ */
+void traceAdd(TraceId id, int64_t startUs, int64_t stopUs);
+
+/** Get the binary trace, e.g. to write it to an LWM2M opaque
+ * resource.  The buffer remains valid until the next traceInit().
+ *
+ * @param ppBuf  place to put a pointer to the binary trace.
+ * @return       the number of bytes in the binary trace.
+ */
+int32_t traceGet(const char **ppBuf);
+
+/** Print the binary trace to the console as one hex line.  The
+ * line is written directly, not through diag.h, so call this after
+ * diagStop() to keep it clear of diagnostics.
+ */
+void traceDump();
+
+/** Return the name of a trace point.
+ *
+ * @param id the trace point.
+ * @return   the name.
+ */
+const char *pTraceName(TraceId id);
+
+/** Decode a binary trace, e.g. on the host.
+ *
+ * @param pBuf             the binary trace.
+ * @param len              the number of bytes at pBuf.
+ * @param pWakeTimeSeconds place to put the wake time from the
+ *                         header, may be NULL.
+ * @param pSpans           storage for the decoded spans.
+ * @param maxNumSpans      the number of spans pSpans can hold.
+ * @return                 the number of spans decoded or negative
+ *                         if the buffer is not a valid trace.
+ */
+int32_t traceDecode(const char *pBuf, int32_t len, uint32_t *pWakeTimeSeconds,
+                    TraceSpan *pSpans, int32_t maxNumSpans);
+
+#endif // _TRACE_H_
+
+// End Of File
@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "ts_codec.h"
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Zig-zag encode a signed value so that small magnitudes, of
+// either sign, become small unsigned values.
+static uint32_t zigzag(uint32_t value)
+{
+    return (value << 1) ^ (uint32_t) (((int32_t) value) >> 31);
+}
+
+// Undo zigzag().
+static uint32_t unzigzag(uint32_t value)
+{
+    return (value >> 1) ^ (0 - (value & 1));
+}
+
+// Write a varint, returning the number of bytes written.
+static int32_t varintPut(uint8_t *pBuf, uint32_t value)
+{
+    int32_t length = 0;
+
+    while (value >= 0x80) {
+        pBuf[length] = (uint8_t) (value | 0x80);
+        value >>= 7;
+        length++;
+    }
+    pBuf[length] = (uint8_t) value;
+
+    return length + 1;
+}
+
+// Read a varint, returning false if it runs off the end of
+// the buffer or is too long.
+static bool varintGet(TsCodec *pCodec, uint32_t *pValue)
+{
+    uint32_t value = 0;
+    uint8_t byte;
+
+    for (int32_t shift = 0; shift < 35; shift += 7) {
+        if (pCodec->length >= pCodec->size) {
+            return false;
+        }
+        byte = pCodec->pBuf[pCodec->length];
+        pCodec->length++;
+        value |= ((uint32_t) (byte & 0x7f)) << shift;
+        if ((byte & 0x80) == 0) {
+            *pValue = value;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Write the bits of a float XORed with the last ones, returning
+// the number of bytes written.
+static int32_t xorPut(uint8_t *pBuf, uint32_t bits)
+{
+    int32_t shift = 0;
+    int32_t numBytes = 0;
+
+    if (bits != 0) {
+        while ((bits & 0xff) == 0) {
+            bits >>= 8;
+            shift++;
+        }
+        while ((numBytes + shift < 4) && ((bits >> (numBytes * 8)) != 0)) {
+            pBuf[1 + numBytes] = (uint8_t) (bits >> (numBytes * 8));
+            numBytes++;
+        }
+    }
+    pBuf[0] = (uint8_t) ((shift << 4) | numBytes);
+
+    return 1 + numBytes;
+}
+
+// Read what xorPut() wrote, returning false if it is not valid.
+static bool xorGet(TsCodec *pCodec, uint32_t *pBits)
+{
+    uint32_t bits = 0;
+    int32_t shift;
+    int32_t numBytes;
+
+    if (pCodec->length >= pCodec->size) {
+        return false;
+    }
+    shift = pCodec->pBuf[pCodec->length] >> 4;
+    numBytes = pCodec->pBuf[pCodec->length] & 0x0f;
+    pCodec->length++;
+    if ((shift > 3) || (shift + numBytes > 4) ||
+        (pCodec->length + numBytes > pCodec->size)) {
+        return false;
+    }
+    for (int32_t x = 0; x < numBytes; x++) {
+        bits |= ((uint32_t) pCodec->pBuf[pCodec->length + x]) << (x * 8);
+    }
+    pCodec->length += numBytes;
+    *pBits = bits << (shift * 8);
+
+    return true;
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Start encoding a batch.
+int32_t tsCodecEncodeStart(TsCodec *pCodec, uint8_t *pBuf, int32_t size,
+                           int32_t numChannels, uint32_t flags)
+{
+    if ((pBuf == NULL) || (size < TS_CODEC_HEADER_SIZE) ||
+        (numChannels < 1) || (numChannels > TS_CODEC_MAX_CHANNELS) ||
+        (flags > (TS_CODEC_FLAG_FLOAT | TS_CODEC_FLAG_XOR))) {
+        return TS_CODEC_ERROR_PARAM;
+    }
+
+    memset(pCodec, 0, sizeof(*pCodec));
+    pCodec->pBuf = pBuf;
+    pCodec->size = size;
+    pCodec->numChannels = numChannels;
+    pCodec->flags = flags;
+    pBuf[0] = (uint8_t) ((TS_CODEC_VERSION << 4) | flags);
+    pBuf[1] = (uint8_t) numChannels;
+    pCodec->length = TS_CODEC_HEADER_SIZE;
+
+    return 0;
+}
+
+// Add a reading to a batch.
+int32_t tsCodecEncode(TsCodec *pCodec, uint32_t timeSeconds,
+                      const TsCodecValue *pValues)
+{
+    uint8_t reading[TS_CODEC_MAX_READING_SIZE(TS_CODEC_MAX_CHANNELS)];
+    uint32_t lastTime = pCodec->lastTime;
+    uint32_t delta = 0;
+    uint32_t value;
+    int32_t length;
+
+    if (pCodec->numReadings == 0) {
+        lastTime = timeSeconds;
+    }
+    delta = timeSeconds - lastTime;
+    length = varintPut(reading, zigzag(delta - pCodec->lastDelta));
+    for (int32_t x = 0; x < pCodec->numChannels; x++) {
+        if (pCodec->flags & TS_CODEC_FLAG_FLOAT) {
+            memcpy(&value, &(pValues[x].number), sizeof(value));
+            if (pCodec->flags & TS_CODEC_FLAG_XOR) {
+                length += xorPut(reading + length, value ^ pCodec->lastValues[x]);
+            } else {
+                memcpy(reading + length, &value, sizeof(value));
+                length += sizeof(value);
+            }
+        } else {
+            value = (uint32_t) pValues[x].integer;
+            length += varintPut(reading + length, zigzag(value - pCodec->lastValues[x]));
+        }
+    }
+
+    // Only change the batch if the whole reading fits
+    if (pCodec->length + length > pCodec->size) {
+        return TS_CODEC_ERROR_FULL;
+    }
+    if (pCodec->numReadings == 0) {
+        pCodec->pBuf[2] = (uint8_t) timeSeconds;
+        pCodec->pBuf[3] = (uint8_t) (timeSeconds >> 8);
+        pCodec->pBuf[4] = (uint8_t) (timeSeconds >> 16);
+        pCodec->pBuf[5] = (uint8_t) (timeSeconds >> 24);
+    }
+    memcpy(pCodec->pBuf + pCodec->length, reading, length);
+    pCodec->length += length;
+    pCodec->numReadings++;
+    pCodec->lastTime = timeSeconds;
+    pCodec->lastDelta = delta;
+    for (int32_t x = 0; x < pCodec->numChannels; x++) {
+        if (pCodec->flags & TS_CODEC_FLAG_FLOAT) {
+            memcpy(&(pCodec->lastValues[x]), &(pValues[x].number), sizeof(pCodec->lastValues[x]));
+        } else {
+            pCodec->lastValues[x] = (uint32_t) pValues[x].integer;
+        }
+    }
+
+    return 0;
+}
+
+// Get the length of a batch.
+int32_t tsCodecEncodedLength(const TsCodec *pCodec)
+{
+    return (pCodec->numReadings > 0) ? pCodec->length : 0;
+}
+
+// Start decoding a batch.
+int32_t tsCodecDecodeStart(TsCodec *pCodec, const uint8_t *pBuf,
+                           int32_t length)
+{
+    if ((pBuf == NULL) || (length < TS_CODEC_HEADER_SIZE) ||
+        ((pBuf[0] >> 4) != TS_CODEC_VERSION) ||
+        ((pBuf[0] & 0x0f) > (TS_CODEC_FLAG_FLOAT | TS_CODEC_FLAG_XOR)) ||
+        (pBuf[1] < 1) || (pBuf[1] > TS_CODEC_MAX_CHANNELS)) {
+        return TS_CODEC_ERROR_DATA;
+    }
+
+    memset(pCodec, 0, sizeof(*pCodec));
+    // The decoder never writes to the buffer
+    pCodec->pBuf = (uint8_t *) pBuf;
+    pCodec->size = length;
+    pCodec->flags = pBuf[0] & 0x0f;
+    pCodec->numChannels = pBuf[1];
+    pCodec->lastTime = ((uint32_t) pBuf[2]) | (((uint32_t) pBuf[3]) << 8) |
+                       (((uint32_t) pBuf[4]) << 16) | (((uint32_t) pBuf[5]) << 24);
+    pCodec->length = TS_CODEC_HEADER_SIZE;
+
+    return 0;
+}
+
+// Get the next reading from a batch.
+int32_t tsCodecDecode(TsCodec *pCodec, uint32_t *pTimeSeconds,
+                      TsCodecValue *pValues)
+{
+    uint32_t value;
+
+    if (pCodec->length >= pCodec->size) {
+        return 0;
+    }
+
+    if (!varintGet(pCodec, &value)) {
+        return TS_CODEC_ERROR_DATA;
+    }
+    pCodec->lastDelta += unzigzag(value);
+    pCodec->lastTime += pCodec->lastDelta;
+    for (int32_t x = 0; x < pCodec->numChannels; x++) {
+        if (pCodec->flags & TS_CODEC_FLAG_FLOAT) {
+            if (pCodec->flags & TS_CODEC_FLAG_XOR) {
+                if (!xorGet(pCodec, &value)) {
+                    return TS_CODEC_ERROR_DATA;
+                }
+                pCodec->lastValues[x] ^= value;
+            } else {
+                if (pCodec->length + (int32_t) sizeof(value) > pCodec->size) {
+                    return TS_CODEC_ERROR_DATA;
+                }
+                memcpy(&(pCodec->lastValues[x]), pCodec->pBuf + pCodec->length,
+                       sizeof(pCodec->lastValues[x]));
+                pCodec->length += sizeof(pCodec->lastValues[x]);
+            }
+            memcpy(&(pValues[x].number), &(pCodec->lastValues[x]), sizeof(pValues[x].number));
+        } else {
+            if (!varintGet(pCodec, &value)) {
+                return TS_CODEC_ERROR_DATA;
+            }
+            pCodec->lastValues[x] += unzigzag(value);
+            pValues[x].integer = (int32_t) pCodec->lastValues[x];
+        }
+    }
+    *pTimeSeconds = pCodec->lastTime;
+    pCodec->numReadings++;
+
+    return 1;
+}
+
+// Get the number of channels in a batch being decoded.
+int32_t tsCodecNumChannels(const TsCodec *pCodec)
+{
+    return pCodec->numChannels;
+}
+
+// Get the flags of a batch being decoded.
+uint32_t tsCodecFlags(const TsCodec *pCodec)
+{
+    return pCodec->flags;
+}
+
+// End Of File
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _TS_CODEC_H_
+#define _TS_CODEC_H_
+
+/* A compact encoding for a batch of timestamped readings, each
+ * reading being one value for each of a fixed number of channels,
+ * so that a whole batch can go to the LWM2M server in a single
+ * opaque resource.  The encoding is streamed: readings are added
+ * one at a time into a caller-supplied buffer.
+ *
+ * The format is:
+ *
+ * - a six byte header: TS_CODEC_VERSION in the upper nibble and
+ *   TS_CODEC_FLAG_xxx in the lower nibble of the first byte, the
+ *   number of channels in the second, then the timestamp of the
+ *   first reading as a little-endian uint32_t,
+ * - then, for each reading, the delta-of-delta of its timestamp
+ *   as a zig-zag varint, which is a single zero byte when the
+ *   readings are evenly spaced, followed by a value per channel:
+ *   - integer channels: the difference from the channel's last
+ *     value as a zig-zag varint,
+ *   - float channels: the raw little-endian float or, with
+ *     TS_CODEC_FLAG_XOR, the XOR with the channel's last value
+ *     as a control byte, upper nibble the number of zero bytes
+ *     dropped from the bottom and lower nibble the number of
+ *     bytes which follow, then those bytes, little-endian; an
+ *     unchanged value is the single byte 0.
+ *
+ * The number of readings is not stored: the batch ends at the end
+ * of the buffer.  Varints are LEB128, least significant seven bits
+ * first.  All arithmetic on timestamps and integer values is
+ * modulo 2^32 so that any sequence encodes.
+ *
+ * This file is also compiled on the host by the decoder and the
+ * benchmark so it must not depend on ESP-IDF.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The version of the encoding.
+ */
+#define TS_CODEC_VERSION 1
+
+/** The size of the header in bytes.
+ */
+#define TS_CODEC_HEADER_SIZE 6
+
+/** The most channels in a reading.
+ */
+#ifndef TS_CODEC_MAX_CHANNELS
+# define TS_CODEC_MAX_CHANNELS 16
+#endif
+
+/** The most bytes a reading can take up, for sizing buffers.
+ */
+#define TS_CODEC_MAX_READING_SIZE(numChannels) (5 + (numChannels) * 5)
+
+/** Flag: the channels are floats rather than integers.
+ */
+#define TS_CODEC_FLAG_FLOAT 0x01
+
+/** Flag: float channels are XORed with their last value.
+ */
+#define TS_CODEC_FLAG_XOR   0x02
+
+/** Error: there is no room for the reading; the batch is
+ * unchanged and remains valid.
+ */
+#define TS_CODEC_ERROR_FULL  -1
+
+/** Error: a parameter is out of range.
+ */
+#define TS_CODEC_ERROR_PARAM -2
+
+/** Error: the encoded data is not valid.
+ */
+#define TS_CODEC_ERROR_DATA  -3
+
+// ----------------------------------------------------------------
+// TYPES
+// ----------------------------------------------------------------
+
+/** A channel value.
+ */
+typedef union {
+    int32_t integer;
+    float number;
+} TsCodecValue;
+
+/** The state of an encoder or decoder; the contents are private.
+ */
+typedef struct {
+    uint8_t *pBuf;
+    int32_t size;
+    int32_t length;      //!< Bytes used (encoder) or read (decoder).
+    int32_t numReadings;
+    int32_t numChannels;
+    uint32_t flags;
+    uint32_t lastTime;
+    uint32_t lastDelta;
+    uint32_t lastValues[TS_CODEC_MAX_CHANNELS];
+} TsCodec;
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Start encoding a batch.
+ *
+ * @param pCodec      the encoder state.
+ * @param pBuf        where to put the batch.
+ * @param size        the number of bytes at pBuf, at least
+ *                    TS_CODEC_HEADER_SIZE.
+ * @param numChannels the number of values in each reading, 1 to
+ *                    TS_CODEC_MAX_CHANNELS.
+ * @param flags       TS_CODEC_FLAG_xxx.
+ * @return            zero on success, else negative error code.
+ */
+int32_t tsCodecEncodeStart(TsCodec *pCodec, uint8_t *pBuf, int32_t size,
+                           int32_t numChannels, uint32_t flags);
+
+/** Add a reading to a batch.
+ *
+ * @param pCodec      the encoder state.
+ * @param timeSeconds the timestamp of the reading.
+ * @param pValues     numChannels values.
+ * @return            zero on success, else negative error code;
+ *                    on TS_CODEC_ERROR_FULL the caller should send
+ *                    the batch and start a new one.
+ */
+int32_t tsCodecEncode(TsCodec *pCodec, uint32_t timeSeconds,
+                      const TsCodecValue *pValues);
+
+/** Get the length of a batch.
+ *
+ * @param pCodec the encoder state.
+ * @return       the number of bytes of the buffer used, zero if no
+ *               readings have been added.
+ */
+int32_t tsCodecEncodedLength(const TsCodec *pCodec);
+
+/** Start decoding a batch.
+ *
+ * @param pCodec the decoder state.
+ * @param pBuf   the batch.
+ * @param length the number of bytes at pBuf.
+ * @return       zero on success, else negative error code.
+ */
+int32_t tsCodecDecodeStart(TsCodec *pCodec, const uint8_t *pBuf,
+                           int32_t length);
+
+/** Get the next reading from a batch.
+ *
+ * @param pCodec       the decoder state.
+ * @param pTimeSeconds place to put the timestamp.
+ * @param pValues      place to put numChannels values.
+ * @return             1 if a reading was decoded, 0 at the end of
+ *                     the batch, else negative error code.
+ */
+int32_t tsCodecDecode(TsCodec *pCodec, uint32_t *pTimeSeconds,
+                      TsCodecValue *pValues);
+
+/** Get the number of channels in a batch being decoded.
+ *
+ * @param pCodec the decoder state, after tsCodecDecodeStart().
+ * @return       the number of channels.
+ */
+int32_t tsCodecNumChannels(const TsCodec *pCodec);
+
+/** Get the flags of a batch being decoded.
+ *
+ * @param pCodec the decoder state, after tsCodecDecodeStart().
+ * @return       TS_CODEC_FLAG_xxx.
+ */
+uint32_t tsCodecFlags(const TsCodec *pCodec);
+
+#endif // _TS_CODEC_H_
+
+// End Of File
@@ -106,4 +106,20 @@ int asciiToInt(const char *pBuf)
      return (int) answer;
 }
 
+// Calculate a CRC32, bit-wise to avoid a 1 kbyte table.
+uint32_t utilitiesCrc32(uint32_t crc, const void *pBuf, int len)
+{
+    const uint8_t *pByte = (const uint8_t *) pBuf;
+
+    crc = ~crc;
+    for (int x = 0; x < len; x++) {
+        crc ^= pByte[x];
+        for (int y = 0; y < 8; y++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+
+    return ~crc;
+}
+
 // End Of File
@@ -12,6 +12,8 @@
 #ifndef _UTILITIES_H_
 #define _UTILITIES_H_
 
+#include <stdint.h>
+
 // ----------------------------------------------------------------
 // COMPILE-TIME CONSTANTS
 // ----------------------------------------------------------------
@@ -88,6 +90,17 @@ int utilitiesBytesToHexString(const char *pInBuf, int lenInBuf, char *pOutBuf, i
  */
 int asciiToInt(const char *pBuf);
 
+/** Calculate the CRC32 (IEEE 802.3 polynomial, as used by zlib)
+ * of a buffer.  Pass the result of a previous call as crc to
+ * continue a calculation across several buffers, 0 to start.
+ *
+ * @param crc    the CRC so far, 0 to start.
+ * @param pBuf   pointer to the buffer.
+ * @param len    the number of bytes in the buffer.
+ * @return       the CRC.
+ */
+uint32_t utilitiesCrc32(uint32_t crc, const void *pBuf, int len);
+
 #endif // _UTILITIES_H_
 
 // End Of File
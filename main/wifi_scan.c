@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "esp_event.h"
+#include "esp_wifi.h"
+#include "rtc_state.h"
+#include "diag.h"
+#include "wifi_scan.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+// The event group bit set when the scan is complete.
+#define WIFI_SCAN_DONE_BIT 0x01
+
+// ----------------------------------------------------------------
+// PRIVATE VARIABLES
+// ----------------------------------------------------------------
+
+// Signals the end of the scan.
+static EventGroupHandle_t gEventGroup = NULL;
+
+// True while a scan is in progress.
+static volatile bool gScanning = false;
+
+// True if the scan in progress is of all channels.
+static bool gFullScan = false;
+
+// The channels still to be scanned, bit n for channel n.
+static uint32_t gChannelsToScan = 0;
+
+// The channels on which access points were seen.
+static uint32_t gChannelsSeen = 0;
+
+// Where the Wifi driver puts what it found.
+static wifi_ap_record_t gRecords[WIFI_SCAN_MAX_RECORDS];
+
+// The strongest access points, strongest first.
+static wifi_ap_record_t gAps[WIFI_SCAN_MAX_APS];
+static int32_t gNumAps = 0;
+
+// ----------------------------------------------------------------
+// STATIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Start a non-blocking scan of one channel, or all channels
+// if channel is zero.
+static esp_err_t scanChannel(int32_t channel)
+{
+    wifi_scan_config_t config;
+
+    memset(&config, 0, sizeof(config));
+    config.channel = (uint8_t) channel;
+    config.show_hidden = true;
+    config.scan_type = WIFI_SCAN_TYPE_ACTIVE;
+
+    return esp_wifi_scan_start(&config, false);
+}
+
+// Take the next channel to scan off the list, returning
+// zero if there are none left.
+static int32_t nextChannel()
+{
+    for (int32_t channel = 1; channel <= WIFI_SCAN_MAX_CHANNEL; channel++) {
+        if (gChannelsToScan & (1UL << channel)) {
+            gChannelsToScan &= ~(1UL << channel);
+            return channel;
+        }
+    }
+
+    return 0;
+}
+
+// Add an access point to the pool if it is one of the strongest.
+static void keep(const wifi_ap_record_t *pRecord)
+{
+    int32_t x;
+
+    for (x = 0; x < gNumAps; x++) {
+        if (memcmp(gAps[x].bssid, pRecord->bssid, sizeof(gAps[x].bssid)) == 0) {
+            // Already have it
+            return;
+        }
+    }
+    // Find where it goes and shuffle the weaker ones down,
+    // dropping the weakest if the pool is full
+    for (x = gNumAps; (x > 0) && (gAps[x - 1].rssi < pRecord->rssi); x--) {
+        if (x < WIFI_SCAN_MAX_APS) {
+            gAps[x] = gAps[x - 1];
+        }
+    }
+    if (x < WIFI_SCAN_MAX_APS) {
+        gAps[x] = *pRecord;
+        if (gNumAps < WIFI_SCAN_MAX_APS) {
+            gNumAps++;
+        }
+    }
+}
+
+// ----------------------------------------------------------------
+// PUBLIC FUNCTIONS
+// ----------------------------------------------------------------
+
+// Start a scan.
+int32_t wifiScanStart(bool lastChannelsOnly)
+{
+    esp_err_t espError;
+    int32_t channel = 0;
+
+    if (gEventGroup == NULL) {
+        gEventGroup = xEventGroupCreate();
+        if (gEventGroup == NULL) {
+            return -1;
+        }
+    }
+    xEventGroupClearBits(gEventGroup, WIFI_SCAN_DONE_BIT);
+    gNumAps = 0;
+    gChannelsSeen = 0;
+    gChannelsToScan = 0;
+    if (lastChannelsOnly) {
+        gChannelsToScan = rtcStateGetWifiChannels();
+    }
+    gFullScan = (gChannelsToScan == 0);
+    if (!gFullScan) {
+        channel = nextChannel();
+    }
+
+    espError = esp_wifi_start();
+    if (espError == ESP_OK) {
+        gScanning = true;
+        espError = scanChannel(channel);
+        if (espError != ESP_OK) {
+            gScanning = false;
+        }
+    }
+    if (espError != ESP_OK) {
+        DIAG_ERROR("WIFI_SCAN: error: unable to start Wifi scan (0x%x).\n", espError);
+        return -1;
+    }
+    if (gFullScan) {
+        DIAG_INFO("WIFI_SCAN: Wifi scan of all channels started.\n");
+    } else {
+        DIAG_INFO("WIFI_SCAN: Wifi scan of channels 0x%04x started.\n",
+                  (unsigned int) (gChannelsToScan | (1UL << channel)));
+    }
+
+    return 0;
+}
+
+// Handle a Wifi event.
+void wifiScanHandleEvent(const system_event_t *pEvent)
+{
+    uint16_t number = WIFI_SCAN_MAX_RECORDS;
+    int32_t channel;
+
+    if ((pEvent->event_id != SYSTEM_EVENT_SCAN_DONE) || !gScanning) {
+        return;
+    }
+
+    if (esp_wifi_scan_get_ap_records(&number, gRecords) == ESP_OK) {
+        for (int32_t x = 0; x < number; x++) {
+            keep(&(gRecords[x]));
+            if (gRecords[x].primary <= WIFI_SCAN_MAX_CHANNEL) {
+                gChannelsSeen |= 1UL << gRecords[x].primary;
+            }
+        }
+    }
+
+    channel = nextChannel();
+    if ((channel == 0) && !gFullScan && (gNumAps == 0)) {
+        // Nothing where there was something last time: look everywhere
+        gFullScan = true;
+        if (scanChannel(0) == ESP_OK) {
+            return;
+        }
+    } else if (channel > 0) {
+        if (scanChannel(channel) == ESP_OK) {
+            return;
+        }
+    }
+
+    gScanning = false;
+    xEventGroupSetBits(gEventGroup, WIFI_SCAN_DONE_BIT);
+}
+
+// Wait for the scan to complete.
+bool wifiScanWait(int32_t waitMs)
+{
+    EventBits_t bits = 0;
+
+    if (gEventGroup != NULL) {
+        bits = xEventGroupWaitBits(gEventGroup, WIFI_SCAN_DONE_BIT, pdFALSE, pdTRUE,
+                                   waitMs / portTICK_PERIOD_MS);
+    }
+
+    return (bits & WIFI_SCAN_DONE_BIT) != 0;
+}
+
+// Get the access points found.
+int32_t wifiScanGetAps(const wifi_ap_record_t **ppAps)
+{
+    *ppAps = gAps;
+
+    return gNumAps;
+}
+
+// Stop scanning.
+void wifiScanStop()
+{
+    if (gScanning) {
+        gScanning = false;
+        esp_wifi_scan_stop();
+    } else if ((gEventGroup != NULL) &&
+               (xEventGroupGetBits(gEventGroup) & WIFI_SCAN_DONE_BIT)) {
+        // Written here, rather than in the event task, so that
+        // only this task writes to the RTC state
+        rtcStateSetWifiChannels(gChannelsSeen);
+    }
+    esp_wifi_stop();
+    if (gEventGroup != NULL) {
+        vEventGroupDelete(gEventGroup);
+        gEventGroup = NULL;
+    }
+}
+
+// End Of File
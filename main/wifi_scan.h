@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) u-blox Melbourn Ltd
+ * u-blox Melbourn Ltd, Melbourn, UK
+ *
+ * All rights reserved.
+ *
+ * This source file is the sole property of u-blox Melbourn Ltd.
+ * Reproduction or utilisation of this source in whole or part is
+ * forbidden without the written consent of u-blox Melbourn Ltd.
+ */
+
+#ifndef _WIFI_SCAN_H_
+#define _WIFI_SCAN_H_
+
+/* A non-blocking scan for Wifi access points, for hybrid
+ * location.  wifiScanStart() kicks the scan off and returns;
+ * the scan completes in the background (e.g. while registering
+ * with the cellular network), wifiScanHandleEvent() being called
+ * from the Wifi event handler on SYSTEM_EVENT_SCAN_DONE.  Only the
+ * strongest WIFI_SCAN_MAX_APS access points are kept, in a fixed
+ * pool, so nothing is allocated.
+ *
+ * The channels on which access points were seen are kept in RTC
+ * memory (see rtc_state.h) so that the next scan can be limited
+ * to just those channels, one channel at a time, which is much
+ * quicker than scanning all of them.  If nothing is found on those
+ * channels then all channels are scanned.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_event.h"
+#include "esp_wifi.h"
+
+// ----------------------------------------------------------------
+// COMPILE-TIME CONSTANTS
+// ----------------------------------------------------------------
+
+/** The number of access points kept, the strongest first.
+ */
+#ifndef WIFI_SCAN_MAX_APS
+# define WIFI_SCAN_MAX_APS 8
+#endif
+
+/** The number of access points read from the Wifi driver after
+ * each scan; any more are lost.
+ */
+#ifndef WIFI_SCAN_MAX_RECORDS
+# define WIFI_SCAN_MAX_RECORDS 20
+#endif
+
+/** The highest Wifi channel number.
+ */
+#define WIFI_SCAN_MAX_CHANNEL 14
+
+// ----------------------------------------------------------------
+// FUNCTIONS
+// ----------------------------------------------------------------
+
+/** Start a scan; Wifi must have been initialised in station mode.
+ *
+ * @param lastChannelsOnly if true, and access points were seen
+ *                         last time, scan only the channels they
+ *                         were seen on.
+ * @return                 zero on success, else negative error code.
+ */
+int32_t wifiScanStart(bool lastChannelsOnly);
+
+/** Handle a Wifi event; call this from the Wifi event handler.
+ *
+ * @param pEvent the event.
+ */
+void wifiScanHandleEvent(const system_event_t *pEvent);
+
+/** Wait for the scan to complete.
+ *
+ * @param waitMs the longest to wait in milliseconds.
+ * @return       true if the scan is complete.
+ */
+bool wifiScanWait(int32_t waitMs);
+
+/** Get the access points found, the strongest first; only valid
+ * once the scan is complete.
+ *
+ * @param ppAps place to put a pointer to the access points.
+ * @return      the number of access points at *ppAps.
+ */
+int32_t wifiScanGetAps(const wifi_ap_record_t **ppAps);
+
+/** Stop scanning and switch Wifi off.
+ */
+void wifiScanStop();
+
+#endif // _WIFI_SCAN_H_
+
+// End Of File